@@ -33,6 +33,7 @@
 
 #include "audio_driver.h"
 #include "audio_thread_wrapper.h"
+#include "audio_output_thread.h"
 #include "../gfx/video_driver.h"
 #include "../record/record_driver.h"
 #include "../frontend/frontend_driver.h"
@@ -40,6 +41,8 @@
 #include "../command.h"
 #include "../driver.h"
 #include "../configuration.h"
+#include "../frame_timeline.h"
+#include "../managers/frame_delay.h"
 #include "../retroarch.h"
 #include "../verbosity.h"
 #include "../list_special.h"
@@ -332,6 +335,9 @@ static bool audio_driver_init_internal(bool audio_cb_inited)
    float *samples_buf    = NULL;
    int16_t *conv_buf     = NULL;
    int16_t *rewind_buf   = NULL;
+#ifdef HAVE_THREADS
+   const audio_driver_t *out_driver = NULL;
+#endif
    size_t max_bufsamples = AUDIO_CHUNK_SIZE_NONBLOCKING * 2;
    settings_t *settings  = config_get_ptr();
    /* Accomodate rewind since at some point we might have two full buffers. */
@@ -390,6 +396,20 @@ static bool audio_driver_init_internal(bool audio_cb_inited)
          retroarch_fail(1, "audio_driver_init_internal()");
       }
    }
+   else if (settings->bools.audio_output_thread
+         && audio_init_output_thread(
+               &out_driver,
+               &audio_driver_context_audio_data,
+               *settings->arrays.audio_device
+               ? settings->arrays.audio_device : NULL,
+               settings->uints.audio_out_rate, &new_rate,
+               settings->uints.audio_latency,
+               settings->uints.audio_block_frames,
+               current_audio))
+   {
+      RARCH_LOG("[Audio]: Started audio output thread.\n");
+      current_audio = out_driver;
+   }
    else
 #endif
    {
@@ -654,13 +674,21 @@ static bool audio_driver_flush(const int16_t *data, size_t samples)
       output_frames  *= sizeof(int16_t);
    }
 
+   frame_timeline_begin(FRAME_TIMELINE_AUDIO_FLUSH);
+   frame_delay_auto_wait_begin();
+
    if (current_audio->write(audio_driver_context_audio_data,
             output_data, output_frames * 2) < 0)
    {
+      frame_delay_auto_wait_end();
+      frame_timeline_end(FRAME_TIMELINE_AUDIO_FLUSH);
       audio_driver_active = false;
       return false;
    }
 
+   frame_delay_auto_wait_end();
+   frame_timeline_end(FRAME_TIMELINE_AUDIO_FLUSH);
+
    return true;
 }
 
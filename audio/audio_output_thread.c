@@ -0,0 +1,523 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <retro_atomic.h>
+#include <retro_math.h>
+#include <retro_miscellaneous.h>
+#include <rthreads/rthreads.h>
+#include <audio/conversion/float_to_s16.h>
+
+#include "audio_output_thread.h"
+#include "../verbosity.h"
+
+/* Samples handed to the driver per write. */
+#define AUDIO_OUTPUT_THREAD_CHUNK     1024
+/* Sleepers are woken up explicitly, the timeout only covers
+ * a wakeup that raced with going to sleep. */
+#define AUDIO_OUTPUT_THREAD_WAIT_USEC 2000
+
+#ifdef HAVE_RETRO_ATOMIC
+typedef retro_atomic_int_t audio_output_pos_t;
+#else
+typedef int audio_output_pos_t;
+#endif
+
+typedef struct audio_output_thread
+{
+   const audio_driver_t *driver;
+   void *driver_data;
+
+   sthread_t *thread;
+   slock_t *lock;
+   scond_t *cond;
+#ifndef HAVE_RETRO_ATOMIC
+   slock_t *ring_lock;
+#endif
+   bool alive;
+   bool stopped;
+   bool stopped_ack;
+   bool is_paused;
+   bool is_shutdown;
+   bool use_float;
+   bool nonblock;
+   bool nonblock_changed;
+   volatile bool failed;
+
+   int inited;
+
+   /* Interleaved stereo samples. Positions are always even, and
+    * one frame stays free to tell a full ring from an empty one. */
+   float *ring;
+   int16_t *conv_buf;
+   int ring_mask;
+   audio_output_pos_t read;  /* Only moved by the output thread. */
+   audio_output_pos_t write; /* Only moved by the emulator thread. */
+   audio_output_pos_t reader_waiting;
+   audio_output_pos_t writer_waiting;
+
+   /* Initialization options. */
+   const char *device;
+   unsigned *new_rate;
+   unsigned out_rate;
+   unsigned latency;
+   unsigned block_frames;
+} audio_output_thread_t;
+
+static int audio_output_thread_load(audio_output_thread_t *thr,
+      audio_output_pos_t *pos)
+{
+#ifdef HAVE_RETRO_ATOMIC
+   return (int)retro_atomic_load_acquire(pos);
+#else
+   int val;
+
+   slock_lock(thr->ring_lock);
+   val = *pos;
+   slock_unlock(thr->ring_lock);
+
+   return val;
+#endif
+}
+
+static void audio_output_thread_store(audio_output_thread_t *thr,
+      audio_output_pos_t *pos, int val)
+{
+#ifdef HAVE_RETRO_ATOMIC
+   /* Exchange rather than store, so that the following look at
+    * the other side's waiting flag cannot move ahead of it. */
+   retro_atomic_xchg(pos, val);
+#else
+   slock_lock(thr->ring_lock);
+   *pos = val;
+   slock_unlock(thr->ring_lock);
+#endif
+}
+
+static int audio_output_thread_used(audio_output_thread_t *thr,
+      int read, int write)
+{
+   return (write - read) & thr->ring_mask;
+}
+
+/* Sleeps until the other thread has moved @pos away from @seen. */
+static void audio_output_thread_wait(audio_output_thread_t *thr,
+      audio_output_pos_t *waiting, audio_output_pos_t *pos, int seen)
+{
+   slock_lock(thr->lock);
+   audio_output_thread_store(thr, waiting, 1);
+   if (audio_output_thread_load(thr, pos) == seen
+         && thr->alive && !thr->stopped)
+      scond_wait_timeout(thr->cond, thr->lock,
+            AUDIO_OUTPUT_THREAD_WAIT_USEC);
+   audio_output_thread_store(thr, waiting, 0);
+   slock_unlock(thr->lock);
+}
+
+static void audio_output_thread_wake(audio_output_thread_t *thr,
+      audio_output_pos_t *waiting)
+{
+   if (!audio_output_thread_load(thr, waiting))
+      return;
+
+   slock_lock(thr->lock);
+   scond_broadcast(thr->cond);
+   slock_unlock(thr->lock);
+}
+
+static void audio_output_thread_loop(void *data)
+{
+   int read                   = 0;
+   audio_output_thread_t *thr = (audio_output_thread_t*)data;
+
+   if (!thr)
+      return;
+
+   RARCH_LOG("[Audio Output Thread]: Initializing audio driver.\n");
+   thr->driver_data   = thr->driver->init(thr->device, thr->out_rate,
+         thr->latency, thr->block_frames, thr->new_rate);
+   slock_lock(thr->lock);
+   thr->inited        = thr->driver_data ? 1 : -1;
+   if (thr->inited > 0 && thr->driver->use_float)
+      thr->use_float  = thr->driver->use_float(thr->driver_data);
+   scond_broadcast(thr->cond);
+   slock_unlock(thr->lock);
+
+   if (thr->inited < 0)
+      return;
+
+   for (;;)
+   {
+      int write, count;
+
+      slock_lock(thr->lock);
+
+      if (!thr->alive)
+      {
+         thr->stopped_ack = true;
+         scond_broadcast(thr->cond);
+         slock_unlock(thr->lock);
+         break;
+      }
+
+      if (thr->stopped)
+      {
+         thr->driver->stop(thr->driver_data);
+         while (thr->stopped)
+         {
+            thr->stopped_ack = true;
+            scond_broadcast(thr->cond);
+
+            scond_wait(thr->cond, thr->lock);
+         }
+         thr->driver->start(thr->driver_data, thr->is_shutdown);
+      }
+
+      if (thr->nonblock_changed)
+      {
+         thr->driver->set_nonblock_state(thr->driver_data, thr->nonblock);
+         thr->nonblock_changed = false;
+      }
+
+      slock_unlock(thr->lock);
+
+      write = audio_output_thread_load(thr, &thr->write);
+      count = audio_output_thread_used(thr, read, write);
+
+      if (!count)
+      {
+         audio_output_thread_wait(thr,
+               &thr->reader_waiting, &thr->write, write);
+         continue;
+      }
+
+      count = MIN(count, thr->ring_mask + 1 - read);
+      count = MIN(count, AUDIO_OUTPUT_THREAD_CHUNK);
+
+      /* Once the driver failed, keep draining so the emulator
+       * thread never waits on us. */
+      if (!thr->failed)
+      {
+         ssize_t ret;
+
+         if (thr->use_float)
+            ret = thr->driver->write(thr->driver_data,
+                  thr->ring + read, count * sizeof(float));
+         else
+         {
+            convert_float_to_s16(thr->conv_buf, thr->ring + read, count);
+            ret = thr->driver->write(thr->driver_data,
+                  thr->conv_buf, count * sizeof(int16_t));
+         }
+
+         if (ret < 0)
+            thr->failed = true;
+      }
+
+      read = (read + count) & thr->ring_mask;
+      audio_output_thread_store(thr, &thr->read, read);
+      audio_output_thread_wake(thr, &thr->writer_waiting);
+   }
+
+   RARCH_LOG("[Audio Output Thread]: Tearing down driver.\n");
+   thr->driver->free(thr->driver_data);
+}
+
+static void audio_output_thread_block(audio_output_thread_t *thr)
+{
+   if (!thr)
+      return;
+
+   if (thr->stopped)
+      return;
+
+   slock_lock(thr->lock);
+   thr->stopped_ack = false;
+   thr->stopped     = true;
+   scond_broadcast(thr->cond);
+
+   /* Wait until audio driver actually goes to sleep. */
+   while (!thr->stopped_ack)
+      scond_wait(thr->cond, thr->lock);
+
+   slock_unlock(thr->lock);
+}
+
+static void audio_output_thread_unblock(audio_output_thread_t *thr)
+{
+   if (!thr)
+      return;
+
+   slock_lock(thr->lock);
+   thr->stopped = false;
+   scond_broadcast(thr->cond);
+   slock_unlock(thr->lock);
+}
+
+static void audio_output_thread_free(void *data)
+{
+   audio_output_thread_t *thr = (audio_output_thread_t*)data;
+
+   if (!thr)
+      return;
+
+   if (thr->thread)
+   {
+      slock_lock(thr->lock);
+      thr->stopped = false;
+      thr->alive   = false;
+      scond_broadcast(thr->cond);
+      slock_unlock(thr->lock);
+
+      sthread_join(thr->thread);
+   }
+
+   if (thr->lock)
+      slock_free(thr->lock);
+   if (thr->cond)
+      scond_free(thr->cond);
+#ifndef HAVE_RETRO_ATOMIC
+   if (thr->ring_lock)
+      slock_free(thr->ring_lock);
+#endif
+   free(thr->ring);
+   free(thr->conv_buf);
+   free(thr);
+}
+
+static bool audio_output_thread_alive(void *data)
+{
+   audio_output_thread_t *thr = (audio_output_thread_t*)data;
+
+   if (!thr)
+      return false;
+
+   return !thr->is_paused;
+}
+
+static bool audio_output_thread_stop(void *data)
+{
+   audio_output_thread_t *thr = (audio_output_thread_t*)data;
+
+   if (!thr)
+      return false;
+
+   audio_output_thread_block(thr);
+   thr->is_paused = true;
+
+   return true;
+}
+
+static bool audio_output_thread_start(void *data, bool is_shutdown)
+{
+   audio_output_thread_t *thr = (audio_output_thread_t*)data;
+
+   if (!thr)
+      return false;
+
+   thr->is_paused   = false;
+   thr->is_shutdown = is_shutdown;
+   audio_output_thread_unblock(thr);
+
+   return true;
+}
+
+static void audio_output_thread_set_nonblock_state(void *data, bool state)
+{
+   audio_output_thread_t *thr = (audio_output_thread_t*)data;
+
+   if (!thr)
+      return;
+
+   slock_lock(thr->lock);
+   thr->nonblock         = state;
+   thr->nonblock_changed = true;
+   scond_broadcast(thr->cond);
+   slock_unlock(thr->lock);
+}
+
+static bool audio_output_thread_use_float(void *data)
+{
+   /* Samples are queued as float, the output
+    * thread converts them if the driver wants s16. */
+   return true;
+}
+
+static ssize_t audio_output_thread_write(void *data,
+      const void *buf, size_t size)
+{
+   int write;
+   int done                   = 0;
+   const float *in            = (const float*)buf;
+   int samples                = (int)(size / sizeof(float));
+   audio_output_thread_t *thr = (audio_output_thread_t*)data;
+
+   if (!thr)
+      return 0;
+
+   if (thr->failed)
+      return -1;
+
+   write = audio_output_thread_load(thr, &thr->write);
+
+   while (done < samples)
+   {
+      int count;
+      int read  = audio_output_thread_load(thr, &thr->read);
+      int avail = thr->ring_mask - 1
+         - audio_output_thread_used(thr, read, write);
+
+      if (avail <= 0)
+      {
+         /* Drop what does not fit, like a nonblocking driver. */
+         if (thr->nonblock || thr->is_paused || thr->failed)
+            break;
+
+         audio_output_thread_wait(thr,
+               &thr->writer_waiting, &thr->read, read);
+         continue;
+      }
+
+      count = MIN(avail, samples - done);
+      count = MIN(count, thr->ring_mask + 1 - write);
+
+      memcpy(thr->ring + write, in + done, count * sizeof(float));
+
+      write = (write + count) & thr->ring_mask;
+      audio_output_thread_store(thr, &thr->write, write);
+      audio_output_thread_wake(thr, &thr->reader_waiting);
+
+      done += count;
+   }
+
+   return done * sizeof(float);
+}
+
+static size_t audio_output_thread_write_avail(void *data)
+{
+   audio_output_thread_t *thr = (audio_output_thread_t*)data;
+   int read                   = audio_output_thread_load(thr, &thr->read);
+   int write                  = audio_output_thread_load(thr, &thr->write);
+
+   return (thr->ring_mask - 1
+         - audio_output_thread_used(thr, read, write)) * sizeof(float);
+}
+
+static size_t audio_output_thread_buffer_size(void *data)
+{
+   audio_output_thread_t *thr = (audio_output_thread_t*)data;
+
+   return (thr->ring_mask - 1) * sizeof(float);
+}
+
+static const audio_driver_t audio_output_thread = {
+   NULL,
+   audio_output_thread_write,
+   audio_output_thread_stop,
+   audio_output_thread_start,
+   audio_output_thread_alive,
+   audio_output_thread_set_nonblock_state,
+   audio_output_thread_free,
+   audio_output_thread_use_float,
+   "audio-output-thread",
+   NULL,
+   NULL,
+   /* Rate control keeps the queue half full,
+    * the driver itself just stays full. */
+   audio_output_thread_write_avail,
+   audio_output_thread_buffer_size,
+};
+
+/**
+ * audio_init_output_thread:
+ * @out_driver                : output driver
+ * @out_data                  : output audio data
+ * @device                    : audio device (optional)
+ * @out_rate                  : output audio rate
+ * @new_rate                  : new output audio rate
+ * @latency                   : audio latency
+ * @block_frames              : block frames of the driver
+ * @driver                    : audio driver
+ *
+ * Starts a audio driver in a new thread, fed from a lock-free
+ * queue of float samples. The queue holds about half of
+ * @latency on top of the driver's own buffer.
+ *
+ * Returns: true (1) if successful, otherwise false (0).
+ **/
+bool audio_init_output_thread(const audio_driver_t **out_driver,
+      void **out_data, const char *device, unsigned audio_out_rate,
+      unsigned *new_rate, unsigned latency,
+      unsigned block_frames, const audio_driver_t *drv)
+{
+   uint32_t samples           = (uint32_t)
+      ((uint64_t)audio_out_rate * latency / 1000);
+   audio_output_thread_t *thr = (audio_output_thread_t*)
+      calloc(1, sizeof(*thr));
+   if (!thr)
+      return false;
+
+   samples             = next_pow2(MAX(samples,
+            AUDIO_OUTPUT_THREAD_CHUNK * 2));
+
+   thr->driver         = (const audio_driver_t*)drv;
+   thr->device         = device;
+   thr->out_rate       = audio_out_rate;
+   thr->new_rate       = new_rate;
+   thr->latency        = latency;
+   thr->block_frames   = block_frames;
+   thr->ring_mask      = (int)samples - 1;
+
+   if (!(thr->ring     = (float*)calloc(samples, sizeof(float))))
+      goto error;
+   if (!(thr->conv_buf = (int16_t*)malloc(
+               AUDIO_OUTPUT_THREAD_CHUNK * sizeof(int16_t))))
+      goto error;
+   if (!(thr->cond     = scond_new()))
+      goto error;
+   if (!(thr->lock     = slock_new()))
+      goto error;
+#ifndef HAVE_RETRO_ATOMIC
+   if (!(thr->ring_lock = slock_new()))
+      goto error;
+#endif
+
+   thr->alive = true;
+
+   if (!(thr->thread   = sthread_create(audio_output_thread_loop, thr)))
+      goto error;
+
+   /* Wait until thread has initialized (or failed) the driver. */
+   slock_lock(thr->lock);
+   while (!thr->inited)
+      scond_wait(thr->cond, thr->lock);
+   slock_unlock(thr->lock);
+
+   if (thr->inited < 0) /* Thread failed. */
+      goto error;
+
+   *out_driver         = &audio_output_thread;
+   *out_data           = thr;
+   return true;
+
+error:
+   *out_driver         = NULL;
+   *out_data           = NULL;
+   audio_output_thread_free(thr);
+   return false;
+}
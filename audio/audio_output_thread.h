@@ -0,0 +1,48 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RARCH_AUDIO_OUTPUT_THREAD_H__
+#define RARCH_AUDIO_OUTPUT_THREAD_H__
+
+#include <boolean.h>
+
+#include "audio_driver.h"
+
+/**
+ * audio_init_output_thread:
+ * @out_driver                : output driver
+ * @out_data                  : output audio data
+ * @device                    : audio device (optional)
+ * @out_rate                  : output audio rate
+ * @new_rate                  : new output audio rate
+ * @latency                   : audio latency
+ * @block_frames              : block frames of the driver
+ * @driver                    : audio driver
+ *
+ * Starts a audio driver in a new thread, fed from a lock-free
+ * queue of float samples. Writes only block when the queue is
+ * full, and the queue reports its fill level for rate control.
+ * Unlike audio_init_thread, this is used for drivers that are
+ * written to, not for the audio callback.
+ *
+ * Returns: true (1) if successful, otherwise false (0).
+ **/
+bool audio_init_output_thread(const audio_driver_t **out_driver,
+      void **out_data, const char *device, unsigned out_rate,
+      unsigned *new_rate, unsigned latency,
+      unsigned block_frames, const audio_driver_t *driver);
+
+#endif
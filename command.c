@@ -68,6 +68,7 @@
 #include "core_info.h"
 #include "core_type.h"
 #include "performance_counters.h"
+#include "frame_timeline.h"
 #include "dynamic.h"
 #include "content.h"
 #include "dirs.h"
@@ -77,6 +78,8 @@
 #include "retroarch.h"
 #include "managers/cheat_manager.h"
 #include "managers/state_manager.h"
+#include "managers/run_ahead.h"
+#include "managers/frame_delay.h"
 #include "ui/ui_companion_driver.h"
 #include "tasks/tasks_internal.h"
 #include "list_special.h"
@@ -125,9 +128,11 @@ struct command
 
 static bool command_read_ram(const char *arg);
 static bool command_write_ram(const char *arg);
+static bool command_timeline_dump(const char *arg);
 
 static const struct cmd_action_map action_map[] = {
    { "SET_SHADER",      command_set_shader,  "<shader path>" },
+   { "TIMELINE_DUMP",   command_timeline_dump, "<trace path>" },
 #ifdef HAVE_CHEEVOS
    { "READ_CORE_RAM",   command_read_ram,    "<address> <number of bytes>" },
    { "WRITE_CORE_RAM",  command_write_ram,   "<address> <byte1> <byte2> ..." },
@@ -246,6 +251,29 @@ bool command_set_shader(const char *arg)
    return video_driver_set_shader(type, arg);
 }
 
+static bool command_timeline_dump(const char *arg)
+{
+   char msg[256];
+
+   if (!frame_timeline_is_active())
+   {
+      RARCH_WARN("[Timeline]: Nothing recorded, enable frame_timeline_enable first.\n");
+      return false;
+   }
+
+   if (!frame_timeline_write_trace(arg))
+   {
+      RARCH_ERR("[Timeline]: Could not write trace to \"%s\".\n", arg);
+      return false;
+   }
+
+   snprintf(msg, sizeof(msg), "Frame timeline: \"%s\"", arg);
+   runloop_msg_queue_push(msg, 1, 120, true);
+   RARCH_LOG("[Timeline]: Wrote trace to \"%s\".\n", arg);
+
+   return true;
+}
+
 static bool command_read_ram(const char *arg)
 {
 #if defined(HAVE_COMMAND) && defined(HAVE_CHEEVOS)
@@ -1058,6 +1086,9 @@ static void command_event_deinit_core(bool reinit)
    cheevos_unload();
 #endif
 
+   runahead_event_deinit();
+   frame_delay_auto_reset();
+
    core_unload_game();
    core_unload();
    core_uninit_symbols();
@@ -1925,7 +1956,8 @@ TODO: Add a setting for these tweaks */
                if (!netplay_driver_ctl(RARCH_NETPLAY_CTL_IS_ENABLED, NULL))
 #endif
                {
-                  state_manager_event_init((unsigned)settings->rewind_buffer_size);
+                  state_manager_event_init((unsigned)settings->rewind_buffer_size,
+                        settings->bools.rewind_threaded);
                }
             }
          }
@@ -1933,10 +1965,10 @@ TODO: Add a setting for these tweaks */
       case CMD_EVENT_REWIND_TOGGLE:
          {
             settings_t *settings      = config_get_ptr();
+            /* Start over, so changed rewind settings apply. */
+            command_event(CMD_EVENT_REWIND_DEINIT, NULL);
             if (settings->bools.rewind_enable)
                command_event(CMD_EVENT_REWIND_INIT, NULL);
-            else
-               command_event(CMD_EVENT_REWIND_DEINIT, NULL);
          }
          break;
       case CMD_EVENT_AUTOSAVE_DEINIT:
@@ -65,6 +65,7 @@ static bool materialui_icons_enable      = true;
 static const bool def_history_list_enable = true;
 static const bool def_playlist_entry_remove = true;
 static const bool def_playlist_entry_rename = true;
+static const bool def_playlist_binary_format = false;
 
 static const unsigned int def_user_language = 0;
 
@@ -146,6 +147,17 @@ static const unsigned hard_sync_frames = 0;
  */
 static const unsigned frame_delay = 0;
 
+/* Tunes the frame delay automatically, to the largest value
+ * the core leaves time for. Overrides frame_delay.
+ */
+static const bool frame_delay_auto = false;
+
+/* Sets how many frames to run ahead of the displayed frame, using
+ * savestates to hide the input lag inherent to the emulated game.
+ * Requires a core with serialization support. 0 disables it.
+ */
+static const unsigned run_ahead_frames = 0;
+
 /* Inserts a black frame inbetween frames.
  * Useful for 120 Hz monitors who want to play 60 Hz material with eliminated
  * ghosting. video_refresh_rate should still be configured as if it
@@ -174,6 +186,10 @@ static const bool threaded_data_runloop_enable = true;
 static const bool threaded_data_runloop_enable = false;
 #endif
 
+/* Amount of worker threads used by the threaded data runloop.
+ * 0 uses the amount of CPU cores minus one. */
+static const unsigned threaded_data_runloop_workers = 0;
+
 /* Set to true if HW render cores should get their private context. */
 static const bool video_shared_context = false;
 
@@ -447,6 +463,10 @@ static const int out_latency = 64;
 /* Will sync audio. (recommended) */
 static const bool audio_sync = true;
 
+/* Write audio to the driver on a thread of its own, so a
+ * blocking driver does not eat into the frame time. */
+static const bool audio_output_thread = false;
+
 /* Audio rate control. */
 #if !defined(RARCH_CONSOLE)
 static const bool rate_control = true;
@@ -483,6 +503,12 @@ static const bool fps_show = false;
 /* Show frame count on FPS display */
 static const bool framecount_show = true;
 
+/* Record per-frame stage timings, see frame_timeline.h */
+static const bool frame_timeline_enable = false;
+
+/* Show the recorded stage timings as a graph onscreen. */
+static const bool frame_timeline_show = false;
+
 /* Enables use of rewind. This will incur some memory footprint
  * depending on the save state buffer. */
 static const bool rewind_enable = false;
@@ -494,6 +520,11 @@ static const unsigned rewind_buffer_size = 20 << 20; /* 20MiB */
 /* How many frames to rewind at a time. */
 static const unsigned rewind_granularity = 1;
 
+/* Diff and compress rewind savestates on a separate thread.
+ * Takes the per-frame rewind cost off the main thread and fits
+ * more history in the rewind buffer. */
+static const bool rewind_threaded = false;
+
 /* Pause gameplay when gameplay loses focus. */
 #ifdef EMSCRIPTEN
 static const bool pause_nonactive = false;
@@ -551,6 +582,11 @@ static const bool savestate_auto_load = false;
 
 static const bool savestate_thumbnail_enable = false;
 
+/* Compress savestates written to disk. Uncompressed
+ * savestates can still be loaded, but compressed ones
+ * cannot be loaded by older versions of RetroArch. */
+static const bool savestate_file_compression = false;
+
 /* Slowmotion ratio. */
 static const float slowmotion_ratio = 3.0;
 
@@ -65,6 +65,7 @@ typedef struct settings
       bool video_windowed_fullscreen;
       bool video_vsync;
       bool video_hard_sync;
+      bool video_frame_delay_auto;
       bool video_black_frame_insertion;
       bool video_vfilter;
       bool video_smooth;
@@ -84,11 +85,14 @@ typedef struct settings
       bool video_force_srgb_disable;
       bool video_fps_show;
       bool video_framecount_show;
+      bool video_frame_timeline_show;
+      bool frame_timeline_enable;
       bool video_msg_bgcolor_enable;
 
       /* Audio */
       bool audio_enable;
       bool audio_sync;
+      bool audio_output_thread;
       bool audio_rate_control;
       bool audio_wasapi_exclusive_mode;
       bool audio_wasapi_float_format;
@@ -209,13 +213,16 @@ typedef struct settings
       bool history_list_enable;
       bool playlist_entry_remove;
       bool playlist_entry_rename;
+      bool playlist_binary_format;
       bool rewind_enable;
+      bool rewind_threaded;
       bool pause_nonactive;
       bool block_sram_overwrite;
       bool savestate_auto_index;
       bool savestate_auto_save;
       bool savestate_auto_load;
       bool savestate_thumbnail_enable;
+      bool savestate_file_compression;
       bool network_cmd_enable;
       bool stdin_cmd_enable;
       bool keymapper_enable;
@@ -306,6 +313,7 @@ typedef struct settings
       unsigned bundle_assets_extract_version_current;
       unsigned bundle_assets_extract_last_version;
       unsigned content_history_size;
+      unsigned threaded_data_runloop_workers;
       unsigned libretro_log_level;
       unsigned rewind_granularity;
       unsigned autosave_interval;
@@ -321,6 +329,7 @@ typedef struct settings
       unsigned video_swap_interval;
       unsigned video_hard_sync_frames;
       unsigned video_frame_delay;
+      unsigned run_ahead_frames;
       unsigned video_viwidth;
       unsigned video_aspect_ratio_idx;
       unsigned video_rotation;
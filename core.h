@@ -159,6 +159,8 @@ bool core_set_default_callbacks(struct retro_callbacks *cbs);
 
 bool core_set_rewind_callbacks(void);
 
+bool core_set_runahead_callbacks(bool suspend_video, bool suspend_audio);
+
 #ifdef HAVE_NETWORKING
 bool core_set_netplay_callbacks(void);
 
@@ -170,6 +172,8 @@ bool core_set_poll_type(unsigned *type);
 /* Runs the core for one frame. */
 bool core_run(void);
 
+bool core_run_no_input_polling(void);
+
 bool core_init(void);
 
 bool core_deinit(void *data);
@@ -60,6 +60,16 @@ static void retro_input_poll_null(void)
 {
 }
 
+static void retro_audio_sample_null(int16_t left, int16_t right)
+{
+}
+
+static size_t retro_audio_sample_batch_null(const int16_t *data,
+      size_t frames)
+{
+   return frames;
+}
+
 static void core_input_state_poll_maybe(void)
 {
    if (current_core.poll_type == POLL_TYPE_NORMAL)
@@ -173,6 +183,31 @@ bool core_set_rewind_callbacks(void)
    return true;
 }
 
+/**
+ * core_set_runahead_callbacks:
+ * @suspend_video        : discard video frames emitted by the core
+ * @suspend_audio        : discard audio samples emitted by the core
+ *
+ * Sets the A/V callbacks for frames run speculatively by
+ * run-ahead, whose output must not reach the drivers.
+ * Passing false for both restores the regular callbacks.
+ **/
+bool core_set_runahead_callbacks(bool suspend_video, bool suspend_audio)
+{
+   current_core.retro_set_video_refresh(suspend_video
+         ? retro_frame_null : video_driver_frame);
+
+   if (suspend_audio)
+   {
+      current_core.retro_set_audio_sample(retro_audio_sample_null);
+      current_core.retro_set_audio_sample_batch(retro_audio_sample_batch_null);
+   }
+   else
+      core_set_rewind_callbacks();
+
+   return true;
+}
+
 #ifdef HAVE_NETWORKING
 /**
  * core_set_netplay_callbacks:
@@ -424,6 +459,20 @@ bool core_run(void)
    return true;
 }
 
+/* Runs the core for one frame, reusing the input state of
+ * the previous poll instead of polling the input driver again. */
+bool core_run_no_input_polling(void)
+{
+   current_core.input_polled = true;
+   current_core.retro_set_input_poll(retro_input_poll_null);
+
+   current_core.retro_run();
+
+   current_core.retro_set_input_poll(core_input_state_poll_maybe);
+
+   return true;
+}
+
 bool core_load(unsigned poll_type_behavior)
 {
    current_core.poll_type = poll_type_behavior;
@@ -15,11 +15,23 @@
  *  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <ctype.h>
+#include <stdint.h>
+
 #include <compat/strl.h>
 #include <string/stdstring.h>
 #include <file/file_path.h>
 #include <lists/dir_list.h>
 #include <file/archive_file.h>
+#include <streams/file_stream.h>
+#include <memmap.h>
+
+#ifdef HAVE_MMAN
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -80,61 +92,738 @@ static void core_info_list_resolve_all_extensions(
 #endif
 }
 
-static void core_info_list_resolve_all_firmware(
-      core_info_list_t *core_info_list)
+/* Version of the core info cache layout, bump on any change. */
+#define CORE_INFO_CACHE_VERSION 1
+
+enum core_info_cache_string
+{
+   CORE_INFO_CACHE_DISPLAY_NAME = 0,
+   CORE_INFO_CACHE_CORE_NAME,
+   CORE_INFO_CACHE_SYSTEMNAME,
+   CORE_INFO_CACHE_MANUFACTURER,
+   CORE_INFO_CACHE_EXTENSIONS,
+   CORE_INFO_CACHE_AUTHORS,
+   CORE_INFO_CACHE_PERMISSIONS,
+   CORE_INFO_CACHE_LICENSES,
+   CORE_INFO_CACHE_CATEGORIES,
+   CORE_INFO_CACHE_DATABASES,
+   CORE_INFO_CACHE_NOTES,
+   CORE_INFO_CACHE_STRINGS
+};
+
+/* The cache file is a header, the records, the firmware
+ * records and a string table. Strings are offsets into the
+ * table, 0 is NULL. All of it is in native byte order. */
+struct core_info_cache_header
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t record_size;
+   uint32_t count;
+   uint32_t firmware_count;
+   uint32_t strings_size;
+   uint32_t pad;
+};
+
+struct core_info_cache_record
+{
+   /* Size and modification time of the .info file
+    * the record was made from. */
+   int64_t mtime;
+   int32_t size;
+   uint32_t info_path;
+   uint32_t strings[CORE_INFO_CACHE_STRINGS];
+   uint32_t firmware_first;
+   uint32_t firmware_count;
+   uint32_t supports_no_game;
+};
+
+struct core_info_cache_firmware
+{
+   uint32_t path;
+   uint32_t desc;
+   uint32_t optional;
+};
+
+struct core_info_cache
+{
+   void *data;
+   size_t size;
+   bool mapped;
+   const struct core_info_cache_header *header;
+   const struct core_info_cache_record *records;
+   const struct core_info_cache_firmware *firmware;
+   const char *strings;
+   /* Info file path to record. */
+   struct core_info_map *paths;
+};
+
+struct core_info_map_bucket
+{
+   const char *key;
+   uint32_t hash;
+   unsigned count;
+   unsigned capacity;
+   /* Ascending, each at most once. */
+   unsigned *ids;
+};
+
+/* Open addressing map from a case-insensitive string
+ * to a list of ids. Keys are not copied. Ids are the
+ * order cores were loaded in, core_info_list_get_supported_cores
+ * sorts the list afterwards so they must not be used as
+ * indices into it. */
+struct core_info_map
+{
+   struct core_info_map_bucket *buckets;
+   size_t size;
+   size_t used;
+};
+
+static uint32_t core_info_map_hash(const char *key)
+{
+   uint32_t hash = 5381;
+
+   for (; *key; key++)
+      hash = hash * 33 + (uint32_t)tolower((unsigned char)*key);
+
+   return hash;
+}
+
+static struct core_info_map_bucket *core_info_map_slot(
+      struct core_info_map_bucket *buckets, size_t size,
+      const char *key, uint32_t hash)
+{
+   size_t mask = size - 1;
+   size_t i    = hash & mask;
+
+   while (buckets[i].key)
+   {
+      if (buckets[i].hash == hash
+            && string_is_equal_noncase(buckets[i].key, key))
+         break;
+      i = (i + 1) & mask;
+   }
+
+   return &buckets[i];
+}
+
+static struct core_info_map *core_info_map_new(void)
+{
+   struct core_info_map *map = (struct core_info_map*)
+      calloc(1, sizeof(*map));
+
+   if (!map)
+      return NULL;
+
+   map->size    = 64;
+   map->buckets = (struct core_info_map_bucket*)
+      calloc(map->size, sizeof(*map->buckets));
+
+   if (!map->buckets)
+   {
+      free(map);
+      return NULL;
+   }
+
+   return map;
+}
+
+static void core_info_map_free(struct core_info_map *map)
 {
    size_t i;
-   unsigned c;
+
+   if (!map)
+      return;
+
+   for (i = 0; i < map->size; i++)
+      free(map->buckets[i].ids);
+   free(map->buckets);
+   free(map);
+}
+
+static bool core_info_map_grow(struct core_info_map *map)
+{
+   size_t i;
+   size_t size                          = map->size * 2;
+   struct core_info_map_bucket *buckets = (struct core_info_map_bucket*)
+      calloc(size, sizeof(*buckets));
+
+   if (!buckets)
+      return false;
+
+   for (i = 0; i < map->size; i++)
+      if (map->buckets[i].key)
+         *core_info_map_slot(buckets, size, map->buckets[i].key,
+               map->buckets[i].hash) = map->buckets[i];
+
+   free(map->buckets);
+   map->buckets = buckets;
+   map->size    = size;
+   return true;
+}
+
+/* Ids have to be added in ascending order. */
+static void core_info_map_add(struct core_info_map *map,
+      const char *key, unsigned id)
+{
+   uint32_t hash;
+   struct core_info_map_bucket *bucket = NULL;
+
+   if (!map || string_is_empty(key))
+      return;
+
+   if ((map->used + 1) * 2 > map->size && !core_info_map_grow(map))
+      return;
+
+   hash   = core_info_map_hash(key);
+   bucket = core_info_map_slot(map->buckets, map->size, key, hash);
+
+   if (!bucket->key)
+   {
+      bucket->key  = key;
+      bucket->hash = hash;
+      map->used++;
+   }
+
+   if (bucket->count && bucket->ids[bucket->count - 1] == id)
+      return;
+
+   if (bucket->count == bucket->capacity)
+   {
+      unsigned capacity = bucket->capacity ? bucket->capacity * 2 : 4;
+      unsigned *ids     = (unsigned*)realloc(bucket->ids,
+            capacity * sizeof(*ids));
+
+      if (!ids)
+         return;
+
+      bucket->ids      = ids;
+      bucket->capacity = capacity;
+   }
+
+   bucket->ids[bucket->count++] = id;
+}
+
+static const struct core_info_map_bucket *core_info_map_find(
+      const struct core_info_map *map, const char *key)
+{
+   const struct core_info_map_bucket *bucket = NULL;
+
+   if (!map || string_is_empty(key))
+      return NULL;
+
+   bucket = core_info_map_slot(map->buckets, map->size,
+         key, core_info_map_hash(key));
+
+   return bucket->key ? bucket : NULL;
+}
+
+static void core_info_list_build_maps(core_info_list_t *core_info_list)
+{
+   size_t i, j;
+
+   core_info_list->ext_map      = core_info_map_new();
+   core_info_list->database_map = core_info_map_new();
 
    for (i = 0; i < core_info_list->count; i++)
    {
-      unsigned count                  = 0;
-      core_info_firmware_t *firmware  = NULL;
-      core_info_t *info               = (core_info_t*)&core_info_list->list[i];
-      config_file_t *config           = (config_file_t*)info->config_data;
+      const core_info_t *info = &core_info_list->list[i];
 
-      if (!config || !config_get_uint(config, "firmware_count", &count))
-         continue;
+      if (info->supported_extensions_list)
+         for (j = 0; j < info->supported_extensions_list->size; j++)
+            core_info_map_add(core_info_list->ext_map,
+                  info->supported_extensions_list->elems[j].data,
+                  (unsigned)i);
+
+      if (info->databases_list)
+         for (j = 0; j < info->databases_list->size; j++)
+            core_info_map_add(core_info_list->database_map,
+                  info->databases_list->elems[j].data,
+                  (unsigned)i);
+   }
+}
 
-      firmware = (core_info_firmware_t*)calloc(count, sizeof(*firmware));
+static void core_info_set_lists(core_info_t *info)
+{
+   if (info->supported_extensions)
+      info->supported_extensions_list =
+         string_split(info->supported_extensions, "|");
+   if (info->authors)
+      info->authors_list     = string_split(info->authors, "|");
+   if (info->permissions)
+      info->permissions_list = string_split(info->permissions, "|");
+   if (info->licenses)
+      info->licenses_list    = string_split(info->licenses, "|");
+   if (info->categories)
+      info->categories_list  = string_split(info->categories, "|");
+   if (info->databases)
+      info->databases_list   = string_split(info->databases, "|");
+   if (info->notes)
+      info->note_list        = string_split(info->notes, "|");
+}
 
-      if (!firmware)
-         continue;
+static char *core_info_config_get_string(config_file_t *conf,
+      const char *key)
+{
+   char *tmp = NULL;
+
+   if (config_get_string(conf, key, &tmp) && !string_is_empty(tmp))
+      return tmp;
+
+   free(tmp);
+   return NULL;
+}
+
+static void core_info_resolve_firmware(core_info_t *info,
+      config_file_t *config)
+{
+   unsigned c;
+   core_info_firmware_t *firmware  = NULL;
+
+   if (!info->firmware_count)
+      return;
+
+   firmware = (core_info_firmware_t*)calloc(info->firmware_count,
+         sizeof(*firmware));
+
+   if (!firmware)
+      return;
+
+   info->firmware = firmware;
+
+   for (c = 0; c < info->firmware_count; c++)
+   {
+      char path_key[64];
+      char desc_key[64];
+      char opt_key[64];
+      bool tmp_bool     = false;
+      path_key[0]       = desc_key[0] = opt_key[0] = '\0';
+
+      snprintf(path_key, sizeof(path_key), "firmware%u_path", c);
+      snprintf(desc_key, sizeof(desc_key), "firmware%u_desc", c);
+      snprintf(opt_key,  sizeof(opt_key),  "firmware%u_opt",  c);
+
+      info->firmware[c].path = core_info_config_get_string(config, path_key);
+      info->firmware[c].desc = core_info_config_get_string(config, desc_key);
+
+      if (config_get_bool(config, opt_key , &tmp_bool))
+         info->firmware[c].optional = tmp_bool;
+   }
+}
+
+static void core_info_parse_config_file(core_info_t *info,
+      config_file_t *conf)
+{
+   bool tmp_bool  = false;
+   unsigned count = 0;
+
+   info->display_name         = core_info_config_get_string(conf, "display_name");
+   info->core_name            = core_info_config_get_string(conf, "corename");
+   info->systemname           = core_info_config_get_string(conf, "systemname");
+   info->system_manufacturer  = core_info_config_get_string(conf, "manufacturer");
+   info->supported_extensions = core_info_config_get_string(conf, "supported_extensions");
+   info->authors              = core_info_config_get_string(conf, "authors");
+   info->permissions          = core_info_config_get_string(conf, "permissions");
+   info->licenses             = core_info_config_get_string(conf, "license");
+   info->categories           = core_info_config_get_string(conf, "categories");
+   info->databases            = core_info_config_get_string(conf, "database");
+   info->notes                = core_info_config_get_string(conf, "notes");
+
+   config_get_uint(conf, "firmware_count", &count);
+   info->firmware_count       = count;
+
+   if (config_get_bool(conf, "supports_no_game", &tmp_bool))
+      info->supports_no_game  = tmp_bool;
+
+   core_info_resolve_firmware(info, conf);
+   core_info_set_lists(info);
+
+   info->has_info             = true;
+}
+
+static char **core_info_string_fields(core_info_t *info,
+      char **fields)
+{
+   fields[CORE_INFO_CACHE_DISPLAY_NAME] = info->display_name;
+   fields[CORE_INFO_CACHE_CORE_NAME]    = info->core_name;
+   fields[CORE_INFO_CACHE_SYSTEMNAME]   = info->systemname;
+   fields[CORE_INFO_CACHE_MANUFACTURER] = info->system_manufacturer;
+   fields[CORE_INFO_CACHE_EXTENSIONS]   = info->supported_extensions;
+   fields[CORE_INFO_CACHE_AUTHORS]      = info->authors;
+   fields[CORE_INFO_CACHE_PERMISSIONS]  = info->permissions;
+   fields[CORE_INFO_CACHE_LICENSES]     = info->licenses;
+   fields[CORE_INFO_CACHE_CATEGORIES]   = info->categories;
+   fields[CORE_INFO_CACHE_DATABASES]    = info->databases;
+   fields[CORE_INFO_CACHE_NOTES]        = info->notes;
+   return fields;
+}
+
+static const char *core_info_cache_string(
+      const struct core_info_cache *cache, uint32_t offset)
+{
+   if (!offset || offset >= cache->header->strings_size)
+      return NULL;
+   return cache->strings + offset;
+}
+
+static char *core_info_cache_strdup(
+      const struct core_info_cache *cache, uint32_t offset)
+{
+   const char *str = core_info_cache_string(cache, offset);
+   return str ? strdup(str) : NULL;
+}
+
+static void core_info_cache_close(struct core_info_cache *cache)
+{
+   core_info_map_free(cache->paths);
+
+#ifdef HAVE_MMAN
+   if (cache->mapped)
+      munmap(cache->data, cache->size);
+   else
+#endif
+      free(cache->data);
+
+   memset(cache, 0, sizeof(*cache));
+}
+
+static bool core_info_cache_map(struct core_info_cache *cache,
+      const char *path)
+{
+#ifdef HAVE_MMAN
+   struct stat st;
+   void *data = NULL;
+   int fd     = open(path, O_RDONLY);
+
+   if (fd < 0)
+      return false;
+
+   if (fstat(fd, &st) < 0 || st.st_size <= 0)
+   {
+      close(fd);
+      return false;
+   }
+
+   data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+
+   if (data == MAP_FAILED)
+      return false;
+
+   cache->data   = data;
+   cache->size   = st.st_size;
+   cache->mapped = true;
+   return true;
+#else
+   void *data  = NULL;
+   ssize_t len = 0;
+
+   if (!path_is_valid(path)
+         || !filestream_read_file(path, &data, &len) || len <= 0)
+   {
+      free(data);
+      return false;
+   }
+
+   cache->data = data;
+   cache->size = len;
+   return true;
+#endif
+}
+
+/* Maps the cache file, it is checked for consistency
+ * and ignored if anything is off. */
+static bool core_info_cache_open(struct core_info_cache *cache,
+      const char *path)
+{
+   size_t i, expected;
+   const struct core_info_cache_header *header = NULL;
+
+   memset(cache, 0, sizeof(*cache));
+
+   if (!core_info_cache_map(cache, path))
+      return false;
+
+   if (cache->size < sizeof(*header))
+      goto error;
+
+   header   = (const struct core_info_cache_header*)cache->data;
+
+   if (memcmp(header->magic, "RACINFO", 8)
+         || header->version     != CORE_INFO_CACHE_VERSION
+         || header->record_size != sizeof(struct core_info_cache_record)
+         || !header->strings_size)
+      goto error;
+
+   expected = sizeof(*header)
+      + (size_t)header->count          * sizeof(*cache->records)
+      + (size_t)header->firmware_count * sizeof(*cache->firmware)
+      + header->strings_size;
+
+   if (expected != cache->size)
+      goto error;
+
+   cache->header   = header;
+   cache->records  = (const struct core_info_cache_record*)(header + 1);
+   cache->firmware = (const struct core_info_cache_firmware*)
+      (cache->records + header->count);
+   cache->strings  = (const char*)(cache->firmware + header->firmware_count);
+
+   if (cache->strings[header->strings_size - 1] != '\0')
+      goto error;
+
+   cache->paths    = core_info_map_new();
+
+   for (i = 0; i < header->count; i++)
+   {
+      const struct core_info_cache_record *rec = &cache->records[i];
+
+      if (rec->firmware_first > header->firmware_count
+            || rec->firmware_count > header->firmware_count - rec->firmware_first)
+         goto error;
 
-      info->firmware = firmware;
+      core_info_map_add(cache->paths,
+            core_info_cache_string(cache, rec->info_path), (unsigned)i);
+   }
+
+   return true;
+
+error:
+   core_info_cache_close(cache);
+   return false;
+}
 
-      for (c = 0; c < count; c++)
+static bool core_info_cache_load(const struct core_info_cache *cache,
+      core_info_t *info, const char *info_path,
+      int32_t size, int64_t mtime)
+{
+   unsigned i;
+   const struct core_info_cache_record *rec  = NULL;
+   const struct core_info_map_bucket *bucket = core_info_map_find(
+         cache->paths, info_path);
+
+   if (!bucket)
+      return false;
+
+   /* Paths are case sensitive, the map is not. */
+   for (i = 0; i < bucket->count; i++)
+   {
+      rec = &cache->records[bucket->ids[i]];
+      if (string_is_equal(core_info_cache_string(cache, rec->info_path),
+               info_path))
+         break;
+      rec = NULL;
+   }
+
+   if (!rec || rec->mtime != mtime || rec->size != size)
+      return false;
+
+   info->display_name         = core_info_cache_strdup(cache,
+         rec->strings[CORE_INFO_CACHE_DISPLAY_NAME]);
+   info->core_name            = core_info_cache_strdup(cache,
+         rec->strings[CORE_INFO_CACHE_CORE_NAME]);
+   info->systemname           = core_info_cache_strdup(cache,
+         rec->strings[CORE_INFO_CACHE_SYSTEMNAME]);
+   info->system_manufacturer  = core_info_cache_strdup(cache,
+         rec->strings[CORE_INFO_CACHE_MANUFACTURER]);
+   info->supported_extensions = core_info_cache_strdup(cache,
+         rec->strings[CORE_INFO_CACHE_EXTENSIONS]);
+   info->authors              = core_info_cache_strdup(cache,
+         rec->strings[CORE_INFO_CACHE_AUTHORS]);
+   info->permissions          = core_info_cache_strdup(cache,
+         rec->strings[CORE_INFO_CACHE_PERMISSIONS]);
+   info->licenses             = core_info_cache_strdup(cache,
+         rec->strings[CORE_INFO_CACHE_LICENSES]);
+   info->categories           = core_info_cache_strdup(cache,
+         rec->strings[CORE_INFO_CACHE_CATEGORIES]);
+   info->databases            = core_info_cache_strdup(cache,
+         rec->strings[CORE_INFO_CACHE_DATABASES]);
+   info->notes                = core_info_cache_strdup(cache,
+         rec->strings[CORE_INFO_CACHE_NOTES]);
+   info->supports_no_game     = rec->supports_no_game != 0;
+   info->firmware_count       = rec->firmware_count;
+
+   if (rec->firmware_count)
+   {
+      info->firmware = (core_info_firmware_t*)calloc(
+            rec->firmware_count, sizeof(*info->firmware));
+
+      if (info->firmware)
       {
-         char path_key[64];
-         char desc_key[64];
-         char opt_key[64];
-         bool tmp_bool     = false;
-         char *tmp         = NULL;
-         path_key[0]       = desc_key[0] = opt_key[0] = '\0';
-
-         snprintf(path_key, sizeof(path_key), "firmware%u_path", c);
-         snprintf(desc_key, sizeof(desc_key), "firmware%u_desc", c);
-         snprintf(opt_key,  sizeof(opt_key),  "firmware%u_opt",  c);
-
-         if (config_get_string(config, path_key, &tmp) && !string_is_empty(tmp))
+         for (i = 0; i < rec->firmware_count; i++)
          {
-            info->firmware[c].path = strdup(tmp);
-            free(tmp);
-            tmp = NULL;
-         }
-         if (config_get_string(config, desc_key, &tmp) && !string_is_empty(tmp))
-         {
-            info->firmware[c].desc = strdup(tmp);
-            free(tmp);
-            tmp = NULL;
+            const struct core_info_cache_firmware *fw =
+               &cache->firmware[rec->firmware_first + i];
+
+            info->firmware[i].path     = core_info_cache_strdup(cache, fw->path);
+            info->firmware[i].desc     = core_info_cache_strdup(cache, fw->desc);
+            info->firmware[i].optional = fw->optional != 0;
          }
-         if (tmp)
-            free(tmp);
-         tmp = NULL;
-         if (config_get_bool(config, opt_key , &tmp_bool))
-            info->firmware[c].optional = tmp_bool;
       }
    }
+
+   core_info_set_lists(info);
+
+   info->has_info = true;
+   return true;
+}
+
+struct core_info_cache_writer
+{
+   char *strings;
+   size_t strings_size;
+   size_t strings_cap;
+};
+
+static uint32_t core_info_cache_add_string(
+      struct core_info_cache_writer *writer, const char *str)
+{
+   size_t len;
+   uint32_t offset;
+
+   if (!str)
+      return 0;
+
+   len = strlen(str) + 1;
+
+   if (writer->strings_size + len > writer->strings_cap)
+   {
+      size_t cap    = writer->strings_cap ? writer->strings_cap : 4096;
+      char *strings = NULL;
+
+      while (writer->strings_size + len > cap)
+         cap *= 2;
+
+      strings = (char*)realloc(writer->strings, cap);
+      if (!strings)
+         return 0;
+
+      writer->strings     = strings;
+      writer->strings_cap = cap;
+   }
+
+   offset = (uint32_t)writer->strings_size;
+   memcpy(writer->strings + offset, str, len);
+   writer->strings_size += len;
+   return offset;
+}
+
+/**
+ * core_info_cache_write:
+ * @path                 : path of the cache file.
+ * @infos                : core info, NULL if a core has none.
+ * @info_paths           : path of the .info file of each core.
+ * @sizes                : size of each .info file.
+ * @mtimes               : modification time of each .info file.
+ * @count                : number of cores.
+ *
+ * Writes the core info cache. Cores without a .info file
+ * or a modification time are left out.
+ **/
+static void core_info_cache_write(const char *path,
+      core_info_t *infos, char **info_paths,
+      const int32_t *sizes, const int64_t *mtimes, size_t count)
+{
+   size_t i, j;
+   size_t data_size;
+   struct core_info_cache_header header;
+   struct core_info_cache_writer writer;
+   uint8_t *data                            = NULL;
+   struct core_info_cache_record *records   = (struct core_info_cache_record*)
+      calloc(count ? count : 1, sizeof(*records));
+   struct core_info_cache_firmware *fw      = NULL;
+   size_t fw_count                          = 0;
+   size_t fw_total                          = 0;
+   uint32_t rec_count                       = 0;
+
+   memset(&writer, 0, sizeof(writer));
+
+   if (!records)
+      return;
+
+   for (i = 0; i < count; i++)
+      if (infos[i].has_info)
+         fw_total += infos[i].firmware ? infos[i].firmware_count : 0;
+
+   fw = (struct core_info_cache_firmware*)calloc(
+         fw_total ? fw_total : 1, sizeof(*fw));
+   if (!fw)
+      goto end;
+
+   /* Offset 0 is NULL. */
+   core_info_cache_add_string(&writer, "");
+
+   for (i = 0; i < count; i++)
+   {
+      char *fields[CORE_INFO_CACHE_STRINGS];
+      core_info_t *info                   = &infos[i];
+      struct core_info_cache_record *rec  = &records[rec_count];
+
+      if (!info->has_info || !info_paths[i] || mtimes[i] < 0)
+         continue;
+
+      core_info_string_fields(info, fields);
+
+      rec->mtime            = mtimes[i];
+      rec->size             = sizes[i];
+      rec->info_path        = core_info_cache_add_string(&writer, info_paths[i]);
+      for (j = 0; j < CORE_INFO_CACHE_STRINGS; j++)
+         rec->strings[j]    = core_info_cache_add_string(&writer, fields[j]);
+      rec->supports_no_game = info->supports_no_game;
+      rec->firmware_first   = (uint32_t)fw_count;
+      rec->firmware_count   = (uint32_t)info->firmware_count;
+
+      if (!info->firmware)
+         rec->firmware_count = 0;
+
+      for (j = 0; j < rec->firmware_count; j++, fw_count++)
+      {
+         fw[fw_count].path     = core_info_cache_add_string(&writer,
+               info->firmware[j].path);
+         fw[fw_count].desc     = core_info_cache_add_string(&writer,
+               info->firmware[j].desc);
+         fw[fw_count].optional = info->firmware[j].optional;
+      }
+
+      rec_count++;
+   }
+
+   if (!writer.strings)
+      goto end;
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, "RACINFO", 8);
+   header.version        = CORE_INFO_CACHE_VERSION;
+   header.record_size    = sizeof(*records);
+   header.count          = rec_count;
+   header.firmware_count = (uint32_t)fw_count;
+   header.strings_size   = (uint32_t)writer.strings_size;
+
+   data_size = sizeof(header)
+      + rec_count * sizeof(*records)
+      + fw_count  * sizeof(*fw)
+      + writer.strings_size;
+   data      = (uint8_t*)malloc(data_size);
+
+   if (!data)
+      goto end;
+
+   memcpy(data, &header, sizeof(header));
+   memcpy(data + sizeof(header), records, rec_count * sizeof(*records));
+   memcpy(data + sizeof(header) + rec_count * sizeof(*records),
+         fw, fw_count * sizeof(*fw));
+   memcpy(data + data_size - writer.strings_size,
+         writer.strings, writer.strings_size);
+
+   if (!filestream_write_file(path, data, data_size))
+      RARCH_WARN("[Core info]: Could not write cache to \"%s\".\n", path);
+
+end:
+   free(data);
+   free(writer.strings);
+   free(records);
+   free(fw);
 }
 
 static void core_info_list_free(core_info_list_t *core_info_list)
@@ -167,16 +856,20 @@ static void core_info_list_free(core_info_list_t *core_info_list)
       string_list_free(info->licenses_list);
       string_list_free(info->categories_list);
       string_list_free(info->databases_list);
-      config_file_free((config_file_t*)info->config_data);
 
-      for (j = 0; j < info->firmware_count; j++)
+      if (info->firmware)
       {
-         free(info->firmware[j].path);
-         free(info->firmware[j].desc);
+         for (j = 0; j < info->firmware_count; j++)
+         {
+            free(info->firmware[j].path);
+            free(info->firmware[j].desc);
+         }
       }
       free(info->firmware);
    }
 
+   core_info_map_free(core_info_list->ext_map);
+   core_info_map_free(core_info_list->database_map);
    free(core_info_list->all_ext);
    free(core_info_list->list);
    free(core_info_list);
@@ -229,6 +922,14 @@ error:
 static core_info_list_t *core_info_list_new(const char *path)
 {
    size_t i;
+   struct core_info_cache cache;
+   char cache_path[PATH_MAX_LENGTH];
+   size_t cached                    = 0;
+   size_t cacheable                 = 0;
+   bool have_cache                  = false;
+   char **info_paths                = NULL;
+   int32_t *sizes                   = NULL;
+   int64_t *mtimes                  = NULL;
    core_info_t *core_info           = NULL;
    core_info_list_t *core_info_list = NULL;
    struct string_list *contents     = dir_list_new_special(
@@ -241,155 +942,52 @@ static core_info_list_t *core_info_list_new(const char *path)
    if (!core_info_list)
       goto error;
 
-   core_info = (core_info_t*)calloc(contents->size, sizeof(*core_info));
-   if (!core_info)
+   core_info  = (core_info_t*)calloc(contents->size, sizeof(*core_info));
+   info_paths = (char**)calloc(contents->size + 1, sizeof(*info_paths));
+   sizes      = (int32_t*)calloc(contents->size + 1, sizeof(*sizes));
+   mtimes     = (int64_t*)calloc(contents->size + 1, sizeof(*mtimes));
+   if (!core_info || !info_paths || !sizes || !mtimes)
       goto error;
 
    core_info_list->list  = core_info;
    core_info_list->count = contents->size;
 
+   cache_path[0] = '\0';
+   fill_pathname_cache(cache_path, sizeof(cache_path),
+         FILE_PATH_CORE_INFO_CACHE);
+   have_cache    = !string_is_empty(cache_path)
+      && core_info_cache_open(&cache, cache_path);
+
    for (i = 0; i < contents->size; i++)
    {
       size_t info_path_size = PATH_MAX_LENGTH * sizeof(char);
       char *info_path       = (char*)malloc(PATH_MAX_LENGTH * sizeof(char));
 
       info_path[0]          = '\0';
+      mtimes[i]             = -1;
 
-      if ( 
-            core_info_list_iterate(info_path, info_path_size,
-            contents, i) 
-            && path_is_valid(info_path))
+      if (core_info_list_iterate(info_path, info_path_size,
+               contents, i))
+         mtimes[i]          = path_get_modified_time(info_path, &sizes[i]);
+
+      if (mtimes[i] >= 0 && have_cache
+            && core_info_cache_load(&cache, &core_info[i],
+               info_path, sizes[i], mtimes[i]))
+      {
+         info_paths[i] = info_path;
+         cached++;
+      }
+      else if (!string_is_empty(info_path) && path_is_valid(info_path))
       {
-         char *tmp           = NULL;
-         bool tmp_bool       = false;
-         unsigned count      = 0;
          config_file_t *conf = config_file_new(info_path);
 
-         free(info_path);
-
-         if (!conf)
-            continue;
-
-         if (config_get_string(conf, "display_name", &tmp) 
-               && !string_is_empty(tmp))
-         {
-            core_info[i].display_name = strdup(tmp);
-            free(tmp);
-            tmp = NULL;
-         }
-         if (config_get_string(conf, "corename", &tmp) 
-               && !string_is_empty(tmp))
-         {
-            core_info[i].core_name = strdup(tmp);
-            free(tmp);
-            tmp = NULL;
-         }
-
-         if (config_get_string(conf, "systemname", &tmp) 
-               && !string_is_empty(tmp))
-         {
-            core_info[i].systemname = strdup(tmp);
-            free(tmp);
-            tmp = NULL;
-         }
-
-         if (config_get_string(conf, "manufacturer", &tmp) 
-               && !string_is_empty(tmp))
-         {
-            core_info[i].system_manufacturer = strdup(tmp);
-            free(tmp);
-            tmp = NULL;
-         }
-
-         config_get_uint(conf, "firmware_count", &count);
-
-         core_info[i].firmware_count = count;
-
-         if (config_get_string(conf, "supported_extensions", &tmp) 
-               && !string_is_empty(tmp))
-         {
-            core_info[i].supported_extensions      = strdup(tmp);
-            core_info[i].supported_extensions_list =
-               string_split(core_info[i].supported_extensions, "|");
-
-            free(tmp);
-            tmp = NULL;
-         }
-
-         if (config_get_string(conf, "authors", &tmp) 
-               && !string_is_empty(tmp))
-         {
-            core_info[i].authors      = strdup(tmp);
-            core_info[i].authors_list =
-               string_split(core_info[i].authors, "|");
-
-            free(tmp);
-            tmp = NULL;
-         }
-
-         if (config_get_string(conf, "permissions", &tmp) 
-               && !string_is_empty(tmp))
-         {
-            core_info[i].permissions      = strdup(tmp);
-            core_info[i].permissions_list =
-               string_split(core_info[i].permissions, "|");
-
-            free(tmp);
-            tmp = NULL;
-         }
-
-         if (config_get_string(conf, "license", &tmp) 
-               && !string_is_empty(tmp))
-         {
-            core_info[i].licenses      = strdup(tmp);
-            core_info[i].licenses_list =
-               string_split(core_info[i].licenses, "|");
-
-            free(tmp);
-            tmp = NULL;
-         }
-
-         if (config_get_string(conf, "categories", &tmp) 
-               && !string_is_empty(tmp))
+         if (conf)
          {
-            core_info[i].categories      = strdup(tmp);
-            core_info[i].categories_list =
-               string_split(core_info[i].categories, "|");
-
-            free(tmp);
-            tmp = NULL;
+            core_info_parse_config_file(&core_info[i], conf);
+            config_file_free(conf);
          }
 
-         if (config_get_string(conf, "database", &tmp) 
-               && !string_is_empty(tmp))
-         {
-            core_info[i].databases      = strdup(tmp);
-            core_info[i].databases_list =
-               string_split(core_info[i].databases, "|");
-
-            free(tmp);
-            tmp = NULL;
-         }
-
-         if (config_get_string(conf, "notes", &tmp) 
-               && !string_is_empty(tmp))
-         {
-            core_info[i].notes     = strdup(tmp);
-            core_info[i].note_list = string_split(core_info[i].notes, "|");
-
-            free(tmp);
-            tmp = NULL;
-         }
-
-         if (tmp)
-            free(tmp);
-         tmp    = NULL;
-
-         if (config_get_bool(conf, "supports_no_game",
-               &tmp_bool))
-            core_info[i].supports_no_game = tmp_bool;
-
-         core_info[i].config_data = conf;
+         info_paths[i] = info_path;
       }
       else
          free(info_path);
@@ -400,20 +998,49 @@ static core_info_list_t *core_info_list_new(const char *path)
       if (!core_info[i].display_name)
          core_info[i].display_name =
             strdup(path_basename(core_info[i].path));
-   }
 
-   if (core_info_list)
-   {
-      core_info_list_resolve_all_extensions(core_info_list);
-      core_info_list_resolve_all_firmware(core_info_list);
+      /* Same test as core_info_cache_write. */
+      if (core_info[i].has_info && info_paths[i] && mtimes[i] >= 0)
+         cacheable++;
    }
 
+   /* Rewrite the cache when a core was added, removed
+    * or updated. Info files without a modification time
+    * are never cached, so they do not force a rewrite. */
+   if (     !string_is_empty(cache_path) && cacheable > 0
+         && (!have_cache || cached != cache.header->count
+            || cached != cacheable))
+      core_info_cache_write(cache_path, core_info, info_paths,
+            sizes, mtimes, contents->size);
+
+   RARCH_LOG("[Core info]: %u cores, %u info files from cache.\n",
+         (unsigned)contents->size, (unsigned)cached);
+
+   if (have_cache)
+      core_info_cache_close(&cache);
+
+   core_info_list_resolve_all_extensions(core_info_list);
+   core_info_list_build_maps(core_info_list);
+
+   for (i = 0; i < contents->size; i++)
+      free(info_paths[i]);
+   free(info_paths);
+   free(sizes);
+   free(mtimes);
    dir_list_free(contents);
    return core_info_list;
 
 error:
+   if (info_paths)
+      for (i = 0; i < contents->size; i++)
+         free(info_paths[i]);
+   free(info_paths);
+   free(sizes);
+   free(mtimes);
    if (contents)
       dir_list_free(contents);
+   if (core_info_list && !core_info_list->list)
+      free(core_info);
    core_info_list_free(core_info_list);
    return NULL;
 }
@@ -814,11 +1441,7 @@ size_t core_info_list_num_info_files(core_info_list_t *core_info_list)
       return 0;
 
    for (i = 0; i < core_info_list->count; i++)
-   {
-      config_file_t *conf = (config_file_t*)
-         core_info_list->list[i].config_data;
-      num += !!conf;
-   }
+      num += core_info_list->list[i].has_info;
 
    return num;
 }
@@ -827,6 +1450,7 @@ bool core_info_database_supports_content_path(const char *database_path, const c
 {
    char *database           = NULL;
    const char *new_path     = path_basename(database_path);
+   bool ret                 = false;
 
    if (string_is_empty(new_path))
       return false;
@@ -834,34 +1458,38 @@ bool core_info_database_supports_content_path(const char *database_path, const c
    database                 = strdup(new_path);
 
    if (string_is_empty(database))
-      goto error;
+      goto end;
 
    path_remove_extension(database);
 
    if (core_info_curr_list)
    {
-      size_t i;
-
-      for (i = 0; i < core_info_curr_list->count; i++)
+      const struct core_info_map_bucket *ext = core_info_map_find(
+            core_info_curr_list->ext_map, path_get_extension(path));
+      const struct core_info_map_bucket *db  = core_info_map_find(
+            core_info_curr_list->database_map, database);
+      unsigned i = 0;
+      unsigned j = 0;
+
+      /* Is there a core in both sorted id lists? */
+      while (ext && db && i < ext->count && j < db->count)
       {
-         const core_info_t *info = &core_info_curr_list->list[i];
-
-         if (!string_list_find_elem(info->supported_extensions_list,
-                  path_get_extension(path)))
-            continue;
-
-         if (!string_list_find_elem(info->databases_list, database))
-            continue;
+         if (ext->ids[i] == db->ids[j])
+         {
+            ret = true;
+            break;
+         }
 
-         free(database);
-         return true;
+         if (ext->ids[i] < db->ids[j])
+            i++;
+         else
+            j++;
       }
    }
 
-error:
-   if (database)
-      free(database);
-   return false;
+end:
+   free(database);
+   return ret;
 }
 
 bool core_info_list_get_display_name(core_info_list_t *core_info_list,
@@ -38,9 +38,10 @@ typedef struct
 typedef struct
 {
    bool supports_no_game;
+   /* The .info file of the core was found. */
+   bool has_info;
    size_t firmware_count;
    char *path;
-   void *config_data;
    char *display_name;
    char *core_name;
    char *system_manufacturer;
@@ -63,11 +64,17 @@ typedef struct
    void *userdata;
 } core_info_t;
 
+struct core_info_map;
+
 typedef struct
 {
    core_info_t *list;
    size_t count;
    char *all_ext;
+   /* Extension and database name to the cores that
+    * handle them, see core_info_database_supports_content_path. */
+   struct core_info_map *ext_map;
+   struct core_info_map *database_map;
 } core_info_list_t;
 
 typedef struct core_info_ctx_firmware
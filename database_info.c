@@ -206,19 +206,24 @@ char *bin_to_hex_alloc(const uint8_t *data, size_t len)
 }
 
 
-static int database_cursor_iterate(libretrodb_cursor_t *cur,
+struct database_info_index
+{
+   libretrodb_t *db;
+   libretrodb_hash_index_t *crc;
+   libretrodb_hash_index_t *serial;
+   bool crc_failed;
+   bool serial_failed;
+};
+
+static int database_info_parse_item(struct rmsgpack_dom_value *item,
       database_info_t *db_info)
 {
    unsigned i;
-   struct rmsgpack_dom_value item;
    const char* str                = NULL;
 
-   if (libretrodb_cursor_read_item(cur, &item) != 0)
-      return -1;
-
-   if (item.type != RDT_MAP)
+   if (item->type != RDT_MAP)
    {
-      rmsgpack_dom_value_free(&item);
+      rmsgpack_dom_value_free(item);
       return 1;
    }
 
@@ -226,11 +231,11 @@ static int database_cursor_iterate(libretrodb_cursor_t *cur,
    db_info->rumble_supported       = -1;
    db_info->coop_supported         = -1;
 
-   for (i = 0; i < item.val.map.len; i++)
+   for (i = 0; i < item->val.map.len; i++)
    {
       uint32_t                 value = 0;
-      struct rmsgpack_dom_value *key = &item.val.map.items[i].key;
-      struct rmsgpack_dom_value *val = &item.val.map.items[i].value;
+      struct rmsgpack_dom_value *key = &item->val.map.items[i].key;
+      struct rmsgpack_dom_value *val = &item->val.map.items[i].value;
       const char *val_string         = NULL;
 
       if (!key || !val)
@@ -354,11 +359,22 @@ static int database_cursor_iterate(libretrodb_cursor_t *cur,
       }
    }
 
-   rmsgpack_dom_value_free(&item);
+   rmsgpack_dom_value_free(item);
 
    return 0;
 }
 
+static int database_cursor_iterate(libretrodb_cursor_t *cur,
+      database_info_t *db_info)
+{
+   struct rmsgpack_dom_value item;
+
+   if (libretrodb_cursor_read_item(cur, &item) != 0)
+      return -1;
+
+   return database_info_parse_item(&item, db_info);
+}
+
 static int database_cursor_open(libretrodb_t *db,
       libretrodb_cursor_t *cur, const char *path, const char *query)
 {
@@ -612,3 +628,124 @@ void database_info_list_free(database_info_list_t *database_info_list)
 
    free(database_info_list->list);
 }
+
+database_info_index_t *database_info_index_new(const char *rdb_path)
+{
+   database_info_index_t *idx = (database_info_index_t*)
+      calloc(1, sizeof(*idx));
+
+   if (!idx)
+      return NULL;
+
+   idx->db = libretrodb_new();
+
+   if (!idx->db)
+      goto error;
+
+   if (libretrodb_open(rdb_path, idx->db) != 0)
+   {
+      libretrodb_free(idx->db);
+      idx->db = NULL;
+      goto error;
+   }
+
+   return idx;
+
+error:
+   free(idx);
+   return NULL;
+}
+
+void database_info_index_free(database_info_index_t *idx)
+{
+   if (!idx)
+      return;
+
+   libretrodb_hash_index_free(idx->crc);
+   libretrodb_hash_index_free(idx->serial);
+
+   if (idx->db)
+   {
+      libretrodb_close(idx->db);
+      libretrodb_free(idx->db);
+   }
+
+   free(idx);
+}
+
+static database_info_list_t *database_info_index_find(
+      database_info_index_t *idx, libretrodb_hash_index_t *hash_idx,
+      const void *key, size_t len)
+{
+   struct rmsgpack_dom_value item;
+   database_info_list_t *list = NULL;
+   database_info_t *db_info   = NULL;
+
+   if (libretrodb_hash_index_find(idx->db, hash_idx, key, len, &item) != 0)
+      return NULL;
+
+   list    = (database_info_list_t*)malloc(sizeof(*list));
+   db_info = (database_info_t*)calloc(1, sizeof(*db_info));
+
+   if (!list || !db_info)
+   {
+      rmsgpack_dom_value_free(&item);
+      goto error;
+   }
+
+   /* Frees the item in either case. */
+   if (database_info_parse_item(&item, db_info) != 0)
+      goto error;
+
+   list->list  = db_info;
+   list->count = 1;
+
+   return list;
+
+error:
+   free(db_info);
+   free(list);
+   return NULL;
+}
+
+database_info_list_t *database_info_index_find_crc(
+      database_info_index_t *idx, uint32_t crc)
+{
+   uint32_t key;
+
+   if (!idx || !crc)
+      return NULL;
+
+   if (!idx->crc && !idx->crc_failed)
+   {
+      idx->crc        = libretrodb_hash_index_new(idx->db, "crc");
+      idx->crc_failed = !idx->crc;
+   }
+
+   if (!idx->crc)
+      return NULL;
+
+   /* CRCs are stored as big-endian binary blobs. */
+   key = swap_if_little32(crc);
+
+   return database_info_index_find(idx, idx->crc, &key, sizeof(key));
+}
+
+database_info_list_t *database_info_index_find_serial(
+      database_info_index_t *idx, const char *serial)
+{
+   if (!idx || string_is_empty(serial))
+      return NULL;
+
+   if (!idx->serial && !idx->serial_failed)
+   {
+      idx->serial        = libretrodb_hash_index_new(idx->db, "serial");
+      idx->serial_failed = !idx->serial;
+   }
+
+   if (!idx->serial)
+      return NULL;
+
+   return database_info_index_find(idx, idx->serial,
+         serial, strlen(serial));
+}
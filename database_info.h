@@ -120,11 +120,35 @@ typedef struct
    database_info_t *list;
 } database_info_list_t;
 
+typedef struct database_info_index database_info_index_t;
+
 database_info_list_t *database_info_list_new(const char *rdb_path,
       const char *query);
 
 void database_info_list_free(database_info_list_t *list);
 
+/**
+ * database_info_index_new:
+ * @rdb_path            : Path to the database.
+ *
+ * Opens a database for repeated lookups. The CRC and serial
+ * hash indexes are built on first use, so each lookup after
+ * that is a single probe instead of a full database scan.
+ *
+ * Returns: handle, or NULL if the database could not be opened.
+ **/
+database_info_index_t *database_info_index_new(const char *rdb_path);
+
+void database_info_index_free(database_info_index_t *idx);
+
+/* Both return a list holding the first matching entry,
+ * or NULL if there is none. */
+database_info_list_t *database_info_index_find_crc(
+      database_info_index_t *idx, uint32_t crc);
+
+database_info_list_t *database_info_index_find_serial(
+      database_info_index_t *idx, const char *serial);
+
 database_info_handle_t *database_info_dir_init(const char *dir,
       enum database_type type, retro_task_t *task);
 
@@ -386,3 +386,10 @@ bool glslang::compile_spirv(const string &source, Stage stage, std::vector<uint3
    return true;
 }
 
+string glslang::compiler_version()
+{
+   string spirv;
+
+   GetSpirvVersion(spirv);
+   return string(GetGlslVersionString()) + ", SPIR-V " + spirv;
+}
@@ -18,6 +18,9 @@ namespace glslang
     };
 
     bool compile_spirv(const std::string &source, Stage stage, std::vector<uint32_t> *spirv);
+
+    /* Identifies the compiler and the SPIR-V it emits. */
+    std::string compiler_version();
 }
 
 #endif
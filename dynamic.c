@@ -927,6 +927,11 @@ static void core_performance_counter_stop(struct retro_perf_counter *perf)
       perf->total += cpu_features_get_perf_counter() - perf->start;
 }
 
+static uint64_t core_get_cpu_features(void)
+{
+   return cpu_features_get() & ~CPU_FEATURE_PRIVATE_MASK;
+}
+
 /**
  * rarch_environment_cb:
  * @cmd                          : Identifier of command.
@@ -1389,7 +1394,7 @@ bool rarch_environment_cb(unsigned cmd, void *data)
 
          RARCH_LOG("Environ GET_PERF_INTERFACE.\n");
          cb->get_time_usec    = cpu_features_get_time_usec;
-         cb->get_cpu_features = cpu_features_get;
+         cb->get_cpu_features = core_get_cpu_features;
          cb->get_perf_counter = cpu_features_get_perf_counter;
 
          cb->perf_register    = performance_counter_register; 
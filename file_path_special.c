@@ -211,6 +211,39 @@ bool fill_pathname_application_data(char *s, size_t len)
    return false;
 }
 
+/**
+ * fill_pathname_cache:
+ * @s                  : output path
+ * @len                : size of output path
+ * @name               : cache file or directory
+ *
+ * Gets the path of a cache that is rebuilt when missing. It goes
+ * to the cache directory, or next to the config file if there is
+ * none, since the directories the cached data comes from are
+ * often read-only.
+ *
+ * Returns: true if there is a place for it, otherwise false.
+ **/
+bool fill_pathname_cache(char *s, size_t len, enum file_path_enum name)
+{
+   char dir[PATH_MAX_LENGTH];
+   settings_t *settings = config_get_ptr();
+
+   dir[0] = '\0';
+   *s     = '\0';
+
+   if (settings && !string_is_empty(settings->paths.directory_cache))
+      strlcpy(dir, settings->paths.directory_cache, sizeof(dir));
+   else if (!path_is_empty(RARCH_PATH_CONFIG))
+      fill_pathname_basedir(dir, path_get(RARCH_PATH_CONFIG), sizeof(dir));
+
+   if (string_is_empty(dir))
+      return false;
+
+   fill_pathname_join(s, dir, file_path_str(name), len);
+   return true;
+}
+
 #if !defined(RARCH_CONSOLE)
 void fill_pathname_application_path(char *s, size_t len)
 {
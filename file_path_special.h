@@ -87,7 +87,11 @@ enum file_path_enum
    FILE_PATH_S3M_EXTENSION,
    FILE_PATH_XM_EXTENSION,
    FILE_PATH_CONFIG_EXTENSION,
-   FILE_PATH_CORE_INFO_EXTENSION
+   FILE_PATH_CORE_INFO_EXTENSION,
+   FILE_PATH_CORE_INFO_CACHE,
+   FILE_PATH_VULKAN_PIPELINE_CACHE,
+   FILE_PATH_SLANG_CACHE_DIR,
+   FILE_PATH_GLSL_CACHE_DIR
 };
 
 enum application_special_type
@@ -138,6 +142,8 @@ const char *file_path_str(enum file_path_enum enum_idx);
 
 bool fill_pathname_application_data(char *s, size_t len);
 
+bool fill_pathname_cache(char *s, size_t len, enum file_path_enum name);
+
 void fill_pathname_application_special(char *s, size_t len, enum application_special_type type);
 
 #endif
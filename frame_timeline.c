@@ -0,0 +1,458 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <compat/strl.h>
+#include <features/features_cpu.h>
+#include <streams/file_stream.h>
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
+#include "frame_timeline.h"
+
+/* Must be a power of two. */
+#define FRAME_TIMELINE_FRAMES       512
+#define FRAME_TIMELINE_MASK         (FRAME_TIMELINE_FRAMES - 1)
+/* The video thread may still be working on the newest frames,
+ * so the graph leaves these out. */
+#define FRAME_TIMELINE_GRAPH_LAG    3
+#define FRAME_TIMELINE_GRAPH_FRAMES 60
+#define FRAME_TIMELINE_SPARK_FRAMES 48
+/* One bar character per this many usec. */
+#define FRAME_TIMELINE_BAR_USEC     500
+#define FRAME_TIMELINE_BAR_MAX      32
+
+struct frame_timeline_entry
+{
+   uint64_t frame;
+   uint64_t video_frame;
+   retro_time_t start;
+   retro_time_t begin[FRAME_TIMELINE_STAGE_LAST];
+   retro_time_t end[FRAME_TIMELINE_STAGE_LAST];
+   retro_time_t busy[FRAME_TIMELINE_STAGE_LAST];
+   retro_time_t current[FRAME_TIMELINE_STAGE_LAST];
+};
+
+struct frame_timeline
+{
+   struct frame_timeline_entry *entries;
+   /* Video frame count -> entry, for the video thread. */
+   unsigned video_map[FRAME_TIMELINE_FRAMES];
+   uint64_t frame;
+#ifdef HAVE_THREADS
+   /* Taken by the video thread and whoever reads its stages. */
+   slock_t *lock;
+#endif
+};
+
+static struct frame_timeline frame_timeline_st;
+
+static const char *frame_timeline_names[FRAME_TIMELINE_STAGE_LAST] = {
+   "input",
+   "core",
+   "filter",
+   "submit",
+   "shader",
+   "swap",
+   "audio"
+};
+
+static void frame_timeline_lock(void)
+{
+#ifdef HAVE_THREADS
+   slock_lock(frame_timeline_st.lock);
+#endif
+}
+
+static void frame_timeline_unlock(void)
+{
+#ifdef HAVE_THREADS
+   slock_unlock(frame_timeline_st.lock);
+#endif
+}
+
+static struct frame_timeline_entry *frame_timeline_get_entry(uint64_t frame)
+{
+   struct frame_timeline_entry *entry =
+      &frame_timeline_st.entries[frame & FRAME_TIMELINE_MASK];
+
+   if (!frame || entry->frame != frame)
+      return NULL;
+   return entry;
+}
+
+static void frame_timeline_stage_begin(struct frame_timeline_entry *entry,
+      enum frame_timeline_stage stage)
+{
+   retro_time_t now = cpu_features_get_time_usec();
+
+   if (!entry->begin[stage])
+      entry->begin[stage] = now;
+   entry->current[stage]  = now;
+}
+
+static void frame_timeline_stage_end(struct frame_timeline_entry *entry,
+      enum frame_timeline_stage stage)
+{
+   retro_time_t now = cpu_features_get_time_usec();
+
+   if (!entry->current[stage])
+      return;
+
+   entry->end[stage]      = now;
+   entry->busy[stage]    += now - entry->current[stage];
+   entry->current[stage]  = 0;
+}
+
+void frame_timeline_deinit(void)
+{
+#ifdef HAVE_THREADS
+   if (frame_timeline_st.lock)
+      slock_free(frame_timeline_st.lock);
+#endif
+   free(frame_timeline_st.entries);
+   memset(&frame_timeline_st, 0, sizeof(frame_timeline_st));
+}
+
+bool frame_timeline_is_active(void)
+{
+   return frame_timeline_st.entries != NULL;
+}
+
+void frame_timeline_frame_begin(bool enable)
+{
+   struct frame_timeline_entry *entry = NULL;
+
+   if (!enable)
+   {
+      if (frame_timeline_st.entries)
+      {
+         frame_timeline_lock();
+         free(frame_timeline_st.entries);
+         frame_timeline_st.entries = NULL;
+         frame_timeline_unlock();
+      }
+      return;
+   }
+
+   if (!frame_timeline_st.entries)
+   {
+#ifdef HAVE_THREADS
+      if (!frame_timeline_st.lock)
+         frame_timeline_st.lock = slock_new();
+      if (!frame_timeline_st.lock)
+         return;
+#endif
+      frame_timeline_lock();
+      frame_timeline_st.entries = (struct frame_timeline_entry*)
+         calloc(FRAME_TIMELINE_FRAMES, sizeof(*frame_timeline_st.entries));
+      frame_timeline_unlock();
+
+      if (!frame_timeline_st.entries)
+         return;
+   }
+
+   frame_timeline_lock();
+   frame_timeline_st.frame++;
+   entry        = &frame_timeline_st.entries[
+      frame_timeline_st.frame & FRAME_TIMELINE_MASK];
+   memset(entry, 0, sizeof(*entry));
+   entry->frame = frame_timeline_st.frame;
+   entry->start = cpu_features_get_time_usec();
+   frame_timeline_unlock();
+}
+
+void frame_timeline_begin(enum frame_timeline_stage stage)
+{
+   struct frame_timeline_entry *entry = NULL;
+
+   if (!frame_timeline_st.entries)
+      return;
+
+   entry = frame_timeline_get_entry(frame_timeline_st.frame);
+   if (entry)
+      frame_timeline_stage_begin(entry, stage);
+}
+
+void frame_timeline_end(enum frame_timeline_stage stage)
+{
+   struct frame_timeline_entry *entry = NULL;
+
+   if (!frame_timeline_st.entries)
+      return;
+
+   entry = frame_timeline_get_entry(frame_timeline_st.frame);
+   if (entry)
+      frame_timeline_stage_end(entry, stage);
+}
+
+void frame_timeline_set_video_frame(uint64_t frame_count)
+{
+   struct frame_timeline_entry *entry = NULL;
+
+   if (!frame_timeline_st.entries)
+      return;
+
+   frame_timeline_lock();
+   entry = frame_timeline_get_entry(frame_timeline_st.frame);
+   if (entry)
+   {
+      entry->video_frame = frame_count;
+      frame_timeline_st.video_map[frame_count & FRAME_TIMELINE_MASK] =
+         (unsigned)(frame_timeline_st.frame & FRAME_TIMELINE_MASK);
+   }
+   frame_timeline_unlock();
+}
+
+static struct frame_timeline_entry *frame_timeline_get_video_entry(
+      uint64_t frame_count)
+{
+   struct frame_timeline_entry *entry = NULL;
+
+   if (!frame_timeline_st.entries)
+      return NULL;
+
+   entry = &frame_timeline_st.entries[
+      frame_timeline_st.video_map[frame_count & FRAME_TIMELINE_MASK]];
+
+   if (!entry->frame || entry->video_frame != frame_count)
+      return NULL;
+   return entry;
+}
+
+void frame_timeline_video_begin(uint64_t frame_count,
+      enum frame_timeline_stage stage)
+{
+   struct frame_timeline_entry *entry = NULL;
+
+#ifdef HAVE_THREADS
+   if (!frame_timeline_st.lock)
+      return;
+#endif
+
+   frame_timeline_lock();
+   entry = frame_timeline_get_video_entry(frame_count);
+   if (entry)
+      frame_timeline_stage_begin(entry, stage);
+   frame_timeline_unlock();
+}
+
+void frame_timeline_video_end(uint64_t frame_count,
+      enum frame_timeline_stage stage)
+{
+   struct frame_timeline_entry *entry = NULL;
+
+#ifdef HAVE_THREADS
+   if (!frame_timeline_st.lock)
+      return;
+#endif
+
+   frame_timeline_lock();
+   entry = frame_timeline_get_video_entry(frame_count);
+   if (entry)
+      frame_timeline_stage_end(entry, stage);
+   frame_timeline_unlock();
+}
+
+static void frame_timeline_bar(char *s, size_t len, retro_time_t usec)
+{
+   size_t i;
+   size_t count = (size_t)(usec / FRAME_TIMELINE_BAR_USEC);
+
+   if (count > FRAME_TIMELINE_BAR_MAX)
+      count = FRAME_TIMELINE_BAR_MAX;
+   if (count >= len)
+      count = len - 1;
+
+   for (i = 0; i < count; i++)
+      s[i] = '#';
+   s[count] = '\0';
+}
+
+bool frame_timeline_get_graph(char *s, size_t len)
+{
+   unsigned i, stage;
+   static const char levels[] = " .:-=+*#";
+   retro_time_t busy[FRAME_TIMELINE_STAGE_LAST];
+   retro_time_t spark[FRAME_TIMELINE_SPARK_FRAMES];
+   char spark_text[FRAME_TIMELINE_SPARK_FRAMES + 1];
+   unsigned frames      = 0;
+   unsigned spark_count = 0;
+   retro_time_t spark_max = 0;
+   size_t pos           = 0;
+
+   if (!frame_timeline_st.entries || !len)
+      return false;
+
+   memset(busy, 0, sizeof(busy));
+
+   frame_timeline_lock();
+
+   for (i = FRAME_TIMELINE_GRAPH_LAG;
+         i < FRAME_TIMELINE_GRAPH_LAG + FRAME_TIMELINE_GRAPH_FRAMES; i++)
+   {
+      struct frame_timeline_entry *entry = NULL;
+
+      if (frame_timeline_st.frame <= i)
+         break;
+
+      entry = frame_timeline_get_entry(frame_timeline_st.frame - i);
+      if (!entry)
+         continue;
+
+      for (stage = 0; stage < FRAME_TIMELINE_STAGE_LAST; stage++)
+         busy[stage] += entry->busy[stage];
+      frames++;
+   }
+
+   /* Time between frame starts, oldest first. */
+   for (i = FRAME_TIMELINE_SPARK_FRAMES; i > 0; i--)
+   {
+      struct frame_timeline_entry *entry = NULL;
+      struct frame_timeline_entry *next  = NULL;
+
+      if (frame_timeline_st.frame <= i)
+         continue;
+
+      entry = frame_timeline_get_entry(frame_timeline_st.frame - i);
+      next  = frame_timeline_get_entry(frame_timeline_st.frame - i + 1);
+      if (!entry || !next)
+         continue;
+
+      spark[spark_count] = next->start - entry->start;
+      if (spark[spark_count] > spark_max)
+         spark_max = spark[spark_count];
+      spark_count++;
+   }
+
+   frame_timeline_unlock();
+
+   if (!frames)
+      return false;
+
+   pos += snprintf(s + pos, len - pos,
+         "Frame timeline, avg ms over %u frames (# = %.1f ms)\n",
+         frames, FRAME_TIMELINE_BAR_USEC / 1000.0);
+
+   for (stage = 0; stage < FRAME_TIMELINE_STAGE_LAST && pos < len; stage++)
+   {
+      char bar[FRAME_TIMELINE_BAR_MAX + 1];
+      retro_time_t avg = busy[stage] / frames;
+
+      frame_timeline_bar(bar, sizeof(bar), avg);
+      pos += snprintf(s + pos, len - pos, "%-6s %6.2f %s\n",
+            frame_timeline_names[stage], avg / 1000.0, bar);
+   }
+
+   if (spark_count && spark_max && pos < len)
+   {
+      for (i = 0; i < spark_count; i++)
+         spark_text[i] = levels[(spark[i] * (sizeof(levels) - 2)) / spark_max];
+      spark_text[spark_count] = '\0';
+
+      snprintf(s + pos, len - pos, "frame  %6.2f [%s] max",
+            spark_max / 1000.0, spark_text);
+   }
+
+   return true;
+}
+
+bool frame_timeline_write_trace(const char *path)
+{
+   unsigned i, stage;
+   bool written = false;
+   RFILE *file  = NULL;
+
+   if (!frame_timeline_st.entries || !path || !*path)
+      return false;
+
+   file = filestream_open(path, RFILE_MODE_WRITE, -1);
+   if (!file)
+      return false;
+
+   /* Emulation stages go on one track, the video driver's on another,
+    * as with a threaded driver that is where they really run. */
+   filestream_printf(file,
+         "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+         "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+         "\"args\":{\"name\":\"emulation\"}},\n"
+         "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,"
+         "\"args\":{\"name\":\"video\"}}");
+
+   frame_timeline_lock();
+
+   for (i = FRAME_TIMELINE_FRAMES; i > 0; i--)
+   {
+      struct frame_timeline_entry *entry = NULL;
+      struct frame_timeline_entry *next  = NULL;
+      retro_time_t frame_end             = 0;
+
+      if (frame_timeline_st.frame < i)
+         continue;
+
+      entry = frame_timeline_get_entry(frame_timeline_st.frame - i + 1);
+      if (!entry)
+         continue;
+
+      next  = frame_timeline_get_entry(frame_timeline_st.frame - i + 2);
+      if (next)
+         frame_end = next->start;
+      else
+         for (stage = 0; stage < FRAME_TIMELINE_STAGE_LAST; stage++)
+            if (entry->end[stage] > frame_end)
+               frame_end = entry->end[stage];
+
+      if (frame_end > entry->start)
+         filestream_printf(file,
+               ",\n{\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"X\","
+               "\"pid\":1,\"tid\":1,\"ts\":" STRING_REP_INT64
+               ",\"dur\":" STRING_REP_INT64 ",\"args\":{\"frame\":"
+               STRING_REP_UINT64 "}}",
+               (int64_t)entry->start, (int64_t)(frame_end - entry->start),
+               (uint64_t)entry->frame);
+
+      for (stage = 0; stage < FRAME_TIMELINE_STAGE_LAST; stage++)
+      {
+         unsigned tid = (stage == FRAME_TIMELINE_SHADER
+               || stage == FRAME_TIMELINE_SWAP) ? 2 : 1;
+
+         if (!entry->begin[stage] || entry->end[stage] < entry->begin[stage])
+            continue;
+
+         filestream_printf(file,
+               ",\n{\"name\":\"%s\",\"cat\":\"stage\",\"ph\":\"X\","
+               "\"pid\":1,\"tid\":%u,\"ts\":" STRING_REP_INT64
+               ",\"dur\":" STRING_REP_INT64 ",\"args\":{\"frame\":"
+               STRING_REP_UINT64 ",\"busy_us\":" STRING_REP_INT64 "}}",
+               frame_timeline_names[stage], tid,
+               (int64_t)entry->begin[stage],
+               (int64_t)(entry->end[stage] - entry->begin[stage]),
+               (uint64_t)entry->frame, (int64_t)entry->busy[stage]);
+      }
+
+      written = true;
+   }
+
+   frame_timeline_unlock();
+
+   filestream_printf(file, "\n]}\n");
+   filestream_close(file);
+
+   return written;
+}
@@ -0,0 +1,100 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_TIMELINE_H
+#define _FRAME_TIMELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+enum frame_timeline_stage
+{
+   FRAME_TIMELINE_INPUT_POLL = 0,
+   FRAME_TIMELINE_CORE_RUN,
+   FRAME_TIMELINE_FILTER,
+   FRAME_TIMELINE_SUBMIT,
+   /* Recorded by video drivers, possibly on the video thread. */
+   FRAME_TIMELINE_SHADER,
+   FRAME_TIMELINE_SWAP,
+   FRAME_TIMELINE_AUDIO_FLUSH,
+   FRAME_TIMELINE_STAGE_LAST
+};
+
+/**
+ * frame_timeline_frame_begin:
+ * @enable               : keep recording. Turning it off frees
+ *                         the recorded frames.
+ *
+ * Starts a new frame in the timeline. Called once per
+ * iteration of the runloop, before anything is timed.
+ **/
+void frame_timeline_frame_begin(bool enable);
+
+void frame_timeline_deinit(void);
+
+bool frame_timeline_is_active(void);
+
+/* Times a stage of the frame started by frame_timeline_frame_begin.
+ * Stages entered more than once per frame are accumulated. */
+void frame_timeline_begin(enum frame_timeline_stage stage);
+
+void frame_timeline_end(enum frame_timeline_stage stage);
+
+/**
+ * frame_timeline_set_video_frame:
+ * @frame_count          : frame count the current frame is
+ *                         handed to the video driver with.
+ *
+ * Lets frame_timeline_video_begin/end find the frame again
+ * from the video thread.
+ **/
+void frame_timeline_set_video_frame(uint64_t frame_count);
+
+void frame_timeline_video_begin(uint64_t frame_count,
+      enum frame_timeline_stage stage);
+
+void frame_timeline_video_end(uint64_t frame_count,
+      enum frame_timeline_stage stage);
+
+/**
+ * frame_timeline_get_graph:
+ * @s                    : output text.
+ * @len                  : size of @s.
+ *
+ * Renders the recent frames as a text graph for the OSD.
+ *
+ * Returns: true (1) if there was anything to show.
+ **/
+bool frame_timeline_get_graph(char *s, size_t len);
+
+/**
+ * frame_timeline_write_trace:
+ * @path                 : file to write.
+ *
+ * Exports the recorded frames in Chrome trace event JSON,
+ * viewable in chrome://tracing or Perfetto.
+ *
+ * Returns: true (1) on success.
+ **/
+bool frame_timeline_write_trace(const char *path);
+
+RETRO_END_DECLS
+
+#endif
@@ -43,6 +43,8 @@
 
 #include "../../configuration.h"
 #include "../../dynamic.h"
+#include "../../file_path_special.h"
+#include "../../frame_timeline.h"
 #include "../../record/record_driver.h"
 
 #include "../../retroarch.h"
@@ -403,9 +405,17 @@ static bool gl_shader_init(gl_t *gl, const gfx_ctx_driver_t *ctx_driver,
 
 #ifdef HAVE_GLSL
       case RARCH_SHADER_GLSL:
-         gl_glsl_set_get_proc_address(ctx_driver->get_proc_address);
-         gl_glsl_set_context_type(gl->core_context_in_use,
-               hwr->version_major, hwr->version_minor);
+         {
+            char cache_dir[PATH_MAX_LENGTH];
+
+            fill_pathname_cache(cache_dir, sizeof(cache_dir),
+                  FILE_PATH_GLSL_CACHE_DIR);
+
+            gl_glsl_set_get_proc_address(ctx_driver->get_proc_address);
+            gl_glsl_set_context_type(gl->core_context_in_use,
+                  hwr->version_major, hwr->version_minor);
+            gl_glsl_set_cache_dir(cache_dir);
+         }
          break;
 #endif
 
@@ -1107,6 +1117,8 @@ static bool gl_frame(void *data, const void *frame,
       set_texture_coords(feedback_info.coord, xamt, yamt);
    }
 
+   frame_timeline_video_begin(frame_count, FRAME_TIMELINE_SHADER);
+
    glClear(GL_COLOR_BUFFER_BIT);
 
    params.data          = gl;
@@ -1139,6 +1151,8 @@ static bool gl_frame(void *data, const void *frame,
       gl->renderchain_driver->renderchain_render(gl, video_info,
             frame_count, &gl->tex_info, &feedback_info);
 
+   frame_timeline_video_end(frame_count, FRAME_TIMELINE_SHADER);
+
    /* Set prev textures. */
    if (gl->renderchain_driver->bind_prev_texture)
       gl->renderchain_driver->bind_prev_texture(gl, &gl->tex_info);
@@ -1196,6 +1210,8 @@ static bool gl_frame(void *data, const void *frame,
 #endif
             gl_pbo_async_readback(gl);
 
+   frame_timeline_video_begin(frame_count, FRAME_TIMELINE_SWAP);
+
    /* Disable BFI during fast forward, slow-motion,
     * and pause to prevent flicker. */
    if (
@@ -1219,6 +1235,8 @@ static bool gl_frame(void *data, const void *frame,
                video_info->hard_sync_frames);
    }
 
+   frame_timeline_video_end(frame_count, FRAME_TIMELINE_SWAP);
+
    if (gl->core_context_in_use &&
          gl->renderchain_driver->unbind_vao)
       gl->renderchain_driver->unbind_vao(gl);
@@ -19,6 +19,8 @@
 #include <string.h>
 
 #include <retro_assert.h>
+#include <retro_miscellaneous.h>
+#include <features/features_cpu.h>
 #include <gfx/scaler/scaler.h>
 #include <gfx/video_frame.h>
 #include <retro_assert.h>
@@ -297,6 +299,10 @@ static void *sdl_gfx_init(const video_info_t *video, const input_driver_t **inpu
    vid->scaler.scaler_type      = video->smooth ? SCALER_TYPE_BILINEAR : SCALER_TYPE_POINT;
    vid->scaler.in_fmt           = video->rgb32 ? SCALER_FMT_ARGB8888 : SCALER_FMT_RGB565;
    vid->scaler.out_fmt          = SCALER_FMT_ARGB8888;
+#ifdef HAVE_THREADS
+   /* Frames are scaled to the window on the CPU. */
+   vid->scaler.threads          = MIN(cpu_features_get_core_amount(), 4);
+#endif
 
    vid->menu.scaler             = vid->scaler;
    vid->menu.scaler.scaler_type = SCALER_TYPE_BILINEAR;
@@ -20,6 +20,8 @@
 #include <string.h>
 
 #include <compat/strl.h>
+#include <file/file_path.h>
+#include <streams/file_stream.h>
 #include <gfx/scaler/scaler.h>
 #include <gfx/video_frame.h>
 #include <formats/image.h>
@@ -43,6 +45,7 @@
 
 #include "../../driver.h"
 #include "../../configuration.h"
+#include "../../file_path_special.h"
 #include "../../record/record_driver.h"
 
 #include "../../retroarch.h"
@@ -762,9 +765,14 @@ static bool vulkan_init_default_filter_chain(vk_t *vk)
 static bool vulkan_init_filter_chain_preset(vk_t *vk, const char *shader_path)
 {
    struct vulkan_filter_chain_create_info info;
+   char cache_dir[PATH_MAX_LENGTH];
 
    memset(&info, 0, sizeof(info));
 
+   if (fill_pathname_cache(cache_dir, sizeof(cache_dir),
+            FILE_PATH_SLANG_CACHE_DIR))
+      info.shader_cache_dir   = cache_dir;
+
    info.device                = vk->context->device;
    info.gpu                   = vk->context->gpu;
    info.memory_properties     = &vk->context->memory_properties;
@@ -830,18 +838,105 @@ static void vulkan_init_resources(vk_t *vk)
    vulkan_init_command_buffers(vk);
 }
 
+/* Drivers are supposed to reject cache data from another
+ * GPU or driver version, check the header anyway since
+ * some of them crash on it instead. */
+static bool vulkan_pipeline_cache_is_compatible(vk_t *vk,
+      const uint8_t *data, size_t size)
+{
+   uint32_t header[4];
+   const VkPhysicalDeviceProperties *props = &vk->context->gpu_properties;
+
+   if (size < sizeof(header) + VK_UUID_SIZE)
+      return false;
+
+   memcpy(header, data, sizeof(header));
+
+   return header[0] >= sizeof(header) + VK_UUID_SIZE
+      && header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+      && header[2] == props->vendorID
+      && header[3] == props->deviceID
+      && !memcmp(data + sizeof(header),
+            props->pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+static void vulkan_save_pipeline_cache(vk_t *vk)
+{
+   char path[PATH_MAX_LENGTH];
+   char tmp_path[PATH_MAX_LENGTH];
+   size_t size = 0;
+   void *data  = NULL;
+
+   if (!fill_pathname_cache(path, sizeof(path),
+            FILE_PATH_VULKAN_PIPELINE_CACHE))
+      return;
+
+   if (vkGetPipelineCacheData(vk->context->device,
+            vk->pipelines.cache, &size, NULL) != VK_SUCCESS || !size)
+      return;
+
+   if (!(data = malloc(size)))
+      return;
+
+   strlcpy(tmp_path, path, sizeof(tmp_path));
+   strlcat(tmp_path, ".tmp", sizeof(tmp_path));
+
+   /* Write and rename, other instances may be reading it. */
+   if (vkGetPipelineCacheData(vk->context->device,
+            vk->pipelines.cache, &size, data) == VK_SUCCESS
+         && filestream_write_file(tmp_path, data, size))
+   {
+#ifdef _WIN32
+      path_file_remove(path);
+#endif
+      if (!path_file_rename(tmp_path, path))
+         path_file_remove(tmp_path);
+   }
+
+   free(data);
+}
+
 static void vulkan_init_static_resources(vk_t *vk)
 {
    unsigned i;
+   char path[PATH_MAX_LENGTH];
    uint32_t blank[4 * 4];
+   void *cache_data                  = NULL;
+   ssize_t cache_size                = 0;
    VkCommandPoolCreateInfo pool_info = { 
       VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
    /* Create the pipeline cache. */
    VkPipelineCacheCreateInfo cache   = { 
       VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
 
-   vkCreatePipelineCache(vk->context->device,
-         &cache, NULL, &vk->pipelines.cache);
+   /* Start from the pipelines of the last run, so the stock
+    * and shader pipelines are not compiled again. */
+   if (     fill_pathname_cache(path, sizeof(path),
+               FILE_PATH_VULKAN_PIPELINE_CACHE)
+         && path_is_valid(path)
+         && filestream_read_file(path, &cache_data, &cache_size))
+   {
+      if (vulkan_pipeline_cache_is_compatible(vk,
+               (const uint8_t*)cache_data, cache_size))
+      {
+         cache.initialDataSize = cache_size;
+         cache.pInitialData    = cache_data;
+      }
+      else
+         RARCH_LOG("[Vulkan]: Ignoring pipeline cache of another GPU or driver.\n");
+   }
+
+   if (vkCreatePipelineCache(vk->context->device,
+         &cache, NULL, &vk->pipelines.cache) != VK_SUCCESS
+         && cache.pInitialData)
+   {
+      cache.initialDataSize = 0;
+      cache.pInitialData    = NULL;
+      vkCreatePipelineCache(vk->context->device,
+            &cache, NULL, &vk->pipelines.cache);
+   }
+
+   free(cache_data);
 
    pool_info.queueFamilyIndex = vk->context->graphics_queue_index;
 
@@ -859,6 +954,7 @@ static void vulkan_init_static_resources(vk_t *vk)
 static void vulkan_deinit_static_resources(vk_t *vk)
 {
    unsigned i;
+   vulkan_save_pipeline_cache(vk);
    vkDestroyPipelineCache(vk->context->device,
          vk->pipelines.cache, NULL);
    vulkan_destroy_texture(
@@ -20,6 +20,9 @@
 #include <algorithm>
 
 #include <retro_miscellaneous.h>
+#include <compat/strl.h>
+#include <rhash.h>
+#include <encodings/crc32.h>
 #include <file/file_path.h>
 #include <streams/file_stream.h>
 #include <lists/string_list.h>
@@ -32,6 +35,13 @@
 
 using namespace std;
 
+/* Bump when the compiler options or the cache layout change.
+ * Cache entries are also keyed on the glslang version, so a
+ * different compiler never picks up stale SPIR-V. */
+#define GLSLANG_CACHE_VERSION "slang-spirv-2"
+#define GLSLANG_CACHE_MAGIC   0x43565053 /* 'SPVC' */
+#define SPIRV_MAGIC           0x07230203
+
 bool glslang_read_shader_file(const char *path, vector<string> *output, bool root_file)
 {
    vector<const char *> lines;
@@ -363,11 +373,102 @@ bool glslang_parse_meta(const vector<string> &lines, glslang_meta *meta)
    return true;
 }
 
-bool glslang_compile_shader(const char *shader_path, glslang_output *output)
+static const string &glslang_cache_compiler(void)
+{
+   static const string version = GLSLANG_CACHE_VERSION "\n"
+      + glslang::compiler_version();
+   return version;
+}
+
+/* Also stored in the cache files, so a file from another
+ * compiler is rejected even if it is renamed. */
+static uint32_t glslang_cache_compiler_crc(void)
+{
+   const string &version = glslang_cache_compiler();
+   return encoding_crc32(0, (const uint8_t*)version.data(), version.size());
+}
+
+static void glslang_cache_path(char *s, size_t len, const char *cache_dir,
+      const string &vertex, const string &fragment)
+{
+   char name[64 + 5];
+   string key = glslang_cache_compiler() + "\n" + vertex + '\0' + fragment;
+
+   sha256_hash(name, (const uint8_t*)key.data(), key.size());
+   strlcat(name, ".spv", sizeof(name));
+
+   fill_pathname_join(s, cache_dir, name, len);
+}
+
+/* Cache files hold the magic, the CRC of the compiler version,
+ * the word counts of both stages and the stages themselves, in
+ * native byte order. */
+static bool glslang_cache_load(const char *path, glslang_output *output)
+{
+   const uint32_t *words = NULL;
+   void *buf             = NULL;
+   ssize_t len           = 0;
+   bool ret              = false;
+
+   if (!path_is_valid(path) || !filestream_read_file(path, &buf, &len))
+      return false;
+
+   words = (const uint32_t*)buf;
+
+   if (     len >= 4 * (ssize_t)sizeof(uint32_t)
+         && words[0] == GLSLANG_CACHE_MAGIC
+         && words[1] == glslang_cache_compiler_crc())
+   {
+      size_t vertex_words   = words[2];
+      size_t fragment_words = words[3];
+
+      if ((size_t)len == (4 + vertex_words + fragment_words) * sizeof(uint32_t)
+            && vertex_words && fragment_words
+            && words[4] == SPIRV_MAGIC
+            && words[4 + vertex_words] == SPIRV_MAGIC)
+      {
+         output->vertex.assign(words + 4, words + 4 + vertex_words);
+         output->fragment.assign(words + 4 + vertex_words,
+               words + 4 + vertex_words + fragment_words);
+         ret = true;
+      }
+   }
+
+   free(buf);
+   return ret;
+}
+
+static void glslang_cache_save(const char *path, const char *cache_dir,
+      const glslang_output *output)
+{
+   vector<uint32_t> words;
+
+   if (!path_is_directory(cache_dir) && !path_mkdir(cache_dir))
+      return;
+
+   words.reserve(4 + output->vertex.size() + output->fragment.size());
+   words.push_back(GLSLANG_CACHE_MAGIC);
+   words.push_back(glslang_cache_compiler_crc());
+   words.push_back((uint32_t)output->vertex.size());
+   words.push_back((uint32_t)output->fragment.size());
+   words.insert(end(words), begin(output->vertex), end(output->vertex));
+   words.insert(end(words), begin(output->fragment), end(output->fragment));
+
+   /* A partly written file fails the size check on load. */
+   if (!filestream_write_file(path, words.data(),
+            words.size() * sizeof(uint32_t)))
+      RARCH_WARN("[slang]: Failed to write shader cache \"%s\".\n", path);
+}
+
+bool glslang_compile_shader(const char *shader_path, const char *cache_dir,
+      glslang_output *output)
 {
    vector<string> lines;
+   string vertex_source;
+   string fragment_source;
+   char cache_path[PATH_MAX_LENGTH];
 
-   RARCH_LOG("[slang]: Compiling shader \"%s\".\n", shader_path);
+   cache_path[0] = '\0';
 
    if (!glslang_read_shader_file(shader_path, &lines, true))
       return false;
@@ -375,20 +476,40 @@ bool glslang_compile_shader(const char *shader_path, glslang_output *output)
    if (!glslang_parse_meta(lines, &output->meta))
       return false;
 
-   if (    !glslang::compile_spirv(build_stage_source(lines, "vertex"),
+   vertex_source   = build_stage_source(lines, "vertex");
+   fragment_source = build_stage_source(lines, "fragment");
+
+   if (cache_dir && *cache_dir)
+   {
+      glslang_cache_path(cache_path, sizeof(cache_path), cache_dir,
+            vertex_source, fragment_source);
+
+      if (glslang_cache_load(cache_path, output))
+      {
+         RARCH_LOG("[slang]: Loaded shader \"%s\" from cache.\n", shader_path);
+         return true;
+      }
+   }
+
+   RARCH_LOG("[slang]: Compiling shader \"%s\".\n", shader_path);
+
+   if (    !glslang::compile_spirv(vertex_source,
             glslang::StageVertex, &output->vertex))
    {
       RARCH_ERR("Failed to compile vertex shader stage.\n");
       return false;
    }
 
-   if (    !glslang::compile_spirv(build_stage_source(lines, "fragment"),
+   if (    !glslang::compile_spirv(fragment_source,
             glslang::StageFragment, &output->fragment))
    {
       RARCH_ERR("Failed to compile fragment shader stage.\n");
       return false;
    }
 
+   if (*cache_path)
+      glslang_cache_save(cache_path, cache_dir, output);
+
    return true;
 }
 
@@ -87,7 +87,11 @@ struct glslang_output
    glslang_meta meta;
 };
 
-bool glslang_compile_shader(const char *shader_path, glslang_output *output);
+// Compiles both stages of a slang shader. When cache_dir is set,
+// SPIR-V for the same source (after #include) is loaded from there
+// instead of compiled, and newly compiled shaders are stored there.
+bool glslang_compile_shader(const char *shader_path, const char *cache_dir,
+      glslang_output *output);
 const char *glslang_format_to_string(enum glslang_format fmt);
 
 // Helpers for internal use.
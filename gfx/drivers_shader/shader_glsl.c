@@ -21,6 +21,7 @@
 #include <compat/posix_string.h>
 #include <file/file_path.h>
 #include <retro_assert.h>
+#include <rhash.h>
 #include <streams/file_stream.h>
 #include <string/stdstring.h>
 
@@ -39,6 +40,15 @@
 
 #define PREV_TEXTURES (GFX_MAX_TEXTURES - 1)
 
+#if defined(HAVE_OPENGL) && (!defined(HAVE_OPENGLES) || defined(HAVE_OPENGLES3))
+#define HAVE_GLSL_PROGRAM_BINARY
+#endif
+
+/* Bump when the sources fed to the compiler change,
+ * so that programs of older builds are not reused. */
+#define GLSL_CACHE_VERSION "glsl-binary-1"
+#define GLSL_CACHE_MAGIC   0x42534c47 /* 'GLSB' */
+
 /* Cache the VBO. */
 struct cache_vbo
 {
@@ -146,11 +156,13 @@ typedef struct glsl_shader_data
    struct shader_program_glsl_data prg[GFX_MAX_SHADERS];
    struct video_shader *shader;
    state_tracker_t *state_tracker;
+   bool cache_binaries;
 } glsl_shader_data_t;
 
 static bool glsl_core;
 static unsigned glsl_major;
 static unsigned glsl_minor;
+static char glsl_cache_dir[PATH_MAX_LENGTH];
 
 static bool gl_glsl_add_lut(
       const struct video_shader *shader,
@@ -394,6 +406,147 @@ static bool gl_glsl_link_program(GLuint prog)
    return true;
 }
 
+#ifdef HAVE_GLSL_PROGRAM_BINARY
+static bool gl_glsl_program_binary_supported(void)
+{
+   GLint formats = 0;
+
+   if (string_is_empty(glsl_cache_dir))
+      return false;
+#ifndef HAVE_OPENGLES
+   if (!glGetProgramBinary || !glProgramBinary || !glProgramParameteri)
+      return false;
+#endif
+   if (!gl_check_capability(GL_CAPS_PROGRAM_BINARY))
+      return false;
+
+   /* Drivers may expose the entry points without any format. */
+   glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+   return formats > 0;
+}
+
+/* Binaries are only valid for the driver that made them,
+ * so its strings are part of the key along with everything
+ * gl_glsl_compile_shader() puts in front of the sources. */
+static void gl_glsl_cache_path(glsl_shader_data_t *glsl,
+      const struct shader_program_info *program_info,
+      char *s, size_t len)
+{
+   char name[64 + 5];
+   char header[1024];
+   size_t i;
+   size_t key_len       = 0;
+   uint8_t *key         = NULL;
+   const char *vendor   = (const char*)glGetString(GL_VENDOR);
+   const char *renderer = (const char*)glGetString(GL_RENDERER);
+   const char *version  = (const char*)glGetString(GL_VERSION);
+   const char *parts[4];
+   size_t part_len[4];
+
+   *s = '\0';
+
+   snprintf(header, sizeof(header), "%s\n%s\n%s\n%s\n%d %u.%u\n",
+         GLSL_CACHE_VERSION, vendor ? vendor : "", renderer ? renderer : "",
+         version ? version : "", glsl_core, glsl_major, glsl_minor);
+
+   parts[0] = header;
+   parts[1] = glsl->alias_define;
+   parts[2] = program_info->vertex   ? program_info->vertex   : "";
+   parts[3] = program_info->fragment ? program_info->fragment : "";
+
+   /* Keep the terminators so that parts can't run into each other. */
+   for (i = 0; i < ARRAY_SIZE(parts); i++)
+   {
+      part_len[i] = strlen(parts[i]) + 1;
+      key_len    += part_len[i];
+   }
+
+   if (!(key = (uint8_t*)malloc(key_len)))
+      return;
+
+   for (i = 0, key_len = 0; i < ARRAY_SIZE(parts); i++)
+   {
+      memcpy(key + key_len, parts[i], part_len[i]);
+      key_len += part_len[i];
+   }
+
+   sha256_hash(name, key, key_len);
+   strlcat(name, ".bin", sizeof(name));
+
+   fill_pathname_join(s, glsl_cache_dir, name, len);
+   free(key);
+}
+
+/* Cache files hold the magic, the binary format and
+ * the binary size, followed by the binary itself. */
+static bool gl_glsl_load_program_binary(GLuint prog, const char *path)
+{
+   GLint status      = GL_FALSE;
+   void *buf         = NULL;
+   ssize_t len       = 0;
+   uint32_t *header  = NULL;
+
+   if (!path_is_valid(path) || !filestream_read_file(path, &buf, &len))
+      return false;
+
+   header = (uint32_t*)buf;
+
+   if (     len > 3 * (ssize_t)sizeof(uint32_t)
+         && header[0] == GLSL_CACHE_MAGIC
+         && header[2] == len - 3 * sizeof(uint32_t))
+   {
+      glProgramBinary(prog, header[1], header + 3, header[2]);
+      glGetProgramiv(prog, GL_LINK_STATUS, &status);
+   }
+
+   free(buf);
+
+   /* Rejected after a driver update or for a corrupt file,
+    * it gets replaced once the program is compiled again. */
+   if (status != GL_TRUE)
+   {
+      RARCH_LOG("[GLSL]: Cached program \"%s\" is not usable.\n", path);
+      path_file_remove(path);
+      return false;
+   }
+
+   return true;
+}
+
+static void gl_glsl_save_program_binary(GLuint prog, const char *path)
+{
+   GLenum format    = 0;
+   GLint size       = 0;
+   GLsizei len      = 0;
+   uint32_t *header = NULL;
+
+   glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH, &size);
+   if (size <= 0)
+      return;
+
+   if (!path_is_directory(glsl_cache_dir) && !path_mkdir(glsl_cache_dir))
+      return;
+
+   if (!(header = (uint32_t*)malloc(3 * sizeof(uint32_t) + size)))
+      return;
+
+   glGetProgramBinary(prog, size, &len, &format, header + 3);
+
+   if (len > 0)
+   {
+      header[0] = GLSL_CACHE_MAGIC;
+      header[1] = format;
+      header[2] = len;
+
+      /* A partly written file fails the size check on load. */
+      if (!filestream_write_file(path, header, 3 * sizeof(uint32_t) + len))
+         RARCH_WARN("[GLSL]: Failed to write program cache \"%s\".\n", path);
+   }
+
+   free(header);
+}
+#endif
+
 
 static bool gl_glsl_compile_program(
       void *data,
@@ -401,9 +554,13 @@ static bool gl_glsl_compile_program(
       void *program_data,
       struct shader_program_info *program_info)
 {
+   char cache_path[PATH_MAX_LENGTH];
    glsl_shader_data_t *glsl = (glsl_shader_data_t*)data;
    struct shader_program_glsl_data *program = (struct shader_program_glsl_data*)program_data;
    GLuint prog = glCreateProgram();
+   bool cached = false;
+
+   cache_path[0] = '\0';
 
    if (!program)
       program = &glsl->prg[idx];
@@ -411,7 +568,21 @@ static bool gl_glsl_compile_program(
    if (!prog)
       goto error;
 
-   if (program_info->vertex)
+#ifdef HAVE_GLSL_PROGRAM_BINARY
+   if (glsl->cache_binaries
+         && (program_info->vertex || program_info->fragment))
+   {
+      gl_glsl_cache_path(glsl, program_info, cache_path, sizeof(cache_path));
+
+      if (*cache_path && gl_glsl_load_program_binary(prog, cache_path))
+      {
+         RARCH_LOG("[GLSL]: Loaded program #%u from cache.\n", idx);
+         cached = true;
+      }
+   }
+#endif
+
+   if (program_info->vertex && !cached)
    {
       RARCH_LOG("[GLSL]: Found GLSL vertex shader.\n");
       program->vprg = glCreateShader(GL_VERTEX_SHADER);
@@ -428,7 +599,7 @@ static bool gl_glsl_compile_program(
       glAttachShader(prog, program->vprg);
    }
 
-   if (program_info->fragment)
+   if (program_info->fragment && !cached)
    {
       RARCH_LOG("[GLSL]: Found GLSL fragment shader.\n");
       program->fprg = glCreateShader(GL_FRAGMENT_SHADER);
@@ -442,12 +613,24 @@ static bool gl_glsl_compile_program(
       glAttachShader(prog, program->fprg);
    }
 
-   if (program_info->vertex || program_info->fragment)
+   if ((program_info->vertex || program_info->fragment) && !cached)
    {
       RARCH_LOG("[GLSL]: Linking GLSL program.\n");
+#ifdef HAVE_GLSL_PROGRAM_BINARY
+      if (*cache_path)
+         glProgramParameteri(prog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
       if (!gl_glsl_link_program(prog))
          goto error;
 
+#ifdef HAVE_GLSL_PROGRAM_BINARY
+      if (*cache_path)
+         gl_glsl_save_program_binary(prog, cache_path);
+#endif
+   }
+
+   if (program_info->vertex || program_info->fragment)
+   {
       /* Clean up dead memory. We're not going to relink the program.
        * Detaching first seems to kill some mobile drivers
        * (according to the intertubes anyways). */
@@ -926,6 +1109,10 @@ static void *gl_glsl_init(void *data, const char *path)
       }
    }
 
+#ifdef HAVE_GLSL_PROGRAM_BINARY
+   glsl->cache_binaries = gl_glsl_program_binary_supported();
+#endif
+
    shader_prog_info.vertex   = stock_vertex;
    shader_prog_info.fragment = stock_fragment;
    shader_prog_info.is_file  = false;
@@ -1663,6 +1850,14 @@ void gl_glsl_set_context_type(bool core_profile,
    glsl_minor = minor;
 }
 
+void gl_glsl_set_cache_dir(const char *dir)
+{
+   if (dir)
+      strlcpy(glsl_cache_dir, dir, sizeof(glsl_cache_dir));
+   else
+      *glsl_cache_dir = '\0';
+}
+
 const shader_backend_t gl_glsl_backend = {
    gl_glsl_init,
    gl_glsl_deinit,
@@ -25,4 +25,8 @@ void gl_glsl_set_get_proc_address(gfx_ctx_proc_t (*proc)(const char*));
 
 void gl_glsl_set_context_type(bool core_profile, unsigned major, unsigned minor);
 
+/* Linked programs are cached in this directory when the
+ * driver supports program binaries, NULL or empty disables it. */
+void gl_glsl_set_cache_dir(const char *dir);
+
 #endif
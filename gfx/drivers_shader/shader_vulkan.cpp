@@ -2899,7 +2899,8 @@ vulkan_filter_chain_t *vulkan_filter_chain_create_from_preset(
       pass_info.address       = VULKAN_FILTER_CHAIN_ADDRESS_REPEAT;
       pass_info.max_levels    = 0;
 
-      if (!glslang_compile_shader(pass->source.path, &output))
+      if (!glslang_compile_shader(pass->source.path,
+               info->shader_cache_dir, &output))
       {
          RARCH_ERR("Failed to compile shader: \"%s\".\n",
                pass->source.path);
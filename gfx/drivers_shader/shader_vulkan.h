@@ -98,6 +98,8 @@ struct vulkan_filter_chain_create_info
    VkPhysicalDevice gpu;
    const VkPhysicalDeviceMemoryProperties *memory_properties;
    VkPipelineCache pipeline_cache;
+   /* Where compiled slang passes are cached, can be NULL. */
+   const char *shader_cache_dir;
    VkQueue queue;
    VkCommandPool command_pool;
    unsigned num_passes;
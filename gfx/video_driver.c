@@ -62,6 +62,9 @@
 #include "../input/input_driver.h"
 #include "../list_special.h"
 #include "../core.h"
+#include "../managers/state_manager.h"
+#include "../frame_timeline.h"
+#include "../managers/frame_delay.h"
 #include "../command.h"
 #include "../msg_hash.h"
 #include "../verbosity.h"
@@ -1324,6 +1327,20 @@ bool video_monitor_fps_statistics(double *refresh_rate,
    return true;
 }
 
+bool video_monitor_get_last_frame_time(retro_time_t *frame_time,
+      uint64_t *sample_count)
+{
+   if (!video_driver_frame_time_count)
+      return false;
+
+   *frame_time   = video_driver_frame_time_samples[
+      (video_driver_frame_time_count - 1)
+      & (MEASURE_FRAME_TIME_SAMPLES_COUNT - 1)];
+   *sample_count = video_driver_frame_time_count;
+
+   return true;
+}
+
 
 
 float video_driver_get_aspect_ratio(void)
@@ -2341,6 +2358,26 @@ void video_driver_frame(const void *data, unsigned width,
                   "FPS: %6.1f",
                   last_fps);
          }
+
+         {
+            retro_time_t rewind_time = 0;
+            unsigned rewind_frames   = 0;
+
+            if (state_manager_get_stats(&rewind_time, &rewind_frames))
+            {
+               char rewind_text[64];
+               struct retro_system_av_info *av_info =
+                  video_viewport_get_system_av_info();
+               double fps = av_info->timing.fps > 0.0
+                  ? av_info->timing.fps : 60.0;
+
+               snprintf(rewind_text, sizeof(rewind_text),
+                     " || Rewind: %.2f ms, %.1f s",
+                     rewind_time / 1000.0, rewind_frames / fps);
+               strlcat(video_info.fps_text, rewind_text,
+                     sizeof(video_info.fps_text));
+            }
+         }
       }
    }
    else
@@ -2374,14 +2411,23 @@ void video_driver_frame(const void *data, unsigned width,
       )
       recording_dump_frame(data, width, height, pitch, video_info.runloop_is_idle);
 
-   if (data && video_driver_state_filter &&
-         video_driver_frame_filter(data, &video_info, width, height, pitch,
-            &output_width, &output_height, &output_pitch))
+   if (data && video_driver_state_filter)
    {
-      data   = video_driver_state_buffer;
-      width  = output_width;
-      height = output_height;
-      pitch  = output_pitch;
+      bool filtered;
+
+      frame_timeline_begin(FRAME_TIMELINE_FILTER);
+      filtered = video_driver_frame_filter(data, &video_info,
+            width, height, pitch,
+            &output_width, &output_height, &output_pitch);
+      frame_timeline_end(FRAME_TIMELINE_FILTER);
+
+      if (filtered)
+      {
+         data   = video_driver_state_buffer;
+         width  = output_width;
+         height = output_height;
+         pitch  = output_pitch;
+      }
    }
 
    video_driver_msg[0] = '\0';
@@ -2400,13 +2446,41 @@ void video_driver_frame(const void *data, unsigned width,
 #endif
    }
 
+   frame_timeline_set_video_frame(video_driver_frame_count);
+   frame_timeline_begin(FRAME_TIMELINE_SUBMIT);
+   frame_delay_auto_wait_begin();
+
    video_driver_active = current_video->frame(
          video_driver_data, data, width, height,
          video_driver_frame_count,
          (unsigned)pitch, video_driver_msg, &video_info);
 
+   frame_delay_auto_wait_end();
+   frame_timeline_end(FRAME_TIMELINE_SUBMIT);
+
    video_driver_frame_count++;
 
+   if (video_info.frame_timeline_show)
+   {
+      static char timeline_text[1024];
+      size_t len = 0;
+
+      if (video_info.fps_show)
+      {
+         len = strlcpy(timeline_text, video_info.fps_text,
+               sizeof(timeline_text));
+         if (len < sizeof(timeline_text) - 1)
+            timeline_text[len++] = '\n';
+      }
+
+      if (len < sizeof(timeline_text) - 1 && frame_timeline_get_graph(
+               timeline_text + len, sizeof(timeline_text) - len))
+      {
+         runloop_msg_queue_push(timeline_text, 1, 1, false);
+         return;
+      }
+   }
+
    if (video_info.fps_show)
       runloop_msg_queue_push(video_info.fps_text, 1, 1, false);
 }
@@ -2533,6 +2607,7 @@ void video_driver_build_info(video_frame_info_t *video_info)
    video_info->hard_sync_frames      = settings->uints.video_hard_sync_frames;
    video_info->fps_show              = settings->bools.video_fps_show;
    video_info->framecount_show       = settings->bools.video_framecount_show;
+   video_info->frame_timeline_show   = settings->bools.video_frame_timeline_show;
    video_info->scale_integer         = settings->bools.video_scale_integer;
    video_info->aspect_ratio_idx      = settings->uints.video_aspect_ratio_idx;
    video_info->post_filter_record    = settings->bools.video_post_filter_record;
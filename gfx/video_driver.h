@@ -412,6 +412,7 @@ typedef struct video_frame_info
    bool hard_sync;
    bool fps_show;
    bool framecount_show;
+   bool frame_timeline_show;
    bool scale_integer;
    bool post_filter_record;
    bool windowed_fullscreen;
@@ -1100,6 +1101,16 @@ void video_monitor_set_refresh_rate(float hz);
 bool video_monitor_fps_statistics(double *refresh_rate,
       double *deviation, unsigned *sample_points);
 
+/**
+ * video_monitor_get_last_frame_time:
+ * @frame_time         : Time between the last two video frames, in usec.
+ * @sample_count       : Amount of frame time samples taken so far.
+ *
+ * Returns: true (1) if there is a sample yet, otherwise false (0).
+ **/
+bool video_monitor_get_last_frame_time(retro_time_t *frame_time,
+      uint64_t *sample_count);
+
 unsigned video_pixel_get_alignment(unsigned pitch);
 
 const video_poke_interface_t *video_driver_get_poke(void);
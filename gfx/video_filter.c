@@ -43,45 +43,323 @@ struct rarch_soft_plug
    const struct softfilter_implementation *impl;
 };
 
+/* Work packets requested per thread. A filter cuts the frame
+ * into that many slices, and whichever thread runs out of work
+ * first picks up the next one, so uneven slices even out. */
+#define SOFTFILTER_SLICES_PER_THREAD 4
+#define SOFTFILTER_MAX_PACKETS       1024
+
 #ifdef HAVE_THREADS
+#include <retro_atomic.h>
 #include <rthreads/rthreads.h>
 
-struct filter_thread_data
+/* Times a worker polls for the next frame before going to sleep. */
+#define SOFTFILTER_SPIN_COUNT        4096
+
+/* The claim word packs the frame tag, the packet count and the
+ * next packet to hand out, so that a single fetch-and-add both
+ * claims a packet and tells which frame it belongs to. The index
+ * can overshoot by one per thread without reaching the count. */
+#define SOFTFILTER_INDEX_MASK        0xfff
+#define SOFTFILTER_COUNT_SHIFT       12
+#define SOFTFILTER_TAG_SHIFT         24
+#define SOFTFILTER_TAG_MASK          0x7f
+
+#ifdef HAVE_RETRO_ATOMIC
+typedef retro_atomic_int_t softfilter_counter_t;
+#else
+typedef int softfilter_counter_t;
+#endif
+
+/* Worker threads shared by every softfilter. The thread that
+ * submits a frame works on it as well, so a scheduler for N
+ * threads only starts N - 1 workers. */
+struct softfilter_scheduler
 {
-   sthread_t *thread;
-   const struct softfilter_work_packet *packet;
-   scond_t *cond;
+   sthread_t **workers;
+   unsigned num_workers;
+   unsigned refcount;
+
+   slock_t *submit_lock;
    slock_t *lock;
+   scond_t *cond;
+   scond_t *done_cond;
+#ifndef HAVE_RETRO_ATOMIC
+   slock_t *counter_lock;
+#endif
+
+   /* Frame being processed, only written while no packet
+    * of the previous frame is outstanding. */
    void *userdata;
-   bool die;
-   bool done;
+   const struct softfilter_work_packet *packets;
+   unsigned tag;
+
+   softfilter_counter_t claim;
+   softfilter_counter_t done;
+
+   unsigned parked;
+   bool submitter_parked;
+   bool quit;
 };
 
-static void filter_thread_loop(void *data)
+/* Softfilters are created and freed on the main thread. */
+static struct softfilter_scheduler *softfilter_scheduler_shared = NULL;
+
+static int softfilter_scheduler_load(struct softfilter_scheduler *sched,
+      softfilter_counter_t *counter)
 {
-   struct filter_thread_data *thr = (struct filter_thread_data*)data;
+#ifdef HAVE_RETRO_ATOMIC
+   return (int)retro_atomic_load_acquire(counter);
+#else
+   int val;
+
+   slock_lock(sched->counter_lock);
+   val = *counter;
+   slock_unlock(sched->counter_lock);
+
+   return val;
+#endif
+}
+
+static void softfilter_scheduler_store(struct softfilter_scheduler *sched,
+      softfilter_counter_t *counter, int val)
+{
+#ifdef HAVE_RETRO_ATOMIC
+   retro_atomic_xchg(counter, val);
+#else
+   slock_lock(sched->counter_lock);
+   *counter = val;
+   slock_unlock(sched->counter_lock);
+#endif
+}
+
+static int softfilter_scheduler_fetch_add(
+      struct softfilter_scheduler *sched,
+      softfilter_counter_t *counter, int val)
+{
+#ifdef HAVE_RETRO_ATOMIC
+   return (int)retro_atomic_fetch_add(counter, val);
+#else
+   int old;
+
+   slock_lock(sched->counter_lock);
+   old       = *counter;
+   *counter += val;
+   slock_unlock(sched->counter_lock);
+
+   return old;
+#endif
+}
 
+/* Claims and runs packets of the current frame until none are left. */
+static void softfilter_scheduler_work(struct softfilter_scheduler *sched)
+{
    for (;;)
    {
-      bool die;
-      slock_lock(thr->lock);
-      while (thr->done && !thr->die)
-         scond_wait(thr->cond, thr->lock);
-      die = thr->die;
-      slock_unlock(thr->lock);
-
-      if (die)
+      const struct softfilter_work_packet *packet;
+      int claim      = softfilter_scheduler_fetch_add(sched,
+            &sched->claim, 1);
+      unsigned index = claim & SOFTFILTER_INDEX_MASK;
+      unsigned count = (claim >> SOFTFILTER_COUNT_SHIFT)
+         & SOFTFILTER_INDEX_MASK;
+
+      if (index >= count)
          break;
 
-      if (thr->packet && thr->packet->work)
-         thr->packet->work(thr->userdata, thr->packet->thread_data);
+      packet = &sched->packets[index];
+      if (packet->work)
+         packet->work(sched->userdata, packet->thread_data);
+
+      if ((unsigned)softfilter_scheduler_fetch_add(sched,
+               &sched->done, 1) + 1 == count)
+      {
+         slock_lock(sched->lock);
+         if (sched->submitter_parked)
+            scond_signal(sched->done_cond);
+         slock_unlock(sched->lock);
+      }
+   }
+}
+
+static void softfilter_scheduler_loop(void *data)
+{
+   struct softfilter_scheduler *sched = (struct softfilter_scheduler*)data;
+   int seen = 0;
+
+   for (;;)
+   {
+      unsigned spins;
+      int tag = seen;
+
+      for (spins = 0; spins < SOFTFILTER_SPIN_COUNT && tag == seen; spins++)
+         tag = softfilter_scheduler_load(sched, &sched->claim)
+            >> SOFTFILTER_TAG_SHIFT;
 
-      slock_lock(thr->lock);
-      thr->done = true;
-      scond_signal(thr->cond);
-      slock_unlock(thr->lock);
+      if (tag == seen)
+      {
+         bool quit;
+
+         slock_lock(sched->lock);
+         sched->parked++;
+         while (!sched->quit && (tag = softfilter_scheduler_load(sched,
+                     &sched->claim) >> SOFTFILTER_TAG_SHIFT) == seen)
+            scond_wait(sched->cond, sched->lock);
+         sched->parked--;
+         quit = sched->quit;
+         slock_unlock(sched->lock);
+
+         if (quit)
+            break;
+      }
+
+      seen = tag;
+      softfilter_scheduler_work(sched);
    }
 }
+
+static void softfilter_scheduler_free(struct softfilter_scheduler *sched)
+{
+   unsigned i;
+
+   if (!sched)
+      return;
+
+   if (sched->lock)
+   {
+      slock_lock(sched->lock);
+      sched->quit = true;
+      scond_broadcast(sched->cond);
+      slock_unlock(sched->lock);
+   }
+
+   for (i = 0; i < sched->num_workers; i++)
+      sthread_join(sched->workers[i]);
+   free(sched->workers);
+
+   if (sched->submit_lock)
+      slock_free(sched->submit_lock);
+   if (sched->lock)
+      slock_free(sched->lock);
+   if (sched->cond)
+      scond_free(sched->cond);
+   if (sched->done_cond)
+      scond_free(sched->done_cond);
+#ifndef HAVE_RETRO_ATOMIC
+   if (sched->counter_lock)
+      slock_free(sched->counter_lock);
+#endif
+   free(sched);
+}
+
+static struct softfilter_scheduler *softfilter_scheduler_new(unsigned threads)
+{
+   unsigned i;
+   struct softfilter_scheduler *sched = (struct softfilter_scheduler*)
+      calloc(1, sizeof(*sched));
+
+   if (!sched)
+      return NULL;
+
+   sched->workers     = (sthread_t**)calloc(threads - 1,
+         sizeof(*sched->workers));
+   sched->submit_lock = slock_new();
+   sched->lock        = slock_new();
+   sched->cond        = scond_new();
+   sched->done_cond   = scond_new();
+#ifndef HAVE_RETRO_ATOMIC
+   sched->counter_lock = slock_new();
+   if (!sched->counter_lock)
+      goto error;
+#endif
+
+   if (!sched->workers || !sched->submit_lock || !sched->lock
+         || !sched->cond || !sched->done_cond)
+      goto error;
+
+   for (i = 0; i < threads - 1; i++)
+   {
+      sched->workers[i] = sthread_create(softfilter_scheduler_loop, sched);
+      if (!sched->workers[i])
+         goto error;
+      sched->num_workers++;
+   }
+
+   return sched;
+
+error:
+   softfilter_scheduler_free(sched);
+   return NULL;
+}
+
+/* Returns the shared scheduler, starting it for @threads
+ * threads if no softfilter is using it yet. */
+static struct softfilter_scheduler *softfilter_scheduler_acquire(
+      unsigned threads)
+{
+   if (!softfilter_scheduler_shared)
+   {
+      softfilter_scheduler_shared = softfilter_scheduler_new(threads);
+      if (!softfilter_scheduler_shared)
+         return NULL;
+   }
+
+   softfilter_scheduler_shared->refcount++;
+   return softfilter_scheduler_shared;
+}
+
+static void softfilter_scheduler_release(struct softfilter_scheduler *sched)
+{
+   if (!sched || --sched->refcount)
+      return;
+
+   softfilter_scheduler_free(sched);
+   softfilter_scheduler_shared = NULL;
+}
+
+/* Hands @count packets to the workers, works on them alongside
+ * and returns once all of them are done. */
+static void softfilter_scheduler_run(struct softfilter_scheduler *sched,
+      void *userdata, const struct softfilter_work_packet *packets,
+      unsigned count)
+{
+   unsigned spins;
+
+   slock_lock(sched->submit_lock);
+
+   sched->userdata = userdata;
+   sched->packets  = packets;
+   sched->tag      = (sched->tag + 1) & SOFTFILTER_TAG_MASK;
+   softfilter_scheduler_store(sched, &sched->done, 0);
+
+   slock_lock(sched->lock);
+   softfilter_scheduler_store(sched, &sched->claim,
+         (int)((sched->tag << SOFTFILTER_TAG_SHIFT)
+         | (count << SOFTFILTER_COUNT_SHIFT)));
+   if (sched->parked)
+      scond_broadcast(sched->cond);
+   slock_unlock(sched->lock);
+
+   softfilter_scheduler_work(sched);
+
+   for (spins = 0; spins < SOFTFILTER_SPIN_COUNT; spins++)
+   {
+      if ((unsigned)softfilter_scheduler_load(sched, &sched->done) == count)
+         break;
+   }
+
+   if (spins == SOFTFILTER_SPIN_COUNT)
+   {
+      slock_lock(sched->lock);
+      sched->submitter_parked = true;
+      while ((unsigned)softfilter_scheduler_load(sched,
+               &sched->done) != count)
+         scond_wait(sched->done_cond, sched->lock);
+      sched->submitter_parked = false;
+      slock_unlock(sched->lock);
+   }
+
+   slock_unlock(sched->submit_lock);
+}
 #endif
 
 struct rarch_softfilter
@@ -101,7 +379,7 @@ struct rarch_softfilter
    unsigned threads;
 
 #ifdef HAVE_THREADS
-   struct filter_thread_data *thread_data;
+   struct softfilter_scheduler *scheduler;
 #endif
 };
 
@@ -207,10 +485,18 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
    filt->max_width = max_width;
    filt->max_height = max_height;
 
+   if (threads == RARCH_SOFTFILTER_THREADS_AUTO)
+      threads = cpu_features_get_core_amount();
+#ifndef HAVE_THREADS
+   threads = 1;
+#endif
+
+   /* Filters take the thread count as the number of
+    * slices to cut each frame into. */
    filt->impl_data = filt->impl->create(
          &softfilter_config, input_fmt, input_fmt, max_width, max_height,
-         threads != RARCH_SOFTFILTER_THREADS_AUTO ? threads : 
-         cpu_features_get_core_amount(), cpu_features,
+         threads > 1 ? MIN(threads * SOFTFILTER_SLICES_PER_THREAD,
+            SOFTFILTER_MAX_PACKETS) : 1, cpu_features,
          &userdata);
    if (!filt->impl_data)
    {
@@ -218,18 +504,21 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
       return false;
    }
 
-   threads = filt->impl->query_num_threads(filt->impl_data);
-   if (!threads)
+   filt->threads = filt->impl->query_num_threads(filt->impl_data);
+   if (!filt->threads || filt->threads > SOFTFILTER_MAX_PACKETS)
    {
       RARCH_ERR("Invalid number of threads.\n");
       return false;
    }
 
-   filt->threads = threads;
-   RARCH_LOG("Using %u threads for softfilter.\n", threads);
+   if (filt->threads == 1)
+      threads = 1;
+
+   RARCH_LOG("Using %u threads and %u work packets for softfilter.\n",
+         threads, filt->threads);
 
    filt->packets = (struct softfilter_work_packet*)
-      calloc(threads, sizeof(*filt->packets));
+      calloc(filt->threads, sizeof(*filt->packets));
    if (!filt->packets)
    {
       RARCH_ERR("Failed to allocate softfilter packets.\n");
@@ -237,25 +526,10 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
    }
 
 #ifdef HAVE_THREADS
-   filt->thread_data = (struct filter_thread_data*)
-      calloc(threads, sizeof(*filt->thread_data));
-   if (!filt->thread_data)
-      return false;
-
-   for (i = 0; i < threads; i++)
+   if (threads > 1)
    {
-      filt->thread_data[i].userdata = filt->impl_data;
-      filt->thread_data[i].done = true;
-
-      filt->thread_data[i].lock = slock_new();
-      if (!filt->thread_data[i].lock)
-         return false;
-      filt->thread_data[i].cond = scond_new();
-      if (!filt->thread_data[i].cond)
-         return false;
-      filt->thread_data[i].thread = sthread_create(
-            filter_thread_loop, &filt->thread_data[i]);
-      if (!filt->thread_data[i].thread)
+      filt->scheduler = softfilter_scheduler_acquire(threads);
+      if (!filt->scheduler)
          return false;
    }
 #endif
@@ -472,19 +746,7 @@ void rarch_softfilter_free(rarch_softfilter_t *filt)
 #endif
 
 #ifdef HAVE_THREADS
-   for (i = 0; i < filt->threads; i++)
-   {
-      if (!filt->thread_data[i].thread)
-         continue;
-      slock_lock(filt->thread_data[i].lock);
-      filt->thread_data[i].die = true;
-      scond_signal(filt->thread_data[i].cond);
-      slock_unlock(filt->thread_data[i].lock);
-      sthread_join(filt->thread_data[i].thread);
-      slock_free(filt->thread_data[i].lock);
-      scond_free(filt->thread_data[i].cond);
-   }
-   free(filt->thread_data);
+   softfilter_scheduler_release(filt->scheduler);
 #endif
    free(filt);
 }
@@ -526,33 +788,19 @@ void rarch_softfilter_process(rarch_softfilter_t *filt,
             output, output_stride, input, width, height, input_stride);
    
 #ifdef HAVE_THREADS
-   /* Fire off workers */
-   for (i = 0; i < filt->threads; i++)
+   if (filt->scheduler)
    {
-#if 0
-      RARCH_LOG("Firing off filter thread %u ...\n", i);
-#endif
-      filt->thread_data[i].packet = &filt->packets[i];
-      slock_lock(filt->thread_data[i].lock);
-      filt->thread_data[i].done = false;
-      scond_signal(filt->thread_data[i].cond);
-      slock_unlock(filt->thread_data[i].lock);
+      softfilter_scheduler_run(filt->scheduler, filt->impl_data,
+            filt->packets, filt->threads);
+      return;
    }
+#endif
 
-   /* Wait for workers */
    for (i = 0; i < filt->threads; i++)
    {
-#if 0
-      RARCH_LOG("Waiting for filter thread %u ...\n", i);
-#endif
-      slock_lock(filt->thread_data[i].lock);
-      while (!filt->thread_data[i].done)
-         scond_wait(filt->thread_data[i].cond, filt->thread_data[i].lock);
-      slock_unlock(filt->thread_data[i].lock);
+      if (filt->packets[i].work)
+         filt->packets[i].work(filt->impl_data,
+               filt->packets[i].thread_data);
    }
-#else
-   for (i = 0; i < filt->threads; i++)
-      filt->packets[i].work(filt->impl_data, filt->packets[i].thread_data);
-#endif
 }
 
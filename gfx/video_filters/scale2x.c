@@ -50,7 +50,7 @@ struct filter_data
 #define SCALE2X_GENERIC(typename_t, width, height, first, last, src, src_stride, dst, dst_stride, out0, out1) \
    for (y = 0; y < height; ++y) \
    { \
-      const int prevline = ((y == 0) && first) ? 0 : src_stride; \
+      const int prevline = ((y == 0) && !first) ? 0 : src_stride; \
       const int nextline = ((y == height - 1) && last) ? 0 : src_stride; \
       \
       for (x = 0; x < width; ++x) \
@@ -137,7 +137,7 @@ static void *scale2x_generic_create(const struct softfilter_config *config,
       return NULL;
    filt->workers = (struct softfilter_thread_data*)
       calloc(threads, sizeof(struct softfilter_thread_data));
-   filt->threads = 1;
+   filt->threads = threads;
    filt->in_fmt  = in_fmt;
    if (!filt->workers)
    {
@@ -128,7 +128,11 @@ struct softfilter_work_packet
  * maximum possible input size.
  *
  * Input sizes can very per call to softfilter_process_t, but they 
- * will never be larger than the maximum. */
+ * will never be larger than the maximum.
+ *
+ * threads is the number of work packets the frame may be cut into.
+ * The host can ask for more packets than it has threads and hand
+ * them out as threads become free. */
 typedef void *(*softfilter_create_t)(const struct softfilter_config *config,
       unsigned in_fmt, unsigned out_fmt,
       unsigned max_width, unsigned max_height,
@@ -148,6 +152,8 @@ typedef void (*softfilter_query_output_size_t)(void *data,
  *
  * The number of elements in the array is as returned by query_num_threads.
  * The processing itself happens in worker threads after this returns.
+ * Packets can run in any order and on any thread, so they must not
+ * depend on each other or on state changed by another packet.
  */
 typedef void (*softfilter_get_work_packets_t)(void *data,
       struct softfilter_work_packet *packets,
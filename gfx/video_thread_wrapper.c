@@ -22,6 +22,7 @@
 #include <features/features_cpu.h>
 #include <rthreads/rthreads.h>
 #include <string/stdstring.h>
+#include <retro_atomic.h>
 
 #include "video_thread_wrapper.h"
 #include "font_driver.h"
@@ -147,6 +148,26 @@ struct thread_packet
    } data;
 };
 
+/* Frames are triple buffered. The emulator thread owns one slot,
+ * the video thread owns another, and the third is handed between
+ * them by swapping 'frame.ready', which holds a slot index and
+ * THREAD_FRAME_PENDING while the video thread has not taken it yet.
+ * Neither thread holds a lock while it writes or reads frame data. */
+#define THREAD_FRAME_SLOTS    3
+#define THREAD_FRAME_INDEX    3
+#define THREAD_FRAME_PENDING  4
+
+struct thread_frame_slot
+{
+   uint8_t *buffer;
+   unsigned width;
+   unsigned height;
+   unsigned pitch;
+   uint64_t count;
+   bool dupe;
+   char msg[255];
+};
+
 struct thread_video
 {
    slock_t *lock;
@@ -208,15 +229,18 @@ struct thread_video
 
    struct
    {
+      /* Guards texture and state change updates, not frame data. */
       slock_t *lock;
-      uint8_t *buffer;
-      unsigned width;
-      unsigned height;
-      unsigned pitch;
-      bool updated;
+#ifdef HAVE_RETRO_ATOMIC
+      retro_atomic_int_t ready;
+#else
+      slock_t *ready_lock;
+      int ready;
+#endif
+      int write; /* Only touched by the emulator thread. */
+      int read;  /* Only touched by the video thread. */
+      struct thread_frame_slot slot[THREAD_FRAME_SLOTS];
       bool within_thread;
-      uint64_t count;
-      char msg[255];
    } frame;
 
    video_driver_t video_thread;
@@ -575,6 +599,37 @@ static bool video_thread_handle_packet(
    return false;
 }
 
+static int video_thread_frame_exchange(thread_video_t *thr, int ready)
+{
+#ifdef HAVE_RETRO_ATOMIC
+   return (int)retro_atomic_xchg(&thr->frame.ready, ready);
+#else
+   int prev;
+
+   slock_lock(thr->frame.ready_lock);
+   prev             = thr->frame.ready;
+   thr->frame.ready = ready;
+   slock_unlock(thr->frame.ready_lock);
+
+   return prev;
+#endif
+}
+
+static bool video_thread_frame_pending(thread_video_t *thr)
+{
+   int ready;
+
+#ifdef HAVE_RETRO_ATOMIC
+   ready = (int)retro_atomic_load_acquire(&thr->frame.ready);
+#else
+   slock_lock(thr->frame.ready_lock);
+   ready = thr->frame.ready;
+   slock_unlock(thr->frame.ready_lock);
+#endif
+
+   return (ready & THREAD_FRAME_PENDING) != 0;
+}
+
 static void video_thread_loop(void *data)
 {
    thread_video_t *thr = (thread_video_t*)data;
@@ -585,10 +640,10 @@ static void video_thread_loop(void *data)
       bool updated = false;
 
       slock_lock(thr->lock);
-      while (thr->send_cmd == CMD_VIDEO_NONE && !thr->frame.updated)
+      while (thr->send_cmd == CMD_VIDEO_NONE
+            && !video_thread_frame_pending(thr))
          scond_wait(thr->cond_thread, thr->lock);
-      if (thr->frame.updated)
-         updated = true;
+      updated = video_thread_frame_pending(thr);
 
       /* To avoid race condition where send_cmd is updated 
        * right after the switch is checked. */
@@ -602,6 +657,7 @@ static void video_thread_loop(void *data)
       if (updated)
       {
          struct video_viewport vp;
+         struct thread_frame_slot *slot = NULL;
          bool                 ret = false;
          bool               alive = false;
          bool               focus = false;
@@ -614,6 +670,17 @@ static void video_thread_loop(void *data)
          vp.full_width            = 0;
          vp.full_height           = 0;
 
+         /* Only this thread clears the pending flag, so this
+          * takes the newest frame the emulator has published. */
+         thr->frame.read          = video_thread_frame_exchange(thr,
+               thr->frame.read) & THREAD_FRAME_INDEX;
+         slot                     = &thr->frame.slot[thr->frame.read];
+
+         /* The emulator may be waiting to publish its next frame. */
+         slock_lock(thr->lock);
+         scond_signal(thr->cond_cmd);
+         slock_unlock(thr->lock);
+
          slock_lock(thr->frame.lock);
 
          thread_update_driver_state(thr);
@@ -624,9 +691,9 @@ static void video_thread_loop(void *data)
             video_driver_build_info(&video_info);
 
             ret = thr->driver->frame(thr->driver_data,
-                  thr->frame.buffer, thr->frame.width, thr->frame.height,
-                  thr->frame.count,
-                  thr->frame.pitch, *thr->frame.msg ? thr->frame.msg : NULL,
+                  slot->dupe ? NULL : slot->buffer,
+                  slot->width, slot->height, slot->count,
+                  slot->pitch, *slot->msg ? slot->msg : NULL,
                   &video_info);
          }
 
@@ -648,7 +715,6 @@ static void video_thread_loop(void *data)
          thr->alive         = alive;
          thr->focus         = focus;
          thr->has_windowed  = has_windowed;
-         thr->frame.updated = false;
          thr->vp            = vp;
          scond_signal(thr->cond_cmd);
          slock_unlock(thr->lock);
@@ -716,9 +782,9 @@ static bool video_thread_frame(void *data, const void *frame_,
       unsigned width, unsigned height, uint64_t frame_count,
       unsigned pitch, const char *msg, video_frame_info_t *video_info)
 {
+   int prev;
    unsigned copy_stride;
-   const uint8_t *src                  = NULL;
-   uint8_t *dst                        = NULL;
+   struct thread_frame_slot *slot      = NULL;
    thread_video_t *thr                 = (thread_video_t*)data;
 
    /* If called from within read_viewport, we're actually in the 
@@ -733,23 +799,16 @@ static bool video_thread_frame(void *data, const void *frame_,
       return false;
    }
 
-   copy_stride = width * (thr->info.rgb32 
-         ? sizeof(uint32_t) : sizeof(uint16_t));
-
-   src = (const uint8_t*)frame_;
-   dst = thr->frame.buffer;
-
-   slock_lock(thr->lock);
-
    if (!thr->nonblock)
    {
-
       retro_time_t target_frame_time = (retro_time_t)
          roundf(1000000 / video_info->refresh_rate);
       retro_time_t target = thr->last_time + target_frame_time;
 
+      slock_lock(thr->lock);
+
       /* Ideally, use absolute time, but that is only a good idea on POSIX. */
-      while (thr->frame.updated)
+      while (video_thread_frame_pending(thr))
       {
          retro_time_t current = cpu_features_get_time_usec();
          retro_time_t delta   = target - current;
@@ -760,43 +819,73 @@ static bool video_thread_frame(void *data, const void *frame_,
          if (!scond_wait_timeout(thr->cond_cmd, thr->lock, delta))
             break;
       }
+
+      slock_unlock(thr->lock);
    }
 
-   /* Drop frame if updated flag is still set, as thread is 
-    * still working on last frame. */
-   if (!thr->frame.updated)
+   /* A dupe shows nothing new while the last frame is still
+    * waiting for the video thread. */
+   if (!frame_ && video_thread_frame_pending(thr))
    {
-      if (src)
+      thr->miss_count++;
+      thr->last_time = cpu_features_get_time_usec();
+      return true;
+   }
+
+   slot        = &thr->frame.slot[thr->frame.write];
+   copy_stride = width * (thr->info.rgb32 
+         ? sizeof(uint32_t) : sizeof(uint16_t));
+
+   /* The core may have rendered straight into our slot,
+    * see thread_get_current_software_framebuffer. */
+   if (frame_ == slot->buffer)
+      slot->pitch = pitch;
+   else
+   {
+      if (frame_)
       {
          unsigned h;
+         const uint8_t *src = (const uint8_t*)frame_;
+         uint8_t *dst       = slot->buffer;
+
          for (h = 0; h < height; h++, src += pitch, dst += copy_stride)
             memcpy(dst, src, copy_stride);
       }
 
-      thr->frame.updated = true;
-      thr->frame.width  = width;
-      thr->frame.height = height;
-      thr->frame.count  = frame_count;
-      thr->frame.pitch  = copy_stride;
+      slot->pitch = copy_stride;
+   }
 
-      if (msg)
-         strlcpy(thr->frame.msg, msg, sizeof(thr->frame.msg));
-      else
-         *thr->frame.msg = '\0';
+   slot->dupe   = !frame_;
+   slot->width  = width;
+   slot->height = height;
+   slot->count  = frame_count;
 
-      scond_signal(thr->cond_thread);
+   if (msg)
+      strlcpy(slot->msg, msg, sizeof(slot->msg));
+   else
+      *slot->msg = '\0';
+
+   /* Publish the slot and take back the one it replaces. If the
+    * video thread never picked that one up, newest frame wins
+    * and the older one is dropped. */
+   prev             = video_thread_frame_exchange(thr,
+         thr->frame.write | THREAD_FRAME_PENDING);
+   thr->frame.write = prev & THREAD_FRAME_INDEX;
+
+   thr->hit_count++;
+   if (prev & THREAD_FRAME_PENDING)
+      thr->miss_count++;
+
+   slock_lock(thr->lock);
+   scond_signal(thr->cond_thread);
 
 #if defined(HAVE_MENU)
-      if (thr->texture.enable)
-      {
-         while (thr->frame.updated)
-            scond_wait(thr->cond_cmd, thr->lock);
-      }
-#endif
-      thr->hit_count++;
+   if (thr->texture.enable)
+   {
+      while (video_thread_frame_pending(thr))
+         scond_wait(thr->cond_cmd, thr->lock);
    }
-   else
-      thr->miss_count++;
+#endif
 
    slock_unlock(thr->lock);
 
@@ -815,12 +904,16 @@ static bool video_thread_init(thread_video_t *thr,
       const video_info_t info,
       const input_driver_t **input, void **input_data)
 {
+   unsigned i;
    size_t max_size;
    thread_packet_t pkt = {CMD_INIT};
 
    thr->lock                 = slock_new();
    thr->alpha_lock           = slock_new();
    thr->frame.lock           = slock_new();
+#ifndef HAVE_RETRO_ATOMIC
+   thr->frame.ready_lock     = slock_new();
+#endif
    thr->cond_cmd             = scond_new();
    thr->cond_thread          = scond_new();
    thr->input                = input;
@@ -834,12 +927,20 @@ static bool video_thread_init(thread_video_t *thr,
    max_size                  = info.input_scale * RARCH_SCALE_BASE;
    max_size                 *= max_size;
    max_size                 *= info.rgb32 ? sizeof(uint32_t) : sizeof(uint16_t);
-   thr->frame.buffer         = (uint8_t*)malloc(max_size);
 
-   if (!thr->frame.buffer)
-      return false;
+   for (i = 0; i < THREAD_FRAME_SLOTS; i++)
+   {
+      thr->frame.slot[i].buffer = (uint8_t*)malloc(max_size);
+
+      if (!thr->frame.slot[i].buffer)
+         return false;
 
-   memset(thr->frame.buffer, 0x80, max_size);
+      memset(thr->frame.slot[i].buffer, 0x80, max_size);
+   }
+
+   thr->frame.write          = 0;
+   thr->frame.ready          = 1;
+   thr->frame.read           = 2;
 
    thr->last_time            = cpu_features_get_time_usec();
    thr->thread               = sthread_create(video_thread_loop, thr);
@@ -936,6 +1037,7 @@ static bool video_thread_read_viewport(void *data, uint8_t *buffer, bool is_idle
 
 static void video_thread_free(void *data)
 {
+   unsigned i;
    thread_video_t *thr = (thread_video_t*)data;
    thread_packet_t pkt = { CMD_FREE };
 
@@ -949,8 +1051,12 @@ static void video_thread_free(void *data)
 #if defined(HAVE_MENU)
    free(thr->texture.frame);
 #endif
-   free(thr->frame.buffer);
+   for (i = 0; i < THREAD_FRAME_SLOTS; i++)
+      free(thr->frame.slot[i].buffer);
    slock_free(thr->frame.lock);
+#ifndef HAVE_RETRO_ATOMIC
+   slock_free(thr->frame.ready_lock);
+#endif
    slock_free(thr->lock);
    scond_free(thr->cond_cmd);
    scond_free(thr->cond_thread);
@@ -1256,6 +1362,38 @@ static struct video_shader *thread_get_current_shader(void *data)
    return thr->poke->get_current_shader(thr->driver_data);
 }
 
+/* Lets the core render into the slot the next video_thread_frame
+ * publishes, which saves copying the frame. */
+static bool thread_get_current_software_framebuffer(void *data,
+      struct retro_framebuffer *fb)
+{
+   unsigned max_width;
+   enum retro_pixel_format fmt = video_driver_get_pixel_format();
+   thread_video_t *thr         = (thread_video_t*)data;
+
+   if (!thr || !fb)
+      return false;
+
+   /* Filtered and converted frames never reach us as the
+    * core's own buffer. */
+   if (video_driver_frame_filter_alive()
+         || fmt == RETRO_PIXEL_FORMAT_0RGB1555)
+      return false;
+
+   max_width = thr->info.input_scale * RARCH_SCALE_BASE;
+
+   if (fb->width > max_width || fb->height > max_width)
+      return false;
+
+   fb->data         = thr->frame.slot[thr->frame.write].buffer;
+   fb->pitch        = max_width * (thr->info.rgb32
+         ? sizeof(uint32_t) : sizeof(uint16_t));
+   fb->format       = fmt;
+   fb->memory_flags = RETRO_MEMORY_TYPE_CACHED;
+
+   return true;
+}
+
 static const video_poke_interface_t thread_poke = {
    thread_load_texture,
    thread_unload_texture,
@@ -1281,6 +1419,8 @@ static const video_poke_interface_t thread_poke = {
    NULL,
 
    thread_get_current_shader,
+   thread_get_current_software_framebuffer,
+   NULL, /* get_hw_render_interface */
 };
 
 static void video_thread_get_poke_interface(
@@ -125,6 +125,7 @@ PERFORMANCE
 ============================================================ */
 #include "../libretro-common/features/features_cpu.c"
 #include "../performance_counters.c"
+#include "../frame_timeline.c"
 
 /*============================================================
 CONFIG FILE
@@ -746,6 +747,7 @@ DRIVERS
 #include "../gfx/video_driver.c"
 #include "../gfx/video_coord_array.c"
 #include "../input/input_driver.c"
+#include "../input/input_snapshot.c"
 #include "../audio/audio_driver.c"
 #include "../libretro-common/audio/audio_mixer.c"
 #include "../camera/camera_driver.c"
@@ -836,6 +838,9 @@ CONFIGURATION
 STATE MANAGER
 ============================================================ */
 #include "../managers/state_manager.c"
+#include "../managers/state_delta.c"
+#include "../managers/run_ahead.c"
+#include "../managers/frame_delay.c"
 
 /*============================================================
 FRONTEND
@@ -969,6 +974,7 @@ THREAD
 #include "../libretro-common/rthreads/rthreads.c"
 #include "../gfx/video_thread_wrapper.c"
 #include "../audio/audio_thread_wrapper.c"
+#include "../audio/audio_output_thread.c"
 #endif
 
 
@@ -1015,6 +1021,7 @@ DATA RUNLOOP
 #ifdef HAVE_LIBRETRODB
 #include "../tasks/task_database.c"
 #include "../tasks/task_database_cue.c"
+#include "../tasks/task_database_hash.c"
 #endif
 
 /*============================================================
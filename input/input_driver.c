@@ -41,6 +41,7 @@
 #include "input_driver.h"
 #include "input_keymaps.h"
 #include "input_remapping.h"
+#include "input_snapshot.h"
 
 #include "../config.def.keybinds.h"
 
@@ -52,6 +53,7 @@
 
 #include "../msg_hash.h"
 #include "../configuration.h"
+#include "../frame_timeline.h"
 #include "../file_path_special.h"
 #include "../driver.h"
 #include "../retroarch.h"
@@ -535,8 +537,12 @@ void input_poll(void)
    size_t i;
    settings_t *settings           = config_get_ptr();
    uint8_t max_users              = (uint8_t)input_driver_max_users;
-   
+
+   frame_timeline_begin(FRAME_TIMELINE_INPUT_POLL);
    current_input->poll(current_input_data);
+   frame_timeline_end(FRAME_TIMELINE_INPUT_POLL);
+
+   input_snapshot_invalidate();
 
    input_driver_turbo_btns.count++;
 
@@ -586,6 +592,53 @@ void input_poll(void)
 #endif
 }
 
+/**
+ * input_state_device:
+ *
+ * Reads one input from the input driver and everything
+ * layered over it, after remapping and before turbo.
+ **/
+static int16_t input_state_device(void *data, unsigned port,
+      unsigned device, unsigned idx, unsigned id)
+{
+   int16_t res          = 0;
+   settings_t *settings = (settings_t*)data;
+
+   if (((id < RARCH_FIRST_META_KEY) || (device == RETRO_DEVICE_KEYBOARD)))
+   {
+      bool bind_valid = libretro_input_binds[port] && libretro_input_binds[port][id].valid;
+
+      if (bind_valid || device == RETRO_DEVICE_KEYBOARD)
+      {
+         rarch_joypad_info_t joypad_info;
+
+         joypad_info.axis_threshold = input_driver_axis_threshold;
+         joypad_info.joy_idx        = settings->uints.input_joypad_map[port];
+         joypad_info.auto_binds     = input_autoconf_binds[joypad_info.joy_idx];
+
+         res = current_input->input_state(
+               current_input_data, joypad_info, libretro_input_binds, port, device, idx, id);
+      }
+   }
+
+#ifdef HAVE_OVERLAY
+   if (overlay_ptr)
+      input_state_overlay(overlay_ptr, &res, port, device, idx, id);
+#endif
+
+#ifdef HAVE_NETWORKGAMEPAD
+   if (input_driver_remote)
+      input_remote_state(&res, port, device, idx, id);
+#endif
+
+#ifdef HAVE_KEYMAPPER
+   if (input_driver_mapper)
+      input_mapper_state(&res, port, device, idx, id);
+#endif
+
+   return res;
+}
+
 /**
  * input_state:
  * @port                 : user number.
@@ -595,6 +648,9 @@ void input_poll(void)
  *
  * Input state callback function.
  *
+ * Joypad buttons and analog sticks come from a snapshot
+ * taken once per poll, see input_snapshot.h.
+ *
  * Returns: Non-zero if the given key (identified by @id) 
  * was pressed by the user (assigned to @port).
  **/
@@ -640,37 +696,9 @@ int16_t input_state(unsigned port, unsigned device,
          }
       }
 
-      if (((id < RARCH_FIRST_META_KEY) || (device == RETRO_DEVICE_KEYBOARD)))
-      {
-         bool bind_valid = libretro_input_binds[port] && libretro_input_binds[port][id].valid;
-
-         if (bind_valid || device == RETRO_DEVICE_KEYBOARD)
-         {
-            rarch_joypad_info_t joypad_info;
-
-            joypad_info.axis_threshold = input_driver_axis_threshold;
-            joypad_info.joy_idx        = settings->uints.input_joypad_map[port];
-            joypad_info.auto_binds     = input_autoconf_binds[joypad_info.joy_idx];
-
-            res = current_input->input_state(
-                  current_input_data, joypad_info, libretro_input_binds, port, device, idx, id);
-         }
-      }
-
-#ifdef HAVE_OVERLAY
-      if (overlay_ptr)
-         input_state_overlay(overlay_ptr, &res, port, device, idx, id);
-#endif
-
-#ifdef HAVE_NETWORKGAMEPAD
-      if (input_driver_remote)
-         input_remote_state(&res, port, device, idx, id);
-#endif
-
-#ifdef HAVE_KEYMAPPER
-      if (input_driver_mapper)
-         input_mapper_state(&res, port, device, idx, id);
-#endif
+      if (!input_snapshot_get(port, device, idx, id,
+               input_state_device, settings, &res))
+         res = input_state_device(settings, port, device, idx, id);
 
       /* Don't allow turbo for D-pad. */
       if (device == RETRO_DEVICE_JOYPAD && (id < RETRO_DEVICE_ID_JOYPAD_UP ||
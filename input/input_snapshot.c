@@ -0,0 +1,39 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_snapshot.h"
+
+struct input_snapshot_port input_snapshot_ports[MAX_USERS];
+
+void input_snapshot_invalidate(void)
+{
+   unsigned i;
+
+   for (i = 0; i < MAX_USERS; i++)
+      input_snapshot_ports[i].known = 0;
+}
+
+int16_t input_snapshot_read(unsigned port, unsigned slot,
+      unsigned device, unsigned idx, unsigned id,
+      input_snapshot_read_t read, void *data)
+{
+   struct input_snapshot_port *snap = &input_snapshot_ports[port];
+
+   snap->known       |= (1 << slot);
+   snap->values[slot] = read(data, port, device, idx, id);
+
+   return snap->values[slot];
+}
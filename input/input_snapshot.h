@@ -0,0 +1,121 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INPUT_SNAPSHOT_H__
+#define INPUT_SNAPSHOT_H__
+
+#include <stdint.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+#include <retro_inline.h>
+#include <libretro.h>
+
+#include "input_defines.h"
+
+RETRO_BEGIN_DECLS
+
+/* Reads one input straight from the drivers, after remapping
+ * and before turbo, the way input_state would without a cache. */
+typedef int16_t (*input_snapshot_read_t)(void *data, unsigned port,
+      unsigned device, unsigned idx, unsigned id);
+
+/* Joypad buttons, then the four analog stick axes. */
+#define INPUT_SNAPSHOT_SLOTS (RARCH_FIRST_CUSTOM_BIND + 4)
+
+/* 48 bytes, so a frame's reads of one port touch at most two
+ * cache lines. Bit N of 'known' is set once values[N] has been
+ * read since the last poll. */
+struct input_snapshot_port
+{
+   uint32_t known;
+   int16_t values[INPUT_SNAPSHOT_SLOTS];
+   uint32_t pad;
+};
+
+extern struct input_snapshot_port input_snapshot_ports[MAX_USERS];
+
+/**
+ * input_snapshot_invalidate:
+ *
+ * Drops all cached inputs. Call after the input drivers
+ * have been polled.
+ **/
+void input_snapshot_invalidate(void);
+
+/* Slow path of input_snapshot_get, reads and caches one input. */
+int16_t input_snapshot_read(unsigned port, unsigned slot,
+      unsigned device, unsigned idx, unsigned id,
+      input_snapshot_read_t read, void *data);
+
+/**
+ * input_snapshot_get:
+ * @port                 : user number.
+ * @device               : RETRO_DEVICE_JOYPAD or RETRO_DEVICE_ANALOG.
+ * @idx                  : index value of user.
+ * @id                   : identifier of button or axis.
+ * @read                 : reads the input on its first lookup
+ *                         after input_snapshot_invalidate.
+ * @data                 : passed to @read.
+ * @res                  : the cached value.
+ *
+ * Looks a joypad button or analog stick axis up in the
+ * snapshot of @port. Each input is read from the drivers
+ * once per poll, every later lookup in the same frame is
+ * a table read. Inputs the core never asks for are never
+ * read.
+ *
+ * Returns: true (1) if the input is cached, false (0) if
+ * it has to be read from the drivers.
+ **/
+static INLINE bool input_snapshot_get(unsigned port, unsigned device,
+      unsigned idx, unsigned id,
+      input_snapshot_read_t read, void *data, int16_t *res)
+{
+   unsigned slot;
+
+   if (port >= MAX_USERS)
+      return false;
+
+   switch (device)
+   {
+      case RETRO_DEVICE_JOYPAD:
+         if (id >= RARCH_FIRST_CUSTOM_BIND)
+            return false;
+         slot = id;
+         break;
+      case RETRO_DEVICE_ANALOG:
+         /* Analog buttons are rare, read them directly. */
+         if (idx > RETRO_DEVICE_INDEX_ANALOG_RIGHT
+               || id > RETRO_DEVICE_ID_ANALOG_Y)
+            return false;
+         slot = RARCH_FIRST_CUSTOM_BIND + idx * 2 + id;
+         break;
+      default:
+         return false;
+   }
+
+   if (input_snapshot_ports[port].known & (1 << slot))
+      *res = input_snapshot_ports[port].values[slot];
+   else
+      *res = input_snapshot_read(port, slot, device, idx, id, read, data);
+
+   return true;
+}
+
+RETRO_END_DECLS
+
+#endif
@@ -48,6 +48,8 @@ MSG_HASH(MENU_ENUM_LABEL_AUDIO_SETTINGS,
       "audio_settings")
 MSG_HASH(MENU_ENUM_LABEL_AUDIO_SYNC,
       "audio_sync")
+MSG_HASH(MENU_ENUM_LABEL_AUDIO_OUTPUT_THREAD,
+      "audio_output_thread")
 MSG_HASH(MENU_ENUM_LABEL_AUDIO_VOLUME,
       "audio_volume")
 MSG_HASH(MENU_ENUM_LABEL_AUDIO_WASAPI_EXCLUSIVE_MODE,
@@ -177,6 +179,8 @@ MSG_HASH(MENU_ENUM_LABEL_CONTENT_HISTORY_SIZE,
       "content_history_size")
 MSG_HASH(MENU_ENUM_LABEL_PLAYLIST_ENTRY_REMOVE,
       "playlist_entry_remove")
+MSG_HASH(MENU_ENUM_LABEL_PLAYLIST_BINARY_FORMAT,
+      "playlist_binary_format")
 MSG_HASH(MENU_ENUM_LABEL_CONTENT_SETTINGS,
       "quick_menu")
 MSG_HASH(MENU_ENUM_LABEL_CORE_ASSETS_DIRECTORY,
@@ -413,6 +417,10 @@ MSG_HASH(MENU_ENUM_LABEL_FAVORITES_TAB,
       "favorites_tab")
 MSG_HASH(MENU_ENUM_LABEL_FPS_SHOW,
       "fps_show")
+MSG_HASH(MENU_ENUM_LABEL_FRAME_TIMELINE_ENABLE,
+      "frame_timeline_enable")
+MSG_HASH(MENU_ENUM_LABEL_FRAME_TIMELINE_SHOW,
+      "frame_timeline_show")
 MSG_HASH(MENU_ENUM_LABEL_FRAME_THROTTLE_ENABLE,
       "fastforward_ratio_throttle_enable")
 MSG_HASH(MENU_ENUM_LABEL_FRAME_THROTTLE_SETTINGS,
@@ -861,6 +869,8 @@ MSG_HASH(MENU_ENUM_LABEL_REWIND_ENABLE,
       "rewind_enable")
 MSG_HASH(MENU_ENUM_LABEL_REWIND_GRANULARITY,
       "rewind_granularity")
+MSG_HASH(MENU_ENUM_LABEL_REWIND_THREADED,
+      "rewind_threaded")
 MSG_HASH(MENU_ENUM_LABEL_REWIND_SETTINGS,
       "rewind_settings")
 MSG_HASH(MENU_ENUM_LABEL_RGUI_BROWSER_DIRECTORY,
@@ -885,6 +895,8 @@ MSG_HASH(MENU_ENUM_LABEL_SAVESTATE_AUTO_LOAD,
       "savestate_auto_load")
 MSG_HASH(MENU_ENUM_LABEL_SAVESTATE_THUMBNAIL_ENABLE,
       "savestate_thumbnails")
+MSG_HASH(MENU_ENUM_LABEL_SAVESTATE_FILE_COMPRESSION,
+      "savestate_file_compression")
 MSG_HASH(MENU_ENUM_LABEL_SAVESTATE_AUTO_SAVE,
       "savestate_auto_save")
 MSG_HASH(MENU_ENUM_LABEL_SAVESTATE_DIRECTORY,
@@ -1059,6 +1071,10 @@ MSG_HASH(MENU_ENUM_LABEL_VIDEO_FORCE_SRGB_DISABLE,
       "video_force_srgb_disable")
 MSG_HASH(MENU_ENUM_LABEL_VIDEO_FRAME_DELAY,
       "video_frame_delay")
+MSG_HASH(MENU_ENUM_LABEL_VIDEO_FRAME_DELAY_AUTO,
+      "video_frame_delay_auto")
+MSG_HASH(MENU_ENUM_LABEL_RUN_AHEAD_FRAMES,
+      "run_ahead_frames")
 MSG_HASH(MENU_ENUM_LABEL_VIDEO_FULLSCREEN,
       "video_fullscreen")
 MSG_HASH(MENU_ENUM_LABEL_VIDEO_GAMMA,
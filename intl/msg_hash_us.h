@@ -270,6 +270,10 @@ MSG_HASH(
       MENU_ENUM_LABEL_VALUE_AUDIO_SYNC,
       "Audio Sync"
       )
+MSG_HASH(
+      MENU_ENUM_LABEL_VALUE_AUDIO_OUTPUT_THREAD,
+      "Audio Output Thread"
+      )
 MSG_HASH(
       MENU_ENUM_LABEL_VALUE_AUDIO_VOLUME,
       "Audio Volume Level (dB)"
@@ -495,6 +499,8 @@ MSG_HASH(
       "History List Size")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_PLAYLIST_ENTRY_REMOVE,
       "Allow to remove entries")
+MSG_HASH(MENU_ENUM_LABEL_VALUE_PLAYLIST_BINARY_FORMAT,
+      "Save playlists in binary format")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_CONTENT_SETTINGS,
       "Quick Menu")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_CORE_ASSETS_DIR,
@@ -619,6 +625,10 @@ MSG_HASH(MENU_ENUM_LABEL_VALUE_FAVORITES_TAB,
       "Favorites")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_FPS_SHOW,
       "Display Framerate")
+MSG_HASH(MENU_ENUM_LABEL_VALUE_FRAME_TIMELINE_ENABLE,
+      "Frame Timeline")
+MSG_HASH(MENU_ENUM_LABEL_VALUE_FRAME_TIMELINE_SHOW,
+      "Display Frame Timeline")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_FRAME_THROTTLE_ENABLE,
       "Limit Maximum Run Speed")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_FRAME_THROTTLE_SETTINGS,
@@ -1251,6 +1261,8 @@ MSG_HASH(MENU_ENUM_LABEL_VALUE_REWIND_ENABLE,
       "Rewind Enable")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_REWIND_GRANULARITY,
       "Rewind Granularity")
+MSG_HASH(MENU_ENUM_LABEL_VALUE_REWIND_THREADED,
+      "Threaded Rewind")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_REWIND_SETTINGS,
       "Rewind")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_RGUI_BROWSER_DIRECTORY,
@@ -1281,6 +1293,8 @@ MSG_HASH(MENU_ENUM_LABEL_VALUE_SAVESTATE_DIRECTORY,
       "Savestate")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_SAVESTATE_THUMBNAIL_ENABLE,
       "Savestate Thumbnails")
+MSG_HASH(MENU_ENUM_LABEL_VALUE_SAVESTATE_FILE_COMPRESSION,
+      "Savestate Compression")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_SAVE_CURRENT_CONFIG,
       "Save Current Configuration")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_SAVE_CURRENT_CONFIG_OVERRIDE_CORE,
@@ -1615,6 +1629,10 @@ MSG_HASH(MENU_ENUM_LABEL_VALUE_VIDEO_FORCE_SRGB_DISABLE,
       "Force-disable sRGB FBO")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_VIDEO_FRAME_DELAY,
       "Frame Delay")
+MSG_HASH(MENU_ENUM_LABEL_VALUE_VIDEO_FRAME_DELAY_AUTO,
+      "Automatic Frame Delay")
+MSG_HASH(MENU_ENUM_LABEL_VALUE_RUN_AHEAD_FRAMES,
+      "Run-Ahead Frames")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_VIDEO_FULLSCREEN,
       "Use Fullscreen Mode")
 MSG_HASH(MENU_ENUM_LABEL_VALUE_VIDEO_GAMMA,
@@ -1827,6 +1845,8 @@ MSG_HASH(MENU_ENUM_SUBLABEL_CPU_CORES,
       "Amount of cores that the CPU has.")
 MSG_HASH(MENU_ENUM_SUBLABEL_FPS_SHOW,
       "Displays the current framerate per second onscreen.")
+MSG_HASH(MENU_ENUM_SUBLABEL_FRAME_TIMELINE_SHOW,
+      "Displays how long input polling, the core, filtering, the video driver and audio take per frame.")
 MSG_HASH(MENU_ENUM_SUBLABEL_INPUT_HOTKEY_BINDS,
       "Configure hotkey settings.")
 MSG_HASH(MENU_ENUM_SUBLABEL_INPUT_MENU_ENUM_TOGGLE_GAMEPAD_COMBO,
@@ -1863,6 +1883,10 @@ MSG_HASH(MENU_ENUM_SUBLABEL_VIDEO_BLACK_FRAME_INSERTION,
       "Inserts a black frame inbetween frames. Useful for users with 120Hz screens who want to play 60Hz content to eliminate ghosting.")
 MSG_HASH(MENU_ENUM_SUBLABEL_VIDEO_FRAME_DELAY,
       "Reduces latency at the cost of a higher risk of video stuttering. Adds a delay after V-Sync (in ms).")
+MSG_HASH(MENU_ENUM_SUBLABEL_VIDEO_FRAME_DELAY_AUTO,
+      "Measures how long the core takes every frame and keeps the frame delay as high as it can go without missing V-Sync. Overrides Frame Delay.")
+MSG_HASH(MENU_ENUM_SUBLABEL_RUN_AHEAD_FRAMES,
+      "Runs the core this many frames ahead and rewinds it with savestates, removing the game's own input lag. Costs CPU time for every extra frame and requires savestate support.")
 MSG_HASH(MENU_ENUM_SUBLABEL_VIDEO_HARD_SYNC_FRAMES,
       "Sets how many frames the CPU can run ahead of the GPU when using 'Hard GPU Sync'.")
 MSG_HASH(MENU_ENUM_SUBLABEL_VIDEO_MAX_SWAPCHAIN_IMAGES,
@@ -2317,6 +2341,10 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_AUDIO_SYNC,
    "Synchronize audio. Recommended."
    )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_AUDIO_OUTPUT_THREAD,
+   "Write audio to the driver on its own thread, so a full driver buffer does not stall the frame. Adds a little latency."
+   )
 MSG_HASH(
    MENU_ENUM_SUBLABEL_INPUT_AXIS_THRESHOLD,
    "How far an axis must be tilted to result in a button press."
@@ -2588,6 +2616,10 @@ MSG_HASH(
       MENU_ENUM_SUBLABEL_REWIND_GRANULARITY,
       "When rewinding a defined number of frames, you can rewind several frames at a time, increasing the rewind speed."
       )
+MSG_HASH(
+      MENU_ENUM_SUBLABEL_REWIND_THREADED,
+      "Compresses savestates on a separate thread, lowering the per-frame rewind cost and fitting more history into the buffer."
+      )
 MSG_HASH(
       MENU_ENUM_SUBLABEL_LIBRETRO_LOG_LEVEL,
       "Sets log level for cores. If a log level issued by a core is below this value, it is ignored."
@@ -2596,6 +2628,10 @@ MSG_HASH(
       MENU_ENUM_SUBLABEL_PERFCNT_ENABLE,
       "Enable performance counters for RetroArch (and cores)."
       )
+MSG_HASH(
+      MENU_ENUM_SUBLABEL_FRAME_TIMELINE_ENABLE,
+      "Record when each stage of the last frames ran. Export them with the TIMELINE_DUMP network command."
+      )
 MSG_HASH(
       MENU_ENUM_SUBLABEL_SAVESTATE_AUTO_SAVE,
       "Automatically makes a savestate at the end of RetroArch's runtime. RetroArch will automatically load this savestate if 'Auto Load State' is enabled."
@@ -2608,6 +2644,10 @@ MSG_HASH(
       MENU_ENUM_SUBLABEL_SAVESTATE_THUMBNAIL_ENABLE,
       "Show thumbnails of save states inside the menu."
       )
+MSG_HASH(
+      MENU_ENUM_SUBLABEL_SAVESTATE_FILE_COMPRESSION,
+      "Compress save state files on a background task. Uncompressed save states can still be loaded."
+      )
 MSG_HASH(
       MENU_ENUM_SUBLABEL_AUTOSAVE_INTERVAL,
       "Autosaves the non-volatile Save RAM at a regular interval. This is disabled by default unless set otherwise. The interval is measured in seconds. A value of 0 disables autosave."
@@ -2888,6 +2928,8 @@ MSG_HASH(MENU_ENUM_SUBLABEL_THREADED_DATA_RUNLOOP_ENABLE,
       "Perform tasks on a separate thread.")
 MSG_HASH(MENU_ENUM_SUBLABEL_PLAYLIST_ENTRY_REMOVE,
       "Allow the user to remove entries from collections.")
+MSG_HASH(MENU_ENUM_SUBLABEL_PLAYLIST_BINARY_FORMAT,
+      "Save playlists in a compact binary format that loads faster. Text playlists can still be loaded.")
 MSG_HASH(MENU_ENUM_SUBLABEL_SYSTEM_DIRECTORY,
       "Sets the System directory. Cores can query for this directory to load BIOSes, system-specific configs, etc.")
 MSG_HASH(MENU_ENUM_SUBLABEL_RGUI_BROWSER_DIRECTORY,
@@ -33,6 +33,7 @@
 #include <streams/file_stream.h>
 #include <libretro.h>
 #include <features/features_cpu.h>
+#include <retro_simd.h>
 #include <retro_timers.h>
 
 #if defined(_WIN32) && !defined(_XBOX)
@@ -550,7 +551,7 @@ uint64_t cpu_features_get(void)
    const int avx_flags = (1 << 27) | (1 << 28);
 #endif
 
-   char buf[sizeof(" MMX MMXEXT SSE SSE2 SSE3 SSSE3 SS4 SSE4.2 AES AVX AVX2 NEON VMX VMX128 VFPU PS")];
+   char buf[sizeof(" MMX MMXEXT SSE SSE2 SSE3 SSSE3 SS4 SSE4.2 AES PCLMUL AVX AVX2 NEON VFPv3 VFPv4 VMX VMX128 VFPU PS ASIMD CRC32")];
 
    memset(buf, 0, sizeof(buf));
 
@@ -681,6 +682,9 @@ uint64_t cpu_features_get(void)
    if (flags[2] & (1 << 25))
       cpu |= RETRO_SIMD_AES;
 
+   if (flags[2] & (1 << 1))
+      cpu |= CPU_FEATURE_PCLMUL;
+
 
    /* Must only perform xgetbv check if we have
     * AVX CPU support (guaranteed to have at least i686). */
@@ -729,6 +733,9 @@ uint64_t cpu_features_get(void)
 #endif
    }
 
+   if (check_arm_cpu_feature("crc32"))
+      cpu |= CPU_FEATURE_CRC32;
+
 #if 0
     check_arm_cpu_feature("swp");
     check_arm_cpu_feature("half");
@@ -764,6 +771,7 @@ uint64_t cpu_features_get(void)
    if (cpu & RETRO_SIMD_SSE4)   strlcat(buf, " SSE4", sizeof(buf));
    if (cpu & RETRO_SIMD_SSE42)  strlcat(buf, " SSE4.2", sizeof(buf));
    if (cpu & RETRO_SIMD_AES)    strlcat(buf, " AES", sizeof(buf));
+   if (cpu & CPU_FEATURE_PCLMUL) strlcat(buf, " PCLMUL", sizeof(buf));
    if (cpu & RETRO_SIMD_AVX)    strlcat(buf, " AVX", sizeof(buf));
    if (cpu & RETRO_SIMD_AVX2)   strlcat(buf, " AVX2", sizeof(buf));
    if (cpu & RETRO_SIMD_NEON)   strlcat(buf, " NEON", sizeof(buf));
@@ -774,6 +782,35 @@ uint64_t cpu_features_get(void)
    if (cpu & RETRO_SIMD_VFPU)   strlcat(buf, " VFPU", sizeof(buf));
    if (cpu & RETRO_SIMD_PS)     strlcat(buf, " PS", sizeof(buf));
    if (cpu & RETRO_SIMD_ASIMD)  strlcat(buf, " ASIMD", sizeof(buf));
+   if (cpu & CPU_FEATURE_CRC32)  strlcat(buf, " CRC32", sizeof(buf));
 
    return cpu;
 }
+
+uint64_t cpu_features_get_simd(void)
+{
+   static uint64_t simd;
+   static bool detected;
+
+   if (!detected)
+   {
+      uint64_t cpu = cpu_features_get();
+
+#if defined(__SSE2__)
+      cpu |= RETRO_SIMD_SSE2;
+#endif
+#if defined(RETRO_HAVE_NEON)
+      /* features_cpu only reports it on 32-bit ARM,
+       * AArch64 always has it. */
+      cpu |= RETRO_SIMD_NEON;
+#endif
+      /* The AVX flag also tells that the OS saves YMM registers. */
+      if (!(cpu & RETRO_SIMD_AVX))
+         cpu &= ~(uint64_t)RETRO_SIMD_AVX2;
+
+      simd     = cpu;
+      detected = true;
+   }
+
+   return simd;
+}
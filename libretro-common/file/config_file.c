@@ -48,11 +48,18 @@
 
 #define MAX_INCLUDE_DEPTH 16
 
+/* Smallest hash index, in slots. */
+#define CONFIG_INDEX_MIN 64
+
 struct config_entry_list
 {
    /* If we got this from an #include,
     * do not allow overwrite. */
    bool readonly;
+   /* The entry and its key live in a config_file_buffer. */
+   bool buffered;
+   /* The value lives in a config_file_buffer. */
+   bool value_buffered;
    uint32_t key_hash;
 
    char *key;
@@ -60,6 +67,15 @@ struct config_entry_list
    struct config_entry_list *next;
 };
 
+/* A file read in one go. Keys and values point into
+ * 'data', entries are taken from 'entries'. */
+struct config_file_buffer
+{
+   char *data;
+   struct config_entry_list *entries;
+   struct config_file_buffer *next;
+};
+
 struct config_include_list
 {
    char *path;
@@ -74,43 +90,111 @@ struct config_file
    unsigned include_depth;
 
    struct config_include_list *includes;
+
+   /* Open addressing hash index of the first
+    * entry for every key, in list order. */
+   struct config_entry_list **index;
+   size_t index_size;
+   size_t index_count;
+
+   struct config_file_buffer *buffers;
 };
 
 static config_file_t *config_file_new_internal(
       const char *path, unsigned depth);
 
-static char *getaline(RFILE *file)
+static void config_index_insert(config_file_t *conf,
+      struct config_entry_list *entry)
 {
-   char* newline     = (char*)malloc(9);
-   char* newline_tmp = NULL;
-   size_t cur_size   = 8;
-   size_t idx        = 0;
-   int in            = filestream_getc(file);
+   size_t mask = conf->index_size - 1;
+   size_t i    = entry->key_hash & mask;
 
-   if (!newline)
-      return NULL;
-
-   while (in != EOF && in != '\n')
+   while (conf->index[i])
    {
-      if (idx == cur_size)
-      {
-         cur_size *= 2;
-         newline_tmp = (char*)realloc(newline, cur_size + 1);
+      /* Keep the first entry, it is the one that counts. */
+      if (conf->index[i]->key_hash == entry->key_hash
+            && string_is_equal(conf->index[i]->key, entry->key))
+         return;
+      i = (i + 1) & mask;
+   }
 
-         if (!newline_tmp)
-         {
-            free(newline);
-            return NULL;
-         }
+   conf->index[i] = entry;
+   conf->index_count++;
+}
 
-         newline = newline_tmp;
-      }
+/* Rebuilds the index from the entry list, after entries
+ * were put in front of others or removed. */
+static void config_index_rebuild(config_file_t *conf)
+{
+   size_t count                    = 0;
+   size_t size                     = CONFIG_INDEX_MIN;
+   struct config_entry_list *entry = NULL;
 
-      newline[idx++] = in;
-      in = filestream_getc(file);
-   }
-   newline[idx] = '\0';
-   return newline;
+   for (entry = conf->entries; entry; entry = entry->next)
+      count++;
+
+   while (size < count * 2)
+      size *= 2;
+
+   free(conf->index);
+   conf->index_count = 0;
+   conf->index_size  = 0;
+   conf->index       = (struct config_entry_list**)
+      calloc(size, sizeof(*conf->index));
+
+   if (!conf->index)
+      return;
+
+   conf->index_size  = size;
+
+   for (entry = conf->entries; entry; entry = entry->next)
+      if (entry->key)
+         config_index_insert(conf, entry);
+}
+
+/* Indexes an entry that was just linked in at the tail. */
+static void config_index_add(config_file_t *conf,
+      struct config_entry_list *entry)
+{
+   if (!entry->key)
+      return;
+
+   /* Keep the load factor at or below one half. */
+   if ((conf->index_count + 1) * 2 > conf->index_size)
+      config_index_rebuild(conf);
+   else
+      config_index_insert(conf, entry);
+}
+
+static void config_file_add_entry(config_file_t *conf,
+      struct config_entry_list *entry)
+{
+   if (conf->entries)
+      conf->tail->next = entry;
+   else
+      conf->entries    = entry;
+
+   conf->tail          = entry;
+
+   config_index_add(conf, entry);
+}
+
+/* Moves the buffers of @child over to @conf, after
+ * pilfering its entries. */
+static void config_file_take_buffers(config_file_t *conf,
+      config_file_t *child)
+{
+   struct config_file_buffer *buffer = child->buffers;
+
+   if (!buffer)
+      return;
+
+   while (buffer->next)
+      buffer = buffer->next;
+
+   buffer->next    = conf->buffers;
+   conf->buffers   = child->buffers;
+   child->buffers  = NULL;
 }
 
 static char *strip_comment(char *str)
@@ -186,54 +270,36 @@ static char *extract_value(char *line, bool is_value)
    tok = strtok_r(line, " \n\t\f\r\v", &save);
 
 end:
-   if (tok)
-      return strdup(tok);
-   return NULL;
+   return tok;
 }
 
 /* Move semantics? */
 static void add_child_list(config_file_t *parent, config_file_t *child)
 {
    struct config_entry_list *list = child->entries;
-   if (parent->entries)
-   {
-      struct config_entry_list *head = parent->entries;
-      while (head->next)
-         head = head->next;
 
-      /* set list readonly */
-      while (list)
-      {
-         list->readonly = true;
-         list           = list->next;
-      }
-      head->next        = child->entries;
-   }
-   else
+   if (list)
    {
+      if (parent->entries)
+         parent->tail->next = list;
+      else
+         parent->entries    = list;
+
+      parent->tail          = child->tail;
+
       /* set list readonly */
       while (list)
       {
          list->readonly = true;
+         config_index_add(parent, list);
          list           = list->next;
       }
-      parent->entries   = child->entries;
    }
 
    child->entries = NULL;
+   child->tail    = NULL;
 
-   /* Rebase tail. */
-   if (parent->entries)
-   {
-      struct config_entry_list *head = 
-         (struct config_entry_list*)parent->entries;
-
-      while (head->next)
-         head = head->next;
-      parent->tail = head;
-   }
-   else
-      parent->tail = NULL;
+   config_file_take_buffers(parent, child);
 }
 
 static void add_sub_conf(config_file_t *conf, char *path)
@@ -298,16 +364,9 @@ static void add_sub_conf(config_file_t *conf, char *path)
 static bool parse_line(config_file_t *conf,
       struct config_entry_list *list, char *line)
 {
-   char *comment   = NULL;
-   char *key_tmp   = NULL;
-   size_t cur_size = 8;
-   size_t idx      = 0;
-   char *key       = (char*)malloc(9);
-
-   if (!key)
-      return false;
-
-   comment = strip_comment(line);
+   char *key       = NULL;
+   char *key_end   = NULL;
+   char *comment   = strip_comment(line);
 
    /* Starting line with # and include includes config files. */
    if ((comment == line) && (conf->include_depth < MAX_INCLUDE_DEPTH))
@@ -318,8 +377,8 @@ static bool parse_line(config_file_t *conf,
          char *line = comment + strlen("include ");
          char *path = extract_value(line, false);
          if (path)
-            add_sub_conf(conf, path);
-         goto error;
+            add_sub_conf(conf, strdup(path));
+         return false;
       }
    }
    else if (conf->include_depth >= MAX_INCLUDE_DEPTH)
@@ -331,52 +390,160 @@ static bool parse_line(config_file_t *conf,
    while (isspace((int)*line))
       line++;
 
+   key = line;
    while (isgraph((int)*line))
+      line++;
+   key_end = line;
+
+   list->value = extract_value(line, true);
+   if (!list->value)
+      return false;
+
+   /* Only terminate the key once the value has been found,
+    * extract_value needs the space after it. */
+   *key_end       = '\0';
+   list->key      = key;
+   list->key_hash = djb2_calculate(key);
+
+   return true;
+}
+
+/**
+ * config_file_parse_buffer:
+ * @conf                 : config file to add the entries to.
+ * @data                 : file contents, NUL terminated.
+ *
+ * Parses a whole file in place. @data is owned by @conf
+ * afterwards, keys and values point into it and all entries
+ * come from one allocation.
+ *
+ * Returns: false (0) if out of memory, otherwise true (1).
+ **/
+static bool config_file_parse_buffer(config_file_t *conf, char *data)
+{
+   size_t lines                      = 1;
+   size_t used                       = 0;
+   char *line                        = data;
+   struct config_file_buffer *buffer = NULL;
+
+   for (line = data; *line; line++)
+      if (*line == '\n')
+         lines++;
+
+   buffer = (struct config_file_buffer*)malloc(sizeof(*buffer));
+   if (!buffer)
+   {
+      free(data);
+      return false;
+   }
+
+   buffer->data    = data;
+   buffer->entries = (struct config_entry_list*)
+      malloc(lines * sizeof(*buffer->entries));
+   buffer->next    = conf->buffers;
+   conf->buffers   = buffer;
+
+   if (!buffer->entries)
+      return false;
+
+   line            = data;
+
+   while (line)
    {
-      if (idx == cur_size)
+      struct config_entry_list *list = &buffer->entries[used];
+      char *next                     = strchr(line, '\n');
+      size_t len                     = 0;
+
+      if (next)
       {
-         cur_size *= 2;
-         key_tmp = (char*)realloc(key, cur_size + 1);
+         len     = next - line;
+         *next++ = '\0';
+      }
+      else
+         len     = strlen(line);
+
+      if (len && line[len - 1] == '\r')
+         line[len - 1] = '\0';
 
-         if (!key_tmp)
-            goto error;
+      list->readonly       = false;
+      list->buffered       = true;
+      list->value_buffered = true;
+      list->key_hash       = 0;
+      list->key            = NULL;
+      list->value          = NULL;
+      list->next           = NULL;
 
-         key = key_tmp;
+      if (*line && parse_line(conf, list, line))
+      {
+         config_file_add_entry(conf, list);
+         used++;
       }
 
-      key[idx++] = *line++;
+      line = next;
    }
-   key[idx] = '\0';
-   list->key = key;
-   list->key_hash = djb2_calculate(key);
 
-   list->value = extract_value(line, true);
-   if (!list->value)
-   {
-      list->key = NULL;
+   return true;
+}
+
+static char *config_file_read(const char *path)
+{
+   ssize_t len = 0;
+   char *data  = NULL;
+   RFILE *file = filestream_open(path, RFILE_MODE_READ, -1);
+
+   if (!file)
+      return NULL;
+
+   if (filestream_seek(file, 0, SEEK_END) != 0)
       goto error;
-   }
 
-   return true;
+   len = filestream_tell(file);
+   if (len < 0)
+      goto error;
+
+   filestream_rewind(file);
+
+   data = (char*)malloc(len + 1);
+   if (!data)
+      goto error;
+
+   len = filestream_read(file, data, len);
+   if (len < 0)
+      goto error;
+
+   data[len] = '\0';
+
+   filestream_close(file);
+   return data;
 
 error:
-   free(key);
-   return false;
+   free(data);
+   filestream_close(file);
+   return NULL;
+}
+
+static void config_file_init(config_file_t *conf)
+{
+   conf->path          = NULL;
+   conf->entries       = NULL;
+   conf->tail          = NULL;
+   conf->includes      = NULL;
+   conf->include_depth = 0;
+   conf->index         = NULL;
+   conf->index_size    = 0;
+   conf->index_count   = 0;
+   conf->buffers       = NULL;
 }
 
 static config_file_t *config_file_new_internal(
       const char *path, unsigned depth)
 {
-   RFILE              *file = NULL;
+   char *data               = NULL;
    struct config_file *conf = (struct config_file*)malloc(sizeof(*conf));
    if (!conf)
       return NULL;
 
-   conf->path          = NULL;
-   conf->entries       = NULL;
-   conf->tail          = NULL;
-   conf->includes      = NULL;
-   conf->include_depth = 0;
+   config_file_init(conf);
 
    if (!path || !*path)
       return conf;
@@ -389,59 +556,20 @@ static config_file_t *config_file_new_internal(
       goto error;
 
    conf->include_depth = depth;
-   file                = filestream_open(path, RFILE_MODE_READ_TEXT, -1);
+   data                = config_file_read(path);
 
-   if (!file)
+   if (!data)
    {
       free(conf->path);
       goto error;
    }
-   setvbuf(filestream_get_fp(file), NULL, _IOFBF, 0x4000);
 
-   while (!filestream_eof(file))
+   if (!config_file_parse_buffer(conf, data))
    {
-      char *line                     = NULL;
-      struct config_entry_list *list = (struct config_entry_list*)malloc(sizeof(*list));
-
-      if (!list)
-      {
-         config_file_free(conf);
-         filestream_close(file);
-         return NULL;
-      }
-
-      list->readonly  = false;
-      list->key_hash  = 0;
-      list->key       = NULL;
-      list->value     = NULL;
-      list->next      = NULL;
-
-      line            = getaline(file);
-
-      if (!line)
-      {
-         free(list);
-         continue;
-      }
-
-      if (*line && parse_line(conf, list, line))
-      {
-         if (conf->entries)
-            conf->tail->next = list;
-         else
-            conf->entries = list;
-
-         conf->tail = list;
-      }
-
-      free(line);
-
-      if (list != conf->tail)
-         free(list);
+      config_file_free(conf);
+      return NULL;
    }
 
-   filestream_close(file);
-
    return conf;
 
 error:
@@ -454,6 +582,7 @@ void config_file_free(config_file_t *conf)
 {
    struct config_include_list *inc_tmp = NULL;
    struct config_entry_list *tmp       = NULL;
+   struct config_file_buffer *buffer   = NULL;
    if (!conf)
       return;
 
@@ -461,19 +590,30 @@ void config_file_free(config_file_t *conf)
    while (tmp)
    {
       struct config_entry_list *hold = NULL;
-      if (tmp->key)
-         free(tmp->key);
-      if (tmp->value)
+      if (!tmp->value_buffered && tmp->value)
          free(tmp->value);
 
       tmp->value = NULL;
-      tmp->key   = NULL;
 
       hold       = tmp;
       tmp        = tmp->next;
 
-      if (hold)
+      if (!hold->buffered)
+      {
+         if (hold->key)
+            free(hold->key);
          free(hold);
+      }
+   }
+
+   buffer = conf->buffers;
+   while (buffer)
+   {
+      struct config_file_buffer *hold = buffer;
+      buffer = buffer->next;
+      free(hold->data);
+      free(hold->entries);
+      free(hold);
    }
 
    inc_tmp = (struct config_include_list*)conf->includes;
@@ -488,6 +628,7 @@ void config_file_free(config_file_t *conf)
 
    if (conf->path)
       free(conf->path);
+   free(conf->index);
    free(conf);
 }
 
@@ -500,8 +641,14 @@ bool config_append_file(config_file_t *conf, const char *path)
    if (new_conf->tail)
    {
       new_conf->tail->next = conf->entries;
+      if (!conf->entries)
+         conf->tail        = new_conf->tail;
       conf->entries        = new_conf->entries; /* Pilfer. */
       new_conf->entries    = NULL;
+      new_conf->tail       = NULL;
+
+      config_file_take_buffers(conf, new_conf);
+      config_index_rebuild(conf);
    }
 
    config_file_free(new_conf);
@@ -511,62 +658,23 @@ bool config_append_file(config_file_t *conf, const char *path)
 
 config_file_t *config_file_new_from_string(const char *from_string)
 {
-   size_t i;
-   struct string_list *lines = NULL;
+   char *data               = NULL;
    struct config_file *conf = (struct config_file*)malloc(sizeof(*conf));
    if (!conf)
       return NULL;
 
-   if (!from_string)
-      return conf;
+   config_file_init(conf);
 
-   conf->path          = NULL;
-   conf->entries       = NULL;
-   conf->tail          = NULL;
-   conf->includes      = NULL;
-   conf->include_depth = 0;
-   
-   lines = string_split(from_string, "\n");
-   if (!lines)
+   if (!from_string)
       return conf;
 
-   for (i = 0; i < lines->size; i++)
+   data = strdup(from_string);
+   if (!data || !config_file_parse_buffer(conf, data))
    {
-      struct config_entry_list *list = (struct config_entry_list*)malloc(sizeof(*list));
-      char                    *line  = lines->elems[i].data;
-
-      if (!list)
-      {
-         string_list_free(lines);
-         config_file_free(conf);
-         return NULL;
-      }
-
-      list->readonly  = false;
-      list->key_hash  = 0;
-      list->key       = NULL;
-      list->value     = NULL;
-      list->next      = NULL;
-
-      if (line && conf)
-      {
-         if (*line && parse_line(conf, list, line))
-         {
-            if (conf->entries)
-               conf->tail->next = list;
-            else
-               conf->entries = list;
-
-            conf->tail = list;
-         }
-      }
-
-      if (list != conf->tail)
-         free(list);
+      config_file_free(conf);
+      return NULL;
    }
 
-   string_list_free(lines);
-
    return conf;
 }
 
@@ -576,33 +684,31 @@ config_file_t *config_file_new(const char *path)
 }
 
 static struct config_entry_list *config_get_entry(const config_file_t *conf,
-      const char *key, struct config_entry_list **prev)
+      const char *key)
 {
-   struct config_entry_list *entry;
-   struct config_entry_list *previous = NULL;
+   size_t i, mask;
+   uint32_t hash;
 
-   uint32_t hash = djb2_calculate(key);
+   if (!conf->index_size)
+      return NULL;
 
-   if (prev)
-      previous = *prev;
+   hash = djb2_calculate(key);
+   mask = conf->index_size - 1;
 
-   for (entry = conf->entries; entry; entry = entry->next)
+   for (i = hash & mask; conf->index[i]; i = (i + 1) & mask)
    {
+      struct config_entry_list *entry = conf->index[i];
+
       if (hash == entry->key_hash && string_is_equal(key, entry->key))
          return entry;
-
-      previous = entry;
    }
 
-   if (prev)
-      *prev = previous;
-
    return NULL;
 }
 
 bool config_get_double(config_file_t *conf, const char *key, double *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
    {
@@ -615,7 +721,7 @@ bool config_get_double(config_file_t *conf, const char *key, double *in)
 
 bool config_get_float(config_file_t *conf, const char *key, float *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
    {
@@ -628,7 +734,7 @@ bool config_get_float(config_file_t *conf, const char *key, float *in)
 
 bool config_get_int(config_file_t *conf, const char *key, int *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
    errno = 0;
 
    if (entry)
@@ -648,7 +754,7 @@ bool config_get_int(config_file_t *conf, const char *key, int *in)
 #if defined(__STDC_VERSION__) && __STDC_VERSION__>=199901L
 bool config_get_uint64(config_file_t *conf, const char *key, uint64_t *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
    errno = 0;
 
    if (entry)
@@ -667,7 +773,7 @@ bool config_get_uint64(config_file_t *conf, const char *key, uint64_t *in)
 
 bool config_get_uint(config_file_t *conf, const char *key, unsigned *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
    errno = 0;
 
    if (entry)
@@ -686,7 +792,7 @@ bool config_get_uint(config_file_t *conf, const char *key, unsigned *in)
 
 bool config_get_hex(config_file_t *conf, const char *key, unsigned *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
    errno = 0;
 
    if (entry)
@@ -705,7 +811,7 @@ bool config_get_hex(config_file_t *conf, const char *key, unsigned *in)
 
 bool config_get_char(config_file_t *conf, const char *key, char *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
    {
@@ -721,7 +827,7 @@ bool config_get_char(config_file_t *conf, const char *key, char *in)
 
 bool config_get_string(config_file_t *conf, const char *key, char **str)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
    {
@@ -742,7 +848,7 @@ bool config_get_config_path(config_file_t *conf, char *s, size_t len)
 bool config_get_array(config_file_t *conf, const char *key,
       char *buf, size_t size)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
       return strlcpy(buf, entry->value, size) < size;
@@ -756,7 +862,7 @@ bool config_get_path(config_file_t *conf, const char *key,
    if (config_get_array(conf, key, buf, size))
       return true;
 #else
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
    {
@@ -769,7 +875,7 @@ bool config_get_path(config_file_t *conf, const char *key,
 
 bool config_get_bool(config_file_t *conf, const char *key, bool *in)
 {
-   const struct config_entry_list *entry = config_get_entry(conf, key, NULL);
+   const struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry)
    {
@@ -790,13 +896,19 @@ bool config_get_bool(config_file_t *conf, const char *key, bool *in)
 
 void config_set_string(config_file_t *conf, const char *key, const char *val)
 {
-   struct config_entry_list *last  = conf->entries;
-   struct config_entry_list *entry = config_get_entry(conf, key, &last);
+   struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (entry && !entry->readonly)
    {
-      free(entry->value);
-      entry->value = strdup(val);
+      /* Saving the config sets every key, mostly to what
+       * it already is. */
+      if (val && string_is_equal(entry->value, val))
+         return;
+
+      if (!entry->value_buffered)
+         free(entry->value);
+      entry->value          = strdup(val);
+      entry->value_buffered = false;
       return;
    }
 
@@ -807,30 +919,33 @@ void config_set_string(config_file_t *conf, const char *key, const char *val)
    if (!entry)
       return;
 
-   entry->readonly  = false;
-   entry->key_hash  = 0;
-   entry->key       = strdup(key);
-   entry->value     = strdup(val);
-   entry->next      = NULL;
+   entry->readonly       = false;
+   entry->buffered       = false;
+   entry->value_buffered = false;
+   entry->key_hash       = djb2_calculate(key);
+   entry->key            = strdup(key);
+   entry->value          = strdup(val);
+   entry->next           = NULL;
 
-   if (last)
-      last->next    = entry;
-   else
-      conf->entries = entry;
+   config_file_add_entry(conf, entry);
 }
 
 void config_unset(config_file_t *conf, const char *key)
 {
-   struct config_entry_list *last  = conf->entries;
-   struct config_entry_list *entry = config_get_entry(conf, key, &last);
+   struct config_entry_list *entry = config_get_entry(conf, key);
 
    if (!entry)
       return;
 
+   if (!entry->buffered)
+      free(entry->key);
+   if (!entry->value_buffered)
+      free(entry->value);
    entry->key   = NULL;
    entry->value = NULL;
-   free(entry->key);
-   free(entry->value);
+
+   /* A later entry with the same key shows through now. */
+   config_index_rebuild(conf);
 }
 
 void config_set_path(config_file_t *conf, const char *entry, const char *val)
@@ -960,16 +1075,7 @@ void config_file_dump(config_file_t *conf, FILE *file)
 
 bool config_entry_exists(config_file_t *conf, const char *entry)
 {
-   struct config_entry_list *list = conf->entries;
-
-   while (list)
-   {
-      if (string_is_equal(entry, list->key))
-         return true;
-      list = list->next;
-   }
-
-   return false;
+   return config_get_entry(conf, entry) != NULL;
 }
 
 bool config_get_entry_list_head(config_file_t *conf,
@@ -104,7 +104,8 @@ enum stat_mode
    IS_VALID
 };
 
-static bool path_stat(const char *path, enum stat_mode mode, int32_t *size)
+static bool path_stat(const char *path, enum stat_mode mode,
+      int32_t *size, int64_t *mtime)
 {
 #if defined(VITA) || defined(PSP)
    SceIoStat buf;
@@ -166,6 +167,15 @@ static bool path_stat(const char *path, enum stat_mode mode, int32_t *size)
    if (size)
       *size = (int32_t)buf.st_size;
 
+   if (mtime)
+   {
+#if defined(VITA) || defined(PSP) || defined(__CELLOS_LV2__)
+      *mtime = -1;
+#else
+      *mtime = (int64_t)buf.st_mtime;
+#endif
+   }
+
    switch (mode)
    {
       case IS_DIRECTORY:
@@ -201,28 +211,37 @@ static bool path_stat(const char *path, enum stat_mode mode, int32_t *size)
  */
 bool path_is_directory(const char *path)
 {
-   return path_stat(path, IS_DIRECTORY, NULL);
+   return path_stat(path, IS_DIRECTORY, NULL, NULL);
 }
 
 bool path_is_character_special(const char *path)
 {
-   return path_stat(path, IS_CHARACTER_SPECIAL, NULL);
+   return path_stat(path, IS_CHARACTER_SPECIAL, NULL, NULL);
 }
 
 bool path_is_valid(const char *path)
 {
-   return path_stat(path, IS_VALID, NULL);
+   return path_stat(path, IS_VALID, NULL, NULL);
 }
 
 int32_t path_get_size(const char *path)
 {
    int32_t filesize = 0;
-   if (path_stat(path, IS_VALID, &filesize))
+   if (path_stat(path, IS_VALID, &filesize, NULL))
       return filesize;
 
    return -1;
 }
 
+int64_t path_get_modified_time(const char *path, int32_t *size)
+{
+   int64_t mtime = -1;
+   if (path_stat(path, IS_VALID, size, &mtime))
+      return mtime;
+
+   return -1;
+}
+
 /**
  * path_mkdir:
  * @dir                : directory
@@ -990,7 +1009,7 @@ bool path_file_rename(const char *old_path, const char *new_path)
          int ret = rename(old_path_local, new_path_local);
          free(old_path_local);
          free(new_path_local);
-         return ret;
+         return ret == 0;
       }
 
       free(old_path_local);
@@ -1009,7 +1028,7 @@ bool path_file_rename(const char *old_path, const char *new_path)
          int ret = _wrename(old_path_wide, new_path_wide);
          free(old_path_wide);
          free(new_path_wide);
-         return ret;
+         return ret == 0;
       }
 
       free(old_path_wide);
@@ -327,6 +327,17 @@ bool gl_check_capability(enum gl_capability_enum enum_idx)
 #else
          if (gl_query_extension("EXT_texture_storage"))
             return true;
+#endif
+         break;
+      case GL_CAPS_PROGRAM_BINARY:
+#ifdef HAVE_OPENGLES
+         if (major >= 3)
+            return true;
+#else
+         if (major > 4 || (major == 4 && minor >= 1))
+            return true;
+         if (gl_query_extension("ARB_get_program_binary"))
+            return true;
 #endif
          break;
       case GL_CAPS_NONE:
@@ -26,17 +26,632 @@
 #include <string.h>
 
 #include <retro_inline.h>
+#include <retro_simd.h>
+#include <features/features_cpu.h>
 
 #include <gfx/scaler/pixconv.h>
 
 #ifdef SCALER_NO_SIMD
 #undef __SSE2__
+#undef RETRO_HAVE_AVX2
+#undef RETRO_HAVE_NEON
 #endif
 
 #if defined(__SSE2__)
 #include <emmintrin.h>
 #endif
 
+/* Converts the longest prefix of a row the SIMD kernel can,
+ * and returns its length. The callers finish the row with
+ * their SSE2 and C loops. */
+#if defined(RETRO_HAVE_AVX2)
+#define CONV_SIMD_ROW(name, simd, out, in, width) \
+   (((simd) & RETRO_SIMD_AVX2) ? name##_avx2(out, in, width) : 0)
+#elif defined(RETRO_HAVE_NEON)
+#define CONV_SIMD_ROW(name, simd, out, in, width) \
+   (((simd) & RETRO_SIMD_NEON) ? name##_neon(out, in, width) : 0)
+#else
+#define CONV_SIMD_ROW(name, simd, out, in, width) ((void)(simd), 0)
+#endif
+
+#define YUV_SHIFT 6
+#define YUV_OFFSET (1 << (YUV_SHIFT - 1))
+#define YUV_MAT_Y (1 << 6)
+#define YUV_MAT_U_G (-22)
+#define YUV_MAT_U_B (113)
+#define YUV_MAT_V_R (90)
+#define YUV_MAT_V_G (-46)
+
+static uint64_t conv_simd_mask = ~(uint64_t)0;
+
+static uint64_t conv_simd_flags(void)
+{
+   return cpu_features_get_simd() & conv_simd_mask;
+}
+
+void conv_set_simd_mask(uint64_t mask)
+{
+   conv_simd_mask = mask;
+}
+
+#if defined(RETRO_HAVE_AVX2)
+/* Unpacking works within 128-bit lanes, so the two results
+ * are put back in pixel order at the end. */
+static INLINE RETRO_TARGET_AVX2 void conv_pack_argb8888_avx2(
+      __m256i r, __m256i g, __m256i b, __m256i *px0, __m256i *px1)
+{
+   const __m256i a    = _mm256_set1_epi16(0x00ff);
+   __m256i res_lo     = _mm256_or_si256(_mm256_unpacklo_epi8(b, g),
+         _mm256_slli_si256(_mm256_unpacklo_epi8(r, a), 2));
+   __m256i res_hi     = _mm256_or_si256(_mm256_unpackhi_epi8(b, g),
+         _mm256_slli_si256(_mm256_unpackhi_epi8(r, a), 2));
+
+   *px0               = _mm256_permute2x128_si256(res_lo, res_hi, 0x20);
+   *px1               = _mm256_permute2x128_si256(res_lo, res_hi, 0x31);
+}
+
+static INLINE RETRO_TARGET_AVX2 void conv_store_bgr24_avx2(
+      uint8_t *output, __m256i argb)
+{
+   const __m256i shuffle = _mm256_setr_epi8(
+         0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+         0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+   const __m256i order   = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+   __m256i packed        = _mm256_permutevar8x32_epi32(
+         _mm256_shuffle_epi8(argb, shuffle), order);
+
+   /* 24 bytes, don't write past the end of the row. */
+   _mm_storeu_si128((__m128i*)output, _mm256_castsi256_si128(packed));
+   _mm_storel_epi64((__m128i*)(output + 16),
+         _mm256_extracti128_si256(packed, 1));
+}
+
+static INLINE RETRO_TARGET_AVX2 void conv_unpack_0rgb1555_avx2(
+      __m256i in, __m256i *r, __m256i *g, __m256i *b)
+{
+   const __m256i pix_mask_r  = _mm256_set1_epi16(0x1f << 10);
+   const __m256i pix_mask_gb = _mm256_set1_epi16(0x1f <<  5);
+   const __m256i mul15_mid   = _mm256_set1_epi16(0x4200);
+   const __m256i mul15_hi    = _mm256_set1_epi16(0x0210);
+
+   *r = _mm256_mulhi_epi16(_mm256_and_si256(in, pix_mask_r), mul15_hi);
+   *g = _mm256_mulhi_epi16(_mm256_and_si256(in, pix_mask_gb), mul15_mid);
+   *b = _mm256_mulhi_epi16(_mm256_and_si256(
+            _mm256_slli_epi16(in, 5), pix_mask_gb), mul15_mid);
+}
+
+static INLINE RETRO_TARGET_AVX2 void conv_unpack_rgb565_avx2(
+      __m256i in, __m256i *r, __m256i *g, __m256i *b)
+{
+   const __m256i pix_mask_r = _mm256_set1_epi16(0x1f << 10);
+   const __m256i pix_mask_g = _mm256_set1_epi16(0x3f <<  5);
+   const __m256i pix_mask_b = _mm256_set1_epi16(0x1f <<  5);
+   const __m256i mul16_r    = _mm256_set1_epi16(0x0210);
+   const __m256i mul16_g    = _mm256_set1_epi16(0x2080);
+   const __m256i mul16_b    = _mm256_set1_epi16(0x4200);
+
+   *r = _mm256_mulhi_epi16(_mm256_and_si256(
+            _mm256_srli_epi16(in, 1), pix_mask_r), mul16_r);
+   *g = _mm256_mulhi_epi16(_mm256_and_si256(in, pix_mask_g), mul16_g);
+   *b = _mm256_mulhi_epi16(_mm256_and_si256(
+            _mm256_slli_epi16(in, 5), pix_mask_b), mul16_b);
+}
+
+static RETRO_TARGET_AVX2 int conv_rgb565_0rgb1555_avx2(
+      uint16_t *output, const uint16_t *input, int width)
+{
+   int w                 = 0;
+   const __m256i hi_mask = _mm256_set1_epi16(0x7fe0);
+   const __m256i lo_mask = _mm256_set1_epi16(0x1f);
+
+   for (; w + 16 <= width; w += 16)
+   {
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i hi       = _mm256_and_si256(_mm256_srli_epi16(in, 1), hi_mask);
+      __m256i lo       = _mm256_and_si256(in, lo_mask);
+      _mm256_storeu_si256((__m256i*)(output + w), _mm256_or_si256(hi, lo));
+   }
+
+   return w;
+}
+
+static RETRO_TARGET_AVX2 int conv_0rgb1555_rgb565_avx2(
+      uint16_t *output, const uint16_t *input, int width)
+{
+   int w                   = 0;
+   const __m256i hi_mask   = _mm256_set1_epi16(
+         (int16_t)((0x1f << 11) | (0x1f << 6)));
+   const __m256i lo_mask   = _mm256_set1_epi16(0x1f);
+   const __m256i glow_mask = _mm256_set1_epi16(1 << 5);
+
+   for (; w + 16 <= width; w += 16)
+   {
+      const __m256i in = _mm256_loadu_si256((const __m256i*)(input + w));
+      __m256i rg       = _mm256_and_si256(_mm256_slli_epi16(in, 1), hi_mask);
+      __m256i b        = _mm256_and_si256(in, lo_mask);
+      __m256i glow     = _mm256_and_si256(_mm256_srli_epi16(in, 4), glow_mask);
+      _mm256_storeu_si256((__m256i*)(output + w),
+            _mm256_or_si256(rg, _mm256_or_si256(b, glow)));
+   }
+
+   return w;
+}
+
+static RETRO_TARGET_AVX2 int conv_0rgb1555_argb8888_avx2(
+      uint32_t *output, const uint16_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 16 <= width; w += 16)
+   {
+      __m256i r, g, b, px0, px1;
+      conv_unpack_0rgb1555_avx2(
+            _mm256_loadu_si256((const __m256i*)(input + w)), &r, &g, &b);
+      conv_pack_argb8888_avx2(r, g, b, &px0, &px1);
+      _mm256_storeu_si256((__m256i*)(output + w + 0), px0);
+      _mm256_storeu_si256((__m256i*)(output + w + 8), px1);
+   }
+
+   return w;
+}
+
+static RETRO_TARGET_AVX2 int conv_rgb565_argb8888_avx2(
+      uint32_t *output, const uint16_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 16 <= width; w += 16)
+   {
+      __m256i r, g, b, px0, px1;
+      conv_unpack_rgb565_avx2(
+            _mm256_loadu_si256((const __m256i*)(input + w)), &r, &g, &b);
+      conv_pack_argb8888_avx2(r, g, b, &px0, &px1);
+      _mm256_storeu_si256((__m256i*)(output + w + 0), px0);
+      _mm256_storeu_si256((__m256i*)(output + w + 8), px1);
+   }
+
+   return w;
+}
+
+static RETRO_TARGET_AVX2 int conv_0rgb1555_bgr24_avx2(
+      uint8_t *output, const uint16_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 16 <= width; w += 16)
+   {
+      __m256i r, g, b, px0, px1;
+      conv_unpack_0rgb1555_avx2(
+            _mm256_loadu_si256((const __m256i*)(input + w)), &r, &g, &b);
+      conv_pack_argb8888_avx2(r, g, b, &px0, &px1);
+      conv_store_bgr24_avx2(output + w * 3 +  0, px0);
+      conv_store_bgr24_avx2(output + w * 3 + 24, px1);
+   }
+
+   return w;
+}
+
+static RETRO_TARGET_AVX2 int conv_rgb565_bgr24_avx2(
+      uint8_t *output, const uint16_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 16 <= width; w += 16)
+   {
+      __m256i r, g, b, px0, px1;
+      conv_unpack_rgb565_avx2(
+            _mm256_loadu_si256((const __m256i*)(input + w)), &r, &g, &b);
+      conv_pack_argb8888_avx2(r, g, b, &px0, &px1);
+      conv_store_bgr24_avx2(output + w * 3 +  0, px0);
+      conv_store_bgr24_avx2(output + w * 3 + 24, px1);
+   }
+
+   return w;
+}
+
+static RETRO_TARGET_AVX2 int conv_argb8888_bgr24_avx2(
+      uint8_t *output, const uint32_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 8 <= width; w += 8)
+      conv_store_bgr24_avx2(output + w * 3,
+            _mm256_loadu_si256((const __m256i*)(input + w)));
+
+   return w;
+}
+
+static RETRO_TARGET_AVX2 int conv_bgr24_argb8888_avx2(
+      uint32_t *output, const uint8_t *input, int width)
+{
+   int w                 = 0;
+   const __m256i shuffle = _mm256_setr_epi8(
+         0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+         0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+   const __m256i a       = _mm256_set1_epi32((int)0xff000000u);
+
+   /* The second load reads 4 bytes past the 8 pixels. */
+   for (; w + 10 <= width; w += 8)
+   {
+      const uint8_t *in = input + w * 3;
+      __m256i bgr       = _mm256_inserti128_si256(_mm256_castsi128_si256(
+               _mm_loadu_si128((const __m128i*)(in + 0))),
+            _mm_loadu_si128((const __m128i*)(in + 12)), 1);
+      _mm256_storeu_si256((__m256i*)(output + w),
+            _mm256_or_si256(_mm256_shuffle_epi8(bgr, shuffle), a));
+   }
+
+   return w;
+}
+
+static RETRO_TARGET_AVX2 int conv_argb8888_0rgb1555_avx2(
+      uint16_t *output, const uint32_t *input, int width)
+{
+   int w                = 0;
+   const __m256i mask_r = _mm256_set1_epi32(0x1f << 10);
+   const __m256i mask_g = _mm256_set1_epi32(0x1f <<  5);
+   const __m256i mask_b = _mm256_set1_epi32(0x1f <<  0);
+
+   for (; w + 16 <= width; w += 16)
+   {
+      __m256i res0, res1;
+      const __m256i in0 = _mm256_loadu_si256((const __m256i*)(input + w + 0));
+      const __m256i in1 = _mm256_loadu_si256((const __m256i*)(input + w + 8));
+
+      res0 = _mm256_or_si256(
+            _mm256_and_si256(_mm256_srli_epi32(in0, 9), mask_r),
+            _mm256_or_si256(
+               _mm256_and_si256(_mm256_srli_epi32(in0, 6), mask_g),
+               _mm256_and_si256(_mm256_srli_epi32(in0, 3), mask_b)));
+      res1 = _mm256_or_si256(
+            _mm256_and_si256(_mm256_srli_epi32(in1, 9), mask_r),
+            _mm256_or_si256(
+               _mm256_and_si256(_mm256_srli_epi32(in1, 6), mask_g),
+               _mm256_and_si256(_mm256_srli_epi32(in1, 3), mask_b)));
+
+      /* Packing interleaves the lanes of both inputs. */
+      _mm256_storeu_si256((__m256i*)(output + w), _mm256_permute4x64_epi64(
+               _mm256_packus_epi32(res0, res1), 0xd8));
+   }
+
+   return w;
+}
+
+static RETRO_TARGET_AVX2 int conv_argb8888_abgr8888_avx2(
+      uint32_t *output, const uint32_t *input, int width)
+{
+   int w                 = 0;
+   const __m256i shuffle = _mm256_setr_epi8(
+         2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+         2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+   for (; w + 8 <= width; w += 8)
+      _mm256_storeu_si256((__m256i*)(output + w), _mm256_shuffle_epi8(
+               _mm256_loadu_si256((const __m256i*)(input + w)), shuffle));
+
+   return w;
+}
+
+static RETRO_TARGET_AVX2 int conv_yuyv_argb8888_avx2(
+      uint32_t *output, const uint8_t *input, int width)
+{
+   int w                       = 0;
+   const __m256i mask_y        = _mm256_set1_epi16(0xff);
+   const __m256i mask_u        = _mm256_set1_epi32(0xff << 8);
+   const __m256i chroma_offset = _mm256_set1_epi16(128);
+   const __m256i round_offset  = _mm256_set1_epi16(YUV_OFFSET);
+   const __m256i yuv_mul       = _mm256_set1_epi16(YUV_MAT_Y);
+   const __m256i u_g_mul       = _mm256_set1_epi16(YUV_MAT_U_G);
+   const __m256i u_b_mul       = _mm256_set1_epi16(YUV_MAT_U_B);
+   const __m256i v_r_mul       = _mm256_set1_epi16(YUV_MAT_V_R);
+   const __m256i v_g_mul       = _mm256_set1_epi16(YUV_MAT_V_G);
+   const __m256i max           = _mm256_set1_epi16(0xff);
+   const __m256i zero          = _mm256_setzero_si256();
+   const __m256i a             = _mm256_set1_epi16((int16_t)0xff00);
+
+   for (; w + 16 <= width; w += 16)
+   {
+      __m256i r, g, b, bg, ra, res_lo, res_hi;
+      /* [Y0, U0, Y1, V0, Y2, U1, Y3, V1, ...] */
+      const __m256i yuv = _mm256_loadu_si256((const __m256i*)(input + w * 2));
+      __m256i y         = _mm256_and_si256(yuv, mask_y);
+      __m256i u         = _mm256_srli_epi32(_mm256_and_si256(yuv, mask_u), 8);
+      __m256i v         = _mm256_srli_epi32(yuv, 24);
+
+      /* Both pixels of a pair get its chroma (nearest). */
+      u = _mm256_sub_epi16(_mm256_or_si256(u, _mm256_slli_epi32(u, 16)),
+            chroma_offset);
+      v = _mm256_sub_epi16(_mm256_or_si256(v, _mm256_slli_epi32(v, 16)),
+            chroma_offset);
+      y = _mm256_mullo_epi16(y, yuv_mul);
+
+      r = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(y,
+                  _mm256_mullo_epi16(v, v_r_mul)), round_offset), YUV_SHIFT);
+      g = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(
+                  _mm256_adds_epi16(y, _mm256_mullo_epi16(v, v_g_mul)),
+                  _mm256_mullo_epi16(u, u_g_mul)), round_offset), YUV_SHIFT);
+      b = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(y,
+                  _mm256_mullo_epi16(u, u_b_mul)), round_offset), YUV_SHIFT);
+
+      r = _mm256_min_epi16(_mm256_max_epi16(r, zero), max);
+      g = _mm256_min_epi16(_mm256_max_epi16(g, zero), max);
+      b = _mm256_min_epi16(_mm256_max_epi16(b, zero), max);
+
+      bg     = _mm256_or_si256(b, _mm256_slli_epi16(g, 8));
+      ra     = _mm256_or_si256(r, a);
+      res_lo = _mm256_unpacklo_epi16(bg, ra);
+      res_hi = _mm256_unpackhi_epi16(bg, ra);
+
+      _mm256_storeu_si256((__m256i*)(output + w + 0),
+            _mm256_permute2x128_si256(res_lo, res_hi, 0x20));
+      _mm256_storeu_si256((__m256i*)(output + w + 8),
+            _mm256_permute2x128_si256(res_lo, res_hi, 0x31));
+   }
+
+   return w;
+}
+#endif
+
+#if defined(RETRO_HAVE_NEON)
+static INLINE uint8x8_t conv_expand5_neon(uint8x8_t v)
+{
+   return vorr_u8(vshl_n_u8(v, 3), vshr_n_u8(v, 2));
+}
+
+static INLINE uint8x8_t conv_expand6_neon(uint8x8_t v)
+{
+   return vorr_u8(vshl_n_u8(v, 2), vshr_n_u8(v, 4));
+}
+
+static INLINE uint8x8x3_t conv_unpack_0rgb1555_neon(uint16x8_t in)
+{
+   uint8x8x3_t bgr;
+   const uint8x8_t mask = vdup_n_u8(0x1f);
+
+   bgr.val[0] = conv_expand5_neon(vand_u8(vmovn_u16(in), mask));
+   bgr.val[1] = conv_expand5_neon(vand_u8(vmovn_u16(vshrq_n_u16(in, 5)), mask));
+   bgr.val[2] = conv_expand5_neon(vand_u8(vmovn_u16(vshrq_n_u16(in, 10)), mask));
+   return bgr;
+}
+
+static INLINE uint8x8x3_t conv_unpack_rgb565_neon(uint16x8_t in)
+{
+   uint8x8x3_t bgr;
+
+   bgr.val[0] = conv_expand5_neon(vand_u8(vmovn_u16(in), vdup_n_u8(0x1f)));
+   bgr.val[1] = conv_expand6_neon(vand_u8(vmovn_u16(vshrq_n_u16(in, 5)),
+            vdup_n_u8(0x3f)));
+   bgr.val[2] = conv_expand5_neon(vmovn_u16(vshrq_n_u16(in, 11)));
+   return bgr;
+}
+
+static int conv_rgb565_0rgb1555_neon(
+      uint16_t *output, const uint16_t *input, int width)
+{
+   int w                    = 0;
+   const uint16x8_t hi_mask = vdupq_n_u16(0x7fe0);
+   const uint16x8_t lo_mask = vdupq_n_u16(0x1f);
+
+   for (; w + 8 <= width; w += 8)
+   {
+      uint16x8_t in = vld1q_u16(input + w);
+      vst1q_u16(output + w, vorrq_u16(
+               vandq_u16(vshrq_n_u16(in, 1), hi_mask),
+               vandq_u16(in, lo_mask)));
+   }
+
+   return w;
+}
+
+static int conv_0rgb1555_rgb565_neon(
+      uint16_t *output, const uint16_t *input, int width)
+{
+   int w                      = 0;
+   const uint16x8_t hi_mask   = vdupq_n_u16((0x1f << 11) | (0x1f << 6));
+   const uint16x8_t lo_mask   = vdupq_n_u16(0x1f);
+   const uint16x8_t glow_mask = vdupq_n_u16(1 << 5);
+
+   for (; w + 8 <= width; w += 8)
+   {
+      uint16x8_t in = vld1q_u16(input + w);
+      vst1q_u16(output + w, vorrq_u16(
+               vandq_u16(vshlq_n_u16(in, 1), hi_mask),
+               vorrq_u16(vandq_u16(in, lo_mask),
+                  vandq_u16(vshrq_n_u16(in, 4), glow_mask))));
+   }
+
+   return w;
+}
+
+static int conv_0rgb1555_argb8888_neon(
+      uint32_t *output, const uint16_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 8 <= width; w += 8)
+   {
+      uint8x8x4_t argb;
+      uint8x8x3_t bgr = conv_unpack_0rgb1555_neon(vld1q_u16(input + w));
+
+      argb.val[0]     = bgr.val[0];
+      argb.val[1]     = bgr.val[1];
+      argb.val[2]     = bgr.val[2];
+      argb.val[3]     = vdup_n_u8(0xff);
+      vst4_u8((uint8_t*)(output + w), argb);
+   }
+
+   return w;
+}
+
+static int conv_rgb565_argb8888_neon(
+      uint32_t *output, const uint16_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 8 <= width; w += 8)
+   {
+      uint8x8x4_t argb;
+      uint8x8x3_t bgr = conv_unpack_rgb565_neon(vld1q_u16(input + w));
+
+      argb.val[0]     = bgr.val[0];
+      argb.val[1]     = bgr.val[1];
+      argb.val[2]     = bgr.val[2];
+      argb.val[3]     = vdup_n_u8(0xff);
+      vst4_u8((uint8_t*)(output + w), argb);
+   }
+
+   return w;
+}
+
+static int conv_0rgb1555_bgr24_neon(
+      uint8_t *output, const uint16_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 8 <= width; w += 8)
+      vst3_u8(output + w * 3, conv_unpack_0rgb1555_neon(vld1q_u16(input + w)));
+
+   return w;
+}
+
+static int conv_rgb565_bgr24_neon(
+      uint8_t *output, const uint16_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 8 <= width; w += 8)
+      vst3_u8(output + w * 3, conv_unpack_rgb565_neon(vld1q_u16(input + w)));
+
+   return w;
+}
+
+static int conv_argb8888_bgr24_neon(
+      uint8_t *output, const uint32_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 16 <= width; w += 16)
+   {
+      uint8x16x3_t bgr;
+      uint8x16x4_t argb = vld4q_u8((const uint8_t*)(input + w));
+
+      bgr.val[0]        = argb.val[0];
+      bgr.val[1]        = argb.val[1];
+      bgr.val[2]        = argb.val[2];
+      vst3q_u8(output + w * 3, bgr);
+   }
+
+   return w;
+}
+
+static int conv_bgr24_argb8888_neon(
+      uint32_t *output, const uint8_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 16 <= width; w += 16)
+   {
+      uint8x16x4_t argb;
+      uint8x16x3_t bgr = vld3q_u8(input + w * 3);
+
+      argb.val[0]      = bgr.val[0];
+      argb.val[1]      = bgr.val[1];
+      argb.val[2]      = bgr.val[2];
+      argb.val[3]      = vdupq_n_u8(0xff);
+      vst4q_u8((uint8_t*)(output + w), argb);
+   }
+
+   return w;
+}
+
+static int conv_argb8888_0rgb1555_neon(
+      uint16_t *output, const uint32_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 8 <= width; w += 8)
+   {
+      uint8x8x4_t argb = vld4_u8((const uint8_t*)(input + w));
+      uint16x8_t r     = vshlq_n_u16(vmovl_u8(vshr_n_u8(argb.val[2], 3)), 10);
+      uint16x8_t g     = vshlq_n_u16(vmovl_u8(vshr_n_u8(argb.val[1], 3)), 5);
+      uint16x8_t b     = vmovl_u8(vshr_n_u8(argb.val[0], 3));
+
+      vst1q_u16(output + w, vorrq_u16(r, vorrq_u16(g, b)));
+   }
+
+   return w;
+}
+
+static int conv_argb8888_abgr8888_neon(
+      uint32_t *output, const uint32_t *input, int width)
+{
+   int w = 0;
+
+   for (; w + 16 <= width; w += 16)
+   {
+      uint8x16x4_t argb = vld4q_u8((const uint8_t*)(input + w));
+      uint8x16_t b      = argb.val[0];
+
+      argb.val[0]       = argb.val[2];
+      argb.val[2]       = b;
+      vst4q_u8((uint8_t*)(output + w), argb);
+   }
+
+   return w;
+}
+
+static INLINE uint8x8_t conv_yuv_neon(int16x8_t y, int16x8_t c)
+{
+   return vqmovun_s16(vshrq_n_s16(vaddq_s16(y, c), YUV_SHIFT));
+}
+
+static int conv_yuyv_argb8888_neon(
+      uint32_t *output, const uint8_t *input, int width)
+{
+   int w                = 0;
+   const int16x8_t bias = vdupq_n_s16(128);
+   const int16x8_t ofs  = vdupq_n_s16(YUV_OFFSET);
+
+   for (; w + 16 <= width; w += 16)
+   {
+      uint8x8x4_t lo, hi;
+      uint8x8x2_t r, g, b;
+      /* Even Y, U, odd Y, V. */
+      uint8x8x4_t yuv = vld4_u8(input + w * 2);
+      int16x8_t y0    = vmulq_n_s16(vreinterpretq_s16_u16(
+               vmovl_u8(yuv.val[0])), YUV_MAT_Y);
+      int16x8_t y1    = vmulq_n_s16(vreinterpretq_s16_u16(
+               vmovl_u8(yuv.val[2])), YUV_MAT_Y);
+      int16x8_t u     = vsubq_s16(vreinterpretq_s16_u16(
+               vmovl_u8(yuv.val[1])), bias);
+      int16x8_t v     = vsubq_s16(vreinterpretq_s16_u16(
+               vmovl_u8(yuv.val[3])), bias);
+      int16x8_t r_c   = vaddq_s16(vmulq_n_s16(v, YUV_MAT_V_R), ofs);
+      int16x8_t g_c   = vaddq_s16(vaddq_s16(vmulq_n_s16(u, YUV_MAT_U_G),
+               vmulq_n_s16(v, YUV_MAT_V_G)), ofs);
+      int16x8_t b_c   = vaddq_s16(vmulq_n_s16(u, YUV_MAT_U_B), ofs);
+
+      r               = vzip_u8(conv_yuv_neon(y0, r_c), conv_yuv_neon(y1, r_c));
+      g               = vzip_u8(conv_yuv_neon(y0, g_c), conv_yuv_neon(y1, g_c));
+      b               = vzip_u8(conv_yuv_neon(y0, b_c), conv_yuv_neon(y1, b_c));
+
+      lo.val[0]       = b.val[0];
+      lo.val[1]       = g.val[0];
+      lo.val[2]       = r.val[0];
+      lo.val[3]       = vdup_n_u8(0xff);
+      hi.val[0]       = b.val[1];
+      hi.val[1]       = g.val[1];
+      hi.val[2]       = r.val[1];
+      hi.val[3]       = vdup_n_u8(0xff);
+
+      vst4_u8((uint8_t*)(output + w + 0), lo);
+      vst4_u8((uint8_t*)(output + w + 8), hi);
+   }
+
+   return w;
+}
+#endif
+
 void conv_rgb565_0rgb1555(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -44,9 +659,10 @@ void conv_rgb565_0rgb1555(void *output_, const void *input_,
    int h;
    const uint16_t *input = (const uint16_t*)input_;
    uint16_t *output = (uint16_t*)output_;
+   uint64_t simd    = conv_simd_flags();
 
-#if defined(__SSE2_)
-   int max_width           = width - 7;
+#if defined(__SSE2__)
+   int max_width           = (simd & RETRO_SIMD_SSE2) ? width - 7 : 0;
    const __m128i hi_mask   = _mm_set1_epi16(0x7fe0);
    const __m128i lo_mask   = _mm_set1_epi16(0x1f);
 #endif
@@ -54,12 +670,12 @@ void conv_rgb565_0rgb1555(void *output_, const void *input_,
    for (h = 0; h < height;
          h++, output += out_stride >> 1, input += in_stride >> 1)
    {
-      int w = 0;
-#if defined(__SSE2_)
+      int w = CONV_SIMD_ROW(conv_rgb565_0rgb1555, simd, output, input, width);
+#if defined(__SSE2__)
       for (; w < max_width; w += 8)
       {
          const __m128i in = _mm_loadu_si128((const __m128i*)(input + w));
-         __m128i hi = _mm_and_si128(_mm_slli_epi16(in, 1), hi_mask);
+         __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 1), hi_mask);
          __m128i lo = _mm_and_si128(in, lo_mask);
          _mm_storeu_si128((__m128i*)(output + w), _mm_or_si128(hi, lo));
       }
@@ -82,9 +698,10 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
    int h;
    const uint16_t *input   = (const uint16_t*)input_;
    uint16_t *output        = (uint16_t*)output_;
+   uint64_t simd           = conv_simd_flags();
 
 #if defined(__SSE2__)
-   int max_width           = width - 7;
+   int max_width           = (simd & RETRO_SIMD_SSE2) ? width - 7 : 0;
 
    const __m128i hi_mask   = _mm_set1_epi16(
          (int16_t)((0x1f << 11) | (0x1f << 6)));
@@ -95,7 +712,7 @@ void conv_0rgb1555_rgb565(void *output_, const void *input_,
    for (h = 0; h < height;
          h++, output += out_stride >> 1, input += in_stride >> 1)
    {
-      int w = 0;
+      int w = CONV_SIMD_ROW(conv_0rgb1555_rgb565, simd, output, input, width);
 #if defined(__SSE2__)
       for (; w < max_width; w += 8)
       {
@@ -126,6 +743,7 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
    int h;
    const uint16_t *input = (const uint16_t*)input_;
    uint32_t *output      = (uint32_t*)output_;
+   uint64_t simd         = conv_simd_flags();
 
 #ifdef __SSE2__
    const __m128i pix_mask_r  = _mm_set1_epi16(0x1f << 10);
@@ -134,13 +752,13 @@ void conv_0rgb1555_argb8888(void *output_, const void *input_,
    const __m128i mul15_hi    = _mm_set1_epi16(0x0210);
    const __m128i a           = _mm_set1_epi16(0x00ff);
 
-   int max_width = width - 7;
+   int max_width = (simd & RETRO_SIMD_SSE2) ? width - 7 : 0;
 #endif
 
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
-      int w = 0;
+      int w = CONV_SIMD_ROW(conv_0rgb1555_argb8888, simd, output, input, width);
 #ifdef __SSE2__
       for (; w < max_width; w += 8)
       {
@@ -193,6 +811,7 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
    int h;
    const uint16_t *input    = (const uint16_t*)input_;
    uint32_t *output         = (uint32_t*)output_;
+   uint64_t simd            = conv_simd_flags();
 
 #if defined(__SSE2__)
    const __m128i pix_mask_r = _mm_set1_epi16(0x1f << 10);
@@ -203,13 +822,13 @@ void conv_rgb565_argb8888(void *output_, const void *input_,
    const __m128i mul16_b    = _mm_set1_epi16(0x4200);
    const __m128i a          = _mm_set1_epi16(0x00ff);
 
-   int max_width            = width - 7;
+   int max_width            = (simd & RETRO_SIMD_SSE2) ? width - 7 : 0;
 #endif
 
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride >> 1)
    {
-      int w = 0;
+      int w = CONV_SIMD_ROW(conv_rgb565_argb8888, simd, output, input, width);
 #if defined(__SSE2__)
       for (; w < max_width; w += 8)
       {
@@ -387,6 +1006,7 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
    int h;
    const uint16_t *input     = (const uint16_t*)input_;
    uint8_t *output           = (uint8_t*)output_;
+   uint64_t simd             = conv_simd_flags();
 
 #if defined(__SSE2__)
    const __m128i pix_mask_r  = _mm_set1_epi16(0x1f << 10);
@@ -395,14 +1015,14 @@ void conv_0rgb1555_bgr24(void *output_, const void *input_,
    const __m128i mul15_hi    = _mm_set1_epi16(0x0210);
    const __m128i a           = _mm_set1_epi16(0x00ff);
 
-   int max_width             = width - 15;
+   int max_width             = (simd & RETRO_SIMD_SSE2) ? width - 15 : 0;
 #endif
 
    for (h = 0; h < height;
          h++, output += out_stride, input += in_stride >> 1)
    {
-      uint8_t *out = output;
-      int   w = 0;
+      int   w = CONV_SIMD_ROW(conv_0rgb1555_bgr24, simd, output, input, width);
+      uint8_t *out = output + w * 3;
 
 #if defined(__SSE2__)
       for (; w < max_width; w += 16, out += 48)
@@ -473,6 +1093,7 @@ void conv_rgb565_bgr24(void *output_, const void *input_,
    int h;
    const uint16_t *input    = (const uint16_t*)input_;
    uint8_t *output          = (uint8_t*)output_;
+   uint64_t simd            = conv_simd_flags();
 
 #if defined(__SSE2__)
    const __m128i pix_mask_r = _mm_set1_epi16(0x1f << 10);
@@ -483,13 +1104,13 @@ void conv_rgb565_bgr24(void *output_, const void *input_,
    const __m128i mul16_b    = _mm_set1_epi16(0x4200);
    const __m128i a          = _mm_set1_epi16(0x00ff);
 
-   int max_width            = width - 15;
+   int max_width            = (simd & RETRO_SIMD_SSE2) ? width - 15 : 0;
 #endif
 
    for (h = 0; h < height; h++, output += out_stride, input += in_stride >> 1)
    {
-      uint8_t *out = output;
-      int        w = 0;
+      int        w = CONV_SIMD_ROW(conv_rgb565_bgr24, simd, output, input, width);
+      uint8_t *out = output + w * 3;
 #if defined(__SSE2__)
       for (; w < max_width; w += 16, out += 48)
       {
@@ -558,12 +1179,17 @@ void conv_bgr24_argb8888(void *output_, const void *input_,
    int h, w;
    const uint8_t *input = (const uint8_t*)input_;
    uint32_t *output     = (uint32_t*)output_;
+   uint64_t simd        = conv_simd_flags();
 
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride)
    {
-      const uint8_t *inp = input;
-      for (w = 0; w < width; w++)
+      const uint8_t *inp;
+
+      w   = CONV_SIMD_ROW(conv_bgr24_argb8888, simd, output, input, width);
+      inp = input + w * 3;
+
+      for (; w < width; w++)
       {
          uint32_t b = *inp++;
          uint32_t g = *inp++;
@@ -580,11 +1206,13 @@ void conv_argb8888_0rgb1555(void *output_, const void *input_,
    int h, w;
    const uint32_t *input = (const uint32_t*)input_;
    uint16_t *output      = (uint16_t*)output_;
+   uint64_t simd         = conv_simd_flags();
 
    for (h = 0; h < height;
          h++, output += out_stride >> 1, input += in_stride >> 2)
    {
-      for (w = 0; w < width; w++)
+      for (w = CONV_SIMD_ROW(conv_argb8888_0rgb1555, simd, output, input,
+               width); w < width; w++)
       {
          uint32_t col = input[w];
          uint16_t r   = (col >> 19) & 0x1f;
@@ -602,16 +1230,17 @@ void conv_argb8888_bgr24(void *output_, const void *input_,
    int h;
    const uint32_t *input = (const uint32_t*)input_;
    uint8_t *output       = (uint8_t*)output_;
+   uint64_t simd         = conv_simd_flags();
 
 #if defined(__SSE2__)
-   int max_width = width - 15;
+   int max_width = (simd & RETRO_SIMD_SSE2) ? width - 15 : 0;
 #endif
 
    for (h = 0; h < height;
          h++, output += out_stride, input += in_stride >> 2)
    {
-      uint8_t *out = output;
-      int        w = 0;
+      int        w = CONV_SIMD_ROW(conv_argb8888_bgr24, simd, output, input, width);
+      uint8_t *out = output + w * 3;
 #if defined(__SSE2__)
       for (; w < max_width; w += 16, out += 48)
       {
@@ -640,11 +1269,13 @@ void conv_argb8888_abgr8888(void *output_, const void *input_,
    int h, w;
    const uint32_t *input = (const uint32_t*)input_;
    uint32_t *output      = (uint32_t*)output_;
+   uint64_t simd         = conv_simd_flags();
 
    for (h = 0; h < height;
          h++, output += out_stride >> 2, input += in_stride >> 2)
    {
-      for (w = 0; w < width; w++)
+      for (w = CONV_SIMD_ROW(conv_argb8888_abgr8888, simd, output, input,
+               width); w < width; w++)
       {
          uint32_t col = input[w];
          output[w]    = ((col << 16) & 0xff0000) | 
@@ -653,14 +1284,6 @@ void conv_argb8888_abgr8888(void *output_, const void *input_,
    }
 }
 
-#define YUV_SHIFT 6
-#define YUV_OFFSET (1 << (YUV_SHIFT - 1))
-#define YUV_MAT_Y (1 << 6)
-#define YUV_MAT_U_G (-22)
-#define YUV_MAT_U_B (113)
-#define YUV_MAT_V_R (90)
-#define YUV_MAT_V_G (-46)
-
 void conv_yuyv_argb8888(void *output_, const void *input_,
       int width, int height,
       int out_stride, int in_stride)
@@ -668,6 +1291,7 @@ void conv_yuyv_argb8888(void *output_, const void *input_,
    int h;
    const uint8_t *input        = (const uint8_t*)input_;
    uint32_t *output            = (uint32_t*)output_;
+   uint64_t simd               = conv_simd_flags();
 
 #if defined(__SSE2__)
    const __m128i mask_y        = _mm_set1_epi16(0xffu);
@@ -687,13 +1311,14 @@ void conv_yuyv_argb8888(void *output_, const void *input_,
 
    for (h = 0; h < height; h++, output += out_stride >> 2, input += in_stride)
    {
-      const uint8_t *src = input;
-      uint32_t      *dst = output;
-      int              w = 0;
+      int              w = CONV_SIMD_ROW(conv_yuyv_argb8888, simd, output, input, width);
+      const uint8_t *src = input + w * 2;
+      uint32_t      *dst = output + w;
 
 #if defined(__SSE2__)
       /* Each loop processes 16 pixels. */
-      for (; w + 16 <= width; w += 16, src += 32, dst += 16)
+      for (; (simd & RETRO_SIMD_SSE2) && w + 16 <= width;
+            w += 16, src += 32, dst += 16)
       {
          __m128i u, v, u0_g, u1_g, u0_b, u1_b, v0_r, v1_r, v0_g, v1_g,
                  r0, g0, b0, r1, g1, b1;
@@ -30,6 +30,220 @@
 #include <gfx/scaler/filter.h>
 #include <gfx/scaler/pixconv.h>
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
+/* One pass over the frame. The first converts the input and runs
+ * the horizontal scaler, the second runs the vertical scaler and
+ * converts the output. Each is split by rows into slices. */
+struct scaler_job
+{
+   struct scaler_ctx *ctx;
+   const void *input;
+   const void *input_frame;
+   void *output;
+   void *output_frame;
+   int input_stride;
+   int output_stride;
+   unsigned pass;
+};
+
+#ifdef HAVE_THREADS
+struct scaler_thread
+{
+   struct scaler_thread_pool *pool;
+   sthread_t *thread;
+   unsigned slice;
+};
+
+struct scaler_thread_pool
+{
+   struct scaler_thread *threads;
+   slock_t *lock;
+   /* Signalled when a job is posted or on shutdown */
+   scond_t *work_cond;
+   /* Signalled when the last worker finishes its slice */
+   scond_t *done_cond;
+   const struct scaler_job *job;
+   unsigned count;
+   unsigned generation;
+   unsigned pending;
+   bool quit;
+};
+#endif
+
+static void scaler_ctx_scale_slice(const struct scaler_job *job,
+      unsigned slice, unsigned slices)
+{
+   struct scaler_ctx *ctx = job->ctx;
+
+   if (job->pass == 0)
+   {
+      int first = ctx->in_height * slice / slices;
+      int last  = ctx->in_height * (slice + 1) / slices;
+
+      if (ctx->in_fmt != SCALER_FMT_ARGB8888)
+         ctx->in_pixconv(
+               (uint8_t*)ctx->input.frame + first * ctx->input.stride,
+               (const uint8_t*)job->input + first * ctx->in_stride,
+               ctx->in_width, last - first,
+               ctx->input.stride, ctx->in_stride);
+
+      /* The special scalers read the whole input, so they
+       * have to wait for the second pass. */
+      if (!ctx->scaler_special && ctx->scaler_horiz)
+         ctx->scaler_horiz(ctx, job->input_frame, job->input_stride,
+               first, last);
+   }
+   else
+   {
+      int first = ctx->out_height * slice / slices;
+      int last  = ctx->out_height * (slice + 1) / slices;
+
+      /* Take some special, and (hopefully) more optimized path. */
+      if (ctx->scaler_special)
+         ctx->scaler_special(ctx, job->output_frame, job->input_frame,
+               ctx->out_width, ctx->out_height,
+               ctx->in_width, ctx->in_height,
+               job->output_stride, job->input_stride,
+               first, last);
+      else if (ctx->scaler_vert)
+         ctx->scaler_vert(ctx, job->output_frame, job->output_stride,
+               first, last);
+
+      if (ctx->out_fmt != SCALER_FMT_ARGB8888)
+         ctx->out_pixconv(
+               (uint8_t*)job->output + first * ctx->out_stride,
+               (const uint8_t*)ctx->output.frame + first * ctx->output.stride,
+               ctx->out_width, last - first,
+               ctx->out_stride, ctx->output.stride);
+   }
+}
+
+#ifdef HAVE_THREADS
+static void scaler_thread_loop(void *data)
+{
+   struct scaler_thread *thread     = (struct scaler_thread*)data;
+   struct scaler_thread_pool *pool  = thread->pool;
+   unsigned generation              = 0;
+
+   slock_lock(pool->lock);
+
+   for (;;)
+   {
+      const struct scaler_job *job = NULL;
+
+      while (!pool->quit && pool->generation == generation)
+         scond_wait(pool->work_cond, pool->lock);
+
+      if (pool->quit)
+         break;
+
+      generation = pool->generation;
+      job        = pool->job;
+      slock_unlock(pool->lock);
+
+      scaler_ctx_scale_slice(job, thread->slice, pool->count + 1);
+
+      slock_lock(pool->lock);
+      if (--pool->pending == 0)
+         scond_signal(pool->done_cond);
+   }
+
+   slock_unlock(pool->lock);
+}
+
+static void scaler_thread_pool_free(struct scaler_thread_pool *pool)
+{
+   unsigned i;
+
+   if (pool->threads)
+   {
+      slock_lock(pool->lock);
+      pool->quit = true;
+      scond_broadcast(pool->work_cond);
+      slock_unlock(pool->lock);
+
+      for (i = 0; i < pool->count; i++)
+         if (pool->threads[i].thread)
+            sthread_join(pool->threads[i].thread);
+
+      free(pool->threads);
+   }
+
+   if (pool->done_cond)
+      scond_free(pool->done_cond);
+   if (pool->work_cond)
+      scond_free(pool->work_cond);
+   if (pool->lock)
+      slock_free(pool->lock);
+
+   free(pool);
+}
+
+/* The calling thread scales a slice as well, so @threads - 1
+ * workers are started. */
+static struct scaler_thread_pool *scaler_thread_pool_new(unsigned threads)
+{
+   unsigned i;
+   struct scaler_thread_pool *pool = (struct scaler_thread_pool*)
+      calloc(1, sizeof(*pool));
+
+   if (!pool)
+      return NULL;
+
+   pool->lock      = slock_new();
+   pool->work_cond = scond_new();
+   pool->done_cond = scond_new();
+   pool->threads   = (struct scaler_thread*)
+      calloc(threads - 1, sizeof(*pool->threads));
+
+   if (!pool->lock || !pool->work_cond || !pool->done_cond || !pool->threads)
+      goto error;
+
+   for (i = 0; i < threads - 1; i++)
+   {
+      pool->threads[i].pool   = pool;
+      pool->threads[i].slice  = i + 1;
+      pool->threads[i].thread = sthread_create(scaler_thread_loop,
+            &pool->threads[i]);
+
+      if (!pool->threads[i].thread)
+         break;
+
+      pool->count++;
+   }
+
+   if (!pool->count)
+      goto error;
+
+   return pool;
+
+error:
+   scaler_thread_pool_free(pool);
+   return NULL;
+}
+
+static void scaler_thread_pool_run(struct scaler_thread_pool *pool,
+      const struct scaler_job *job)
+{
+   slock_lock(pool->lock);
+   pool->job     = job;
+   pool->pending = pool->count;
+   pool->generation++;
+   scond_broadcast(pool->work_cond);
+   slock_unlock(pool->lock);
+
+   scaler_ctx_scale_slice(job, 0, pool->count + 1);
+
+   slock_lock(pool->lock);
+   while (pool->pending)
+      scond_wait(pool->done_cond, pool->lock);
+   slock_unlock(pool->lock);
+}
+#endif
+
 static bool allocate_frames(struct scaler_ctx *ctx)
 {
    uint64_t *scaled_frame = NULL;
@@ -245,6 +459,12 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
 
       if (!scaler_gen_filter(ctx))
          return false;
+
+#ifdef HAVE_THREADS
+      /* Scales on the calling thread alone if this fails. */
+      if (ctx->threads > 1)
+         ctx->pool = scaler_thread_pool_new(ctx->threads);
+#endif
    }
 
    return true;
@@ -252,6 +472,10 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
 
 void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
 {
+#ifdef HAVE_THREADS
+   if (ctx->pool)
+      scaler_thread_pool_free(ctx->pool);
+#endif
    if (ctx->horiz.filter)
       free(ctx->horiz.filter);
    if (ctx->horiz.filter_pos)
@@ -287,6 +511,8 @@ void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
 
    ctx->output.frame        = NULL;
    ctx->output.stride       = 0;
+
+   ctx->pool                = NULL;
 }
 
 /**
@@ -300,44 +526,46 @@ void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
 void scaler_ctx_scale(struct scaler_ctx *ctx,
       void *output, const void *input)
 {
-   const void *input_frame = input;
-   void *output_frame      = output;
-   int input_stride        = ctx->in_stride;
-   int output_stride       = ctx->out_stride;
+   unsigned pass;
+   struct scaler_job job;
+
+   job.ctx           = ctx;
+   job.input         = input;
+   job.input_frame   = input;
+   job.input_stride  = ctx->in_stride;
+   job.output        = output;
+   job.output_frame  = output;
+   job.output_stride = ctx->out_stride;
 
    if (ctx->in_fmt != SCALER_FMT_ARGB8888)
    {
-      ctx->in_pixconv(ctx->input.frame, input,
-            ctx->in_width, ctx->in_height,
-            ctx->input.stride, ctx->in_stride);
-
-      input_frame       = ctx->input.frame;
-      input_stride      = ctx->input.stride;
+      job.input_frame  = ctx->input.frame;
+      job.input_stride = ctx->input.stride;
    }
 
    if (ctx->out_fmt != SCALER_FMT_ARGB8888)
    {
-      output_frame  = ctx->output.frame;
-      output_stride = ctx->output.stride;
+      job.output_frame  = ctx->output.frame;
+      job.output_stride = ctx->output.stride;
    }
 
-   /* Take some special, and (hopefully) more optimized path. */
-   if (ctx->scaler_special)
-      ctx->scaler_special(ctx, output_frame, input_frame,
-            ctx->out_width, ctx->out_height,
-            ctx->in_width, ctx->in_height,
-            output_stride, input_stride);
-   else
+   for (pass = 0; pass < 2; pass++)
    {
-      /* Take generic filter path. */
-      if (ctx->scaler_horiz)
-         ctx->scaler_horiz(ctx, input_frame, input_stride);
-      if (ctx->scaler_vert)
-         ctx->scaler_vert (ctx, output, output_stride);
-   }
+      /* Nothing to do before the special scalers then. */
+      if (pass == 0 && ctx->scaler_special
+            && ctx->in_fmt == SCALER_FMT_ARGB8888)
+         continue;
 
-   if (ctx->out_fmt != SCALER_FMT_ARGB8888)
-      ctx->out_pixconv(output, ctx->output.frame,
-            ctx->out_width, ctx->out_height,
-            ctx->out_stride, ctx->output.stride);
+      job.pass = pass;
+
+#ifdef HAVE_THREADS
+      if (ctx->pool)
+      {
+         scaler_thread_pool_run(ctx->pool, &job);
+         continue;
+      }
+#endif
+
+      scaler_ctx_scale_slice(&job, 0, 1);
+   }
 }
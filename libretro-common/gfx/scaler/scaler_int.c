@@ -20,12 +20,22 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <string.h>
+
 #include <gfx/scaler/scaler_int.h>
 
 #include <retro_inline.h>
+#include <retro_simd.h>
+#include <features/features_cpu.h>
 
 #ifdef SCALER_NO_SIMD
 #undef __SSE2__
+#undef RETRO_HAVE_NEON
+#endif
+
+/* The AVX2 passes use SSE2 for the ends of rows. */
+#if !defined(__SSE2__)
+#undef RETRO_HAVE_AVX2
 #endif
 
 #if defined(__SSE2__)
@@ -59,18 +69,34 @@
  * into 8-bit values.
  *
  * The C version of scalers perform the exact same operations as the 
- * SIMD code for testing purposes.
+ * SIMD code for testing purposes. The sums stay far from the 16-bit
+ * limits, so the SIMD versions can add up taps and pixels in whatever
+ * order suits them and still give the same result.
  */
 
-void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int stride)
+static uint64_t scaler_simd_mask = ~(uint64_t)0;
+
+static uint64_t scaler_simd_flags(void)
+{
+   return cpu_features_get_simd() & scaler_simd_mask;
+}
+
+void scaler_set_simd_mask(uint64_t mask)
+{
+   scaler_simd_mask = mask;
+}
+
+static void scaler_argb8888_vert_c(const struct scaler_ctx *ctx,
+      void *output_, int stride, int first_row, int last_row)
 {
    int h, w, y;
    const uint64_t      *input = ctx->scaled.frame;
-   uint32_t           *output = (uint32_t*)output_;
+   uint32_t           *output = (uint32_t*)output_ + first_row * (stride >> 2);
 
-   const int16_t *filter_vert = ctx->vert.filter;
+   const int16_t *filter_vert = ctx->vert.filter
+      + first_row * ctx->vert.filter_stride;
 
-   for (h = 0; h < ctx->out_height; h++, 
+   for (h = first_row; h < last_row; h++, 
          filter_vert += ctx->vert.filter_stride, output += stride >> 2)
    {
       const uint64_t *input_base = input + ctx->vert.filter_pos[h] 
@@ -79,34 +105,6 @@ void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int strid
       for (w = 0; w < ctx->out_width; w++)
       {
          const uint64_t *input_base_y = input_base + w;
-#if defined(__SSE2__)
-         __m128i final;
-         __m128i res = _mm_setzero_si128();
-
-         for (y = 0; (y + 1) < ctx->vert.filter_len; y += 2,
-               input_base_y += (ctx->scaled.stride >> 2))
-         {
-            __m128i coeff = _mm_set_epi64x(filter_vert[y + 1] * 0x0001000100010001ll, filter_vert[y + 0] * 0x0001000100010001ll);
-            __m128i col   = _mm_set_epi64x(input_base_y[ctx->scaled.stride >> 3], input_base_y[0]);
-
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
-         }
-
-         for (; y < ctx->vert.filter_len; y++, input_base_y += (ctx->scaled.stride >> 3))
-         {
-            __m128i coeff = _mm_set_epi64x(0, filter_vert[y] * 0x0001000100010001ll);
-            __m128i col   = _mm_set_epi64x(0, input_base_y[0]);
-
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
-         }
-
-         res       = _mm_adds_epi16(_mm_srli_si128(res, 8), res);
-         res       = _mm_srai_epi16(res, (7 - 2 - 2));
-
-         final     = _mm_packus_epi16(res, res);
-
-         output[w] = _mm_cvtsi128_si32(final);
-#else
          int16_t res_a = 0;
          int16_t res_r = 0;
          int16_t res_g = 0;
@@ -140,18 +138,19 @@ void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int strid
             (clamp_8bit(res_r) << 16) | 
             (clamp_8bit(res_g) << 8)  |
             (clamp_8bit(res_b) << 0);
-#endif
       }
    }
 }
 
-void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int stride)
+static void scaler_argb8888_horiz_c(const struct scaler_ctx *ctx,
+      const void *input_, int stride, int first_row, int last_row)
 {
    int h, w, x;
-   const uint32_t *input = (uint32_t*)input_;
-   uint64_t *output      = ctx->scaled.frame;
+   const uint32_t *input = (const uint32_t*)input_ + first_row * (stride >> 2);
+   uint64_t *output      = ctx->scaled.frame
+      + first_row * (ctx->scaled.stride >> 3);
 
-   for (h = 0; h < ctx->scaled.height; h++, input += stride >> 2,
+   for (h = first_row; h < last_row; h++, input += stride >> 2,
          output += ctx->scaled.stride >> 3)
    {
       const int16_t *filter_horiz = ctx->horiz.filter;
@@ -160,44 +159,6 @@ void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int
             filter_horiz += ctx->horiz.filter_stride)
       {
          const uint32_t *input_base_x = input + ctx->horiz.filter_pos[w];
-#if defined(__SSE2__)
-         __m128i res = _mm_setzero_si128();
-
-         for (x = 0; (x + 1) < ctx->horiz.filter_len; x += 2)
-         {
-            __m128i coeff = _mm_set_epi64x(filter_horiz[x + 1] * 0x0001000100010001ll, filter_horiz[x + 0] * 0x0001000100010001ll);
-
-            __m128i col   = _mm_unpacklo_epi8(_mm_set_epi64x(0,
-                     ((uint64_t)input_base_x[x + 1] << 32) | input_base_x[x + 0]), _mm_setzero_si128());
-
-            col           = _mm_slli_epi16(col, 7);
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
-         }
-
-         for (; x < ctx->horiz.filter_len; x++)
-         {
-            __m128i coeff = _mm_set_epi64x(0, filter_horiz[x] * 0x0001000100010001ll);
-            __m128i col   = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, 0, input_base_x[x]), _mm_setzero_si128());
-
-            col           = _mm_slli_epi16(col, 7);
-            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
-         }
-
-         res              = _mm_adds_epi16(_mm_srli_si128(res, 8), res);
-
-#ifdef __x86_64__
-         output[w]        = _mm_cvtsi128_si64(res);
-#else /* 32-bit doesn't have si64. Do it in two steps. */
-         union
-         {
-            uint32_t *u32;
-            uint64_t *u64;
-         } u;
-         u.u64    = output + w;
-         u.u32[0] = _mm_cvtsi128_si32(res);
-         u.u32[1] = _mm_cvtsi128_si32(_mm_srli_si128(res, 4));
-#endif
-#else
          int16_t res_a = 0;
          int16_t res_r = 0;
          int16_t res_g = 0;
@@ -220,21 +181,449 @@ void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int
             res_b         += (b * coeff) >> 16;
          }
 
+         /* Sinc filters ring below zero, so keep the sign
+          * from spilling into the other channels. */
          output[w]         = (
-               (uint64_t)res_a  << 48)  | 
-               ((uint64_t)res_r << 32)  |
-               ((uint64_t)res_g << 16)  |
-               ((uint64_t)res_b << 0);
+               (uint64_t)(uint16_t)res_a  << 48)  | 
+               ((uint64_t)(uint16_t)res_r << 32)  |
+               ((uint64_t)(uint16_t)res_g << 16)  |
+               ((uint64_t)(uint16_t)res_b << 0);
+      }
+   }
+}
+
+#if defined(__SSE2__)
+/* The vertical pass works on two output pixels at a time,
+ * as the rows of the scaled frame are contiguous. */
+static void scaler_argb8888_vert_sse2(const struct scaler_ctx *ctx,
+      void *output_, int stride, int first_row, int last_row)
+{
+   int h, w, y;
+   const int scaled_stride    = ctx->scaled.stride >> 3;
+   uint32_t           *output = (uint32_t*)output_ + first_row * (stride >> 2);
+   const int16_t *filter_vert = ctx->vert.filter
+      + first_row * ctx->vert.filter_stride;
+
+   for (h = first_row; h < last_row; h++,
+         filter_vert += ctx->vert.filter_stride, output += stride >> 2)
+   {
+      const uint64_t *input_base = ctx->scaled.frame
+         + ctx->vert.filter_pos[h] * scaled_stride;
+
+      for (w = 0; w + 2 <= ctx->out_width; w += 2)
+      {
+         const uint64_t *input_base_y = input_base + w;
+         __m128i res                  = _mm_setzero_si128();
+
+         for (y = 0; y < ctx->vert.filter_len; y++,
+               input_base_y += scaled_stride)
+            res = _mm_adds_epi16(res, _mm_mulhi_epi16(
+                     _mm_loadu_si128((const __m128i*)input_base_y),
+                     _mm_set1_epi16(filter_vert[y])));
+
+         res = _mm_srai_epi16(res, (7 - 2 - 2));
+         _mm_storel_epi64((__m128i*)(output + w), _mm_packus_epi16(res, res));
+      }
+
+      for (; w < ctx->out_width; w++)
+      {
+         const uint64_t *input_base_y = input_base + w;
+         __m128i res                  = _mm_setzero_si128();
+
+         for (y = 0; y < ctx->vert.filter_len; y++,
+               input_base_y += scaled_stride)
+            res = _mm_adds_epi16(res, _mm_mulhi_epi16(
+                     _mm_loadl_epi64((const __m128i*)input_base_y),
+                     _mm_set1_epi16(filter_vert[y])));
+
+         res       = _mm_srai_epi16(res, (7 - 2 - 2));
+         output[w] = _mm_cvtsi128_si32(_mm_packus_epi16(res, res));
+      }
+   }
+}
+
+/* Even taps are summed in the low half and odd taps in the
+ * high half, which are added up at the end. */
+static void scaler_argb8888_horiz_sse2(const struct scaler_ctx *ctx,
+      const void *input_, int stride, int first_row, int last_row)
+{
+   int h, w, x;
+   const uint32_t *input = (const uint32_t*)input_ + first_row * (stride >> 2);
+   uint64_t *output      = ctx->scaled.frame
+      + first_row * (ctx->scaled.stride >> 3);
+
+   for (h = first_row; h < last_row; h++, input += stride >> 2,
+         output += ctx->scaled.stride >> 3)
+   {
+      const int16_t *filter_horiz = ctx->horiz.filter;
+
+      for (w = 0; w < ctx->scaled.width; w++,
+            filter_horiz += ctx->horiz.filter_stride)
+      {
+         const uint32_t *input_base_x = input + ctx->horiz.filter_pos[w];
+         __m128i res                  = _mm_setzero_si128();
+
+         for (x = 0; (x + 1) < ctx->horiz.filter_len; x += 2)
+         {
+            int32_t taps;
+            __m128i coeff, col;
+
+            memcpy(&taps, filter_horiz + x, sizeof(taps));
+            coeff = _mm_cvtsi32_si128(taps);
+            coeff = _mm_unpacklo_epi16(coeff, coeff);
+            coeff = _mm_unpacklo_epi32(coeff, coeff);
+
+            col   = _mm_unpacklo_epi8(_mm_loadl_epi64(
+                     (const __m128i*)(input_base_x + x)), _mm_setzero_si128());
+            col   = _mm_slli_epi16(col, 7);
+            res   = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
+         }
+
+         for (; x < ctx->horiz.filter_len; x++)
+         {
+            __m128i coeff = _mm_set1_epi16(filter_horiz[x]);
+            __m128i col   = _mm_unpacklo_epi8(_mm_cvtsi32_si128(
+                     input_base_x[x]), _mm_setzero_si128());
+
+            col           = _mm_slli_epi16(col, 7);
+            res           = _mm_adds_epi16(_mm_mulhi_epi16(col, coeff), res);
+         }
+
+         res = _mm_adds_epi16(_mm_srli_si128(res, 8), res);
+         _mm_storel_epi64((__m128i*)(output + w), res);
+      }
+   }
+}
 #endif
+
+#if defined(RETRO_HAVE_AVX2)
+static RETRO_TARGET_AVX2 void scaler_argb8888_vert_avx2(
+      const struct scaler_ctx *ctx,
+      void *output_, int stride, int first_row, int last_row)
+{
+   int h, w, y;
+   const int scaled_stride    = ctx->scaled.stride >> 3;
+   uint32_t           *output = (uint32_t*)output_ + first_row * (stride >> 2);
+   const int16_t *filter_vert = ctx->vert.filter
+      + first_row * ctx->vert.filter_stride;
+
+   for (h = first_row; h < last_row; h++,
+         filter_vert += ctx->vert.filter_stride, output += stride >> 2)
+   {
+      const uint64_t *input_base = ctx->scaled.frame
+         + ctx->vert.filter_pos[h] * scaled_stride;
+
+      for (w = 0; w + 4 <= ctx->out_width; w += 4)
+      {
+         const uint64_t *input_base_y = input_base + w;
+         __m256i res                  = _mm256_setzero_si256();
+
+         for (y = 0; y < ctx->vert.filter_len; y++,
+               input_base_y += scaled_stride)
+            res = _mm256_adds_epi16(res, _mm256_mulhi_epi16(
+                     _mm256_loadu_si256((const __m256i*)input_base_y),
+                     _mm256_set1_epi16(filter_vert[y])));
+
+         /* Packing works within 128-bit lanes, the pixels end up
+          * in the low quadword of each. */
+         res = _mm256_srai_epi16(res, (7 - 2 - 2));
+         res = _mm256_permute4x64_epi64(_mm256_packus_epi16(res, res), 0x08);
+         _mm_storeu_si128((__m128i*)(output + w), _mm256_castsi256_si128(res));
+      }
+
+      for (; w < ctx->out_width; w++)
+      {
+         const uint64_t *input_base_y = input_base + w;
+         __m128i res                  = _mm_setzero_si128();
+
+         for (y = 0; y < ctx->vert.filter_len; y++,
+               input_base_y += scaled_stride)
+            res = _mm_adds_epi16(res, _mm_mulhi_epi16(
+                     _mm_loadl_epi64((const __m128i*)input_base_y),
+                     _mm_set1_epi16(filter_vert[y])));
+
+         res       = _mm_srai_epi16(res, (7 - 2 - 2));
+         output[w] = _mm_cvtsi128_si32(_mm_packus_epi16(res, res));
+      }
+   }
+}
+
+/* Two output pixels at a time, one per 128-bit lane, each
+ * taking two taps per step like the SSE2 version. */
+static RETRO_TARGET_AVX2 void scaler_argb8888_horiz_avx2(
+      const struct scaler_ctx *ctx,
+      const void *input_, int stride, int first_row, int last_row)
+{
+   int h, w, x;
+   const uint32_t *input = (const uint32_t*)input_ + first_row * (stride >> 2);
+   uint64_t *output      = ctx->scaled.frame
+      + first_row * (ctx->scaled.stride >> 3);
+   const int filter_len  = ctx->horiz.filter_len;
+   /* Spreads taps [a0, a1, b0, b1] over the four channels of
+    * a0 and a1 in the low lane and of b0 and b1 in the high. */
+   const __m256i spread  = _mm256_setr_epi8(
+         0, 1, 0, 1, 0, 1, 0, 1, 2, 3, 2, 3, 2, 3, 2, 3,
+         4, 5, 4, 5, 4, 5, 4, 5, 6, 7, 6, 7, 6, 7, 6, 7);
+
+   for (h = first_row; h < last_row; h++, input += stride >> 2,
+         output += ctx->scaled.stride >> 3)
+   {
+      const int16_t *filter_horiz = ctx->horiz.filter;
+
+      for (w = 0; w < ctx->scaled.width; w += 2,
+            filter_horiz += ctx->horiz.filter_stride * 2)
+      {
+         __m256i res           = _mm256_setzero_si256();
+         const int16_t *filt_a = filter_horiz;
+         const int16_t *filt_b = filter_horiz + ctx->horiz.filter_stride;
+         const uint32_t *in_a  = input + ctx->horiz.filter_pos[w];
+         const uint32_t *in_b  = in_a;
+         bool pair             = w + 1 < ctx->scaled.width;
+
+         /* The last pixel of an odd width runs in both lanes. */
+         if (pair)
+            in_b = input + ctx->horiz.filter_pos[w + 1];
+         else
+            filt_b = filt_a;
+
+         for (x = 0; (x + 1) < filter_len; x += 2)
+         {
+            int32_t taps_a, taps_b;
+            __m256i coeff, col;
+
+            memcpy(&taps_a, filt_a + x, sizeof(taps_a));
+            memcpy(&taps_b, filt_b + x, sizeof(taps_b));
+            coeff = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+                     _mm_unpacklo_epi32(_mm_cvtsi32_si128(taps_a),
+                        _mm_cvtsi32_si128(taps_b))), spread);
+
+            col   = _mm256_cvtepu8_epi16(_mm_unpacklo_epi64(
+                     _mm_loadl_epi64((const __m128i*)(in_a + x)),
+                     _mm_loadl_epi64((const __m128i*)(in_b + x))));
+            col   = _mm256_slli_epi16(col, 7);
+            res   = _mm256_adds_epi16(_mm256_mulhi_epi16(col, coeff), res);
+         }
+
+         for (; x < filter_len; x++)
+         {
+            __m256i coeff = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+                     _mm_unpacklo_epi32(
+                        _mm_cvtsi32_si128((uint16_t)filt_a[x]),
+                        _mm_cvtsi32_si128((uint16_t)filt_b[x]))), spread);
+            __m256i col   = _mm256_cvtepu8_epi16(_mm_unpacklo_epi64(
+                     _mm_cvtsi32_si128(in_a[x]), _mm_cvtsi32_si128(in_b[x])));
+
+            col           = _mm256_slli_epi16(col, 7);
+            res           = _mm256_adds_epi16(_mm256_mulhi_epi16(col, coeff), res);
+         }
+
+         res = _mm256_adds_epi16(_mm256_srli_si256(res, 8), res);
+         res = _mm256_permute4x64_epi64(res, 0x08);
+
+         if (pair)
+            _mm_storeu_si128((__m128i*)(output + w), _mm256_castsi256_si128(res));
+         else
+            _mm_storel_epi64((__m128i*)(output + w), _mm256_castsi256_si128(res));
+      }
+   }
+}
+#endif
+
+#if defined(RETRO_HAVE_NEON)
+/* (a * b) >> 16 per 16-bit element, the same as SSE2 mulhi. */
+static INLINE int16x8_t scaler_mulhi_neon(int16x8_t a,
+      int16x4_t b_lo, int16x4_t b_hi)
+{
+   return vcombine_s16(
+         vshrn_n_s32(vmull_s16(vget_low_s16(a),  b_lo), 16),
+         vshrn_n_s32(vmull_s16(vget_high_s16(a), b_hi), 16));
+}
+
+static void scaler_argb8888_vert_neon(const struct scaler_ctx *ctx,
+      void *output_, int stride, int first_row, int last_row)
+{
+   int h, w, y;
+   const int scaled_stride    = ctx->scaled.stride >> 3;
+   uint32_t           *output = (uint32_t*)output_ + first_row * (stride >> 2);
+   const int16_t *filter_vert = ctx->vert.filter
+      + first_row * ctx->vert.filter_stride;
+
+   for (h = first_row; h < last_row; h++,
+         filter_vert += ctx->vert.filter_stride, output += stride >> 2)
+   {
+      const uint64_t *input_base = ctx->scaled.frame
+         + ctx->vert.filter_pos[h] * scaled_stride;
+
+      for (w = 0; w + 2 <= ctx->out_width; w += 2)
+      {
+         const uint64_t *input_base_y = input_base + w;
+         int16x8_t res                = vdupq_n_s16(0);
+
+         for (y = 0; y < ctx->vert.filter_len; y++,
+               input_base_y += scaled_stride)
+         {
+            int16x4_t coeff = vdup_n_s16(filter_vert[y]);
+            res = vqaddq_s16(res, scaler_mulhi_neon(
+                     vld1q_s16((const int16_t*)input_base_y), coeff, coeff));
+         }
+
+         vst1_u8((uint8_t*)(output + w),
+               vqmovun_s16(vshrq_n_s16(res, (7 - 2 - 2))));
+      }
+
+      for (; w < ctx->out_width; w++)
+      {
+         const uint64_t *input_base_y = input_base + w;
+         int16x4_t res                = vdup_n_s16(0);
+
+         for (y = 0; y < ctx->vert.filter_len; y++,
+               input_base_y += scaled_stride)
+            res = vqadd_s16(res, vshrn_n_s32(vmull_s16(
+                        vld1_s16((const int16_t*)input_base_y),
+                        vdup_n_s16(filter_vert[y])), 16));
+
+         res = vshr_n_s16(res, (7 - 2 - 2));
+         vst1_lane_u32(output + w, vreinterpret_u32_u8(
+                  vqmovun_s16(vcombine_s16(res, res))), 0);
       }
    }
 }
 
+static void scaler_argb8888_horiz_neon(const struct scaler_ctx *ctx,
+      const void *input_, int stride, int first_row, int last_row)
+{
+   int h, w, x;
+   const uint32_t *input = (const uint32_t*)input_ + first_row * (stride >> 2);
+   uint64_t *output      = ctx->scaled.frame
+      + first_row * (ctx->scaled.stride >> 3);
+
+   for (h = first_row; h < last_row; h++, input += stride >> 2,
+         output += ctx->scaled.stride >> 3)
+   {
+      const int16_t *filter_horiz = ctx->horiz.filter;
+
+      for (w = 0; w < ctx->scaled.width; w++,
+            filter_horiz += ctx->horiz.filter_stride)
+      {
+         const uint32_t *input_base_x = input + ctx->horiz.filter_pos[w];
+         int16x8_t res                = vdupq_n_s16(0);
+         int16x4_t sum;
+
+         for (x = 0; (x + 1) < ctx->horiz.filter_len; x += 2)
+         {
+            int16x8_t col = vreinterpretq_s16_u16(vshlq_n_u16(vmovl_u8(
+                        vld1_u8((const uint8_t*)(input_base_x + x))), 7));
+            res = vqaddq_s16(res, scaler_mulhi_neon(col,
+                     vdup_n_s16(filter_horiz[x + 0]),
+                     vdup_n_s16(filter_horiz[x + 1])));
+         }
+
+         for (; x < ctx->horiz.filter_len; x++)
+         {
+            int16x8_t col = vreinterpretq_s16_u16(vshlq_n_u16(vmovl_u8(
+                        vreinterpret_u8_u32(vld1_lane_u32(input_base_x + x,
+                              vdup_n_u32(0), 0))), 7));
+            res = vqaddq_s16(res, scaler_mulhi_neon(col,
+                     vdup_n_s16(filter_horiz[x]), vdup_n_s16(0)));
+         }
+
+         sum = vqadd_s16(vget_low_s16(res), vget_high_s16(res));
+         vst1_s16((int16_t*)(output + w), sum);
+      }
+   }
+}
+#endif
+
+/**
+ * scaler_argb8888_vert:
+ * @ctx          : pointer to scaler context object.
+ * @output       : pointer to the first row of the output image.
+ * @stride       : output stride in bytes.
+ * @first_row    : first output row to filter.
+ * @last_row     : output row to stop at.
+ *
+ * Runs the vertical pass over rows [@first_row, @last_row) of the
+ * output, reading the horizontally scaled frame.
+ **/
+void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output,
+      int stride, int first_row, int last_row)
+{
+   uint64_t simd = scaler_simd_flags();
+
+#if defined(RETRO_HAVE_AVX2)
+   if (simd & RETRO_SIMD_AVX2)
+   {
+      scaler_argb8888_vert_avx2(ctx, output, stride, first_row, last_row);
+      return;
+   }
+#endif
+#if defined(__SSE2__)
+   if (simd & RETRO_SIMD_SSE2)
+   {
+      scaler_argb8888_vert_sse2(ctx, output, stride, first_row, last_row);
+      return;
+   }
+#endif
+#if defined(RETRO_HAVE_NEON)
+   if (simd & RETRO_SIMD_NEON)
+   {
+      scaler_argb8888_vert_neon(ctx, output, stride, first_row, last_row);
+      return;
+   }
+#endif
+
+   (void)simd;
+   scaler_argb8888_vert_c(ctx, output, stride, first_row, last_row);
+}
+
+/**
+ * scaler_argb8888_horiz:
+ * @ctx          : pointer to scaler context object.
+ * @input        : pointer to the first row of the ARGB8888 input image.
+ * @stride       : input stride in bytes.
+ * @first_row    : first input row to filter.
+ * @last_row     : input row to stop at.
+ *
+ * Runs the horizontal pass over rows [@first_row, @last_row) of the
+ * input, writing the same rows of the scaled frame.
+ **/
+void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input,
+      int stride, int first_row, int last_row)
+{
+   uint64_t simd = scaler_simd_flags();
+
+#if defined(RETRO_HAVE_AVX2)
+   if (simd & RETRO_SIMD_AVX2)
+   {
+      scaler_argb8888_horiz_avx2(ctx, input, stride, first_row, last_row);
+      return;
+   }
+#endif
+#if defined(__SSE2__)
+   if (simd & RETRO_SIMD_SSE2)
+   {
+      scaler_argb8888_horiz_sse2(ctx, input, stride, first_row, last_row);
+      return;
+   }
+#endif
+#if defined(RETRO_HAVE_NEON)
+   if (simd & RETRO_SIMD_NEON)
+   {
+      scaler_argb8888_horiz_neon(ctx, input, stride, first_row, last_row);
+      return;
+   }
+#endif
+
+   (void)simd;
+   scaler_argb8888_horiz_c(ctx, input, stride, first_row, last_row);
+}
+
 void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
       void *output_, const void *input_,
       int out_width, int out_height,
       int in_width, int in_height,
-      int out_stride, int in_stride)
+      int out_stride, int in_stride,
+      int first_row, int last_row)
 {
    int h, w;
    int x_pos             = (1 << 15) * in_width / out_width - (1 << 15);
@@ -242,14 +631,17 @@ void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
    int y_pos             = (1 << 15) * in_height / out_height - (1 << 15);
    int y_step            = (1 << 16) * in_height / out_height;
    const uint32_t *input = (const uint32_t*)input_;
-   uint32_t *output      = (uint32_t*)output_;
+   uint32_t *output      = (uint32_t*)output_ + first_row * (out_stride >> 2);
 
    if (x_pos < 0)
       x_pos = 0;
    if (y_pos < 0)
       y_pos = 0;
 
-   for (h = 0; h < out_height; h++, y_pos += y_step, output += out_stride >> 2)
+   y_pos += first_row * y_step;
+
+   for (h = first_row; h < last_row; h++, y_pos += y_step,
+         output += out_stride >> 2)
    {
       int               x = x_pos;
       const uint32_t *inp = input + (y_pos >> 16) * (in_stride >> 2);
@@ -258,4 +650,3 @@ void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
          output[w] = inp[x >> 16];
    }
 }
-
@@ -26,12 +26,32 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include <boolean.h>
 #include <retro_common_api.h>
 
 RETRO_BEGIN_DECLS
 
+enum encoding_crc32_impl
+{
+   /* Fastest implementation the CPU supports. */
+   ENCODING_CRC32_IMPL_AUTO = 0,
+   ENCODING_CRC32_IMPL_TABLE,
+   ENCODING_CRC32_IMPL_SLICE8,
+   ENCODING_CRC32_IMPL_PCLMUL,
+   ENCODING_CRC32_IMPL_ARMV8,
+   ENCODING_CRC32_IMPL_LAST
+};
+
 uint32_t encoding_crc32(uint32_t crc, const uint8_t *buf, size_t len);
 
+bool encoding_crc32_impl_available(enum encoding_crc32_impl impl);
+
+/* Forces an implementation, mostly for testing and benchmarking.
+ * Returns false if it is not supported on this CPU. */
+bool encoding_crc32_set_impl(enum encoding_crc32_impl impl);
+
+enum encoding_crc32_impl encoding_crc32_get_impl(void);
+
 RETRO_END_DECLS
 
 #endif
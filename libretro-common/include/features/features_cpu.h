@@ -50,6 +50,13 @@ retro_perf_tick_t cpu_features_get_perf_counter(void);
  **/
 retro_time_t cpu_features_get_time_usec(void);
 
+/* Features only the frontend and libretro-common check for.
+ * They live above the RETRO_SIMD_* bits of the libretro API,
+ * and are not reported to cores. */
+#define CPU_FEATURE_PCLMUL       ((uint64_t)1 << 48)
+#define CPU_FEATURE_CRC32        ((uint64_t)1 << 49)
+#define CPU_FEATURE_PRIVATE_MASK (CPU_FEATURE_PCLMUL | CPU_FEATURE_CRC32)
+
 /**
  * cpu_features_get:
  *
@@ -59,6 +66,18 @@ retro_time_t cpu_features_get_time_usec(void);
  **/
 uint64_t cpu_features_get(void);
 
+/**
+ * cpu_features_get_simd:
+ *
+ * Gets the SIMD instruction sets that code built with
+ * retro_simd.h can be dispatched to: those of cpu_features_get,
+ * plus SSE2 and NEON when the build targets them anyway, minus
+ * AVX2 when the OS does not save AVX registers.
+ *
+ * Returns: bitmask of CPU features, as cpu_features_get.
+ **/
+uint64_t cpu_features_get_simd(void);
+
 /**
  * cpu_features_get_core_amount:
  *
@@ -466,6 +466,16 @@ bool path_is_valid(const char *path);
 
 int32_t path_get_size(const char *path);
 
+/**
+ * path_get_modified_time:
+ * @path               : path
+ * @size               : set to the size of the file, if not NULL.
+ *
+ * Returns: time @path was last modified, in seconds, or -1 if
+ * the file does not exist or the platform does not report it.
+ */
+int64_t path_get_modified_time(const char *path, int32_t *size);
+
 bool path_file_remove(const char *path);
 
 bool path_file_rename(const char *old_path, const char *new_path);
@@ -23,6 +23,8 @@
 #ifndef __LIBRETRO_SDK_SCALER_PIXCONV_H__
 #define __LIBRETRO_SDK_SCALER_PIXCONV_H__
 
+#include <stdint.h>
+
 #include <clamping.h>
 
 #include <retro_common_api.h>
@@ -94,6 +96,16 @@ void conv_copy(void *output, const void *input,
       int width, int height,
       int out_stride, int in_stride);
 
+/**
+ * conv_set_simd_mask:
+ * @mask                  : RETRO_SIMD_* flags the conversions may use.
+ *
+ * Restricts which SIMD code paths the conversions pick at runtime,
+ * on top of what the CPU supports. Pass 0 to force the C paths.
+ * Mainly meant for testing and benchmarking.
+ **/
+void conv_set_simd_mask(uint64_t mask);
+
 RETRO_END_DECLS
 
 #endif
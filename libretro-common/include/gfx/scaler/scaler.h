@@ -32,6 +32,8 @@
 
 RETRO_BEGIN_DECLS
 
+struct scaler_thread_pool;
+
 enum scaler_pix_fmt
 {
    SCALER_FMT_ARGB8888 = 0,
@@ -73,12 +75,14 @@ struct scaler_ctx
    enum scaler_pix_fmt out_fmt;
    enum scaler_type scaler_type;
 
+   /* The scalers take the range of rows to work on last,
+    * so they can be run over slices of the frame. */
    void (*scaler_horiz)(const struct scaler_ctx*,
-         const void*, int);
+         const void*, int, int, int);
    void (*scaler_vert)(const struct scaler_ctx*,
-         void*, int);
+         void*, int, int, int);
    void (*scaler_special)(const struct scaler_ctx*,
-         void*, const void*, int, int, int, int, int, int);
+         void*, const void*, int, int, int, int, int, int, int, int);
 
    void (*in_pixconv)(void*, const void*, int, int, int, int);
    void (*out_pixconv)(void*, const void*, int, int, int, int);
@@ -106,6 +110,11 @@ struct scaler_ctx
       uint32_t *frame;
       int stride;
    } output;
+
+   /* Number of threads scaling is split across, by rows.
+    * 0 or 1 scales on the calling thread. */
+   unsigned threads;
+   struct scaler_thread_pool *pool;
 };
 
 bool scaler_ctx_gen_filter(struct scaler_ctx *ctx);
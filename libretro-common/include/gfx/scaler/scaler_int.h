@@ -30,16 +30,28 @@
 RETRO_BEGIN_DECLS
 
 void scaler_argb8888_vert(const struct scaler_ctx *ctx,
-      void *output, int stride);
+      void *output, int stride, int first_row, int last_row);
 
 void scaler_argb8888_horiz(const struct scaler_ctx *ctx,
-      const void *input, int stride);
+      const void *input, int stride, int first_row, int last_row);
 
 void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
       void *output, const void *input,
       int out_width, int out_height,
       int in_width, int in_height,
-      int out_stride, int in_stride);
+      int out_stride, int in_stride,
+      int first_row, int last_row);
+
+/**
+ * scaler_set_simd_mask:
+ * @mask                  : RETRO_SIMD_* flags the passes may use.
+ *
+ * Restricts which SIMD code paths the horizontal and vertical
+ * passes pick at runtime, on top of what the CPU supports.
+ * Pass 0 to force the C paths. Mainly meant for testing and
+ * benchmarking.
+ **/
+void scaler_set_simd_mask(uint64_t mask);
 
 RETRO_END_DECLS
 
@@ -42,15 +42,29 @@ struct item_file
    size_t entry_idx;
    void *userdata;
    void *actiondata;
+   /* Entry of a virtual list that was not materialized yet. */
+   bool pending;
 };
 
-typedef struct file_list
+typedef struct file_list file_list_t;
+
+/* Fills in entry @idx of a virtual list, typically with
+ * file_list_set_at_offset. */
+typedef void (*file_list_materialize_t)(file_list_t *list,
+      size_t idx, void *data);
+
+struct file_list
 {
    struct item_file *list;
 
    size_t capacity;
    size_t size;
-} file_list_t;
+
+   /* Virtual lists, see file_list_append_virtual. */
+   file_list_materialize_t materialize;
+   void *materialize_data;
+   size_t pending;
+};
 
 
 void *file_list_get_userdata_at_offset(const file_list_t *list, 
@@ -87,6 +101,43 @@ bool file_list_append(file_list_t *userdata, const char *path,
       const char *label, unsigned type, size_t current_directory_ptr,
       size_t entry_index);
 
+/**
+ * @brief appends entries that are only filled in once they are used
+ *
+ * Adds @count empty entries with entry_idx 0 to @count - 1.
+ * @materialize is called to fill one in when file_list_materialize
+ * covers it, so a list of thousands of entries costs only what is
+ * shown of it. The getters do not materialize anything and return
+ * pending entries empty, which keeps them safe to call from a thread
+ * that only reads the list. Setters and sorting materialize what
+ * they touch.
+ *
+ * The list takes ownership of @data and free()s it when it is
+ * cleared or freed. A list can hold one virtual range at a time.
+ *
+ * @param list
+ * @param count
+ * @param materialize
+ * @param data
+ * @return whether or not the operation succeeded
+ */
+bool file_list_append_virtual(file_list_t *list, size_t count,
+      file_list_materialize_t materialize, void *data);
+
+/**
+ * @brief materializes all pending entries in [start, end)
+ *
+ * @param list
+ * @param start
+ * @param end
+ */
+void file_list_materialize(file_list_t *list,
+      size_t start, size_t end);
+
+void file_list_set_at_offset(file_list_t *list, size_t idx,
+      const char *path, const char *label,
+      unsigned type, size_t entry_idx);
+
 bool file_list_prepend(file_list_t *list,
       const char *path, const char *label,
       unsigned type, size_t directory_ptr,
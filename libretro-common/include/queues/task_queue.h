@@ -42,6 +42,22 @@ enum task_type
    TASK_TYPE_BLOCKING
 };
 
+/* Only used by the threaded task queue, where ready tasks
+ * of a higher class are always stepped first. */
+enum task_priority
+{
+   /* Default class: downloads, file I/O, saves. */
+   TASK_PRIORITY_IO = 0,
+   /* Work the user is actively waiting on, e.g. thumbnails. */
+   TASK_PRIORITY_INTERACTIVE,
+   /* Long-running jobs, e.g. content database scans. */
+   TASK_PRIORITY_BACKGROUND,
+   TASK_PRIORITY_LAST
+};
+
+/* Number of exclusive classes, see retro_task::exclusive. */
+#define TASK_EXCLUSIVE_MAX 8
+
 
 typedef struct retro_task retro_task_t;
 typedef void (*retro_task_callback_t)(void *task_data,
@@ -108,6 +124,14 @@ struct retro_task
 
    enum task_type type;
 
+   enum task_priority priority;
+
+   /* Tasks with the same non-zero class (below TASK_EXCLUSIVE_MAX)
+    * are never stepped at the same time by the threaded task
+    * queue, for handlers that touch shared global state.
+    * 0 means the handler can run alongside any other task. */
+   unsigned exclusive;
+
    /* don't touch this. */
    retro_task_t *next;
 };
@@ -177,6 +201,15 @@ void task_queue_unset_threaded(void);
 
 bool task_queue_is_threaded(void);
 
+/* Sets the amount of worker threads used by the threaded
+ * task queue. 0 picks the amount of CPU cores minus one.
+ * Takes effect on the next call to task_queue_check(). */
+void task_queue_set_num_workers(unsigned num);
+
+/* Returns the amount of running worker threads,
+ * 0 if the task queue is not threaded. */
+unsigned task_queue_get_num_workers(void);
+
 /**		
  * Calls func for every running task		
  * until it returns true.		
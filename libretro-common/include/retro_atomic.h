@@ -0,0 +1,68 @@
+/* Copyright  (C) 2010-2017 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (retro_atomic.h).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __LIBRETRO_SDK_ATOMIC_H
+#define __LIBRETRO_SDK_ATOMIC_H
+
+/* Minimal set of atomic operations on an int, enough for
+ * single-producer/single-consumer handoffs between two threads.
+ *
+ * HAVE_RETRO_ATOMIC is defined when the compiler provides them.
+ * Callers must keep a lock based fallback for when it is not. */
+
+#if defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7) || defined(__clang__))
+#define HAVE_RETRO_ATOMIC 1
+
+typedef volatile int retro_atomic_int_t;
+
+#define retro_atomic_load_acquire(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define retro_atomic_store_release(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define retro_atomic_xchg(p, v)          __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+#define retro_atomic_fetch_add(p, v)     __atomic_fetch_add((p), (v), __ATOMIC_ACQ_REL)
+
+#elif defined(__GNUC__) && ((__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+#define HAVE_RETRO_ATOMIC 1
+
+typedef volatile int retro_atomic_int_t;
+
+/* __sync builtins are full barriers. */
+#define retro_atomic_load_acquire(p)     __sync_fetch_and_add((p), 0)
+#define retro_atomic_store_release(p, v) do { __sync_synchronize(); *(p) = (v); __sync_synchronize(); } while (0)
+#define retro_atomic_xchg(p, v)          (__sync_synchronize(), __sync_lock_test_and_set((p), (v)))
+#define retro_atomic_fetch_add(p, v)     __sync_fetch_and_add((p), (v))
+
+#elif defined(_MSC_VER) && _MSC_VER >= 1400 && !defined(_XBOX)
+#define HAVE_RETRO_ATOMIC 1
+
+#include <intrin.h>
+
+typedef volatile long retro_atomic_int_t;
+
+/* Interlocked operations are full barriers. */
+#define retro_atomic_load_acquire(p)     _InterlockedOr((p), 0)
+#define retro_atomic_store_release(p, v) ((void)_InterlockedExchange((p), (v)))
+#define retro_atomic_xchg(p, v)          _InterlockedExchange((p), (v))
+#define retro_atomic_fetch_add(p, v)     _InterlockedExchangeAdd((p), (v))
+
+#endif
+
+#endif
@@ -0,0 +1,59 @@
+/* Copyright  (C) 2010-2017 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (retro_simd.h).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __LIBRETRO_SDK_SIMD_H
+#define __LIBRETRO_SDK_SIMD_H
+
+/* Code paths that are picked at runtime, with
+ * cpu_features_get_simd().
+ *
+ * RETRO_HAVE_AVX2 is defined when the compiler can build AVX2
+ * functions without targeting AVX2 for the whole file. Such
+ * functions are declared with RETRO_TARGET_AVX2.
+ *
+ * RETRO_HAVE_NEON is defined when the build targets a little
+ * endian CPU with NEON.
+ *
+ * A file that has its own way of turning SIMD off can #undef
+ * these after including this header. */
+
+#if defined(__x86_64__) || defined(__i386__) || defined(__i486__) || defined(__i686__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define RETRO_HAVE_AVX2
+#define RETRO_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && _MSC_VER >= 1900
+#define RETRO_HAVE_AVX2
+#define RETRO_TARGET_AVX2
+#endif
+#endif
+
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON)) && !defined(__ARMEB__) && !defined(__AARCH64EB__) && !defined(__ARM_BIG_ENDIAN)
+#define RETRO_HAVE_NEON
+#endif
+
+#if defined(RETRO_HAVE_AVX2)
+#include <immintrin.h>
+#elif defined(RETRO_HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
+#endif
@@ -39,8 +39,58 @@ typedef struct chdstream chdstream_t;
 /* Primary (largest) data track, used for CRC identification purposes */
 #define CHDSTREAM_TRACK_PRIMARY (-3)
 
+/* Decompressed hunks kept per stream by default */
+#define CHDSTREAM_CACHE_HUNKS 16
+/* Hunks decompressed ahead of sequential reads by default */
+#define CHDSTREAM_READ_AHEAD 4
+/* Most threads used when picking one per spare core */
+#define CHDSTREAM_READ_AHEAD_MAX_THREADS 8
+
+/**
+ * chdstream_set_cache:
+ * @hunks                : decompressed hunks to keep per stream.
+ * @read_ahead           : hunks to decompress ahead of sequential
+ *                         reads on a background thread, 0 to
+ *                         disable. Ignored without HAVE_THREADS.
+ *
+ * Sets the hunk cache of streams opened from now on. Hunks
+ * are evicted least recently used first, so streams that
+ * bounce between tracks or seek back do not decompress the
+ * same hunks over and over.
+ **/
+void chdstream_set_cache(unsigned hunks, unsigned read_ahead);
+
+/**
+ * chdstream_open:
+ * @path                 : path of the CHD image.
+ * @track                : track number or one of CHDSTREAM_TRACK_*.
+ *
+ * Opens @track of @path, reading ahead on a single thread.
+ *
+ * Returns: the stream, or NULL on error.
+ **/
 chdstream_t *chdstream_open(const char *path, int32_t track);
 
+/**
+ * chdstream_open_threaded:
+ * @path                 : path of the CHD image.
+ * @track                : track number or one of CHDSTREAM_TRACK_*.
+ * @threads              : threads decompressing hunks ahead of
+ *                         sequential reads, 0 for one per core
+ *                         besides the reading one.
+ *
+ * Hunks are independent, so a stream read from start to end,
+ * as when computing the CRC of a track, is decompressed by
+ * @threads threads at once and still delivered in order. The
+ * read-ahead window grows to at least two hunks per thread.
+ * Each thread opens the image again, so only open streams
+ * this way that are read whole, one at a time.
+ *
+ * Returns: the stream, or NULL on error.
+ **/
+chdstream_t *chdstream_open_threaded(const char *path, int32_t track,
+      unsigned threads);
+
 void chdstream_close(chdstream_t *stream);
 
 ssize_t chdstream_read(chdstream_t *stream, void *data, size_t bytes);
@@ -96,6 +96,17 @@ FILE* filestream_get_fp(RFILE *stream);
 
 int filestream_flush(RFILE *stream);
 
+/**
+ * filestream_sync:
+ * @stream             : file stream
+ *
+ * Flushes @stream and asks the OS to commit its data to the
+ * storage device, where the platform supports it.
+ *
+ * Returns: 0 on success, -1 on failure.
+ **/
+int filestream_sync(RFILE *stream);
+
 RETRO_END_DECLS
 
 #endif
@@ -56,6 +56,9 @@ typedef struct intfstream_info
    {
       void *handle;
       int32_t track;
+      /* Decompress ahead on one thread per spare core, for
+       * tracks that are read whole. */
+      bool threaded;
    } chd;
    enum intfstream_type type;
 } intfstream_info_t;
@@ -25,10 +25,41 @@
 #include <string.h>
 
 #include <retro_common.h>
+#include <retro_inline.h>
 #include <lists/file_list.h>
 #include <string/stdstring.h>
 #include <compat/strcasestr.h>
 
+void file_list_materialize(file_list_t *list,
+      size_t start, size_t end)
+{
+   size_t i;
+
+   if (!list || !list->pending || !list->materialize)
+      return;
+
+   if (end > list->size)
+      end = list->size;
+
+   for (i = start; i < end && list->pending; i++)
+   {
+      if (!list->list[i].pending)
+         continue;
+
+      list->list[i].pending = false;
+      list->pending--;
+      list->materialize(list, i, list->materialize_data);
+   }
+}
+
+static void file_list_clear_virtual(file_list_t *list)
+{
+   free(list->materialize_data);
+   list->materialize      = NULL;
+   list->materialize_data = NULL;
+   list->pending          = 0;
+}
+
 bool file_list_reserve(file_list_t *list, size_t nitems)
 {
    const size_t item_size = sizeof(struct item_file);
@@ -63,6 +94,7 @@ static void file_list_add(file_list_t *list, unsigned idx,
    list->list[idx].entry_idx     = entry_idx;
    list->list[idx].userdata      = NULL;
    list->list[idx].actiondata    = NULL;
+   list->list[idx].pending       = false;
 
    if (label)
       list->list[idx].label      = strdup(label);
@@ -123,6 +155,61 @@ bool file_list_append(file_list_t *list,
    return true;
 }
 
+bool file_list_append_virtual(file_list_t *list, size_t count,
+      file_list_materialize_t materialize, void *data)
+{
+   size_t i;
+
+   if (!list || !materialize || list->materialize)
+      goto error;
+
+   if (list->size + count > list->capacity
+         && !file_list_reserve(list, list->size + count))
+      goto error;
+
+   for (i = 0; i < count; i++)
+   {
+      struct item_file *item = &list->list[list->size + i];
+
+      memset(item, 0, sizeof(*item));
+      item->entry_idx        = i;
+      item->pending          = true;
+   }
+
+   list->size            += count;
+   list->pending          = count;
+   list->materialize      = materialize;
+   list->materialize_data = data;
+
+   return true;
+
+error:
+   free(data);
+   return false;
+}
+
+void file_list_set_at_offset(file_list_t *list, size_t idx,
+      const char *path, const char *label,
+      unsigned type, size_t entry_idx)
+{
+   struct item_file *item = NULL;
+
+   if (!list)
+      return;
+
+   item = &list->list[idx];
+
+   if (item->path)
+      free(item->path);
+   if (item->label)
+      free(item->label);
+
+   item->path      = path  ? strdup(path)  : NULL;
+   item->label     = label ? strdup(label) : NULL;
+   item->type      = type;
+   item->entry_idx = entry_idx;
+}
+
 size_t file_list_get_size(const file_list_t *list)
 {
    if (!list)
@@ -145,6 +232,12 @@ void file_list_pop(file_list_t *list, size_t *directory_ptr)
    if (list->size != 0)
    {
       --list->size;
+      if (list->list[list->size].pending)
+      {
+         list->list[list->size].pending = false;
+         list->pending--;
+      }
+
       if (list->list[list->size].path)
          free(list->list[list->size].path);
       list->list[list->size].path = NULL;
@@ -185,6 +278,7 @@ void file_list_free(file_list_t *list)
    if (list->list)
       free(list->list);
    list->list = NULL;
+   file_list_clear_virtual(list);
    free(list);
 }
 
@@ -208,9 +302,12 @@ void file_list_clear(file_list_t *list)
       if (list->list[i].alt)
          free(list->list[i].alt);
       list->list[i].alt = NULL;
+
+      list->list[i].pending = false;
    }
 
    list->size = 0;
+   file_list_clear_virtual(list);
 }
 
 void file_list_copy(const file_list_t *src, file_list_t *dst)
@@ -255,8 +352,15 @@ void file_list_copy(const file_list_t *src, file_list_t *dst)
 
    memcpy(dst->list, src->list, dst->size * sizeof(struct item_file));
 
+   /* Entries still pending in @src stay empty in @dst. */
+   dst->materialize      = NULL;
+   dst->materialize_data = NULL;
+   dst->pending          = 0;
+
    for (item = dst->list; item < &dst->list[dst->size]; ++item)
    {
+      item->pending  = false;
+
       if (item->path)
          item->path  = strdup(item->path);
 
@@ -274,6 +378,8 @@ void file_list_set_label_at_offset(file_list_t *list, size_t idx,
    if (!list)
       return;
 
+   file_list_materialize(list, idx, idx + 1);
+
    if (list->list[idx].label)
       free(list->list[idx].label);
    list->list[idx].alt      = NULL;
@@ -299,6 +405,8 @@ void file_list_set_alt_at_offset(file_list_t *list, size_t idx,
    if (!list || !alt)
       return;
 
+   file_list_materialize(list, idx, idx + 1);
+
    if (list->list[idx].alt)
       free(list->list[idx].alt);
    list->list[idx].alt      = NULL;
@@ -341,11 +449,13 @@ static int file_list_type_cmp(const void *a_, const void *b_)
 
 void file_list_sort_on_alt(file_list_t *list)
 {
+   file_list_materialize(list, 0, list->size);
    qsort(list->list, list->size, sizeof(list->list[0]), file_list_alt_cmp);
 }
 
 void file_list_sort_on_type(file_list_t *list)
 {
+   file_list_materialize(list, 0, list->size);
    qsort(list->list, list->size, sizeof(list->list[0]), file_list_type_cmp);
 }
 
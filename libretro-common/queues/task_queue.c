@@ -28,6 +28,7 @@
 
 #ifdef HAVE_THREADS
 #include <rthreads/rthreads.h>
+#include <features/features_cpu.h>
 #define SLOCK_LOCK(x) slock_lock(x)
 #define SLOCK_UNLOCK(x) slock_unlock(x)
 #else
@@ -282,60 +283,231 @@ static struct retro_task_impl impl_regular = {
 };
 
 #ifdef HAVE_THREADS
-static slock_t *running_lock    = NULL;
-static slock_t *finished_lock   = NULL;
-static slock_t *property_lock   = NULL;
-static slock_t *queue_lock      = NULL;
-static scond_t *worker_cond     = NULL;
-static sthread_t *worker_thread = NULL;
-static bool worker_continue     = true; /* use running_lock when touching it */
+#define TASK_WORKERS_MAX 16
 
-static void task_queue_remove(task_queue_t *queue, retro_task_t *task)
+/* Ready tasks of one priority class owned by a worker. The owner
+ * takes from the front (oldest first, so long-running tasks are
+ * still stepped in a round-robin fashion), thieves take from
+ * the back. */
+typedef struct
+{
+   retro_task_t **elems;
+   size_t capacity;
+   size_t head;
+   size_t count;
+} task_deque_t;
+
+typedef struct
 {
-   retro_task_t     *t = NULL;
-   retro_task_t *front = NULL;
+   task_deque_t ready[TASK_PRIORITY_LAST];
+   slock_t *lock;
+   sthread_t *thread;
+   unsigned id;
+} task_worker_t;
+
+static slock_t *running_lock          = NULL;
+static slock_t *finished_lock         = NULL;
+static slock_t *property_lock         = NULL;
+static slock_t *worker_lock           = NULL;
+static scond_t *worker_cond           = NULL;
+/* Held while stepping a task of that class, 0 has none. */
+static slock_t *exclusive_locks[TASK_EXCLUSIVE_MAX];
+static task_worker_t task_workers[TASK_WORKERS_MAX];
+static unsigned task_workers_count    = 0;
+static unsigned task_workers_wanted   = 0; /* 0 means automatic */
+static unsigned task_workers_next     = 0; /* use worker_lock when touching it */
+static unsigned tasks_pending         = 0; /* use worker_lock when touching it */
+static bool worker_continue           = true; /* use worker_lock when touching it */
+
+/* Lower rank is served first. */
+static const unsigned task_priority_rank[TASK_PRIORITY_LAST] = {
+   1, /* TASK_PRIORITY_IO          */
+   0, /* TASK_PRIORITY_INTERACTIVE */
+   2  /* TASK_PRIORITY_BACKGROUND  */
+};
 
-   slock_lock(queue_lock);
-   front = queue->front;
-   slock_unlock(queue_lock);
+static unsigned task_queue_resolve_num_workers(void)
+{
+   static unsigned cores = 0;
+   unsigned num          = task_workers_wanted;
 
-   /* Remove first element if needed */
-   if (task == front)
+   if (num == 0)
    {
-      slock_lock(queue_lock);
-      queue->front = task->next;
-      slock_unlock(queue_lock);
-      task->next   = NULL;
-       
-      return;
+      /* Queried once, this runs on every task_queue_check(). */
+      if (cores == 0)
+         cores = cpu_features_get_core_amount();
+      num = cores > 1 ? cores - 1 : 1;
+   }
+
+   if (num > TASK_WORKERS_MAX)
+      num = TASK_WORKERS_MAX;
+
+   return num;
+}
+
+static bool task_deque_push_back(task_deque_t *dq, retro_task_t *task)
+{
+   if (dq->count == dq->capacity)
+   {
+      size_t i;
+      size_t new_cap         = dq->capacity ? dq->capacity * 2 : 16;
+      retro_task_t **elems   = (retro_task_t**)
+         malloc(new_cap * sizeof(*elems));
+
+      if (!elems)
+         return false;
+
+      for (i = 0; i < dq->count; i++)
+         elems[i] = dq->elems[(dq->head + i) % dq->capacity];
+
+      free(dq->elems);
+      dq->elems    = elems;
+      dq->capacity = new_cap;
+      dq->head     = 0;
+   }
+
+   dq->elems[(dq->head + dq->count) % dq->capacity] = task;
+   dq->count++;
+
+   return true;
+}
+
+static retro_task_t *task_deque_pop_front(task_deque_t *dq)
+{
+   retro_task_t *task = NULL;
+
+   if (dq->count == 0)
+      return NULL;
+
+   task     = dq->elems[dq->head];
+   dq->head = (dq->head + 1) % dq->capacity;
+   dq->count--;
+
+   return task;
+}
+
+static retro_task_t *task_deque_pop_back(task_deque_t *dq)
+{
+   if (dq->count == 0)
+      return NULL;
+
+   dq->count--;
+
+   return dq->elems[(dq->head + dq->count) % dq->capacity];
+}
+
+static void task_deque_free(task_deque_t *dq)
+{
+   free(dq->elems);
+   dq->elems    = NULL;
+   dq->capacity = 0;
+   dq->head     = 0;
+   dq->count    = 0;
+}
+
+/* Must be called with running_lock held. */
+static void task_queue_remove(task_queue_t *queue, retro_task_t *task)
+{
+   retro_task_t *prev = NULL;
+   retro_task_t *t    = queue->front;
+
+   for (; t; prev = t, t = t->next)
+   {
+      if (t != task)
+         continue;
+
+      if (prev)
+         prev->next   = task->next;
+      else
+         queue->front = task->next;
+
+      if (queue->back == task)
+         queue->back  = prev;
+
+      task->next      = NULL;
+      break;
    }
+}
 
-   /* Parse queue */
-   t = front;
-    
-   while (t && t->next)
+/**
+ * task_worker_enqueue:
+ * @id                   : worker which will own the task.
+ * @task                 : task ready to be stepped.
+ * @wake                 : signal a sleeping worker even if
+ *                         this is the only pending task.
+ *
+ * Adds a task to the ready queue of its priority class.
+ **/
+static void task_worker_enqueue(unsigned id,
+      retro_task_t *task, bool wake)
+{
+   task_worker_t *worker = &task_workers[id];
+   unsigned prio         = task->priority < TASK_PRIORITY_LAST
+      ? task->priority : TASK_PRIORITY_IO;
+
+   slock_lock(worker->lock);
+   task_deque_push_back(&worker->ready[task_priority_rank[prio]], task);
+   slock_unlock(worker->lock);
+
+   slock_lock(worker_lock);
+   tasks_pending++;
+   /* A worker re-queueing its own task will pick it up
+    * again right away, so only wake up others when there
+    * is more work than it can take. */
+   if (wake || tasks_pending > 1)
+      scond_signal(worker_cond);
+   slock_unlock(worker_lock);
+}
+
+/* Takes the highest priority ready task, looking at the
+ * worker's own queues first and stealing from the others
+ * otherwise. */
+static retro_task_t *task_worker_take(task_worker_t *self)
+{
+   unsigned rank, i;
+
+   for (rank = 0; rank < TASK_PRIORITY_LAST; rank++)
    {
-      /* Remove task and update queue */
-      if (t->next == task)
+      for (i = 0; i < task_workers_count; i++)
       {
-         t->next    = task->next;
-         task->next = NULL;
-         break;
-      }
+         retro_task_t *task    = NULL;
+         task_worker_t *victim = &task_workers[
+            (self->id + i) % task_workers_count];
+
+         slock_lock(victim->lock);
+         if (victim == self)
+            task = task_deque_pop_front(&victim->ready[rank]);
+         else
+            task = task_deque_pop_back(&victim->ready[rank]);
+         slock_unlock(victim->lock);
+
+         if (!task)
+            continue;
 
-      /* Update iterator */
-      t = t->next;
+         slock_lock(worker_lock);
+         tasks_pending--;
+         slock_unlock(worker_lock);
+
+         return task;
+      }
    }
+
+   return NULL;
 }
 
 static void retro_task_threaded_push_running(retro_task_t *task)
 {
+   unsigned id;
+
    slock_lock(running_lock);
-   slock_lock(queue_lock);
    task_queue_put(&tasks_running, task);
-   scond_signal(worker_cond);
-   slock_unlock(queue_lock);
    slock_unlock(running_lock);
+
+   slock_lock(worker_lock);
+   id = task_workers_next++ % task_workers_count;
+   slock_unlock(worker_lock);
+
+   task_worker_enqueue(id, task, true);
 }
 
 static void retro_task_threaded_cancel(void *task)
@@ -433,91 +605,144 @@ static void retro_task_threaded_retrieve(task_retriever_data_t *data)
 
 static void threaded_worker(void *userdata)
 {
-   (void)userdata;
+   task_worker_t *self = (task_worker_t*)userdata;
 
    for (;;)
    {
       retro_task_t *task  = NULL;
-      bool finished = false;
-
-      if (!worker_continue)
-         break; /* should we keep running until all tasks finished? */
+      slock_t *exclusive  = NULL;
+      bool keep_running   = false;
+      bool finished       = false;
+
+      /* Stop as soon as deinit asks, whatever is still
+       * queued is left in tasks_running. */
+      slock_lock(worker_lock);
+      while (worker_continue && tasks_pending == 0)
+         scond_wait(worker_cond, worker_lock);
+      keep_running = worker_continue;
+      slock_unlock(worker_lock);
+
+      if (!keep_running)
+         break;
 
-      slock_lock(running_lock);
+      /* Another worker may have taken it first. */
+      task = task_worker_take(self);
 
-      /* Get first task to run */
-      task = tasks_running.front;
-      if (task == NULL)
-      {
-         scond_wait(worker_cond, running_lock);
-         slock_unlock(running_lock);
+      if (!task)
          continue;
-      }
 
-      slock_unlock(running_lock);
+      if (task->exclusive < TASK_EXCLUSIVE_MAX)
+         exclusive = exclusive_locks[task->exclusive];
 
+      if (exclusive)
+         slock_lock(exclusive);
       task->handler(task);
+      if (exclusive)
+         slock_unlock(exclusive);
 
       slock_lock(property_lock);
       finished = task->finished;
       slock_unlock(property_lock);
 
-      slock_lock(running_lock);
-      task_queue_remove(&tasks_running, task);
-      slock_unlock(running_lock);
-
       /* Update queue */
       if (!finished)
       {
-         /* Re-add task to running queue */
-         retro_task_threaded_push_running(task);
-      }
-      else
-      {
-         /* Add task to finished queue */
-         slock_lock(finished_lock);
-         task_queue_put(&tasks_finished, task);
-         slock_unlock(finished_lock);
+         /* Re-add task to our own ready queue */
+         task_worker_enqueue(self->id, task, false);
+         continue;
       }
+
+      slock_lock(running_lock);
+      task_queue_remove(&tasks_running, task);
+      slock_unlock(running_lock);
+
+      /* Add task to finished queue */
+      slock_lock(finished_lock);
+      task_queue_put(&tasks_finished, task);
+      slock_unlock(finished_lock);
    }
 }
 
 static void retro_task_threaded_init(void)
 {
-   running_lock  = slock_new();
-   finished_lock = slock_new();
-   property_lock = slock_new();
-   queue_lock    = slock_new();
-   worker_cond   = scond_new();
+   unsigned i;
+   retro_task_t *task = NULL;
 
-   slock_lock(running_lock);
+   running_lock       = slock_new();
+   finished_lock      = slock_new();
+   property_lock      = slock_new();
+   worker_lock        = slock_new();
+   worker_cond        = scond_new();
+
+   for (i = 1; i < TASK_EXCLUSIVE_MAX; i++)
+      exclusive_locks[i] = slock_new();
+
+   task_workers_count = task_queue_resolve_num_workers();
+   task_workers_next  = 0;
+   tasks_pending      = 0;
+
+   for (i = 0; i < task_workers_count; i++)
+   {
+      task_workers[i].id   = i;
+      task_workers[i].lock = slock_new();
+   }
+
+   /* Tasks left on hold by a previous deinit get
+    * distributed again before the workers start. */
+   for (task = tasks_running.front; task; task = task->next)
+      task_worker_enqueue(task_workers_next++ % task_workers_count,
+            task, false);
+
+   slock_lock(worker_lock);
    worker_continue = true;
-   slock_unlock(running_lock);
+   slock_unlock(worker_lock);
 
-   worker_thread = sthread_create(threaded_worker, NULL);
+   for (i = 0; i < task_workers_count; i++)
+      task_workers[i].thread = sthread_create(threaded_worker,
+            &task_workers[i]);
 }
 
 static void retro_task_threaded_deinit(void)
 {
-   slock_lock(running_lock);
+   unsigned i, j;
+
+   slock_lock(worker_lock);
    worker_continue = false;
-   scond_signal(worker_cond);
-   slock_unlock(running_lock);
+   scond_broadcast(worker_cond);
+   slock_unlock(worker_lock);
+
+   for (i = 0; i < task_workers_count; i++)
+      sthread_join(task_workers[i].thread);
+
+   /* Tasks that did not finish stay in tasks_running,
+    * retro_task_threaded_init hands them out again. */
+   for (i = 0; i < task_workers_count; i++)
+   {
+      for (j = 0; j < TASK_PRIORITY_LAST; j++)
+         task_deque_free(&task_workers[i].ready[j]);
+      slock_free(task_workers[i].lock);
+      task_workers[i].lock   = NULL;
+      task_workers[i].thread = NULL;
+   }
 
-   sthread_join(worker_thread);
+   for (i = 1; i < TASK_EXCLUSIVE_MAX; i++)
+   {
+      slock_free(exclusive_locks[i]);
+      exclusive_locks[i] = NULL;
+   }
 
    scond_free(worker_cond);
    slock_free(running_lock);
    slock_free(finished_lock);
    slock_free(property_lock);
-   slock_free(queue_lock);
-
-   worker_thread = NULL;
-   worker_cond   = NULL;
-   running_lock  = NULL;
-   finished_lock = NULL;
-   property_lock = NULL;
-   queue_lock = NULL;
+   slock_free(worker_lock);
+
+   task_workers_count = 0;
+   worker_cond        = NULL;
+   running_lock       = NULL;
+   finished_lock      = NULL;
+   property_lock      = NULL;
+   worker_lock        = NULL;
 }
 
 static struct retro_task_impl impl_threaded = {
@@ -578,6 +803,22 @@ bool task_queue_is_threaded(void)
    return task_threaded_enable;
 }
 
+void task_queue_set_num_workers(unsigned num)
+{
+#ifdef HAVE_THREADS
+   task_workers_wanted = num;
+#endif
+}
+
+unsigned task_queue_get_num_workers(void)
+{
+#ifdef HAVE_THREADS
+   if (impl_current == &impl_threaded)
+      return task_workers_count;
+#endif
+   return 0;
+}
+
 bool task_queue_find(task_finder_data_t *find_data)
 {
    if (!impl_current->find(find_data->func, find_data->userdata))
@@ -598,6 +839,9 @@ void task_queue_check(void)
 
    if (want_threaded != current_threaded)
       task_queue_deinit();
+   else if (current_threaded &&
+         task_workers_count != task_queue_resolve_num_workers())
+      task_queue_deinit();
 
    if (!impl_current)
       task_queue_init(want_threaded, msg_push_bak);
@@ -614,7 +858,7 @@ void task_queue_push(retro_task_t *task)
       retro_task_t *running = NULL;
       bool found = false;
 
-      SLOCK_LOCK(queue_lock);
+      SLOCK_LOCK(running_lock);
       running = tasks_running.front;
 
       for (; running; running = running->next)
@@ -626,7 +870,7 @@ void task_queue_push(retro_task_t *task)
          }
       }
 
-      SLOCK_UNLOCK(queue_lock);
+      SLOCK_UNLOCK(running_lock);
 
       /* skip this task, user must try again later */
       if (found)
@@ -0,0 +1,114 @@
+/* Checks every CRC32 implementation the CPU supports against the
+ * table driven reference, then reports the throughput of each.
+ *
+ * Usage: crc32_bench [MiB] [passes] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <encodings/crc32.h>
+#include <features/features_cpu.h>
+
+static const char *impl_names[ENCODING_CRC32_IMPL_LAST] = {
+   "auto",
+   "table",
+   "slice-by-8",
+   "pclmul",
+   "armv8"
+};
+
+static uint32_t crc_with(enum encoding_crc32_impl impl,
+      uint32_t crc, const uint8_t *buf, size_t len)
+{
+   encoding_crc32_set_impl(impl);
+   return encoding_crc32(crc, buf, len);
+}
+
+/* Every length up to 1 KiB at every alignment up to 16, plus
+ * a split update, has to match the reference bit for bit. */
+static bool verify(enum encoding_crc32_impl impl, const uint8_t *data)
+{
+   size_t len, offset;
+
+   if (crc_with(impl, 0, (const uint8_t*)"123456789", 9) != 0xcbf43926)
+      return false;
+
+   for (offset = 0; offset < 16; offset++)
+   {
+      for (len = 0; len <= 1024; len++)
+      {
+         uint32_t expected = crc_with(ENCODING_CRC32_IMPL_TABLE,
+               0, data + offset, len);
+         uint32_t split    = crc_with(impl, 0, data + offset, len / 3);
+
+         if (crc_with(impl, 0, data + offset, len) != expected)
+            return false;
+
+         split = crc_with(impl, split, data + offset + len / 3,
+               len - len / 3);
+
+         if (split != expected)
+            return false;
+      }
+   }
+
+   return true;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, pass;
+   size_t mib      = argc > 1 ? (size_t)strtoul(argv[1], NULL, 0) : 64;
+   unsigned passes = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 0) : 4;
+   size_t size     = mib * 1024 * 1024;
+   uint8_t *data   = (uint8_t*)malloc(size + 16);
+   int failures    = 0;
+
+   if (!data || size < 2048)
+   {
+      printf("Usage: %s [MiB >= 1] [passes]\n", argv[0]);
+      free(data);
+      return 1;
+   }
+
+   srand(0x1234);
+   for (i = 0; i < size + 16; i++)
+      data[i] = (uint8_t)rand();
+
+   encoding_crc32_set_impl(ENCODING_CRC32_IMPL_AUTO);
+   printf("Auto-selected: %s\n", impl_names[encoding_crc32_get_impl()]);
+
+   for (i = ENCODING_CRC32_IMPL_TABLE; i < ENCODING_CRC32_IMPL_LAST; i++)
+   {
+      retro_time_t start, elapsed;
+      uint32_t crc = 0;
+
+      if (!encoding_crc32_impl_available((enum encoding_crc32_impl)i))
+      {
+         printf("%-12s not supported\n", impl_names[i]);
+         continue;
+      }
+
+      if (!verify((enum encoding_crc32_impl)i, data))
+      {
+         printf("%-12s MISMATCH\n", impl_names[i]);
+         failures++;
+         continue;
+      }
+
+      encoding_crc32_set_impl((enum encoding_crc32_impl)i);
+
+      start = cpu_features_get_time_usec();
+      for (pass = 0; pass < passes; pass++)
+         crc = encoding_crc32(crc, data, size);
+      elapsed = cpu_features_get_time_usec() - start;
+
+      printf("%-12s %8.2f GB/s  (crc %08x)\n", impl_names[i],
+            (double)size * passes / (elapsed / 1000000.0) / 1e9, crc);
+   }
+
+   free(data);
+
+   return failures ? 1 : 0;
+}
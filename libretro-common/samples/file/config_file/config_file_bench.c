@@ -0,0 +1,167 @@
+/* Copyright  (C) 2010-2017 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (config_file_bench.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Loads a config file the way RetroArch does at startup: parse it,
+ * look every setting up (plus some that are not in the file, as
+ * with overrides and remaps), then write every setting back as on
+ * config save. Prints the average time of each step. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <file/config_file.h>
+#include <features/features_cpu.h>
+#include <compat/strl.h>
+
+#define MISSING_KEYS 300
+
+/* Provided by RetroArch's file_path_special.c. */
+void fill_pathname_expand_special(char *out_path,
+      const char *in_path, size_t size)
+{
+   strlcpy(out_path, in_path, size);
+}
+
+void fill_pathname_abbreviate_special(char *out_path,
+      const char *in_path, size_t size)
+{
+   strlcpy(out_path, in_path, size);
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, pass;
+   struct config_file_entry entry;
+   char buf[8192];
+   char **keys           = NULL;
+   char **values         = NULL;
+   unsigned count        = 0;
+   unsigned passes       = 100;
+   retro_time_t t_load   = 0;
+   retro_time_t t_get    = 0;
+   retro_time_t t_set    = 0;
+   retro_time_t t_free   = 0;
+   config_file_t *conf   = NULL;
+
+   if (argc < 2)
+   {
+      printf("Usage: %s <config file> [passes]\n", argv[0]);
+      return 1;
+   }
+
+   if (argc > 2)
+      passes = (unsigned)strtoul(argv[2], NULL, 0);
+   if (!passes)
+      passes = 1;
+
+   conf = config_file_new(argv[1]);
+   if (!conf)
+   {
+      printf("Could not load '%s'.\n", argv[1]);
+      return 1;
+   }
+
+   if (config_get_entry_list_head(conf, &entry))
+   {
+      do
+      {
+         count++;
+      } while (config_get_entry_list_next(&entry));
+   }
+
+   keys   = (char**)calloc(count + MISSING_KEYS, sizeof(*keys));
+   values = (char**)calloc(count, sizeof(*values));
+
+   i = 0;
+   if (config_get_entry_list_head(conf, &entry))
+   {
+      do
+      {
+         keys[i]   = strdup(entry.key);
+         values[i] = strdup(entry.value);
+         i++;
+      } while (config_get_entry_list_next(&entry));
+   }
+
+   for (i = 0; i < MISSING_KEYS; i++)
+   {
+      snprintf(buf, sizeof(buf), "missing_setting_%u", i);
+      keys[count + i] = strdup(buf);
+   }
+
+   config_file_free(conf);
+
+   for (pass = 0; pass < passes; pass++)
+   {
+      retro_time_t start = cpu_features_get_time_usec();
+
+      conf   = config_file_new(argv[1]);
+      t_load += cpu_features_get_time_usec() - start;
+
+      if (!conf)
+      {
+         printf("Could not reload '%s'.\n", argv[1]);
+         return 1;
+      }
+
+      start  = cpu_features_get_time_usec();
+      for (i = 0; i < count + MISSING_KEYS; i++)
+      {
+         bool found = config_get_array(conf, keys[i], buf, sizeof(buf));
+
+         if (found != (i < count) || (found && strcmp(buf, values[i])))
+         {
+            printf("Wrong lookup result for '%s'.\n", keys[i]);
+            return 1;
+         }
+      }
+      t_get  += cpu_features_get_time_usec() - start;
+
+      start  = cpu_features_get_time_usec();
+      for (i = 0; i < count; i++)
+         config_set_string(conf, keys[i], values[i]);
+      t_set  += cpu_features_get_time_usec() - start;
+
+      start  = cpu_features_get_time_usec();
+      config_file_free(conf);
+      t_free += cpu_features_get_time_usec() - start;
+   }
+
+   printf("%u keys, %u lookups per pass, %u passes\n",
+         count, count + MISSING_KEYS, passes);
+   printf("load  %9.1f us\n", (double)t_load / passes);
+   printf("get   %9.1f us\n", (double)t_get  / passes);
+   printf("set   %9.1f us\n", (double)t_set  / passes);
+   printf("free  %9.1f us\n", (double)t_free / passes);
+   printf("total %9.1f us\n",
+         (double)(t_load + t_get + t_set + t_free) / passes);
+
+   for (i = 0; i < count + MISSING_KEYS; i++)
+      free(keys[i]);
+   for (i = 0; i < count; i++)
+      free(values[i]);
+   free(keys);
+   free(values);
+
+   return 0;
+}
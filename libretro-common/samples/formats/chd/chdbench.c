@@ -0,0 +1,296 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <zlib.h>
+
+#include <boolean.h>
+
+#include <streams/chd_stream.h>
+#include <encodings/crc32.h>
+#include <features/features_cpu.h>
+
+#define FRAME_SIZE       2448
+#define SECTOR_SIZE      2352
+#define FRAMES_PER_HUNK  8
+#define HUNK_BYTES       (FRAME_SIZE * FRAMES_PER_HUNK)
+#define HEADER_SIZE      108
+#define MAP_ENTRY_SIZE   16
+#define METADATA_TAG     0x43485432 /* 'CHT2' */
+
+static void put_be16(uint8_t *p, uint16_t v)
+{
+   p[0] = v >> 8;
+   p[1] = v;
+}
+
+static void put_be32(uint8_t *p, uint32_t v)
+{
+   p[0] = v >> 24;
+   p[1] = v >> 16;
+   p[2] = v >> 8;
+   p[3] = v;
+}
+
+static void put_be64(uint8_t *p, uint64_t v)
+{
+   put_be32(p, (uint32_t)(v >> 32));
+   put_be32(p + 4, (uint32_t)v);
+}
+
+/* Runs of a repeated byte mixed with noise, which zlib
+ * shrinks to about half like typical disc data. */
+static void fill_hunk(uint8_t *hunk, uint32_t *seed)
+{
+   unsigned i;
+
+   for (i = 0; i < HUNK_BYTES; i += 16)
+   {
+      unsigned j;
+      uint32_t x = *seed;
+
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      *seed = x;
+
+      if (x & 1)
+         memset(hunk + i, x >> 24, 16);
+      else
+      {
+         for (j = 0; j < 16; j++)
+         {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            hunk[i + j] = x >> 24;
+         }
+         *seed = x;
+      }
+   }
+}
+
+/* Writes a V4 CHD with a single MODE1_RAW track of @frames
+ * frames, each hunk deflated like chdman's zlib codec does. */
+static bool write_chd(const char *path, uint32_t frames)
+{
+   uint32_t i;
+   char meta[256];
+   uint8_t header[HEADER_SIZE];
+   uint8_t meta_header[16];
+   z_stream z;
+   uint32_t hunks    = (frames + FRAMES_PER_HUNK - 1) / FRAMES_PER_HUNK;
+   uint64_t offset   = HEADER_SIZE + (uint64_t)(hunks + 1) * MAP_ENTRY_SIZE;
+   uint32_t seed     = 0x12345678;
+   uint8_t *map      = (uint8_t*)calloc(hunks + 1, MAP_ENTRY_SIZE);
+   uint8_t *hunk     = (uint8_t*)malloc(HUNK_BYTES);
+   uint8_t *packed   = (uint8_t*)malloc(HUNK_BYTES * 2);
+   FILE *file        = fopen(path, "wb");
+   bool ret          = false;
+   int meta_len      = 0;
+
+   if (!map || !hunk || !packed || !file)
+      goto end;
+
+   memset(&z, 0, sizeof(z));
+   if (deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+            -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+      goto end;
+
+   fseek(file, offset, SEEK_SET);
+
+   for (i = 0; i < hunks; i++)
+   {
+      uint8_t *entry  = map + i * MAP_ENTRY_SIZE;
+      uint32_t length = HUNK_BYTES;
+      uint8_t type    = 2; /* uncompressed */
+
+      fill_hunk(hunk, &seed);
+
+      deflateReset(&z);
+      z.next_in   = hunk;
+      z.avail_in  = HUNK_BYTES;
+      z.next_out  = packed;
+      z.avail_out = HUNK_BYTES * 2;
+
+      if (deflate(&z, Z_FINISH) == Z_STREAM_END && z.total_out < HUNK_BYTES)
+      {
+         length = (uint32_t)z.total_out;
+         type   = 1; /* compressed */
+      }
+
+      if (fwrite(type == 1 ? packed : hunk, 1, length, file) != length)
+         goto end_deflate;
+
+      put_be64(entry, offset);
+      put_be32(entry + 8, encoding_crc32(0, hunk, HUNK_BYTES));
+      put_be16(entry + 12, length & 0xffff);
+      entry[14] = length >> 16;
+      entry[15] = type;
+
+      offset   += length;
+   }
+
+   memcpy(map + hunks * MAP_ENTRY_SIZE, "EndOfListCookie", MAP_ENTRY_SIZE);
+
+   meta_len = snprintf(meta, sizeof(meta),
+         "TRACK:1 TYPE:MODE1_RAW SUBTYPE:NONE FRAMES:%u PREGAP:0 "
+         "PGTYPE:MODE1_RAW PGSUB:NONE POSTGAP:0", frames) + 1;
+   put_be32(meta_header, METADATA_TAG);
+   put_be32(meta_header + 4, meta_len);
+   put_be64(meta_header + 8, 0);
+   fwrite(meta_header, 1, sizeof(meta_header), file);
+   fwrite(meta, 1, meta_len, file);
+
+   memset(header, 0, sizeof(header));
+   memcpy(header, "MComprHD", 8);
+   put_be32(header + 8, HEADER_SIZE);
+   put_be32(header + 12, 4);
+   put_be32(header + 16, 0);
+   put_be32(header + 20, 1); /* zlib */
+   put_be32(header + 24, hunks);
+   put_be64(header + 28, (uint64_t)hunks * HUNK_BYTES);
+   put_be64(header + 36, offset);
+   put_be32(header + 44, HUNK_BYTES);
+
+   fseek(file, 0, SEEK_SET);
+   ret = fwrite(header, 1, sizeof(header), file) == sizeof(header)
+      && fwrite(map, MAP_ENTRY_SIZE, hunks + 1, file) == hunks + 1;
+
+end_deflate:
+   deflateEnd(&z);
+end:
+   if (file)
+      fclose(file);
+   free(packed);
+   free(hunk);
+   free(map);
+   return ret;
+}
+
+static bool read_track(const char *path, unsigned threads,
+      uint32_t *crc, size_t *size, retro_time_t *time)
+{
+   uint8_t buffer[4096];
+   ssize_t read        = 0;
+   uint32_t acc        = 0;
+   size_t total        = 0;
+   retro_time_t start  = cpu_features_get_time_usec();
+   chdstream_t *stream = chdstream_open_threaded(path,
+         CHDSTREAM_TRACK_FIRST_DATA, threads);
+
+   if (!stream)
+      return false;
+
+   while ((read = chdstream_read(stream, buffer, sizeof(buffer))) > 0)
+   {
+      acc    = encoding_crc32(acc, buffer, read);
+      total += read;
+   }
+
+   chdstream_close(stream);
+
+   *time = cpu_features_get_time_usec() - start;
+   *crc  = acc;
+   *size = total;
+
+   return read == 0;
+}
+
+int main(int argc, char *argv[])
+{
+   int i;
+   unsigned threads;
+   uint32_t crc          = 0;
+   uint32_t base_crc     = 0;
+   size_t size           = 0;
+   retro_time_t time     = 0;
+   unsigned size_mb      = 256;
+   unsigned max_threads  = cpu_features_get_core_amount();
+   const char *path      = NULL;
+   bool generated        = false;
+
+   for (i = 1; i < argc; i++)
+   {
+      if (!strcmp(argv[i], "-s") && i + 1 < argc)
+         size_mb = (unsigned)strtoul(argv[++i], NULL, 0);
+      else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+         max_threads = (unsigned)strtoul(argv[++i], NULL, 0);
+      else if (argv[i][0] == '-')
+      {
+         printf("Usage: %s [-s size in MB] [-t max threads] [chd file]\n",
+               argv[0]);
+         return 1;
+      }
+      else
+         path = argv[i];
+   }
+
+   if (!max_threads)
+      max_threads = 1;
+
+   if (!path)
+   {
+      uint32_t frames = (uint32_t)((uint64_t)size_mb * 1024 * 1024
+            / SECTOR_SIZE);
+
+      frames    = (frames + FRAMES_PER_HUNK - 1) & ~(FRAMES_PER_HUNK - 1);
+      path      = "chdbench.chd";
+      generated = true;
+
+      printf("Writing %u MB test image...\n", size_mb);
+      if (!write_chd(path, frames))
+      {
+         printf("Could not write '%s'.\n", path);
+         return 1;
+      }
+   }
+
+   /* Baseline, every hunk is decompressed by the reader. */
+   chdstream_set_cache(CHDSTREAM_CACHE_HUNKS, 0);
+   if (!read_track(path, 1, &base_crc, &size, &time))
+   {
+      printf("Could not read '%s'.\n", path);
+      return 1;
+   }
+
+   printf("%.1f MB track, crc %08x\n", size / (1024.0 * 1024.0), base_crc);
+   printf("no read-ahead %8.1f MB/s\n", size / (double)time);
+
+   chdstream_set_cache(CHDSTREAM_CACHE_HUNKS, CHDSTREAM_READ_AHEAD);
+
+   for (threads = 1; threads <= max_threads; threads *= 2)
+   {
+      if (!read_track(path, threads, &crc, &size, &time)
+            || crc != base_crc)
+      {
+         printf("Wrong data with %u threads.\n", threads);
+         return 1;
+      }
+
+      printf("%2u threads    %8.1f MB/s\n", threads, size / (double)time);
+   }
+
+   if (generated)
+      remove(path);
+
+   return 0;
+}
@@ -0,0 +1,212 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <boolean.h>
+
+#include <gfx/scaler/pixconv.h>
+#include <features/features_cpu.h>
+
+#define CANARY       0xa5
+#define BENCH_WIDTH  1920
+#define BENCH_HEIGHT 1080
+
+typedef void (*conv_func_t)(void *output, const void *input,
+      int width, int height, int out_stride, int in_stride);
+
+struct conversion
+{
+   const char *name;
+   conv_func_t func;
+   unsigned in_bpp;
+   unsigned out_bpp;
+   /* YUYV comes in pixel pairs. */
+   unsigned align;
+};
+
+struct level
+{
+   const char *name;
+   uint64_t mask;
+};
+
+static const struct conversion conversions[] = {
+   { "0rgb1555 -> argb8888", conv_0rgb1555_argb8888, 2, 4, 1 },
+   { "0rgb1555 -> rgb565",   conv_0rgb1555_rgb565,   2, 2, 1 },
+   { "0rgb1555 -> bgr24",    conv_0rgb1555_bgr24,    2, 3, 1 },
+   { "rgb565 -> 0rgb1555",   conv_rgb565_0rgb1555,   2, 2, 1 },
+   { "rgb565 -> argb8888",   conv_rgb565_argb8888,   2, 4, 1 },
+   { "rgb565 -> bgr24",      conv_rgb565_bgr24,      2, 3, 1 },
+   { "argb8888 -> 0rgb1555", conv_argb8888_0rgb1555, 4, 2, 1 },
+   { "argb8888 -> bgr24",    conv_argb8888_bgr24,    4, 3, 1 },
+   { "argb8888 -> abgr8888", conv_argb8888_abgr8888, 4, 4, 1 },
+   { "bgr24 -> argb8888",    conv_bgr24_argb8888,    3, 4, 1 },
+   { "yuyv -> argb8888",     conv_yuyv_argb8888,     2, 4, 2 },
+};
+
+static const struct level levels[] = {
+   { "C",    0 },
+   { "SSE2", RETRO_SIMD_SSE2 },
+   { "AVX2", RETRO_SIMD_SSE2 | RETRO_SIMD_AVX | RETRO_SIMD_AVX2 },
+   { "NEON", RETRO_SIMD_NEON },
+};
+
+static uint32_t rand_state = 0x12345678;
+
+static uint8_t rand_byte(void)
+{
+   rand_state ^= rand_state << 13;
+   rand_state ^= rand_state >> 17;
+   rand_state ^= rand_state << 5;
+   return (uint8_t)(rand_state >> 24);
+}
+
+static bool level_available(const struct level *level, uint64_t cpu)
+{
+   return (cpu & level->mask) == level->mask;
+}
+
+/* Converts every width up to 80 pixels at odd row strides,
+ * with the output padding filled with a canary, and compares
+ * the whole output buffer against the C paths. */
+static bool verify(const struct conversion *conv, const struct level *level)
+{
+   int width;
+   const int height = 3;
+
+   for (width = conv->align; width <= 80; width += conv->align)
+   {
+      size_t i, in_size, out_size;
+      uint8_t *input, *ref, *out;
+      bool ok;
+      /* Some padding past each row, keeping 16 and 32-bit
+       * rows aligned to their pixel size. */
+      int in_stride  = (width + 3) * conv->in_bpp;
+      int out_stride = (width + 5) * conv->out_bpp;
+
+      in_size  = (size_t)in_stride * height;
+      out_size = (size_t)out_stride * height;
+      input    = (uint8_t*)malloc(in_size);
+      ref      = (uint8_t*)malloc(out_size);
+      out      = (uint8_t*)malloc(out_size);
+
+      for (i = 0; i < in_size; i++)
+         input[i] = rand_byte();
+      memset(ref, CANARY, out_size);
+      memset(out, CANARY, out_size);
+
+      conv_set_simd_mask(0);
+      conv->func(ref, input, width, height, out_stride, in_stride);
+      conv_set_simd_mask(level->mask);
+      conv->func(out, input, width, height, out_stride, in_stride);
+
+      ok = !memcmp(ref, out, out_size);
+
+      free(input);
+      free(ref);
+      free(out);
+
+      if (!ok)
+      {
+         fprintf(stderr, "\n%s: %s differs from C at width %d.\n",
+               conv->name, level->name, width);
+         return false;
+      }
+   }
+
+   return true;
+}
+
+static double bench(const struct conversion *conv, const struct level *level,
+      const uint8_t *input, uint8_t *output, unsigned frames)
+{
+   unsigned i;
+   retro_time_t start;
+   retro_time_t time;
+
+   conv_set_simd_mask(level->mask);
+
+   start = cpu_features_get_time_usec();
+   for (i = 0; i < frames; i++)
+      conv->func(output, input, BENCH_WIDTH, BENCH_HEIGHT,
+            BENCH_WIDTH * conv->out_bpp, BENCH_WIDTH * conv->in_bpp);
+   time  = cpu_features_get_time_usec() - start;
+
+   if (time <= 0)
+      time = 1;
+
+   /* Megapixels per second. */
+   return (double)BENCH_WIDTH * BENCH_HEIGHT * frames / time;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i, j;
+   unsigned frames = 100;
+   uint64_t cpu    = cpu_features_get_simd();
+   uint8_t *input  = (uint8_t*)malloc(BENCH_WIDTH * BENCH_HEIGHT * 4);
+   uint8_t *output = (uint8_t*)malloc(BENCH_WIDTH * BENCH_HEIGHT * 4);
+   bool ok         = true;
+
+   if (argc > 1)
+      frames = (unsigned)strtoul(argv[1], NULL, 0);
+   if (!frames || !input || !output)
+   {
+      printf("Usage: %s [frames]\n", argv[0]);
+      return 1;
+   }
+
+   for (i = 0; i < BENCH_WIDTH * BENCH_HEIGHT * 4; i++)
+      input[i] = rand_byte();
+
+   printf("%-22s", "MPix/s");
+   for (j = 0; j < sizeof(levels) / sizeof(levels[0]); j++)
+      if (level_available(&levels[j], cpu))
+         printf("%10s", levels[j].name);
+   printf("\n");
+
+   for (i = 0; i < sizeof(conversions) / sizeof(conversions[0]); i++)
+   {
+      const struct conversion *conv = &conversions[i];
+
+      printf("%-22s", conv->name);
+      for (j = 0; j < sizeof(levels) / sizeof(levels[0]); j++)
+      {
+         if (!level_available(&levels[j], cpu))
+            continue;
+
+         if (j && !verify(conv, &levels[j]))
+         {
+            ok = false;
+            printf("%10s", "FAIL");
+            continue;
+         }
+
+         printf("%10.1f", bench(conv, &levels[j], input, output, frames));
+         fflush(stdout);
+      }
+      printf("\n");
+   }
+
+   free(input);
+   free(output);
+
+   return ok ? 0 : 1;
+}
@@ -0,0 +1,322 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <boolean.h>
+
+#include <gfx/scaler/scaler.h>
+#include <gfx/scaler/scaler_int.h>
+#include <features/features_cpu.h>
+
+#define CANARY 0xa5
+
+struct level
+{
+   const char *name;
+   uint64_t mask;
+};
+
+struct size
+{
+   int in_width;
+   int in_height;
+   int out_width;
+   int out_height;
+};
+
+static const struct level levels[] = {
+   { "C",    0 },
+   { "SSE2", RETRO_SIMD_SSE2 },
+   { "AVX2", RETRO_SIMD_SSE2 | RETRO_SIMD_AVX | RETRO_SIMD_AVX2 },
+   { "NEON", RETRO_SIMD_NEON },
+};
+
+static const char *type_names[] = { "", "point", "bilinear", "sinc" };
+
+/* Odd sizes, up and down, to get at the row and tap tails. */
+static const struct size verify_sizes[] = {
+   {  97,  61, 203,  89 },
+   { 211,  97,  67,  43 },
+   { 320, 240, 321, 239 },
+   { 255, 255,  31, 127 },
+};
+
+/* 4K recording, 1080p recording and a small core blown up. */
+static const struct size bench_sizes[] = {
+   { 3840, 2160, 1920, 1080 },
+   { 1920, 1080, 1280,  720 },
+   {  320,  240, 1280,  960 },
+};
+
+static uint32_t rand_state = 0x12345678;
+
+static uint8_t rand_byte(void)
+{
+   rand_state ^= rand_state << 13;
+   rand_state ^= rand_state >> 17;
+   rand_state ^= rand_state << 5;
+   return (uint8_t)(rand_state >> 24);
+}
+
+static bool level_available(const struct level *level, uint64_t cpu)
+{
+   return (cpu & level->mask) == level->mask;
+}
+
+static bool init_ctx(struct scaler_ctx *ctx, const struct size *size,
+      enum scaler_type type, enum scaler_pix_fmt out_fmt,
+      int in_stride, int out_stride, unsigned threads)
+{
+   memset(ctx, 0, sizeof(*ctx));
+   ctx->in_width    = size->in_width;
+   ctx->in_height   = size->in_height;
+   ctx->in_stride   = in_stride;
+   ctx->out_width   = size->out_width;
+   ctx->out_height  = size->out_height;
+   ctx->out_stride  = out_stride;
+   ctx->in_fmt      = SCALER_FMT_ARGB8888;
+   ctx->out_fmt     = out_fmt;
+   ctx->scaler_type = type;
+   ctx->threads     = threads;
+
+   return scaler_ctx_gen_filter(ctx);
+}
+
+static bool scale(const struct size *size, enum scaler_type type,
+      enum scaler_pix_fmt out_fmt, unsigned threads,
+      uint8_t *output, int out_stride, const uint8_t *input, int in_stride)
+{
+   struct scaler_ctx ctx;
+
+   if (!init_ctx(&ctx, size, type, out_fmt, in_stride, out_stride, threads))
+      return false;
+
+   scaler_ctx_scale(&ctx, output, input);
+   scaler_ctx_gen_reset(&ctx);
+   return true;
+}
+
+/* Scales with every level and thread count, and compares the
+ * whole output, including canaries past each row, with the
+ * single-threaded C result. */
+static bool verify(enum scaler_type type, enum scaler_pix_fmt out_fmt,
+      uint64_t cpu, unsigned max_threads)
+{
+   unsigned i, j, threads;
+   unsigned out_bpp = out_fmt == SCALER_FMT_BGR24 ? 3 : 4;
+
+   for (i = 0; i < sizeof(verify_sizes) / sizeof(verify_sizes[0]); i++)
+   {
+      const struct size *size = &verify_sizes[i];
+      int in_stride           = (size->in_width + 3) * 4;
+      int out_stride          = (size->out_width + 5) * out_bpp;
+      size_t in_size          = (size_t)in_stride * size->in_height;
+      size_t out_size         = (size_t)out_stride * size->out_height;
+      uint8_t *input          = (uint8_t*)malloc(in_size);
+      uint8_t *ref            = (uint8_t*)malloc(out_size);
+      uint8_t *out            = (uint8_t*)malloc(out_size);
+      size_t k;
+      bool ok                 = true;
+
+      for (k = 0; k < in_size; k++)
+         input[k] = rand_byte();
+      memset(ref, CANARY, out_size);
+
+      scaler_set_simd_mask(0);
+      if (!scale(size, type, out_fmt, 1, ref, out_stride, input, in_stride))
+      {
+         printf("Could not set up %s scaling.\n", type_names[type]);
+         ok = false;
+      }
+
+      for (j = 0; ok && j < sizeof(levels) / sizeof(levels[0]); j++)
+      {
+         if (!level_available(&levels[j], cpu))
+            continue;
+
+         scaler_set_simd_mask(levels[j].mask);
+
+         for (threads = 1; ok && threads <= max_threads; threads++)
+         {
+            memset(out, CANARY, out_size);
+            scale(size, type, out_fmt, threads, out, out_stride,
+                  input, in_stride);
+
+            if (memcmp(ref, out, out_size))
+            {
+               printf("%s %dx%d -> %dx%d: %s with %u threads differs from C.\n",
+                     type_names[type], size->in_width, size->in_height,
+                     size->out_width, size->out_height,
+                     levels[j].name, threads);
+               ok = false;
+            }
+         }
+      }
+
+      free(input);
+      free(ref);
+      free(out);
+
+      if (!ok)
+         return false;
+   }
+
+   return true;
+}
+
+/* Returns output megapixels per second. */
+static double bench(const struct size *size, enum scaler_type type,
+      unsigned threads, unsigned frames)
+{
+   unsigned i;
+   retro_time_t start, time;
+   struct scaler_ctx ctx;
+   int in_stride   = size->in_width * 4;
+   int out_stride  = size->out_width * 4;
+   uint8_t *input  = (uint8_t*)malloc((size_t)in_stride * size->in_height);
+   uint8_t *output = (uint8_t*)malloc((size_t)out_stride * size->out_height);
+
+   for (i = 0; i < (unsigned)(in_stride * size->in_height); i++)
+      input[i] = rand_byte();
+
+   if (!init_ctx(&ctx, size, type, SCALER_FMT_ARGB8888,
+            in_stride, out_stride, threads))
+      return 0.0;
+
+   start = cpu_features_get_time_usec();
+   for (i = 0; i < frames; i++)
+      scaler_ctx_scale(&ctx, output, input);
+   time  = cpu_features_get_time_usec() - start;
+
+   scaler_ctx_gen_reset(&ctx);
+   free(input);
+   free(output);
+
+   if (time <= 0)
+      time = 1;
+
+   return (double)size->out_width * size->out_height * frames / time;
+}
+
+int main(int argc, char *argv[])
+{
+   int i;
+   unsigned j, k, threads;
+   unsigned frames      = 10;
+   unsigned max_threads = cpu_features_get_core_amount();
+   uint64_t cpu         = cpu_features_get_simd();
+   uint64_t best        = 0;
+   bool ok              = true;
+   enum scaler_type type;
+
+   for (i = 1; i < argc; i++)
+   {
+      if (!strcmp(argv[i], "-f") && i + 1 < argc)
+         frames = (unsigned)strtoul(argv[++i], NULL, 0);
+      else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+         max_threads = (unsigned)strtoul(argv[++i], NULL, 0);
+      else
+      {
+         printf("Usage: %s [-f frames] [-t max threads]\n", argv[0]);
+         return 1;
+      }
+   }
+
+   if (!frames)
+      frames = 1;
+   if (max_threads < 4)
+      max_threads = 4;
+
+   for (type = SCALER_TYPE_POINT; type <= SCALER_TYPE_SINC; type++)
+   {
+      if (!verify(type, SCALER_FMT_ARGB8888, cpu, max_threads)
+            || !verify(type, SCALER_FMT_BGR24, cpu, max_threads))
+         ok = false;
+   }
+
+   if (!ok)
+      return 1;
+
+   printf("All levels and thread counts match C.\n\n");
+
+   printf("MPix/s, 1 thread                 ");
+   for (j = 0; j < sizeof(levels) / sizeof(levels[0]); j++)
+      if (level_available(&levels[j], cpu))
+      {
+         printf("%9s", levels[j].name);
+         best = levels[j].mask;
+      }
+   printf("\n");
+
+   for (type = SCALER_TYPE_POINT; type <= SCALER_TYPE_SINC; type++)
+   {
+      for (k = 0; k < sizeof(bench_sizes) / sizeof(bench_sizes[0]); k++)
+      {
+         const struct size *size = &bench_sizes[k];
+
+         printf("%-8s %4dx%-4d -> %4dx%-4d  ", type_names[type],
+               size->in_width, size->in_height,
+               size->out_width, size->out_height);
+
+         for (j = 0; j < sizeof(levels) / sizeof(levels[0]); j++)
+         {
+            if (!level_available(&levels[j], cpu))
+               continue;
+
+            /* Point scaling has no SIMD path. */
+            if (type == SCALER_TYPE_POINT && j)
+               break;
+
+            scaler_set_simd_mask(levels[j].mask);
+            printf("%9.1f", bench(size, type, 1, frames));
+            fflush(stdout);
+         }
+         printf("\n");
+      }
+   }
+
+   printf("\nMPix/s, fastest level, threads   ");
+   for (threads = 1; threads <= max_threads; threads *= 2)
+      printf("%9u", threads);
+   printf("\n");
+
+   scaler_set_simd_mask(best);
+
+   for (type = SCALER_TYPE_POINT; type <= SCALER_TYPE_SINC; type++)
+   {
+      for (k = 0; k < sizeof(bench_sizes) / sizeof(bench_sizes[0]); k++)
+      {
+         const struct size *size = &bench_sizes[k];
+
+         printf("%-8s %4dx%-4d -> %4dx%-4d  ", type_names[type],
+               size->in_width, size->in_height,
+               size->out_width, size->out_height);
+
+         for (threads = 1; threads <= max_threads; threads *= 2)
+         {
+            printf("%9.1f", bench(size, type, threads, frames));
+            fflush(stdout);
+         }
+         printf("\n");
+      }
+   }
+
+   return 0;
+}
@@ -0,0 +1,165 @@
+/* Pushes a few thousand mixed tasks through the threaded task queue
+ * and reports throughput plus per priority class completion latency.
+ *
+ * Usage: task_queue_bench [workers] [tasks]
+ *        workers = 0 picks the amount of CPU cores minus one. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <queues/task_queue.h>
+#include <features/features_cpu.h>
+
+typedef struct
+{
+   retro_time_t pushed;
+   unsigned steps;
+   unsigned work;
+   uint32_t sink;
+} bench_task_state_t;
+
+static retro_time_t *latencies[TASK_PRIORITY_LAST];
+static unsigned latency_count[TASK_PRIORITY_LAST];
+static unsigned tasks_done;
+
+static const char *priority_names[TASK_PRIORITY_LAST] = {
+   "io",
+   "interactive",
+   "background"
+};
+
+static void bench_task_handler(retro_task_t *task)
+{
+   unsigned i;
+   bench_task_state_t *state = (bench_task_state_t*)task->state;
+
+   /* Simulates a slice of decoding / hashing work. */
+   for (i = 0; i < state->work; i++)
+      state->sink = state->sink * 1664525u + 1013904223u + i;
+
+   if (--state->steps == 0)
+      task_set_finished(task, true);
+}
+
+static void bench_task_callback(void *task_data,
+      void *user_data, const char *error)
+{
+   tasks_done++;
+}
+
+static void bench_task_cleanup(retro_task_t *task)
+{
+   bench_task_state_t *state = (bench_task_state_t*)task->state;
+   unsigned prio             = task->priority;
+
+   latencies[prio][latency_count[prio]++] =
+      cpu_features_get_time_usec() - state->pushed;
+
+   free(state);
+}
+
+static int cmp_time(const void *a, const void *b)
+{
+   retro_time_t x = *(const retro_time_t*)a;
+   retro_time_t y = *(const retro_time_t*)b;
+   return (x > y) - (x < y);
+}
+
+static void print_latencies(void)
+{
+   unsigned prio;
+
+   for (prio = 0; prio < TASK_PRIORITY_LAST; prio++)
+   {
+      unsigned n = latency_count[prio];
+
+      if (!n)
+         continue;
+
+      qsort(latencies[prio], n, sizeof(retro_time_t), cmp_time);
+
+      printf("  %-12s %6u tasks  p50 %8.2f ms  p99 %8.2f ms  max %8.2f ms\n",
+            priority_names[prio], n,
+            latencies[prio][n / 2]            / 1000.0,
+            latencies[prio][(n * 99) / 100]   / 1000.0,
+            latencies[prio][n - 1]            / 1000.0);
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned i;
+   retro_time_t start, elapsed;
+   unsigned workers   = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0) : 0;
+   unsigned num_tasks = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 0) : 5000;
+
+   for (i = 0; i < TASK_PRIORITY_LAST; i++)
+      latencies[i] = (retro_time_t*)calloc(num_tasks, sizeof(retro_time_t));
+
+   task_queue_set_num_workers(workers);
+   task_queue_init(true, NULL);
+
+   printf("Workers: %u, tasks: %u\n", task_queue_get_num_workers(), num_tasks);
+
+   start = cpu_features_get_time_usec();
+
+   for (i = 0; i < num_tasks; i++)
+   {
+      retro_task_t         *t = (retro_task_t*)calloc(1, sizeof(*t));
+      bench_task_state_t *state = (bench_task_state_t*)calloc(1, sizeof(*state));
+
+      /* Mix: many short interactive tasks (thumbnails),
+       * medium I/O tasks and a few long background scans. */
+      switch (i % 8)
+      {
+         case 0:
+            t->priority  = TASK_PRIORITY_BACKGROUND;
+            state->steps = 64;
+            state->work  = 20000;
+            break;
+         case 1:
+         case 2:
+         case 3:
+            t->priority  = TASK_PRIORITY_IO;
+            state->steps = 8;
+            state->work  = 10000;
+            break;
+         default:
+            t->priority  = TASK_PRIORITY_INTERACTIVE;
+            state->steps = 2;
+            state->work  = 5000;
+            break;
+      }
+
+      state->pushed = cpu_features_get_time_usec();
+      t->state      = state;
+      t->handler    = bench_task_handler;
+      t->callback   = bench_task_callback;
+      t->cleanup    = bench_task_cleanup;
+
+      task_queue_push(t);
+   }
+
+   task_queue_wait(NULL, NULL);
+
+   /* Tasks finishing while wait() returns still
+    * need their callbacks to be run. */
+   while (tasks_done < num_tasks)
+      task_queue_check();
+
+   elapsed = cpu_features_get_time_usec() - start;
+
+   printf("Completed %u tasks in %.2f ms (%.0f tasks/s)\n",
+         tasks_done, elapsed / 1000.0,
+         tasks_done / (elapsed / 1000000.0));
+   puts("Push-to-completion latency:");
+   print_latencies();
+
+   task_queue_deinit();
+
+   for (i = 0; i < TASK_PRIORITY_LAST; i++)
+      free(latencies[i]);
+
+   return tasks_done == num_tasks ? 0 : 1;
+}
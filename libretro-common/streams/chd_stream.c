@@ -29,19 +29,46 @@
 #include <retro_endianness.h>
 #include <libchdr/chd.h>
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#include <features/features_cpu.h>
+#define SLOCK_LOCK(x) slock_lock(x)
+#define SLOCK_UNLOCK(x) slock_unlock(x)
+#else
+#define SLOCK_LOCK(x)
+#define SLOCK_UNLOCK(x)
+#endif
+
 #define SECTOR_SIZE 2352
 #define SUBCODE_SIZE 96
 #define TRACK_PAD 4
 
+static unsigned chdstream_cache_hunks   = CHDSTREAM_CACHE_HUNKS;
+static unsigned chdstream_read_ahead    = CHDSTREAM_READ_AHEAD;
+
+struct chdstream_hunk
+{
+   uint8_t *mem;
+   /* Use count when last read from, lowest is evicted first */
+   uint32_t last_use;
+   /* Hunk held in mem, -1 if none */
+   int32_t hunknum;
+   /* Being decompressed, mem is not valid yet */
+   bool loading;
+};
+
 struct chdstream
 {
    chd_file *chd;
+   char *path;
    /* Should we swap bytes? */
    bool swab;
    /* Size of frame taken from each hunk */
    uint32_t frame_size;
    /* Offset of data within frame */
    uint32_t frame_offset;
+   /* Size of frame within hunk */
+   uint32_t unit_bytes;
    /* Number of frames per hunk */
    uint32_t frames_per_hunk;
    /* First frame of track in chd */
@@ -52,10 +79,34 @@ struct chdstream
    size_t track_end;
    /* Byte offset of read cursor */
    size_t offset;
-   /* Loaded hunk number */
-   int32_t hunknum;
-   /* Loaded hunk */
-   uint8_t *hunkmem;
+   /* Last hunk holding track data */
+   uint32_t track_last_hunk;
+   /* Decompressed hunks, least recently used is evicted */
+   struct chdstream_hunk *hunks;
+   unsigned hunk_count;
+   uint32_t use_count;
+   /* Slot the read cursor copies from, never evicted */
+   int32_t current;
+   /* Last hunk the read cursor loaded */
+   int32_t last_hunk;
+#ifdef HAVE_THREADS
+   /* Read-ahead runs on a pool of threads, each with its own
+    * chd_file, as libchdr decompressors are not shared safely. */
+   sthread_t **threads;
+   unsigned thread_count;
+   /* Hunks read ahead of the cursor */
+   unsigned read_ahead;
+   slock_t *lock;
+   /* Signalled when the read-ahead window moves or on close */
+   scond_t *ahead_cond;
+   /* Signalled when a slot finished loading */
+   scond_t *loaded_cond;
+   /* Hunks [ahead_next, ahead_end) are to be read ahead */
+   uint32_t ahead_next;
+   uint32_t ahead_end;
+   bool ahead_failed;
+   bool quit;
+#endif
 };
 
 typedef struct metadata {
@@ -198,9 +249,66 @@ chdstream_find_track(chd_file *fd, int32_t track, metadata_t *meta)
    return chdstream_find_track_number(fd, track, meta);
 }
 
-chdstream_t *chdstream_open(const char *path, int32_t track)
+void chdstream_set_cache(unsigned hunks, unsigned read_ahead)
+{
+   chdstream_cache_hunks = hunks ? hunks : 1;
+   chdstream_read_ahead  = read_ahead;
+}
+
+static bool chdstream_alloc_hunks(chdstream_t *stream, uint32_t hunkbytes,
+      unsigned threads)
+{
+   unsigned i;
+   unsigned count = chdstream_cache_hunks;
+
+#ifdef HAVE_THREADS
+   if (chdstream_read_ahead)
+   {
+      /* The reading thread decompresses too, so leave it a core. */
+      if (!threads)
+      {
+         threads = cpu_features_get_core_amount();
+         threads = threads > 1 ? threads - 1 : 1;
+         if (threads > CHDSTREAM_READ_AHEAD_MAX_THREADS)
+            threads = CHDSTREAM_READ_AHEAD_MAX_THREADS;
+      }
+
+      /* Keep every thread busy with a hunk or two to spare. */
+      stream->thread_count = threads;
+      stream->read_ahead   = chdstream_read_ahead;
+      if (stream->read_ahead < threads * 2)
+         stream->read_ahead = threads * 2;
+   }
+
+   /* Leave room for the read cursor's hunk and the ones being
+    * read ahead, so neither ever has to wait for a free slot. */
+   if (stream->read_ahead && count < stream->read_ahead + 2)
+      count = stream->read_ahead + 2;
+#endif
+
+   stream->hunks = (struct chdstream_hunk*)
+      calloc(count, sizeof(*stream->hunks));
+   if (!stream->hunks)
+      return false;
+
+   stream->hunk_count = count;
+
+   for (i = 0; i < count; i++)
+   {
+      stream->hunks[i].hunknum = -1;
+      stream->hunks[i].mem     = (uint8_t*)malloc(hunkbytes);
+      if (!stream->hunks[i].mem)
+         return false;
+   }
+
+   return true;
+}
+
+chdstream_t *chdstream_open_threaded(const char *path, int32_t track,
+      unsigned threads)
 {
    metadata_t meta;
+   uint32_t unitbytes   = 0;
    uint32_t pregap      = 0;
    const chd_header *hd = NULL;
    chdstream_t *stream  = NULL;
@@ -218,10 +326,32 @@ chdstream_t *chdstream_open(const char *path, int32_t track)
       goto error;
 
    hd              = chd_get_header(chd);
-   stream->hunkmem = (uint8_t*)malloc(hd->hunkbytes);
-   if (!stream->hunkmem)
+   /* Only V5 headers store the unit size, older CD images
+    * always use whole frames with subcode. */
+   unitbytes       = hd->unitbytes
+      ? hd->unitbytes : SECTOR_SIZE + SUBCODE_SIZE;
+   if (!chdstream_alloc_hunks(stream, hd->hunkbytes, threads))
       goto error;
 
+   stream->path    = strdup(path);
+   if (!stream->path)
+      goto error;
+
+#ifdef HAVE_THREADS
+   if (stream->read_ahead)
+   {
+      stream->threads     = (sthread_t**)
+         calloc(stream->thread_count, sizeof(*stream->threads));
+      stream->lock        = slock_new();
+      stream->ahead_cond  = scond_new();
+      stream->loaded_cond = scond_new();
+
+      if (!stream->threads || !stream->lock
+            || !stream->ahead_cond || !stream->loaded_cond)
+         goto error;
+   }
+#endif
+
    if (!strcmp(meta.type, "MODE1_RAW"))
    {
       stream->frame_size = SECTOR_SIZE;
@@ -240,7 +370,7 @@ chdstream_t *chdstream_open(const char *path, int32_t track)
    }
    else
    {
-      stream->frame_size = hd->unitbytes;
+      stream->frame_size = unitbytes;
       stream->frame_offset = 0;
    }
 
@@ -252,13 +382,20 @@ chdstream_t *chdstream_open(const char *path, int32_t track)
 
 
    stream->chd             = chd;
-   stream->frames_per_hunk = hd->hunkbytes / hd->unitbytes;
+   stream->unit_bytes      = unitbytes;
+   stream->frames_per_hunk = hd->hunkbytes / unitbytes;
    stream->track_frame     = meta.frame_offset;
    stream->track_start     = (size_t) pregap * stream->frame_size;
    stream->track_end       = stream->track_start + 
       (size_t) meta.frames * stream->frame_size;
    stream->offset          = 0;
-   stream->hunknum         = -1;
+   stream->track_last_hunk = (stream->track_frame
+         + (meta.frames ? meta.frames - 1 : 0)) / stream->frames_per_hunk;
+   stream->current         = -1;
+   stream->last_hunk       = -1;
+
+   if (stream->track_last_hunk >= hd->totalhunks)
+      stream->track_last_hunk = hd->totalhunks - 1;
 
    return stream;
 
@@ -272,45 +409,274 @@ error:
    return NULL;
 }
 
+chdstream_t *chdstream_open(const char *path, int32_t track)
+{
+   return chdstream_open_threaded(path, track, 1);
+}
+
 void chdstream_close(chdstream_t *stream)
 {
-   if (stream)
+   unsigned i;
+
+   if (!stream)
+      return;
+
+#ifdef HAVE_THREADS
+   if (stream->threads)
    {
-      if (stream->hunkmem)
-         free(stream->hunkmem);
-      if (stream->chd)
-         chd_close(stream->chd);
-      free(stream);
+      slock_lock(stream->lock);
+      stream->quit = true;
+      scond_broadcast(stream->ahead_cond);
+      slock_unlock(stream->lock);
+
+      for (i = 0; i < stream->thread_count; i++)
+         if (stream->threads[i])
+            sthread_join(stream->threads[i]);
+      free(stream->threads);
    }
+
+   if (stream->loaded_cond)
+      scond_free(stream->loaded_cond);
+   if (stream->ahead_cond)
+      scond_free(stream->ahead_cond);
+   if (stream->lock)
+      slock_free(stream->lock);
+#endif
+
+   if (stream->hunks)
+   {
+      for (i = 0; i < stream->hunk_count; i++)
+         free(stream->hunks[i].mem);
+      free(stream->hunks);
+   }
+   if (stream->chd)
+      chd_close(stream->chd);
+   free(stream->path);
+   free(stream);
 }
 
-static bool
-chdstream_load_hunk(chdstream_t *stream, uint32_t hunknum)
+static bool chdstream_decompress(chdstream_t *stream, chd_file *chd,
+      uint32_t hunknum, uint8_t *mem)
 {
-   chd_error err;
-   uint16_t *array;
    uint32_t i;
-   uint32_t count;
 
-   if (hunknum == stream->hunknum)
-      return true;
-
-   err = chd_read(stream->chd, hunknum, stream->hunkmem);
-   if (err != CHDERR_NONE)
+   if (chd_read(chd, hunknum, mem) != CHDERR_NONE)
       return false;
 
    if (stream->swab)
    {
-      count = chd_get_header(stream->chd)->hunkbytes / 2;
-      array = (uint16_t*) stream->hunkmem;
+      uint32_t count  = chd_get_header(chd)->hunkbytes / 2;
+      uint16_t *array = (uint16_t*)mem;
+
       for (i = 0; i < count; ++i)
          array[i] = SWAP16(array[i]);
    }
 
-   stream->hunknum = hunknum;
    return true;
 }
 
+/* Call with the lock held. */
+static struct chdstream_hunk *chdstream_find_hunk(chdstream_t *stream,
+      uint32_t hunknum)
+{
+   unsigned i;
+
+   for (i = 0; i < stream->hunk_count; i++)
+      if (stream->hunks[i].hunknum == (int32_t)hunknum)
+         return &stream->hunks[i];
+
+   return NULL;
+}
+
+/* Picks the least recently used slot that is not loading. The
+ * read-ahead thread also has to leave the slot the read cursor
+ * copies from alone. Call with the lock held. */
+static struct chdstream_hunk *chdstream_evict_hunk(chdstream_t *stream,
+      bool keep_current)
+{
+   unsigned i;
+   struct chdstream_hunk *victim = NULL;
+
+   for (i = 0; i < stream->hunk_count; i++)
+   {
+      struct chdstream_hunk *slot = &stream->hunks[i];
+
+      if (slot->loading || (keep_current && (int32_t)i == stream->current))
+         continue;
+
+      if (slot->hunknum < 0)
+         return slot;
+
+      if (!victim || slot->last_use < victim->last_use)
+         victim = slot;
+   }
+
+   return victim;
+}
+
+#ifdef HAVE_THREADS
+static void chdstream_ahead_thread(void *data)
+{
+   chdstream_t *stream = (chdstream_t*)data;
+   chd_file *chd       = NULL;
+
+   /* The other threads and the reader pick up the slack. */
+   if (chd_open(stream->path, CHD_OPEN_READ, NULL, &chd) != CHDERR_NONE)
+      return;
+
+   slock_lock(stream->lock);
+
+   while (!stream->quit)
+   {
+      uint32_t hunknum;
+      bool ok;
+      struct chdstream_hunk *slot = NULL;
+
+      if (stream->ahead_next >= stream->ahead_end)
+      {
+         scond_wait(stream->ahead_cond, stream->lock);
+         continue;
+      }
+
+      hunknum = stream->ahead_next++;
+
+      if (chdstream_find_hunk(stream, hunknum))
+         continue;
+
+      slot = chdstream_evict_hunk(stream, true);
+      if (!slot)
+         continue;
+
+      slot->hunknum = hunknum;
+      slot->loading = true;
+      slock_unlock(stream->lock);
+
+      ok = chdstream_decompress(stream, chd, hunknum, slot->mem);
+
+      slock_lock(stream->lock);
+      slot->loading  = false;
+      slot->last_use = ++stream->use_count;
+      if (!ok)
+         slot->hunknum = -1;
+      scond_broadcast(stream->loaded_cond);
+   }
+
+   slock_unlock(stream->lock);
+
+   chd_close(chd);
+}
+
+/* Moves the read-ahead window to follow the read cursor. The
+ * threads are only started once reads look sequential, so streams
+ * that only peek at a few sectors never pay for them. The threads
+ * claim hunks in order and the reader consumes them in order, so
+ * whole-track reads such as CRC computation decompress up to
+ * thread_count hunks at once. Call with the lock held. */
+static void chdstream_read_ahead_from(chdstream_t *stream,
+      uint32_t hunknum)
+{
+   unsigned i;
+   uint32_t end;
+
+   if (!stream->threads || stream->ahead_failed)
+      return;
+
+   if ((int32_t)hunknum != stream->last_hunk + 1 || stream->last_hunk < 0)
+   {
+      /* Seeked away, stop reading ahead of the old position. */
+      stream->ahead_end = stream->ahead_next;
+      return;
+   }
+
+   end = hunknum + 1 + stream->read_ahead;
+   if (end > stream->track_last_hunk + 1)
+      end = stream->track_last_hunk + 1;
+
+   if (stream->ahead_next < hunknum + 1 || stream->ahead_next > end)
+      stream->ahead_next = hunknum + 1;
+   stream->ahead_end = end;
+
+   if (!stream->threads[0])
+   {
+      for (i = 0; i < stream->thread_count; i++)
+      {
+         stream->threads[i] = sthread_create(chdstream_ahead_thread, stream);
+         if (!stream->threads[i])
+            break;
+      }
+
+      if (!i)
+         stream->ahead_failed = true;
+   }
+   else
+      scond_broadcast(stream->ahead_cond);
+}
+#endif
+
+static const uint8_t *
+chdstream_load_hunk(chdstream_t *stream, uint32_t hunknum)
+{
+   bool ok;
+   struct chdstream_hunk *slot = NULL;
+
+   /* The current slot is never evicted, so it can be
+    * checked without taking the lock. */
+   if (stream->current >= 0
+         && stream->hunks[stream->current].hunknum == (int32_t)hunknum)
+      return stream->hunks[stream->current].mem;
+
+   SLOCK_LOCK(stream->lock);
+
+   slot = chdstream_find_hunk(stream, hunknum);
+
+#ifdef HAVE_THREADS
+   while (slot && slot->loading)
+   {
+      /* Being read ahead, wait for it rather than
+       * decompressing it twice. */
+      scond_wait(stream->loaded_cond, stream->lock);
+      slot = chdstream_find_hunk(stream, hunknum);
+   }
+#endif
+
+   if (!slot)
+   {
+      slot = chdstream_evict_hunk(stream, false);
+      if (!slot)
+      {
+         SLOCK_UNLOCK(stream->lock);
+         return NULL;
+      }
+
+      slot->hunknum = hunknum;
+      slot->loading = true;
+      SLOCK_UNLOCK(stream->lock);
+
+      ok = chdstream_decompress(stream, stream->chd, hunknum, slot->mem);
+
+      SLOCK_LOCK(stream->lock);
+      slot->loading = false;
+      if (!ok)
+      {
+         slot->hunknum = -1;
+         SLOCK_UNLOCK(stream->lock);
+         return NULL;
+      }
+   }
+
+   slot->last_use  = ++stream->use_count;
+   stream->current = (int32_t)(slot - stream->hunks);
+
+#ifdef HAVE_THREADS
+   chdstream_read_ahead_from(stream, hunknum);
+#endif
+   stream->last_hunk = hunknum;
+
+   SLOCK_UNLOCK(stream->lock);
+
+   return slot->mem;
+}
+
 ssize_t chdstream_read(chdstream_t *stream, void *data, size_t bytes)
 {
    size_t end;
@@ -319,8 +685,8 @@ ssize_t chdstream_read(chdstream_t *stream, void *data, size_t bytes)
    uint32_t chd_frame;
    uint32_t hunk;
    uint32_t amount;
+   const uint8_t *hunkmem;
    size_t data_offset   = 0;
-   const chd_header *hd = chd_get_header(stream->chd);
    uint8_t         *out = (uint8_t*)data;
 
    if (stream->track_end - stream->offset < bytes)
@@ -342,14 +708,14 @@ ssize_t chdstream_read(chdstream_t *stream, void *data, size_t bytes)
          chd_frame = stream->track_frame +
             (stream->offset - stream->track_start) / stream->frame_size;
          hunk = chd_frame / stream->frames_per_hunk;
-         hunk_offset = (chd_frame % stream->frames_per_hunk) * hd->unitbytes;
+         hunk_offset = (chd_frame % stream->frames_per_hunk) * stream->unit_bytes;
 
-         if (!chdstream_load_hunk(stream, hunk))
-         {
+         hunkmem = chdstream_load_hunk(stream, hunk);
+         if (!hunkmem)
             return -1;
-         }
+
          memcpy(out + data_offset,
-                stream->hunkmem + frame_offset 
+                hunkmem + frame_offset 
                 + hunk_offset + stream->frame_offset, amount);
       }
 
@@ -513,8 +513,7 @@ ssize_t filestream_tell(RFILE *stream)
    if (stream->mapped && stream->hints & RFILE_HINT_MMAP)
       return stream->mappos;
 #endif
-   if (lseek(stream->fd, 0, SEEK_CUR) < 0)
-      goto error;
+   return lseek(stream->fd, 0, SEEK_CUR);
 #endif
 
    return 0;
@@ -570,6 +569,31 @@ int filestream_flush(RFILE *stream)
 #endif
 }
 
+int filestream_sync(RFILE *stream)
+{
+   int fd;
+
+   if (!stream)
+      return -1;
+
+#if defined(HAVE_BUFFERED_IO)
+   if ((stream->hints & RFILE_HINT_UNBUFFERED) == 0)
+      if (fflush(stream->fp) != 0)
+         return -1;
+#endif
+
+   fd = filestream_get_fd(stream);
+
+#if defined(_WIN32) && !defined(_XBOX)
+   return _commit(fd) == 0 ? 0 : -1;
+#elif defined(_XBOX) || defined(PSP) || defined(VITA) || defined(__CELLOS_LV2__) || defined(GEKKO) || defined(_3DS)
+   (void)fd;
+   return 0;
+#else
+   return fsync(fd) == 0 ? 0 : -1;
+#endif
+}
+
 ssize_t filestream_write(RFILE *stream, const void *s, size_t len)
 {
    if (!stream)
@@ -52,6 +52,7 @@ struct intfstream_internal
    struct
    {
       int32_t track;
+      bool threaded;
       chdstream_t *fp;
    } chd;
 #endif
@@ -102,7 +103,8 @@ bool intfstream_open(intfstream_internal_t *intf, const char *path,
          break;
       case INTFSTREAM_CHD:
 #ifdef HAVE_CHD
-         intf->chd.fp = chdstream_open(path, intf->chd.track);
+         intf->chd.fp = chdstream_open_threaded(path, intf->chd.track,
+               intf->chd.threaded ? 0 : 1);
          if (!intf->chd.fp)
             return false;
          break;
@@ -160,7 +162,8 @@ void *intfstream_init(intfstream_info_t *info)
          break;
       case INTFSTREAM_CHD:
 #ifdef HAVE_CHD
-         intf->chd.track = info->chd.track;
+         intf->chd.track    = info->chd.track;
+         intf->chd.threaded = info->chd.threaded;
          break;
 #else
          goto error;
@@ -68,6 +68,15 @@ struct libretrodb_index
 	uint64_t next;
 };
 
+struct libretrodb_hash_index
+{
+   struct rmsgpack_dom_value key;
+   char field_name[50];
+   uint32_t *hashes;
+   uint64_t *offsets; /* 0 marks an empty slot */
+   size_t mask;
+};
+
 typedef struct libretrodb_metadata
 {
 	uint64_t count;
@@ -143,7 +152,7 @@ int libretrodb_create(RFILE *fd, libretrodb_value_provider value_provider,
    struct rmsgpack_dom_value item;
    uint64_t item_count        = 0;
    libretrodb_header_t header = {{0}};
-   ssize_t root = filestream_seek(fd, 0, SEEK_CUR);
+   ssize_t root = filestream_tell(fd);
 
    memcpy(header.magic_number, MAGIC_NUMBER, sizeof(MAGIC_NUMBER)-1);
 
@@ -172,7 +181,7 @@ int libretrodb_create(RFILE *fd, libretrodb_value_provider value_provider,
    if ((rv = rmsgpack_dom_write(fd, &sentinal)) < 0)
       goto clean;
 
-   header.metadata_offset = swap_if_little64(filestream_seek(fd, 0, SEEK_CUR));
+   header.metadata_offset = swap_if_little64(filestream_tell(fd));
    md.count = item_count;
    libretrodb_write_metadata(fd, &md);
    filestream_seek(fd, root, SEEK_SET);
@@ -226,7 +235,7 @@ int libretrodb_open(const char *path, libretrodb_t *db)
       free(db->path);
 
    db->path  = strdup(path);
-   db->root  = filestream_seek(fd, 0, SEEK_CUR);
+   db->root  = filestream_tell(fd);
 
    if ((rv = (int)filestream_read(fd, &header, sizeof(header))) == -1)
    {
@@ -234,7 +243,8 @@ int libretrodb_open(const char *path, libretrodb_t *db)
       goto error;
    }
 
-   if (strncmp(header.magic_number, MAGIC_NUMBER, sizeof(MAGIC_NUMBER)) != 0)
+   if (memcmp(header.magic_number, MAGIC_NUMBER,
+            sizeof(header.magic_number)) != 0)
    {
       rv = -EINVAL;
       goto error;
@@ -250,7 +260,7 @@ int libretrodb_open(const char *path, libretrodb_t *db)
    }
 
    db->count = md.count;
-   db->first_index_offset = filestream_seek(fd, 0, SEEK_CUR);
+   db->first_index_offset = filestream_tell(fd);
    db->fd = fd;
    return 0;
 
@@ -460,7 +470,7 @@ static int node_iter(void *value, void *ctx)
 
 static uint64_t libretrodb_tell(libretrodb_t *db)
 {
-   return filestream_seek(db->fd, 0, SEEK_CUR);
+   return filestream_tell(db->fd);
 }
 
 static int node_compare(const void *a, const void *b, void *ctx)
@@ -578,6 +588,202 @@ clean:
    return 0;
 }
 
+static uint32_t libretrodb_hash_bytes(const void *data, size_t len)
+{
+   size_t i;
+   const uint8_t *p = (const uint8_t*)data;
+   uint32_t hash    = 5381;
+
+   for (i = 0; i < len; i++)
+      hash = (hash << 5) + hash + p[i];
+
+   return hash;
+}
+
+/* Returns the string or binary value of the indexed field. */
+static const struct rmsgpack_dom_value *libretrodb_hash_index_field(
+      const libretrodb_hash_index_t *idx,
+      const struct rmsgpack_dom_value *item)
+{
+   const struct rmsgpack_dom_value *field = NULL;
+
+   if (item->type != RDT_MAP)
+      return NULL;
+
+   field = rmsgpack_dom_value_map_value(item, &idx->key);
+
+   if (!field || (field->type != RDT_STRING && field->type != RDT_BINARY))
+      return NULL;
+   if (field->val.binary.len == 0)
+      return NULL;
+
+   return field;
+}
+
+libretrodb_hash_index_t *libretrodb_hash_index_new(libretrodb_t *db,
+      const char *field_name)
+{
+   struct rmsgpack_dom_value item;
+   size_t i;
+   size_t count             = 0;
+   size_t capacity          = 0;
+   size_t slots             = 16;
+   uint32_t *hashes         = NULL;
+   uint64_t *offsets        = NULL;
+   libretrodb_hash_index_t *idx = NULL;
+
+   if (!db || !db->fd)
+      return NULL;
+
+   idx = (libretrodb_hash_index_t*)calloc(1, sizeof(*idx));
+
+   if (!idx)
+      return NULL;
+
+   strlcpy(idx->field_name, field_name, sizeof(idx->field_name));
+   idx->key.type            = RDT_STRING;
+   idx->key.val.string.len  = (uint32_t)strlen(idx->field_name);
+   idx->key.val.string.buff = idx->field_name;
+
+   filestream_seek(db->fd,
+         (ssize_t)(db->root + sizeof(libretrodb_header_t)), SEEK_SET);
+
+   /* Gather (hash, offset) pairs in database order first,
+    * so the table can be sized before inserting. */
+   for (;;)
+   {
+      const struct rmsgpack_dom_value *field = NULL;
+      uint64_t offset = filestream_tell(db->fd);
+
+      if (rmsgpack_dom_read(db->fd, &item) < 0)
+         goto error;
+
+      if (item.type == RDT_NULL)
+         break;
+
+      field = libretrodb_hash_index_field(idx, &item);
+
+      if (field)
+      {
+         if (count == capacity)
+         {
+            size_t new_cap        = capacity ? capacity * 2 : 1024;
+            uint32_t *new_hashes  = (uint32_t*)
+               realloc(hashes, new_cap * sizeof(*hashes));
+            uint64_t *new_offsets = NULL;
+
+            if (!new_hashes)
+            {
+               rmsgpack_dom_value_free(&item);
+               goto error;
+            }
+            hashes      = new_hashes;
+
+            new_offsets = (uint64_t*)
+               realloc(offsets, new_cap * sizeof(*offsets));
+
+            if (!new_offsets)
+            {
+               rmsgpack_dom_value_free(&item);
+               goto error;
+            }
+            offsets     = new_offsets;
+            capacity    = new_cap;
+         }
+
+         hashes[count]  = libretrodb_hash_bytes(
+               field->val.binary.buff, field->val.binary.len);
+         offsets[count] = offset;
+         count++;
+      }
+
+      rmsgpack_dom_value_free(&item);
+   }
+
+   /* Keep the load factor at or below 50%. */
+   while (slots < count * 2)
+      slots *= 2;
+
+   idx->mask    = slots - 1;
+   idx->hashes  = (uint32_t*)calloc(slots, sizeof(*idx->hashes));
+   idx->offsets = (uint64_t*)calloc(slots, sizeof(*idx->offsets));
+
+   if (!idx->hashes || !idx->offsets)
+      goto error;
+
+   /* Linear probing; inserting in database order means a lookup
+    * meets the first entry with a given value first. */
+   for (i = 0; i < count; i++)
+   {
+      size_t slot = hashes[i] & idx->mask;
+
+      while (idx->offsets[slot])
+         slot = (slot + 1) & idx->mask;
+
+      idx->hashes[slot]  = hashes[i];
+      idx->offsets[slot] = offsets[i];
+   }
+
+   free(hashes);
+   free(offsets);
+
+   return idx;
+
+error:
+   free(hashes);
+   free(offsets);
+   libretrodb_hash_index_free(idx);
+   return NULL;
+}
+
+void libretrodb_hash_index_free(libretrodb_hash_index_t *idx)
+{
+   if (!idx)
+      return;
+
+   free(idx->hashes);
+   free(idx->offsets);
+   free(idx);
+}
+
+int libretrodb_hash_index_find(libretrodb_t *db,
+      const libretrodb_hash_index_t *idx,
+      const void *key, size_t len, struct rmsgpack_dom_value *out)
+{
+   size_t slot;
+   uint32_t hash;
+
+   if (!db || !db->fd || !idx || !key || !len)
+      return -1;
+
+   hash = libretrodb_hash_bytes(key, len);
+
+   for (slot = hash & idx->mask; idx->offsets[slot];
+         slot = (slot + 1) & idx->mask)
+   {
+      const struct rmsgpack_dom_value *field = NULL;
+
+      if (idx->hashes[slot] != hash)
+         continue;
+
+      filestream_seek(db->fd, (ssize_t)idx->offsets[slot], SEEK_SET);
+
+      if (rmsgpack_dom_read(db->fd, out) < 0)
+         return -1;
+
+      field = libretrodb_hash_index_field(idx, out);
+
+      /* Rule out hash collisions. */
+      if (field && field->val.binary.len == len
+            && memcmp(field->val.binary.buff, key, len) == 0)
+         return 0;
+
+      rmsgpack_dom_value_free(out);
+   }
+
+   return -1;
+}
+
 libretrodb_cursor_t *libretrodb_cursor_new(void)
 {
    libretrodb_cursor_t *dbc = (libretrodb_cursor_t*)
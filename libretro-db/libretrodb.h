@@ -43,6 +43,8 @@ typedef struct libretrodb_cursor libretrodb_cursor_t;
 
 typedef struct libretrodb_index libretrodb_index_t;
 
+typedef struct libretrodb_hash_index libretrodb_hash_index_t;
+
 typedef int (*libretrodb_value_provider)(void *ctx, struct rmsgpack_dom_value *out);
 
 int libretrodb_create(RFILE *fd, libretrodb_value_provider value_provider, void *ctx);
@@ -57,6 +59,38 @@ int libretrodb_create_index(libretrodb_t *db, const char *name,
 int libretrodb_find_entry(libretrodb_t *db, const char *index_name,
         const void *key, struct rmsgpack_dom_value *out);
 
+/**
+ * libretrodb_hash_index_new:
+ * @db                  : Handle to database.
+ * @field_name          : Name of a string or binary field.
+ *
+ * Builds an in-memory hash index over @field_name with a single
+ * pass over the database. Unlike libretrodb_create_index, the
+ * database is left untouched and entries may lack the field or
+ * share the same value.
+ *
+ * Returns: the index, or NULL on failure.
+ **/
+libretrodb_hash_index_t *libretrodb_hash_index_new(libretrodb_t *db,
+      const char *field_name);
+
+void libretrodb_hash_index_free(libretrodb_hash_index_t *idx);
+
+/**
+ * libretrodb_hash_index_find:
+ * @db                  : Handle to the database the index was built on.
+ * @idx                 : Index built with libretrodb_hash_index_new.
+ * @key                 : Raw bytes of the field value to look up.
+ * @len                 : Length of @key.
+ * @out                 : Receives the first matching item, in database
+ *                        order. Must be freed with rmsgpack_dom_value_free.
+ *
+ * Returns: 0 if an item was found, otherwise -1.
+ **/
+int libretrodb_hash_index_find(libretrodb_t *db,
+      const libretrodb_hash_index_t *idx,
+      const void *key, size_t len, struct rmsgpack_dom_value *out);
+
 libretrodb_t *libretrodb_new(void);
 
 void libretrodb_free(libretrodb_t *db);
@@ -0,0 +1,222 @@
+/* Copyright  (C) 2010-2017 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (libretrodb_lookup_bench.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Builds a synthetic database and resolves a synthetic library of
+ * file CRCs against it, once with a compiled query per file (the way
+ * the content scanner used to) and once with a hash index.
+ *
+ * Usage: libretrodb_lookup_bench <db file> [entries] [files] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <streams/file_stream.h>
+#include <retro_endianness.h>
+
+#include "libretrodb.h"
+#include "rmsgpack_dom.h"
+
+/* Scanning with queries is slow enough that only a
+ * sample of the library is timed and extrapolated. */
+#define QUERY_SAMPLE_FILES 200
+
+struct bench_provider
+{
+   unsigned index;
+   unsigned count;
+};
+
+static uint32_t bench_crc(unsigned i)
+{
+   return (i + 1) * 2654435761u;
+}
+
+static double bench_time(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+static void bench_set_string(struct rmsgpack_dom_value *v, const char *s)
+{
+   v->type           = RDT_STRING;
+   v->val.string.len = (uint32_t)strlen(s);
+   v->val.string.buff = strdup(s);
+}
+
+static int bench_value_provider(void *ctx, struct rmsgpack_dom_value *out)
+{
+   char name[64];
+   uint32_t crc;
+   struct bench_provider *p = (struct bench_provider*)ctx;
+
+   if (p->index >= p->count)
+      return 1;
+
+   crc                = swap_if_little32(bench_crc(p->index));
+
+   out->type          = RDT_MAP;
+   out->val.map.len   = 3;
+   out->val.map.items = (struct rmsgpack_dom_pair*)
+      calloc(3, sizeof(struct rmsgpack_dom_pair));
+
+   snprintf(name, sizeof(name), "Synthetic Game %u", p->index);
+   bench_set_string(&out->val.map.items[0].key, "name");
+   bench_set_string(&out->val.map.items[0].value, name);
+
+   snprintf(name, sizeof(name), "SYN-%05u", p->index);
+   bench_set_string(&out->val.map.items[1].key, "serial");
+   bench_set_string(&out->val.map.items[1].value, name);
+
+   bench_set_string(&out->val.map.items[2].key, "crc");
+   out->val.map.items[2].value.type            = RDT_BINARY;
+   out->val.map.items[2].value.val.binary.len  = sizeof(crc);
+   out->val.map.items[2].value.val.binary.buff = (char*)malloc(sizeof(crc));
+   memcpy(out->val.map.items[2].value.val.binary.buff, &crc, sizeof(crc));
+
+   p->index++;
+   return 0;
+}
+
+/* Every other file is unknown to the database. */
+static uint32_t bench_file_crc(unsigned file, unsigned entries)
+{
+   if (file & 1)
+      return bench_crc(entries + file);
+   return bench_crc((file * 7) % entries);
+}
+
+int main(int argc, char **argv)
+{
+   unsigned i;
+   double start, query_time, index_time;
+   struct rmsgpack_dom_value item;
+   struct bench_provider provider;
+   RFILE *fd                    = NULL;
+   libretrodb_t *db             = NULL;
+   libretrodb_hash_index_t *idx = NULL;
+   unsigned query_files         = QUERY_SAMPLE_FILES;
+   unsigned query_hits          = 0;
+   unsigned index_hits          = 0;
+   unsigned entries             = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 0) : 50000;
+   unsigned files               = argc > 3 ? (unsigned)strtoul(argv[3], NULL, 0) : 50000;
+
+   if (argc < 2 || !entries || !files)
+   {
+      printf("Usage: %s <db file> [entries] [files]\n", argv[0]);
+      return 1;
+   }
+
+   if (query_files > files)
+      query_files = files;
+
+   fd = filestream_open(argv[1], RFILE_MODE_WRITE, -1);
+
+   if (!fd)
+   {
+      printf("Could not create '%s'\n", argv[1]);
+      return 1;
+   }
+
+   provider.index = 0;
+   provider.count = entries;
+   libretrodb_create(fd, bench_value_provider, &provider);
+   filestream_close(fd);
+
+   db = libretrodb_new();
+
+   if (libretrodb_open(argv[1], db) != 0)
+   {
+      printf("Could not open '%s'\n", argv[1]);
+      libretrodb_free(db);
+      return 1;
+   }
+
+   printf("Database: %u entries, library: %u files\n", entries, files);
+
+   /* Before: one compiled query and one full cursor pass per file. */
+   start = bench_time();
+   for (i = 0; i < query_files; i++)
+   {
+      char query[50];
+      const char *error       = NULL;
+      libretrodb_query_t *q   = NULL;
+      libretrodb_cursor_t *cur = libretrodb_cursor_new();
+
+      snprintf(query, sizeof(query), "{crc:b\"%08X\"}",
+            bench_file_crc(i, entries));
+      q = libretrodb_query_compile(db, query, strlen(query), &error);
+
+      if (!error && libretrodb_cursor_open(db, cur, q) == 0)
+      {
+         while (libretrodb_cursor_read_item(cur, &item) == 0)
+         {
+            query_hits++;
+            rmsgpack_dom_value_free(&item);
+         }
+         libretrodb_cursor_close(cur);
+      }
+
+      if (q)
+         libretrodb_query_free(q);
+      libretrodb_cursor_free(cur);
+   }
+   query_time = bench_time() - start;
+
+   /* After: one index build, then one probe per file. */
+   start = bench_time();
+   idx   = libretrodb_hash_index_new(db, "crc");
+
+   if (!idx)
+   {
+      printf("Could not build index\n");
+      libretrodb_close(db);
+      libretrodb_free(db);
+      return 1;
+   }
+
+   for (i = 0; i < files; i++)
+   {
+      uint32_t key = swap_if_little32(bench_file_crc(i, entries));
+
+      if (libretrodb_hash_index_find(db, idx, &key, sizeof(key), &item) == 0)
+      {
+         index_hits++;
+         rmsgpack_dom_value_free(&item);
+      }
+   }
+   index_time = bench_time() - start;
+
+   printf("query scan : %8.1f files/s (%u files sampled, %u matches)\n",
+         query_files / query_time, query_files, query_hits);
+   printf("hash index : %8.1f files/s (%u files, %u matches, build included)\n",
+         files / index_time, files, index_hits);
+
+   libretrodb_hash_index_free(idx);
+   libretrodb_close(db);
+   libretrodb_free(db);
+
+   return 0;
+}
@@ -0,0 +1,226 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <features/features_cpu.h>
+
+#include "frame_delay.h"
+
+#include "../gfx/video_driver.h"
+#include "../verbosity.h"
+
+/* Frames of core_run and frame times the worst case is taken over. */
+#define FRAME_DELAY_WINDOW         64
+/* Least time left free between the core finishing and vsync, on
+ * top of the worst core_run time seen, in usec. The actual margin
+ * is the jitter of the measured frame times, when that is larger. */
+#define FRAME_DELAY_MIN_MARGIN_USEC 500
+/* Frames the delay must have looked safe for before it is raised
+ * by one millisecond. Lowering it is never delayed. */
+#define FRAME_DELAY_RAISE_FRAMES   120
+/* Frames to hold off raising the delay after a missed vsync. */
+#define FRAME_DELAY_COOLDOWN       600
+/* Frame times this many periods or longer are hitches
+ * (loading, menu, window moves), not missed vsyncs. */
+#define FRAME_DELAY_HITCH_PERIODS  4
+
+struct frame_delay_auto
+{
+   retro_time_t core_time[FRAME_DELAY_WINDOW];
+   retro_time_t frame_time[FRAME_DELAY_WINDOW];
+   retro_time_t wait_start;
+   retro_time_t wait_time;
+   uint64_t frame_time_count;
+   unsigned frames;
+   unsigned frame_times;
+   unsigned delay;
+   unsigned stable;
+   unsigned cooldown;
+};
+
+static struct frame_delay_auto frame_delay_st;
+
+void frame_delay_auto_reset(void)
+{
+   memset(&frame_delay_st, 0, sizeof(frame_delay_st));
+}
+
+unsigned frame_delay_auto_get(void)
+{
+   return frame_delay_st.delay;
+}
+
+void frame_delay_auto_begin(void)
+{
+   frame_delay_st.wait_time  = 0;
+   frame_delay_st.wait_start = 0;
+}
+
+void frame_delay_auto_wait_begin(void)
+{
+   frame_delay_st.wait_start = cpu_features_get_time_usec();
+}
+
+void frame_delay_auto_wait_end(void)
+{
+   if (!frame_delay_st.wait_start)
+      return;
+
+   frame_delay_st.wait_time += cpu_features_get_time_usec()
+      - frame_delay_st.wait_start;
+   frame_delay_st.wait_start = 0;
+}
+
+static bool frame_delay_auto_missed_vsync(retro_time_t period,
+      retro_time_t *frame_time)
+{
+   uint64_t count = 0;
+
+   if (!video_monitor_get_last_frame_time(frame_time, &count))
+      return false;
+
+   if (count == frame_delay_st.frame_time_count)
+      return false;
+   frame_delay_st.frame_time_count = count;
+
+   if (*frame_time >= period * FRAME_DELAY_HITCH_PERIODS)
+      return false;
+   if (*frame_time > period + period / 2)
+      return true;
+
+   frame_delay_st.frame_time[
+      frame_delay_st.frame_times++ % FRAME_DELAY_WINDOW] = *frame_time;
+
+   return false;
+}
+
+/* Largest distance of a recent frame time from their mean,
+ * i.e. how far off vsync a frame can land. */
+static retro_time_t frame_delay_auto_jitter(void)
+{
+   unsigned i;
+   retro_time_t mean   = 0;
+   retro_time_t jitter = 0;
+   unsigned count      = frame_delay_st.frame_times < FRAME_DELAY_WINDOW
+      ? frame_delay_st.frame_times : FRAME_DELAY_WINDOW;
+
+   if (!count)
+      return 0;
+
+   for (i = 0; i < count; i++)
+      mean += frame_delay_st.frame_time[i];
+   mean /= count;
+
+   for (i = 0; i < count; i++)
+   {
+      retro_time_t diff = frame_delay_st.frame_time[i] - mean;
+
+      if (diff < 0)
+         diff = -diff;
+      if (diff > jitter)
+         jitter = diff;
+   }
+
+   return jitter;
+}
+
+void frame_delay_auto_update(retro_time_t core_run_time,
+      float refresh_rate)
+{
+   unsigned i;
+   retro_time_t period;
+   retro_time_t worst      = 0;
+   retro_time_t frame_time = 0;
+   retro_time_t room       = 0;
+   retro_time_t margin     = 0;
+   unsigned safe           = 0;
+   bool missed             = false;
+
+   if (refresh_rate <= 0.0f)
+      return;
+
+   period = (retro_time_t)(1000000.0f / refresh_rate);
+
+   /* Waiting on vsync and on the audio driver is not emulation,
+    * and shrinks by however much the delay grows. */
+   frame_delay_auto_wait_end();
+   core_run_time -= frame_delay_st.wait_time;
+   if (core_run_time < 0)
+      core_run_time = 0;
+
+   frame_delay_st.core_time[
+      frame_delay_st.frames++ % FRAME_DELAY_WINDOW] = core_run_time;
+
+   missed = frame_delay_auto_missed_vsync(period, &frame_time);
+
+   if (frame_delay_st.frames < FRAME_DELAY_WINDOW)
+      return;
+
+   for (i = 0; i < FRAME_DELAY_WINDOW; i++)
+      if (frame_delay_st.core_time[i] > worst)
+         worst = frame_delay_st.core_time[i];
+
+   margin = frame_delay_auto_jitter();
+   if (margin < FRAME_DELAY_MIN_MARGIN_USEC)
+      margin = FRAME_DELAY_MIN_MARGIN_USEC;
+
+   room = period - worst - margin;
+   if (room > 0)
+      safe = (unsigned)(room / 1000);
+   if (safe > FRAME_DELAY_MAX)
+      safe = FRAME_DELAY_MAX;
+
+   if (frame_delay_st.cooldown)
+      frame_delay_st.cooldown--;
+
+   if (missed && frame_delay_st.delay > 0)
+   {
+      unsigned delay          = frame_delay_st.delay > 2
+         ? frame_delay_st.delay - 2 : 0;
+
+      if (delay > safe)
+         delay                = safe;
+
+      RARCH_LOG("[Frame delay]: Missed vsync (frame took %.2f ms), lowering delay %u -> %u ms.\n",
+            frame_time / 1000.0, frame_delay_st.delay, delay);
+
+      frame_delay_st.delay    = delay;
+      frame_delay_st.stable   = 0;
+      frame_delay_st.cooldown = FRAME_DELAY_COOLDOWN;
+   }
+   else if (safe < frame_delay_st.delay)
+   {
+      RARCH_LOG("[Frame delay]: Core takes up to %.2f ms, lowering delay %u -> %u ms.\n",
+            worst / 1000.0, frame_delay_st.delay, safe);
+
+      frame_delay_st.delay    = safe;
+      frame_delay_st.stable   = 0;
+   }
+   else if (safe > frame_delay_st.delay && !frame_delay_st.cooldown)
+   {
+      if (++frame_delay_st.stable >= FRAME_DELAY_RAISE_FRAMES)
+      {
+         RARCH_LOG("[Frame delay]: Core takes up to %.2f ms, raising delay %u -> %u ms.\n",
+               worst / 1000.0, frame_delay_st.delay, frame_delay_st.delay + 1);
+
+         frame_delay_st.delay++;
+         frame_delay_st.stable = 0;
+      }
+   }
+   else
+      frame_delay_st.stable   = 0;
+}
@@ -0,0 +1,69 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FRAME_DELAY_H
+#define __FRAME_DELAY_H
+
+#include <boolean.h>
+#include <retro_common_api.h>
+#include <libretro.h>
+
+RETRO_BEGIN_DECLS
+
+/* Same limit as the video_frame_delay setting. */
+#define FRAME_DELAY_MAX 15
+
+void frame_delay_auto_reset(void);
+
+/**
+ * frame_delay_auto_get:
+ *
+ * Returns: frame delay to sleep before running the core
+ * this frame, in milliseconds.
+ **/
+unsigned frame_delay_auto_get(void);
+
+/**
+ * frame_delay_auto_begin:
+ *
+ * Starts measuring a core_run call. Time spent between
+ * frame_delay_auto_wait_begin and frame_delay_auto_wait_end
+ * from here on is left out of it.
+ **/
+void frame_delay_auto_begin(void);
+
+/* Brackets the video driver's frame call and the audio
+ * driver's write, which block on vsync and the audio device. */
+void frame_delay_auto_wait_begin(void);
+
+void frame_delay_auto_wait_end(void);
+
+/**
+ * frame_delay_auto_update:
+ * @core_run_time        : time core_run took this frame, in usec,
+ *                         waits included.
+ * @refresh_rate         : display refresh rate in Hz.
+ *
+ * Feeds one frame's measurements to the tuner, which moves
+ * the delay towards the largest value that still leaves
+ * the core enough time before the next vsync.
+ **/
+void frame_delay_auto_update(retro_time_t core_run_time,
+      float refresh_rate);
+
+RETRO_END_DECLS
+
+#endif
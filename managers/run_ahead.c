@@ -0,0 +1,168 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+
+#include <boolean.h>
+
+#include "run_ahead.h"
+#include "state_manager.h"
+#include "../core.h"
+#include "../movie.h"
+#include "../retroarch.h"
+#include "../verbosity.h"
+#include "../performance_counters.h"
+
+#ifdef HAVE_NETWORKING
+#include "../network/netplay/netplay.h"
+#endif
+
+struct runahead_state
+{
+   /* Serialized core state at the end of the last real frame. */
+   void *data;
+   size_t size;
+   /* Set once the core failed to (un)serialize, so we stop trying
+    * until the core is unloaded. */
+   bool unsupported;
+};
+
+static struct runahead_state runahead_state;
+
+static struct retro_perf_counter runahead_core_run_perf   = {0};
+static struct retro_perf_counter runahead_serialize_perf  = {0};
+static struct retro_perf_counter runahead_restore_perf    = {0};
+
+void runahead_event_deinit(void)
+{
+   if (runahead_state.data)
+      free(runahead_state.data);
+
+   runahead_state.data        = NULL;
+   runahead_state.size        = 0;
+   runahead_state.unsupported = false;
+}
+
+static bool runahead_event_init(void)
+{
+   retro_ctx_size_info_t info;
+
+   core_serialize_size(&info);
+
+   if (!info.size)
+      goto error;
+
+   runahead_state.data = malloc(info.size);
+
+   if (!runahead_state.data)
+      goto error;
+
+   runahead_state.size = info.size;
+
+   RARCH_LOG("[Run-Ahead]: Initialized, state size: %u bytes.\n",
+         (unsigned)info.size);
+
+   return true;
+
+error:
+   RARCH_WARN("[Run-Ahead]: Core does not support serialization, disabling.\n");
+   runahead_state.unsupported = true;
+   return false;
+}
+
+static bool runahead_is_allowed(void)
+{
+   if (runahead_state.unsupported)
+      return false;
+#ifdef HAVE_NETWORKING
+   /* Netplay already does its own rollback. */
+   if (netplay_driver_ctl(RARCH_NETPLAY_CTL_IS_DATA_INITED, NULL))
+      return false;
+#endif
+   /* Hidden frames would consume recorded movie input. */
+   if (bsv_movie_ctl(BSV_MOVIE_CTL_IS_INITED, NULL))
+      return false;
+   if (state_manager_frame_is_reversed())
+      return false;
+   return true;
+}
+
+bool runahead_run(unsigned frames)
+{
+   unsigned i;
+   retro_ctx_serialize_info_t serial_info;
+   bool is_perfcnt_enable = rarch_ctl(RARCH_CTL_IS_PERFCNT_ENABLE, NULL);
+
+   if (frames > RUN_AHEAD_MAX_FRAMES)
+      frames = RUN_AHEAD_MAX_FRAMES;
+
+   if (!runahead_is_allowed())
+      return false;
+
+   if (!runahead_state.data && !runahead_event_init())
+      return false;
+
+   performance_counter_init(runahead_core_run_perf,  "runahead_core_run");
+   performance_counter_init(runahead_serialize_perf, "runahead_serialize");
+   performance_counter_init(runahead_restore_perf,   "runahead_unserialize");
+
+   /* The real frame: its audio is kept, its video is
+    * superseded by the speculative frame below. */
+   performance_counter_start_plus(is_perfcnt_enable, runahead_core_run_perf);
+   core_set_runahead_callbacks(true, false);
+   core_run();
+   performance_counter_stop_plus(is_perfcnt_enable, runahead_core_run_perf);
+
+   serial_info.data = runahead_state.data;
+   serial_info.size = runahead_state.size;
+
+   performance_counter_start_plus(is_perfcnt_enable, runahead_serialize_perf);
+   if (!core_serialize(&serial_info))
+   {
+      performance_counter_stop_plus(is_perfcnt_enable, runahead_serialize_perf);
+      RARCH_WARN("[Run-Ahead]: Failed to serialize core state, disabling.\n");
+      core_set_runahead_callbacks(false, false);
+      runahead_event_deinit();
+      runahead_state.unsupported = true;
+      /* The real frame already ran, there is just nothing to show. */
+      return true;
+   }
+   performance_counter_stop_plus(is_perfcnt_enable, runahead_serialize_perf);
+
+   /* Hidden frames, followed by the one we present. */
+   performance_counter_start_plus(is_perfcnt_enable, runahead_core_run_perf);
+   for (i = 1; i <= frames; i++)
+   {
+      core_set_runahead_callbacks(i != frames, true);
+      core_run_no_input_polling();
+   }
+   core_set_runahead_callbacks(false, false);
+   performance_counter_stop_plus(is_perfcnt_enable, runahead_core_run_perf);
+
+   serial_info.data_const = runahead_state.data;
+   serial_info.size       = runahead_state.size;
+
+   performance_counter_start_plus(is_perfcnt_enable, runahead_restore_perf);
+   if (!core_unserialize(&serial_info))
+   {
+      RARCH_WARN("[Run-Ahead]: Failed to unserialize core state, disabling.\n");
+      runahead_event_deinit();
+      runahead_state.unsupported = true;
+   }
+   performance_counter_stop_plus(is_perfcnt_enable, runahead_restore_perf);
+
+   return true;
+}
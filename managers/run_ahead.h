@@ -0,0 +1,47 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RUN_AHEAD_H
+#define __RUN_AHEAD_H
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+#define RUN_AHEAD_MAX_FRAMES 6
+
+void runahead_event_deinit(void);
+
+/**
+ * runahead_run:
+ * @frames               : amount of frames to run ahead.
+ *
+ * Runs the core for one frame, then speculatively runs
+ * it @frames more frames with the same input and only
+ * presents the video of the last one. The core state is
+ * rewound afterwards to the end of the first frame, so
+ * game logic only advances by one frame per call.
+ *
+ * Returns: true (1) if the core was run, false (0) if
+ * run-ahead is not possible right now and the caller
+ * should fall back to core_run().
+ **/
+bool runahead_run(unsigned frames);
+
+RETRO_END_DECLS
+
+#endif
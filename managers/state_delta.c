@@ -0,0 +1,586 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *  Copyright (C) 2014-2017 - Alfred Agrell
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define __STDC_LIMIT_MACROS
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libretro.h>
+#include <retro_inline.h>
+#include <retro_simd.h>
+#include <compat/intrinsics.h>
+#include <features/features_cpu.h>
+
+#include "state_delta.h"
+
+#ifndef UINT16_MAX
+#define UINT16_MAX 0xffff
+#endif
+
+#ifndef UINT32_MAX
+#define UINT32_MAX 0xffffffffu
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(__i486__) || defined(__i686__) || defined(_M_X64) || defined(_M_IX86)
+#define STATE_DELTA_X86
+#endif
+
+/* Other arches SIGBUS (usually) on unaligned accesses. */
+#ifndef STATE_DELTA_X86
+#define STATE_DELTA_NO_UNALIGNED_MEM
+#endif
+
+#if __SSE2__
+#define STATE_DELTA_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+/* The scanners below read this far past the point where they are
+ * guaranteed to stop, so every buffer is padded by this much. */
+#define STATE_DELTA_PADDING 64
+
+/* Format (pseudocode): */
+#if 0
+repeat {
+   uint16 numchanged; /* everything is counted in units of uint16 */
+   if (numchanged)
+   {
+      uint16 numunchanged; /* skip these before handling numchanged */
+      uint16[numchanged] changeddata;
+   }
+   else
+   {
+      uint32 numunchanged;
+      if (!numunchanged)
+         break;
+   }
+}
+#endif
+
+typedef size_t (*state_delta_compress_t)(const void *src,
+      const void *dst, size_t len, void *patch);
+
+static INLINE unsigned state_delta_ctz64(uint64_t x)
+{
+#if defined(__GNUC__)
+   return __builtin_ctzll(x);
+#else
+   unsigned ret = 0;
+
+   while (!(x & 1))
+   {
+      x >>= 1;
+      ret++;
+   }
+
+   return ret;
+#endif
+}
+
+/* There's no equivalent in libc, you'd think so ...
+ * std::mismatch exists, but it's not optimized at all. */
+static INLINE size_t find_change_scalar(const uint16_t *a, const uint16_t *b)
+{
+   const uint16_t *a_org = a;
+#ifdef STATE_DELTA_NO_UNALIGNED_MEM
+   while (((uintptr_t)a & (sizeof(size_t) - 1)) && *a == *b)
+   {
+      a++;
+      b++;
+   }
+   if (*a == *b)
+#endif
+   {
+      const size_t *a_big = (const size_t*)a;
+      const size_t *b_big = (const size_t*)b;
+
+      while (*a_big == *b_big)
+      {
+         a_big++;
+         b_big++;
+      }
+      a = (const uint16_t*)a_big;
+      b = (const uint16_t*)b_big;
+
+      while (*a == *b)
+      {
+         a++;
+         b++;
+      }
+   }
+   return a - a_org;
+}
+
+static INLINE size_t find_same_scalar(const uint16_t *a, const uint16_t *b)
+{
+   const uint16_t *a_org = a;
+#ifdef STATE_DELTA_NO_UNALIGNED_MEM
+   if (((uintptr_t)a & (sizeof(uint32_t) - 1)) && *a != *b)
+   {
+      a++;
+      b++;
+   }
+   if (*a != *b)
+#endif
+   {
+      /* With this, it's random whether two consecutive identical
+       * words are caught.
+       *
+       * Luckily, compression rate is the same for both cases, and
+       * three is always caught.
+       *
+       * (We prefer to miss two-word blocks, anyways; fewer iterations
+       * of the outer loop, as well as in the decompressor.) */
+      const uint32_t *a_big = (const uint32_t*)a;
+      const uint32_t *b_big = (const uint32_t*)b;
+
+      while (*a_big != *b_big)
+      {
+         a_big++;
+         b_big++;
+      }
+      a = (const uint16_t*)a_big;
+      b = (const uint16_t*)b_big;
+
+      if (a != a_org && a[-1] == b[-1])
+      {
+         a--;
+         b--;
+      }
+   }
+   return a - a_org;
+}
+
+#ifdef STATE_DELTA_HAVE_SSE2
+static INLINE size_t find_change_sse2(const uint16_t *a, const uint16_t *b)
+{
+   const __m128i *a128 = (const __m128i*)a;
+   const __m128i *b128 = (const __m128i*)b;
+
+   for (;;)
+   {
+      __m128i v0    = _mm_loadu_si128(a128);
+      __m128i v1    = _mm_loadu_si128(b128);
+      __m128i c     = _mm_cmpeq_epi32(v0, v1);
+      uint32_t mask = _mm_movemask_epi8(c);
+
+      if (mask != 0xffff) /* Something has changed, figure out where. */
+      {
+         size_t ret = (((uint8_t*)a128 - (uint8_t*)a) |
+               (compat_ctz(~mask))) >> 1;
+         return ret | (a[ret] == b[ret]);
+      }
+
+      a128++;
+      b128++;
+   }
+}
+#endif
+
+#ifdef RETRO_HAVE_AVX2
+/* Same as the SSE2 version, 64 bytes at a time. */
+static INLINE RETRO_TARGET_AVX2 size_t find_change_avx2(
+      const uint16_t *a, const uint16_t *b)
+{
+   const __m256i *a256 = (const __m256i*)a;
+   const __m256i *b256 = (const __m256i*)b;
+
+   for (;;)
+   {
+      __m256i c0    = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256(a256),     _mm256_loadu_si256(b256));
+      __m256i c1    = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256(a256 + 1), _mm256_loadu_si256(b256 + 1));
+      uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_and_si256(c0, c1));
+
+      if (mask != 0xffffffff)
+      {
+         uint64_t mask64 = (uint32_t)_mm256_movemask_epi8(c0)
+            | ((uint64_t)(uint32_t)_mm256_movemask_epi8(c1) << 32);
+         size_t ret      = (((uint8_t*)a256 - (uint8_t*)a) |
+               state_delta_ctz64(~mask64)) >> 1;
+         return ret | (a[ret] == b[ret]);
+      }
+
+      a256 += 2;
+      b256 += 2;
+   }
+}
+
+/* Looks at the same 32-bit words as find_same_scalar,
+ * so both produce the same patches. */
+static INLINE RETRO_TARGET_AVX2 size_t find_same_avx2(
+      const uint16_t *a, const uint16_t *b)
+{
+   const uint16_t *a_org = a;
+   const __m256i *a256   = (const __m256i*)a;
+   const __m256i *b256   = (const __m256i*)b;
+
+   for (;;)
+   {
+      uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi32(
+               _mm256_loadu_si256(a256), _mm256_loadu_si256(b256)));
+
+      if (mask)
+      {
+         size_t skip = state_delta_ctz64(mask) >> 1;
+         a           = (const uint16_t*)a256 + skip;
+         b           = (const uint16_t*)b256 + skip;
+         break;
+      }
+
+      a256++;
+      b256++;
+   }
+
+   if (a != a_org && a[-1] == b[-1])
+      a--;
+
+   return a - a_org;
+}
+#endif
+
+#ifdef RETRO_HAVE_NEON
+/* NEON has no movemask; narrowing the compare result by 4 bits
+ * leaves one nibble per byte in a 64-bit value instead. */
+static INLINE uint64_t state_delta_neon_eq32(const uint16_t *a,
+      const uint16_t *b)
+{
+   uint32x4_t eq = vceqq_u32(
+         vreinterpretq_u32_u16(vld1q_u16(a)),
+         vreinterpretq_u32_u16(vld1q_u16(b)));
+   uint8x8_t  nb = vshrn_n_u16(vreinterpretq_u16_u32(eq), 4);
+   return vget_lane_u64(vreinterpret_u64_u8(nb), 0);
+}
+
+static INLINE size_t find_change_neon(const uint16_t *a, const uint16_t *b)
+{
+   size_t pos = 0;
+
+   for (;;)
+   {
+      uint64_t mask = state_delta_neon_eq32(a + pos, b + pos);
+
+      if (mask != UINT64_C(0xffffffffffffffff))
+      {
+         size_t ret = pos + (state_delta_ctz64(~mask) >> 3);
+         return ret | (a[ret] == b[ret]);
+      }
+
+      pos += 8;
+   }
+}
+
+static INLINE size_t find_same_neon(const uint16_t *a, const uint16_t *b)
+{
+   size_t pos = 0;
+
+   /* Keep the scalar 32-bit phase, so both produce the same patches. */
+   if (((uintptr_t)a & (sizeof(uint32_t) - 1)) && *a != *b)
+      pos++;
+   if (a[pos] == b[pos])
+      return pos;
+
+   for (;;)
+   {
+      uint64_t mask = state_delta_neon_eq32(a + pos, b + pos);
+
+      if (mask)
+      {
+         pos += state_delta_ctz64(mask) >> 3;
+         break;
+      }
+
+      pos += 8;
+   }
+
+   if (pos && a[pos - 1] == b[pos - 1])
+      pos--;
+
+   return pos;
+}
+#endif
+
+/* Every implementation shares this loop; it is inlined
+ * into each one so the scanners are called directly. */
+#define STATE_DELTA_COMPRESS_BODY(find_change, find_same) \
+   const uint16_t  *old16 = (const uint16_t*)src; \
+   const uint16_t  *new16 = (const uint16_t*)dst; \
+   uint16_t *compressed16 = (uint16_t*)patch; \
+   size_t          num16s = (len + sizeof(uint16_t) - 1) \
+      / sizeof(uint16_t); \
+   \
+   while (num16s) \
+   { \
+      size_t i, changed; \
+      size_t skip = find_change(old16, new16); \
+      \
+      if (skip >= num16s) \
+         break; \
+      \
+      old16  += skip; \
+      new16  += skip; \
+      num16s -= skip; \
+      \
+      if (skip > UINT16_MAX) \
+      { \
+         if (skip > UINT32_MAX) \
+         { \
+            /* This will make it scan the entire thing again, \
+             * but it only hits on 8GB unchanged data anyways, \
+             * and if you're doing that, you've got bigger problems. */ \
+            skip = UINT32_MAX; \
+         } \
+         *compressed16++ = 0; \
+         *compressed16++ = skip; \
+         *compressed16++ = skip >> 16; \
+         continue; \
+      } \
+      \
+      changed = find_same(old16, new16); \
+      if (changed > UINT16_MAX) \
+         changed = UINT16_MAX; \
+      \
+      *compressed16++ = changed; \
+      *compressed16++ = skip; \
+      \
+      for (i = 0; i < changed; i++) \
+         compressed16[i] = old16[i]; \
+      \
+      old16 += changed; \
+      new16 += changed; \
+      num16s -= changed; \
+      compressed16 += changed; \
+   } \
+   \
+   compressed16[0] = 0; \
+   compressed16[1] = 0; \
+   compressed16[2] = 0; \
+   \
+   return (uint8_t*)(compressed16+3) - (uint8_t*)patch
+
+static size_t state_delta_compress_scalar(const void *src,
+      const void *dst, size_t len, void *patch)
+{
+   STATE_DELTA_COMPRESS_BODY(find_change_scalar, find_same_scalar);
+}
+
+#ifdef STATE_DELTA_HAVE_SSE2
+static size_t state_delta_compress_sse2(const void *src,
+      const void *dst, size_t len, void *patch)
+{
+   STATE_DELTA_COMPRESS_BODY(find_change_sse2, find_same_scalar);
+}
+#endif
+
+#ifdef RETRO_HAVE_AVX2
+static RETRO_TARGET_AVX2 size_t state_delta_compress_avx2(
+      const void *src, const void *dst, size_t len, void *patch)
+{
+   STATE_DELTA_COMPRESS_BODY(find_change_avx2, find_same_avx2);
+}
+#endif
+
+#ifdef RETRO_HAVE_NEON
+static size_t state_delta_compress_neon(const void *src,
+      const void *dst, size_t len, void *patch)
+{
+   STATE_DELTA_COMPRESS_BODY(find_change_neon, find_same_neon);
+}
+#endif
+
+static state_delta_compress_t state_delta_compress_func;
+static enum state_delta_impl state_delta_impl = STATE_DELTA_IMPL_AUTO;
+
+bool state_delta_impl_available(enum state_delta_impl impl)
+{
+   uint64_t simd = cpu_features_get_simd();
+
+   switch (impl)
+   {
+      case STATE_DELTA_IMPL_AUTO:
+      case STATE_DELTA_IMPL_SCALAR:
+         return true;
+      case STATE_DELTA_IMPL_SSE2:
+#ifdef STATE_DELTA_HAVE_SSE2
+         /* Built for a CPU that has SSE2. */
+         return true;
+#else
+         break;
+#endif
+      case STATE_DELTA_IMPL_AVX2:
+#ifdef RETRO_HAVE_AVX2
+         return (simd & RETRO_SIMD_AVX2) != 0;
+#else
+         break;
+#endif
+      case STATE_DELTA_IMPL_NEON:
+#ifdef RETRO_HAVE_NEON
+         return (simd & RETRO_SIMD_NEON) != 0;
+#else
+         break;
+#endif
+      default:
+         break;
+   }
+
+   (void)simd;
+   return false;
+}
+
+bool state_delta_set_impl(enum state_delta_impl impl)
+{
+   state_delta_compress_t func = state_delta_compress_scalar;
+
+   if (impl == STATE_DELTA_IMPL_AUTO)
+   {
+      if (state_delta_impl_available(STATE_DELTA_IMPL_AVX2))
+         impl = STATE_DELTA_IMPL_AVX2;
+      else if (state_delta_impl_available(STATE_DELTA_IMPL_SSE2))
+         impl = STATE_DELTA_IMPL_SSE2;
+      else if (state_delta_impl_available(STATE_DELTA_IMPL_NEON))
+         impl = STATE_DELTA_IMPL_NEON;
+      else
+         impl = STATE_DELTA_IMPL_SCALAR;
+   }
+   else if (!state_delta_impl_available(impl))
+      return false;
+
+   switch (impl)
+   {
+#ifdef STATE_DELTA_HAVE_SSE2
+      case STATE_DELTA_IMPL_SSE2:
+         func = state_delta_compress_sse2;
+         break;
+#endif
+#ifdef RETRO_HAVE_AVX2
+      case STATE_DELTA_IMPL_AVX2:
+         func = state_delta_compress_avx2;
+         break;
+#endif
+#ifdef RETRO_HAVE_NEON
+      case STATE_DELTA_IMPL_NEON:
+         func = state_delta_compress_neon;
+         break;
+#endif
+      default:
+         impl = STATE_DELTA_IMPL_SCALAR;
+         break;
+   }
+
+   state_delta_impl          = impl;
+   state_delta_compress_func = func;
+
+   return true;
+}
+
+enum state_delta_impl state_delta_get_impl(void)
+{
+   if (!state_delta_compress_func)
+      state_delta_set_impl(STATE_DELTA_IMPL_AUTO);
+   return state_delta_impl;
+}
+
+size_t state_delta_maxsize(size_t uncomp)
+{
+   /* bytes covered by a compressed block */
+   const int maxcblkcover = UINT16_MAX * sizeof(uint16_t);
+   /* uncompressed size, rounded to 16 bits */
+   size_t uncomp16        = (uncomp + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
+   /* number of blocks */
+   size_t maxcblks        = (uncomp + maxcblkcover - 1) / maxcblkcover;
+   return uncomp16 + maxcblks * sizeof(uint16_t) * 2 /* two u16 overhead per block */ + sizeof(uint16_t) *
+      3; /* three u16 to end it */
+}
+
+void *state_delta_alloc(size_t len, uint16_t uniq)
+{
+   size_t  len16 = (len + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
+   uint16_t *ret = (uint16_t*)calloc(len16 +
+         sizeof(uint16_t) * 4 + STATE_DELTA_PADDING, 1);
+
+   if (!ret)
+      return NULL;
+
+   /* Force in a different byte at the end, so we don't need to check
+    * bounds in the innermost loop (it's expensive).
+    *
+    * There is also a large amount of data that's the same, to stop
+    * the other scan.
+    *
+    * There is also some padding at the end. This is so we don't
+    * read outside the buffer end if we're reading in large blocks;
+    *
+    * It doesn't make any difference to us, but sacrificing 64 bytes to get
+    * Valgrind happy is worth it. */
+   ret[len16/sizeof(uint16_t) + 3] = uniq;
+
+   return ret;
+}
+
+size_t state_delta_compress(const void *src,
+      const void *dst, size_t len, void *patch)
+{
+   if (!state_delta_compress_func)
+      state_delta_set_impl(STATE_DELTA_IMPL_AUTO);
+
+   return state_delta_compress_func(src, dst, len, patch);
+}
+
+void state_delta_decompress(const void *patch,
+      size_t patchlen, void *data, size_t datalen)
+{
+   uint16_t         *out16 = (uint16_t*)data;
+   const uint16_t *patch16 = (const uint16_t*)patch;
+
+   (void)patchlen;
+   (void)datalen;
+
+   for (;;)
+   {
+      uint16_t numchanged = *(patch16++);
+
+      if (numchanged)
+      {
+         uint16_t i;
+
+         out16 += *patch16++;
+
+         /* We could do memcpy, but it seems that memcpy has a
+          * constant-per-call overhead that actually shows up.
+          *
+          * Our average size in here seems to be 8 or something.
+          * Therefore, we do something with lower overhead. */
+         for (i = 0; i < numchanged; i++)
+            out16[i] = patch16[i];
+
+         patch16 += numchanged;
+         out16 += numchanged;
+      }
+      else
+      {
+         uint32_t numunchanged = patch16[0] | (patch16[1] << 16);
+
+         if (!numunchanged)
+            break;
+         patch16 += 2;
+         out16 += numunchanged;
+      }
+   }
+}
@@ -0,0 +1,83 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *  Copyright (C) 2014-2017 - Alfred Agrell
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __STATE_DELTA_H
+#define __STATE_DELTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+enum state_delta_impl
+{
+   /* Fastest implementation the CPU supports. */
+   STATE_DELTA_IMPL_AUTO = 0,
+   STATE_DELTA_IMPL_SCALAR,
+   STATE_DELTA_IMPL_SSE2,
+   STATE_DELTA_IMPL_AVX2,
+   STATE_DELTA_IMPL_NEON,
+   STATE_DELTA_IMPL_LAST
+};
+
+/* Returns the maximum compressed size of a savestate.
+ * It is very likely to compress to far less. */
+size_t state_delta_maxsize(size_t uncomp);
+
+/*
+ * Allocates a savestate buffer for state_delta_compress.
+ * See state_delta_compress for information about 'uniq'.
+ * When you're done with it, send it to free().
+ */
+void *state_delta_alloc(size_t len, uint16_t uniq);
+
+/*
+ * Takes two savestates and creates a patch that turns 'dst' back into 'src'.
+ * Both 'src' and 'dst' must be returned from state_delta_alloc(),
+ * with the same 'len', and different 'uniq'.
+ *
+ * 'patch' must be size 'state_delta_maxsize(len)' or more.
+ * Returns the number of bytes actually written to 'patch'.
+ */
+size_t state_delta_compress(const void *src,
+      const void *dst, size_t len, void *patch);
+
+/*
+ * Takes 'patch' from a previous call to 'state_delta_compress'
+ * and applies it to 'data' ('dst' from that call),
+ * yielding 'src' in that call.
+ *
+ * If the given arguments do not match a previous call to
+ * state_delta_compress(), anything at all can happen.
+ */
+void state_delta_decompress(const void *patch,
+      size_t patchlen, void *data, size_t datalen);
+
+bool state_delta_impl_available(enum state_delta_impl impl);
+
+/* Forces an implementation, mostly for testing and benchmarking.
+ * Returns false if it is not supported on this CPU. */
+bool state_delta_set_impl(enum state_delta_impl impl);
+
+enum state_delta_impl state_delta_get_impl(void);
+
+RETRO_END_DECLS
+
+#endif
@@ -22,13 +22,24 @@
 
 #include <retro_inline.h>
 #include <compat/strl.h>
-#include <compat/intrinsics.h>
+#include <features/features_cpu.h>
+
+#ifdef HAVE_CONFIG_H
+#include "../config.h"
+#endif
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
 
 #include "state_manager.h"
+#include "state_delta.h"
 #include "../msg_hash.h"
 #include "../movie.h"
 #include "../core.h"
+#include "../retroarch.h"
 #include "../verbosity.h"
+#include "../performance_counters.h"
 #include "../audio/audio_driver.h"
 
 #ifdef HAVE_NETWORKING
@@ -39,124 +50,6 @@
 /* Keep it off unless you're chasing a core bug, it slows things down. */
 #define STRICT_BUF_SIZE 0
 
-#ifndef UINT16_MAX
-#define UINT16_MAX 0xffff
-#endif
-
-#ifndef UINT32_MAX
-#define UINT32_MAX 0xffffffffu
-#endif
-
-#if defined(__x86_64__) || defined(__i386__) || defined(__i486__) || defined(__i686__)
-#define CPU_X86
-#endif
-
-/* Other arches SIGBUS (usually) on unaligned accesses. */
-#ifndef CPU_X86
-#define NO_UNALIGNED_MEM
-#endif
-
-#if __SSE2__
-#include <emmintrin.h>
-#endif
-
-/* There's no equivalent in libc, you'd think so ...
- * std::mismatch exists, but it's not optimized at all. */
-static size_t find_change(const uint16_t *a, const uint16_t *b)
-{
-#if __SSE2__
-   const __m128i *a128 = (const __m128i*)a;
-   const __m128i *b128 = (const __m128i*)b;
-   
-   for (;;)
-   {
-      __m128i v0    = _mm_loadu_si128(a128);
-      __m128i v1    = _mm_loadu_si128(b128);
-      __m128i c     = _mm_cmpeq_epi32(v0, v1);
-      uint32_t mask = _mm_movemask_epi8(c);
-
-      if (mask != 0xffff) /* Something has changed, figure out where. */
-      {
-         size_t ret = (((uint8_t*)a128 - (uint8_t*)a) |
-               (compat_ctz(~mask))) >> 1;
-         return ret | (a[ret] == b[ret]);
-      }
-
-      a128++;
-      b128++;
-   }
-#else
-   const uint16_t *a_org = a;
-#ifdef NO_UNALIGNED_MEM
-   while (((uintptr_t)a & (sizeof(size_t) - 1)) && *a == *b)
-   {
-      a++;
-      b++;
-   }
-   if (*a == *b)
-#endif
-   {
-      const size_t *a_big = (const size_t*)a;
-      const size_t *b_big = (const size_t*)b;
-      
-      while (*a_big == *b_big)
-      {
-         a_big++;
-         b_big++;
-      }
-      a = (const uint16_t*)a_big;
-      b = (const uint16_t*)b_big;
-      
-      while (*a == *b)
-      {
-         a++;
-         b++;
-      }
-   }
-   return a - a_org;
-#endif
-}
-
-static size_t find_same(const uint16_t *a, const uint16_t *b)
-{
-   const uint16_t *a_org = a;
-#ifdef NO_UNALIGNED_MEM
-   if (((uintptr_t)a & (sizeof(uint32_t) - 1)) && *a != *b)
-   {
-      a++;
-      b++;
-   }
-   if (*a != *b)
-#endif
-   {
-      /* With this, it's random whether two consecutive identical
-       * words are caught.
-       *
-       * Luckily, compression rate is the same for both cases, and 
-       * three is always caught.
-       *
-       * (We prefer to miss two-word blocks, anyways; fewer iterations 
-       * of the outer loop, as well as in the decompressor.) */
-      const uint32_t *a_big = (const uint32_t*)a;
-      const uint32_t *b_big = (const uint32_t*)b;
-      
-      while (*a_big != *b_big)
-      {
-         a_big++;
-         b_big++;
-      }
-      a = (const uint16_t*)a_big;
-      b = (const uint16_t*)b_big;
-      
-      if (a != a_org && a[-1] == b[-1])
-      {
-         a--;
-         b--;
-      }
-   }
-   return a - a_org;
-}
-
 struct state_manager
 {
    uint8_t *data;
@@ -179,6 +72,31 @@ struct state_manager
 
    unsigned entries;
    bool thisblock_valid;
+
+   /* Set when patches get an LZ pass before they are stored.
+    * Every entry then starts with a uint32 holding the LZ
+    * length, or 0 if the patch is stored as is. */
+   bool lz;
+   /* Patch staging area for the LZ pass, state_delta_maxsize bytes. */
+   uint8_t *patch;
+   uint32_t *lz_table;
+
+#ifdef HAVE_THREADS
+   /* With a worker, the block the worker still reads as 'old'
+    * is parked here, so the next savestate has somewhere to go. */
+   uint8_t *spareblock;
+
+   sthread_t *thread;
+   slock_t *lock;
+   scond_t *cond;
+   const uint8_t *job_old;
+   const uint8_t *job_new;
+   bool busy;
+   bool quit;
+#endif
+
+   /* Entry count as last seen by the main thread, for stats. */
+   unsigned entries_seen;
 #if STRICT_BUF_SIZE
    size_t debugsize;
    uint8_t *debugblock;
@@ -210,164 +128,191 @@ struct state_manager_rewind_state
    /* Rewind support. */
    state_manager_t *state;
    size_t size;
+   unsigned granularity;
+   /* Main thread cost of a push, smoothed, in usec. */
+   retro_time_t push_time;
 };
 
 static struct state_manager_rewind_state rewind_state;
 static bool frame_is_reversed                         = false;
 
-/* Returns the maximum compressed size of a savestate. 
- * It is very likely to compress to far less. */
-static size_t state_manager_raw_maxsize(size_t uncomp)
-{
-   /* bytes covered by a compressed block */
-   const int maxcblkcover = UINT16_MAX * sizeof(uint16_t);
-   /* uncompressed size, rounded to 16 bits */
-   size_t uncomp16        = (uncomp + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
-   /* number of blocks */
-   size_t maxcblks        = (uncomp + maxcblkcover - 1) / maxcblkcover;
-   return uncomp16 + maxcblks * sizeof(uint16_t) * 2 /* two u16 overhead per block */ + sizeof(uint16_t) *
-      3; /* three u16 to end it */
-}
+static struct retro_perf_counter rewind_push_perf     = {0};
 
-/*
- * See state_manager_raw_compress for information about this.
- * When you're done with it, send it to free().
- */
-static void *state_manager_raw_alloc(size_t len, uint16_t uniq)
+/* A small LZ77 pass over the patches, LZ4-like:
+ *
+ * token (u8: literal count << 4 | match length - 4),
+ * [extra literal count bytes], literals,
+ * offset (u16 little endian), [extra match length bytes]
+ *
+ * A count of 15 in the token is followed by bytes that are added
+ * to it, until one is not 255. The last sequence has no match.
+ *
+ * Patches are mostly the changed words themselves, which repeat
+ * a lot (counters, sprite tables, zeroed memory coming back). */
+#define LZ_HASH_BITS    12
+#define LZ_MIN_MATCH    4
+#define LZ_MAX_OFFSET   0xffff
+/* Matches are not started this close to the end, so
+ * the 4 byte reads never leave the input. */
+#define LZ_END_MARGIN   8
+
+static INLINE uint32_t lz_read32(const uint8_t *ptr)
 {
-   size_t  len16 = (len + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
-   uint16_t *ret = (uint16_t*)calloc(len16 + sizeof(uint16_t) * 4 + 16, 1);
-
-   /* Force in a different byte at the end, so we don't need to check 
-    * bounds in the innermost loop (it's expensive).
-    *
-    * There is also a large amount of data that's the same, to stop 
-    * the other scan.
-    *
-    * There is also some padding at the end. This is so we don't 
-    * read outside the buffer end if we're reading in large blocks;
-    *
-    * It doesn't make any difference to us, but sacrificing 16 bytes to get 
-    * Valgrind happy is worth it. */
-   ret[len16/sizeof(uint16_t) + 3] = uniq;
+   uint32_t ret;
 
+   memcpy(&ret, ptr, sizeof(ret));
    return ret;
 }
 
+static INLINE uint8_t *lz_write_count(uint8_t *out, size_t count)
+{
+   while (count >= 255)
+   {
+      *out++  = 255;
+      count  -= 255;
+   }
+   *out++ = (uint8_t)count;
+   return out;
+}
+
 /*
- * Takes two savestates and creates a patch that turns 'src' into 'dst'.
- * Both 'src' and 'dst' must be returned from state_manager_raw_alloc(), 
- * with the same 'len', and different 'uniq'.
- *
- * 'patch' must be size 'state_manager_raw_maxsize(len)' or more.
- * Returns the number of bytes actually written to 'patch'.
+ * Compresses 'len' bytes of 'in' into 'out', which holds 'out_len' bytes.
+ * 'table' must have room for 1 << LZ_HASH_BITS entries.
+ * Returns the number of bytes written, or 0 if it does not fit.
  */
-static size_t state_manager_raw_compress(const void *src,
-      const void *dst, size_t len, void *patch)
+static size_t state_manager_lz_compress(const uint8_t *in, size_t len,
+      uint8_t *out, size_t out_len, uint32_t *table)
 {
-   const uint16_t  *old16 = (const uint16_t*)src;
-   const uint16_t  *new16 = (const uint16_t*)dst;
-   uint16_t *compressed16 = (uint16_t*)patch;
-   size_t          num16s = (len + sizeof(uint16_t) - 1) 
-      / sizeof(uint16_t);
-   
-   while (num16s)
+   const uint8_t *ip      = in;
+   const uint8_t *anchor  = in;
+   const uint8_t *in_end  = in + len;
+   const uint8_t *limit   = len > LZ_END_MARGIN ? in_end - LZ_END_MARGIN : in;
+   uint8_t *op            = out;
+   uint8_t *out_end       = out + out_len;
+   size_t literals;
+
+   memset(table, 0, sizeof(*table) << LZ_HASH_BITS);
+
+   while (ip < limit)
    {
-      size_t i, changed;
-      size_t skip = find_change(old16, new16);
-   
-      if (skip >= num16s)
-         break;
-   
-      old16  += skip;
-      new16  += skip;
-      num16s -= skip;
-   
-      if (skip > UINT16_MAX)
+      uint8_t *token;
+      const uint8_t *match, *ref;
+      size_t match_len, offset;
+      uint32_t seq  = lz_read32(ip);
+      uint32_t hash = (seq * 2654435761u) >> (32 - LZ_HASH_BITS);
+
+      ref           = in + table[hash];
+      table[hash]   = (uint32_t)(ip - in);
+
+      if (ref >= ip || ip - ref > LZ_MAX_OFFSET || lz_read32(ref) != seq)
       {
-         if (skip > UINT32_MAX)
-         {
-            /* This will make it scan the entire thing again, 
-             * but it only hits on 8GB unchanged data anyways,
-             * and if you're doing that, you've got bigger problems. */
-            skip = UINT32_MAX;
-         }
-         *compressed16++ = 0;
-         *compressed16++ = skip;
-         *compressed16++ = skip >> 16;
+         /* Skip faster through data that does not compress. */
+         ip += 1 + ((ip - anchor) >> 6);
          continue;
       }
-   
-      changed = find_same(old16, new16);
-      if (changed > UINT16_MAX)
-         changed = UINT16_MAX;
-   
-      *compressed16++ = changed;
-      *compressed16++ = skip;
-   
-      for (i = 0; i < changed; i++)
-         compressed16[i] = old16[i];
-   
-      old16 += changed;
-      new16 += changed;
-      num16s -= changed;
-      compressed16 += changed;
+
+      offset = ip - ref;
+      match  = ip + LZ_MIN_MATCH;
+      ref   += LZ_MIN_MATCH;
+
+      while (match < in_end && *match == *ref)
+      {
+         match++;
+         ref++;
+      }
+
+      literals  = ip - anchor;
+      match_len = match - ip - LZ_MIN_MATCH;
+
+      if ((size_t)(out_end - op) < 1 + literals + literals / 255 + 1
+            + 2 + match_len / 255 + 1)
+         return 0;
+
+      token  = op++;
+      *token = (uint8_t)(((literals < 15 ? literals : 15) << 4)
+            | (match_len < 15 ? match_len : 15));
+
+      if (literals >= 15)
+         op = lz_write_count(op, literals - 15);
+      memcpy(op, anchor, literals);
+      op    += literals;
+
+      *op++  = (uint8_t)offset;
+      *op++  = (uint8_t)(offset >> 8);
+
+      if (match_len >= 15)
+         op = lz_write_count(op, match_len - 15);
+
+      ip     = anchor = match;
    }
-   
-   compressed16[0] = 0;
-   compressed16[1] = 0;
-   compressed16[2] = 0;
-   
-   return (uint8_t*)(compressed16+3) - (uint8_t*)patch;
+
+   literals = in_end - anchor;
+
+   if ((size_t)(out_end - op) < 1 + literals + literals / 255 + 1)
+      return 0;
+
+   *op++ = (uint8_t)((literals < 15 ? literals : 15) << 4);
+   if (literals >= 15)
+      op = lz_write_count(op, literals - 15);
+   memcpy(op, anchor, literals);
+   op   += literals;
+
+   return op - out;
 }
 
 /*
- * Takes 'patch' from a previous call to 'state_manager_raw_compress' 
- * and applies it to 'data' ('src' from that call), 
- * yielding 'dst' in that call.
- *
- * If the given arguments do not match a previous call to 
- * state_manager_raw_compress(), anything at all can happen.
+ * Takes 'len' bytes from state_manager_lz_compress and writes
+ * the original data to 'out'.
  */
-static void state_manager_raw_decompress(const void *patch,
-      size_t patchlen, void *data, size_t datalen)
+static void state_manager_lz_decompress(const uint8_t *in,
+      size_t len, uint8_t *out)
 {
-   uint16_t         *out16 = (uint16_t*)data;
-   const uint16_t *patch16 = (const uint16_t*)patch;
-   
-   (void)patchlen;
-   (void)datalen;
-   
+   const uint8_t *in_end = in + len;
+
    for (;;)
    {
-      uint16_t numchanged = *(patch16++);
+      const uint8_t *ref;
+      size_t offset;
+      unsigned token   = *in++;
+      size_t literals  = token >> 4;
+      size_t match_len = token & 15;
 
-      if (numchanged)
+      if (literals == 15)
       {
-         uint16_t i;
+         uint8_t b;
+         do
+         {
+            b         = *in++;
+            literals += b;
+         } while (b == 255);
+      }
 
-         out16 += *patch16++;
+      memcpy(out, in, literals);
+      in  += literals;
+      out += literals;
 
-         /* We could do memcpy, but it seems that memcpy has a 
-          * constant-per-call overhead that actually shows up.
-          *
-          * Our average size in here seems to be 8 or something.
-          * Therefore, we do something with lower overhead. */
-         for (i = 0; i < numchanged; i++)
-            out16[i] = patch16[i];
+      if (in >= in_end)
+         break;
 
-         patch16 += numchanged;
-         out16 += numchanged;
-      }
-      else
-      {
-         uint32_t numunchanged = patch16[0] | (patch16[1] << 16);
+      offset = in[0] | (in[1] << 8);
+      in    += 2;
 
-         if (!numunchanged)
-            break;
-         patch16 += 2;
-         out16 += numunchanged;
+      if (match_len == 15)
+      {
+         uint8_t b;
+         do
+         {
+            b          = *in++;
+            match_len += b;
+         } while (b == 255);
       }
+
+      match_len += LZ_MIN_MATCH;
+
+      /* Matches may overlap their own output. */
+      ref = out - offset;
+      while (match_len--)
+         *out++ = *ref++;
    }
 }
 
@@ -407,17 +352,174 @@ static INLINE size_t read_size_t(const void *ptr)
    return ret;
 }
 
+static size_t state_manager_pack(state_manager_t *state,
+      const uint8_t *oldb, const uint8_t *newb, uint8_t *out)
+{
+   uint32_t lz_len;
+   size_t patch_len;
+
+   if (!state->lz)
+      return state_delta_compress(oldb, newb, state->blocksize, out);
+
+   patch_len = state_delta_compress(oldb, newb,
+         state->blocksize, state->patch);
+   lz_len    = (uint32_t)state_manager_lz_compress(state->patch, patch_len,
+         out + sizeof(uint32_t), patch_len - 1, state->lz_table);
+
+   memcpy(out, &lz_len, sizeof(lz_len));
+
+   if (lz_len)
+      return sizeof(uint32_t) + lz_len;
+
+   /* Did not shrink, keep the patch as is. */
+   memcpy(out + sizeof(uint32_t), state->patch, patch_len);
+   return sizeof(uint32_t) + patch_len;
+}
+
+static void state_manager_unpack(state_manager_t *state,
+      const uint8_t *in, uint8_t *out)
+{
+   uint32_t lz_len;
+
+   if (!state->lz)
+   {
+      state_delta_decompress(in,
+            state->maxcompsize, out, state->blocksize);
+      return;
+   }
+
+   memcpy(&lz_len, in, sizeof(lz_len));
+   in += sizeof(uint32_t);
+
+   if (lz_len)
+   {
+      state_manager_lz_decompress(in, lz_len, state->patch);
+      in = state->patch;
+   }
+
+   state_delta_decompress(in,
+         state->maxcompsize, out, state->blocksize);
+}
+
+/* Stores the patch turning 'newb' back into 'oldb' at the head
+ * of the ring, retiring the oldest entries if they are in the way. */
+static void state_manager_push_patch(state_manager_t *state,
+      const uint8_t *oldb, const uint8_t *newb)
+{
+   uint8_t *compressed;
+   size_t headpos, tailpos, remaining;
+
+recheckcapacity:;
+
+   headpos = state->head - state->data;
+   tailpos = state->tail - state->data;
+   remaining = (tailpos + state->capacity -
+         sizeof(size_t) - headpos - 1) % state->capacity + 1;
+
+   if (remaining <= state->maxcompsize)
+   {
+      state->tail = state->data + read_size_t(state->tail);
+      state->entries--;
+      goto recheckcapacity;
+   }
+
+   compressed  = state->head + sizeof(size_t);
+
+   compressed += state_manager_pack(state, oldb, newb, compressed);
+
+   if (compressed - state->data + state->maxcompsize > state->capacity)
+   {
+      compressed = state->data;
+      if (state->tail == state->data + sizeof(size_t))
+         state->tail = state->data + read_size_t(state->tail);
+   }
+   write_size_t(compressed, state->head-state->data);
+   compressed += sizeof(size_t);
+   write_size_t(state->head, compressed-state->data);
+   state->head = compressed;
+}
+
+#ifdef HAVE_THREADS
+static void state_manager_thread(void *data)
+{
+   state_manager_t *state = (state_manager_t*)data;
+
+   slock_lock(state->lock);
+
+   for (;;)
+   {
+      while (!state->busy && !state->quit)
+         scond_wait(state->cond, state->lock);
+
+      if (state->quit)
+         break;
+
+      slock_unlock(state->lock);
+
+      state_manager_push_patch(state, state->job_old, state->job_new);
+
+      slock_lock(state->lock);
+      state->busy = false;
+      scond_broadcast(state->cond);
+   }
+
+   slock_unlock(state->lock);
+}
+#endif
+
+/* Waits until the worker is done with the ring and the blocks. */
+static void state_manager_wait(state_manager_t *state)
+{
+#ifdef HAVE_THREADS
+   if (!state->thread)
+      return;
+
+   slock_lock(state->lock);
+   while (state->busy)
+      scond_wait(state->cond, state->lock);
+   slock_unlock(state->lock);
+#endif
+}
+
 static void state_manager_free(state_manager_t *state)
 {
    if (!state)
       return;
 
+#ifdef HAVE_THREADS
+   if (state->thread)
+   {
+      state_manager_wait(state);
+
+      slock_lock(state->lock);
+      state->quit = true;
+      scond_broadcast(state->cond);
+      slock_unlock(state->lock);
+
+      sthread_join(state->thread);
+   }
+   if (state->cond)
+      scond_free(state->cond);
+   if (state->lock)
+      slock_free(state->lock);
+   if (state->spareblock)
+      free(state->spareblock);
+   state->thread     = NULL;
+   state->cond       = NULL;
+   state->lock       = NULL;
+   state->spareblock = NULL;
+#endif
+
    if (state->data)
       free(state->data);
    if (state->thisblock)
       free(state->thisblock);
    if (state->nextblock)
       free(state->nextblock);
+   if (state->patch)
+      free(state->patch);
+   if (state->lz_table)
+      free(state->lz_table);
 #if STRICT_BUF_SIZE
    if (state->debugblock)
       free(state->debugblock);
@@ -426,9 +528,12 @@ static void state_manager_free(state_manager_t *state)
    state->data       = NULL;
    state->thisblock  = NULL;
    state->nextblock  = NULL;
+   state->patch      = NULL;
+   state->lz_table   = NULL;
 }
 
-static state_manager_t *state_manager_new(size_t state_size, size_t buffer_size)
+static state_manager_t *state_manager_new(size_t state_size,
+      size_t buffer_size, bool threaded)
 {
    size_t max_comp_size, block_size;
    uint8_t *next_block    = NULL;
@@ -442,14 +547,14 @@ static state_manager_t *state_manager_new(size_t state_size, size_t buffer_size)
    block_size         = (state_size + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
 
    /* the compressed data is surrounded by pointers to the other side */
-   max_comp_size      = state_manager_raw_maxsize(state_size) + sizeof(size_t) * 2;
+   max_comp_size      = state_delta_maxsize(state_size) + sizeof(size_t) * 2;
    state_data         = (uint8_t*)malloc(buffer_size);
 
    if (!state_data)
       goto error;
 
-   this_block         = (uint8_t*)state_manager_raw_alloc(state_size, 0);
-   next_block         = (uint8_t*)state_manager_raw_alloc(state_size, 1);
+   this_block         = (uint8_t*)state_delta_alloc(state_size, 0);
+   next_block         = (uint8_t*)state_delta_alloc(state_size, 1);
 
    if (!this_block || !next_block)
       goto error;
@@ -464,6 +569,36 @@ static state_manager_t *state_manager_new(size_t state_size, size_t buffer_size)
    state->head        = state->data + sizeof(size_t);
    state->tail        = state->data + sizeof(size_t);
 
+   /* Picks the delta encoder now, before a worker could race for it. */
+   state_delta_get_impl();
+
+#ifdef HAVE_THREADS
+   if (threaded)
+   {
+      /* The LZ pass is only worth its time off the main thread. */
+      state->patch       = (uint8_t*)malloc(
+            state_delta_maxsize(state_size));
+      state->lz_table    = (uint32_t*)malloc(
+            sizeof(uint32_t) << LZ_HASH_BITS);
+      /* A third 'uniq' so any two blocks still differ at the end. */
+      state->spareblock  = (uint8_t*)state_delta_alloc(state_size, 2);
+      state->lock        = slock_new();
+      state->cond        = scond_new();
+
+      if (!state->patch || !state->lz_table || !state->spareblock
+            || !state->lock || !state->cond)
+         goto error;
+
+      state->lz           = true;
+      state->maxcompsize += sizeof(uint32_t);
+      state->thread       = sthread_create(state_manager_thread, state);
+
+      /* Still works without the worker, just on this thread. */
+      if (!state->thread)
+         RARCH_WARN("[Rewind]: Could not start worker thread.\n");
+   }
+#endif
+
 #if STRICT_BUF_SIZE
    state->debugsize   = state_size;
    state->debugblock  = (uint8_t*)malloc(state_size);
@@ -472,7 +607,7 @@ static state_manager_t *state_manager_new(size_t state_size, size_t buffer_size)
    return state;
 
 error:
-   if (state_data)
+   if (!state->data)
       free(state_data);
    state_manager_free(state);
    free(state);
@@ -488,10 +623,13 @@ static bool state_manager_pop(state_manager_t *state, const void **data)
 
    *data = NULL;
 
+   state_manager_wait(state);
+
    if (state->thisblock_valid)
    {
       state->thisblock_valid = false;
       state->entries--;
+      state->entries_seen    = state->entries;
       *data = state->thisblock;
       return true;
    }
@@ -506,10 +644,10 @@ static bool state_manager_pop(state_manager_t *state, const void **data)
    compressed = state->data + start + sizeof(size_t);
    out = state->thisblock;
 
-   state_manager_raw_decompress(compressed,
-         state->maxcompsize, out, state->blocksize);
+   state_manager_unpack(state, compressed, out);
 
    state->entries--;
+   state->entries_seen = state->entries;
    return true;
 }
 
@@ -545,43 +683,37 @@ static void state_manager_push_do(state_manager_t *state)
 
    if (state->thisblock_valid)
    {
-      const uint8_t *oldb, *newb;
-      uint8_t *compressed;
-      size_t headpos, tailpos, remaining;
       if (state->capacity < sizeof(size_t) + state->maxcompsize)
          return;
 
-recheckcapacity:;
-
-      headpos = state->head - state->data;
-      tailpos = state->tail - state->data;
-      remaining = (tailpos + state->capacity -
-            sizeof(size_t) - headpos - 1) % state->capacity + 1;
-
-      if (remaining <= state->maxcompsize)
+#ifdef HAVE_THREADS
+      if (state->thread)
       {
-         state->tail = state->data + read_size_t(state->tail);
-         state->entries--;
-         goto recheckcapacity;
-      }
-
-      oldb        = state->thisblock;
-      newb        = state->nextblock;
-      compressed  = state->head + sizeof(size_t);
+         /* Normally long done, the worker had a whole
+          * frame (or rewind_granularity frames) for it. */
+         state_manager_wait(state);
 
-      compressed += state_manager_raw_compress(oldb, newb,
-            state->blocksize, compressed);
-
-      if (compressed - state->data + state->maxcompsize > state->capacity)
-      {
-         compressed = state->data;
-         if (state->tail == state->data + sizeof(size_t))
-            state->tail = state->data + read_size_t(state->tail);
+         state->entries++;
+         state->entries_seen = state->entries;
+
+         slock_lock(state->lock);
+         state->job_old      = state->thisblock;
+         state->job_new      = state->nextblock;
+         state->busy         = true;
+         scond_broadcast(state->cond);
+         slock_unlock(state->lock);
+
+         /* The worker only reads both blocks; the new one may
+          * be read here as well, the old one is left alone. */
+         swap                = state->spareblock;
+         state->spareblock   = state->thisblock;
+         state->thisblock    = state->nextblock;
+         state->nextblock    = swap;
+         return;
       }
-      write_size_t(compressed, state->head-state->data);
-      compressed += sizeof(size_t);
-      write_size_t(state->head, compressed-state->data);
-      state->head = compressed;
+#endif
+
+      state_manager_push_patch(state, state->thisblock, state->nextblock);
    }
    else
       state->thisblock_valid = true;
@@ -591,6 +723,7 @@ recheckcapacity:;
    state->nextblock = swap;
 
    state->entries++;
+   state->entries_seen = state->entries;
 }
 
 #if 0
@@ -611,7 +744,7 @@ static void state_manager_capacity(state_manager_t *state,
 }
 #endif
 
-void state_manager_event_init(unsigned rewind_buffer_size)
+void state_manager_event_init(unsigned rewind_buffer_size, bool threaded)
 {
    retro_ctx_serialize_info_t serial_info;
    retro_ctx_size_info_t info;
@@ -642,10 +775,16 @@ void state_manager_event_init(unsigned rewind_buffer_size)
          (unsigned)(rewind_buffer_size / 1000000));
 
    rewind_state.state = state_manager_new(rewind_state.size,
-         rewind_buffer_size);
+         rewind_buffer_size, threaded);
 
    if (!rewind_state.state)
+   {
       RARCH_WARN("%s.\n", msg_hash_to_str(MSG_REWIND_INIT_FAILED));
+      return;
+   }
+
+   rewind_state.granularity   = 1;
+   rewind_state.push_time     = 0;
 
    state_manager_push_where(rewind_state.state, &state);
 
@@ -674,9 +813,29 @@ void state_manager_event_deinit(void)
    rewind_state.size  = 0;
 }
 
+/**
+ * state_manager_get_stats:
+ * @frame_time           : Main thread time rewind costs per frame, in usec.
+ * @history_frames       : Number of frames that can be rewound right now.
+ *
+ * Returns: true (1) if rewind is running, otherwise false (0).
+ **/
+bool state_manager_get_stats(retro_time_t *frame_time,
+      unsigned *history_frames)
+{
+   if (!rewind_state.state)
+      return false;
+
+   *frame_time     = rewind_state.push_time / rewind_state.granularity;
+   *history_frames = rewind_state.state->entries_seen
+      * rewind_state.granularity;
+   return true;
+}
+
 /**
  * check_rewind:
  * @pressed              : was rewind key pressed or held?
+ * @rewind_granularity   : push a savestate every this many frames.
  *
  * Checks if rewind toggle/hold was being pressed and/or held.
  **/
@@ -708,6 +867,9 @@ bool state_manager_check_rewind(bool pressed,
    if (!rewind_state.state)
       return false;
 
+   if (!rewind_granularity)
+      rewind_granularity = 1; /* Avoid possible SIGFPE. */
+
    if (pressed)
    {
       const void *buf    = NULL;
@@ -770,13 +932,17 @@ bool state_manager_check_rewind(bool pressed,
          netplay_driver_ctl(RARCH_NETPLAY_CTL_DESYNC_POP, NULL);
 #endif
 
-      cnt = (cnt + 1) % (rewind_granularity ?
-            rewind_granularity : 1); /* Avoid possible SIGFPE. */
+      cnt = (cnt + 1) % rewind_granularity;
 
       if ((cnt == 0) || bsv_movie_ctl(BSV_MOVIE_CTL_IS_INITED, NULL))
       {
          retro_ctx_serialize_info_t serial_info;
-         void *state = NULL;
+         void *state            = NULL;
+         bool is_perfcnt_enable = rarch_ctl(RARCH_CTL_IS_PERFCNT_ENABLE, NULL);
+         retro_time_t start     = cpu_features_get_time_usec();
+
+         performance_counter_init(rewind_push_perf, "rewind_push");
+         performance_counter_start_plus(is_perfcnt_enable, rewind_push_perf);
 
          state_manager_push_where(rewind_state.state, &state);
 
@@ -786,6 +952,13 @@ bool state_manager_check_rewind(bool pressed,
          core_serialize(&serial_info);
 
          state_manager_push_do(rewind_state.state);
+
+         performance_counter_stop_plus(is_perfcnt_enable, rewind_push_perf);
+
+         /* Smoothed, a single slow frame should not make it jump. */
+         rewind_state.push_time   = (rewind_state.push_time * 15
+               + (cpu_features_get_time_usec() - start)) / 16;
+         rewind_state.granularity = rewind_granularity;
       }
    }
 
@@ -23,6 +23,7 @@
 
 #include <boolean.h>
 #include <retro_common_api.h>
+#include <libretro.h>
 
 RETRO_BEGIN_DECLS
 
@@ -32,11 +33,28 @@ bool state_manager_frame_is_reversed(void);
 
 void state_manager_event_deinit(void);
 
-void state_manager_event_init(unsigned rewind_buffer_size);
+/**
+ * state_manager_event_init:
+ * @rewind_buffer_size   : size of the rewind buffer in bytes.
+ * @threaded             : diff and LZ compress savestates on a
+ *                         worker thread.
+ **/
+void state_manager_event_init(unsigned rewind_buffer_size, bool threaded);
+
+/**
+ * state_manager_get_stats:
+ * @frame_time           : Main thread time rewind costs per frame, in usec.
+ * @history_frames       : Number of frames that can be rewound right now.
+ *
+ * Returns: true (1) if rewind is running, otherwise false (0).
+ **/
+bool state_manager_get_stats(retro_time_t *frame_time,
+      unsigned *history_frames);
 
 /**
  * check_rewind:
  * @pressed              : was rewind key pressed or held?
+ * @rewind_granularity   : push a savestate every this many frames.
  *
  * Checks if rewind toggle/hold was being pressed and/or held.
  **/
@@ -676,6 +676,14 @@ static void mui_compute_entries_box(mui_handle_t* mui, int width)
       mui_node_t *node   = (mui_node_t*)
             file_list_get_userdata_at_offset(list, i);
 
+      /* Entries of a virtual list that were not built yet
+       * have no sublabel to measure. */
+      if (!node)
+      {
+         sum += scale_factor / 3;
+         continue;
+      }
+
       menu_entry_init(&entry);
       menu_entry_get(&entry, 0, i, NULL, true);
 
@@ -753,6 +761,9 @@ static void mui_render(void *data, bool is_idle)
          mui_node_t *node = (mui_node_t*)
                file_list_get_userdata_at_offset(list, ii);
 
+         if (!node)
+            continue;
+
          if (pointer_y > (-mui->scroll_y + header_height + node->y)
           && pointer_y < (-mui->scroll_y + header_height + node->y + node->line_height)
          )
@@ -779,6 +790,9 @@ static void mui_render(void *data, bool is_idle)
          mui_node_t *node = (mui_node_t*)
                file_list_get_userdata_at_offset(list, ii);
 
+         if (!node)
+            continue;
+
          if (mouse_y > (-mui->scroll_y + header_height + node->y)
           && mouse_y < (-mui->scroll_y + header_height + node->y + node->line_height)
          )
@@ -797,6 +811,34 @@ static void mui_render(void *data, bool is_idle)
          < height - header_height - mui->tabs_height)
       mui->scroll_y = 0;
 
+   /* Touch scrolling can take the view away from the selection,
+    * build the pending entries mui_frame is about to draw. */
+   if (list && list->pending)
+   {
+      size_t ii;
+      float sum          = 0;
+      size_t entries_end = menu_entries_get_size();
+
+      for (ii = 0; ii < entries_end; ii++)
+      {
+         mui_node_t *node  = (mui_node_t*)
+               file_list_get_userdata_at_offset(list, ii);
+         float line_height = node ? node->line_height
+            : menu_display_get_dpi() / 3;
+         int y             = header_height - mui->scroll_y + sum;
+
+         sum += line_height;
+
+         if (y + (int)line_height < 0)
+            continue;
+
+         if (y > (int)height)
+            break;
+
+         file_list_materialize(list, ii, ii + 1);
+      }
+   }
+
    menu_entries_ctl(MENU_ENTRIES_CTL_SET_START, &i);
 }
 
@@ -1016,16 +1058,23 @@ static void mui_render_menu_list(
             file_list_get_userdata_at_offset(list, i);
       size_t selection    = menu_navigation_get_selection();
       int               y = header_height - mui->scroll_y + sum;
+      float line_height   = node ? node->line_height
+         : menu_display_get_dpi() / 3;
       entry_value[0]      = '\0';
 
-      sum += node->line_height;
+      sum += line_height;
 
-      if (y + (int)node->line_height < 0)
+      if (y + (int)line_height < 0)
          continue;
 
       if (y > (int)height)
          break;
 
+      /* Pending entries of a virtual list are built by
+       * mui_render, this one is not in view yet. */
+      if (!node)
+         continue;
+
       menu_entry_init(&entry);
       menu_entry_get(&entry, 0, (unsigned)i, NULL, true);
       menu_entry_get_value(&entry, entry_value, sizeof(entry_value));
@@ -2197,6 +2246,9 @@ static int mui_pointer_down(void *userdata,
          mui_node_t *node = (mui_node_t*)
                file_list_get_userdata_at_offset(list, ii);
 
+         if (!node)
+            continue;
+
          if (y > (-mui->scroll_y + header_height + node->y)
           && y < (-mui->scroll_y + header_height + node->y + node->line_height)
          )
@@ -2266,6 +2318,9 @@ static int mui_pointer_up(void *userdata,
          mui_node_t *node = (mui_node_t*)
                file_list_get_userdata_at_offset(list, ii);
 
+         if (!node)
+            continue;
+
          if (y > (-mui->scroll_y + header_height + node->y)
           && y < (-mui->scroll_y + header_height + node->y + node->line_height)
          )
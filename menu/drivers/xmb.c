@@ -3954,7 +3954,7 @@ static void xmb_list_free(file_list_t *list, size_t a, size_t b)
    xmb_list_clear(list);
 }
 
-static void xmb_list_deep_copy(const file_list_t *src, file_list_t *dst,
+static void xmb_list_deep_copy(file_list_t *src, file_list_t *dst,
       size_t first, size_t last)
 {
    size_t i, j = 0;
@@ -3968,6 +3968,9 @@ static void xmb_list_deep_copy(const file_list_t *src, file_list_t *dst,
    file_list_clear(dst);
    file_list_reserve(dst, (last + 1) - first);
 
+   /* The entries are copied as they are. */
+   file_list_materialize(src, first, last + 1);
+
    for (i = first; i <= last; ++i)
    {
       struct item_file *d = &dst->list[j];
@@ -205,19 +205,28 @@ void menu_cbs_init(void *data,
       menu_file_list_cbs_t *cbs,
       const char *path, const char *label,
       unsigned type, size_t idx)
+{
+   const char *menu_label        = NULL;
+
+   menu_entries_get_last_stack(NULL, &menu_label, NULL, NULL, NULL);
+
+   menu_cbs_init_menu_label(data, cbs, path, label, type, idx, menu_label);
+}
+
+void menu_cbs_init_menu_label(void *data,
+      menu_file_list_cbs_t *cbs,
+      const char *path, const char *label,
+      unsigned type, size_t idx,
+      const char *menu_label)
 {
    menu_ctx_bind_t bind_info;
    const char *repr_label        = NULL;
-   const char *menu_label        = NULL;
    uint32_t label_hash           = 0;
    uint32_t menu_label_hash      = 0;
-   enum msg_hash_enums enum_idx  = MSG_UNKNOWN;
    file_list_t *list             = (file_list_t*)data;
    if (!list)
       return;
 
-   menu_entries_get_last_stack(NULL, &menu_label, NULL, &enum_idx, NULL);
-
    if (!label || !menu_label)
       return;
 
@@ -268,6 +268,14 @@ void menu_cbs_init(void *data,
       const char *path, const char *label,
       unsigned type, size_t idx);
 
+/* Same as menu_cbs_init, for an entry of the menu @menu_label
+ * rather than of the one on top of the stack. */
+void menu_cbs_init_menu_label(void *data,
+      menu_file_list_cbs_t *cbs,
+      const char *path, const char *label,
+      unsigned type, size_t idx,
+      const char *menu_label);
+
 int menu_cbs_exit(void);
 
 RETRO_END_DECLS
@@ -401,7 +401,7 @@ static int menu_displaylist_parse_core_info(menu_displaylist_info_t *info)
 
    core_info_get_current_core(&core_info);
 
-   if (!core_info || !core_info->config_data)
+   if (!core_info || !core_info->has_info)
    {
       menu_entries_append_enum(info->list,
             msg_hash_to_str(MENU_ENUM_LABEL_VALUE_NO_CORE_INFORMATION_AVAILABLE),
@@ -1473,12 +1473,102 @@ static int menu_displaylist_parse_system_info(menu_displaylist_info_t *info)
    return 0;
 }
 
+struct menu_displaylist_playlist
+{
+   bool is_history;
+   /* The playlist the list was built from, by file and size
+    * since the menu driver may have freed it by now. */
+   size_t size;
+   char conf_path[PATH_MAX_LENGTH];
+   char path_playlist[PATH_MAX_LENGTH];
+   /* The menu the list was built for. */
+   char menu_path[PATH_MAX_LENGTH];
+   char menu_label[PATH_MAX_LENGTH];
+};
+
+/* Builds the menu entry of one playlist item, called by the
+ * file list on the main thread once the entry can be shown. */
+static void menu_displaylist_playlist_materialize(file_list_t *list,
+      size_t idx, void *data)
+{
+   char fill_buf[PATH_MAX_LENGTH];
+   char path_short[PATH_MAX_LENGTH];
+   struct menu_displaylist_playlist *virt =
+      (struct menu_displaylist_playlist*)data;
+   playlist_t *playlist            = NULL;
+   const char *core_name           = NULL;
+   const char *path                = NULL;
+   const char *label               = NULL;
+   size_t i                        = list->list[idx].entry_idx;
+
+   fill_buf[0] = path_short[0]     = '\0';
+
+   /* The playlist is owned by the menu driver, it is gone
+    * once another one is opened. */
+   menu_driver_ctl(RARCH_MENU_CTL_PLAYLIST_GET, &playlist);
+
+   if (!playlist || playlist_size(playlist) != virt->size
+         || i >= virt->size
+         || !string_is_equal(virt->conf_path,
+            playlist_get_conf_path(playlist)))
+   {
+      menu_entries_set_at_offset(list, idx, "", virt->path_playlist,
+            MENU_ENUM_LABEL_PLAYLIST_ENTRY, FILE_TYPE_PLAYLIST_ENTRY, i,
+            virt->menu_path, virt->menu_label);
+      return;
+   }
+
+   playlist_get_index(playlist, i,
+         &path, &label, NULL, &core_name, NULL, NULL);
+
+   if (core_name)
+      strlcpy(fill_buf, core_name, sizeof(fill_buf));
+
+   if (path)
+   {
+      if (!string_is_empty(label))
+         strlcpy(fill_buf, label, sizeof(fill_buf));
+      else
+      {
+         fill_short_pathname_representation(path_short, path,
+               sizeof(path_short));
+         strlcpy(fill_buf, path_short, sizeof(fill_buf));
+      }
+
+      if (!string_is_empty(core_name))
+      {
+         if (!string_is_equal(core_name,
+                  file_path_str(FILE_PATH_DETECT)))
+         {
+            strlcat(fill_buf, " (", sizeof(fill_buf));
+            strlcat(fill_buf, core_name, sizeof(fill_buf));
+            strlcat(fill_buf, ")", sizeof(fill_buf));
+         }
+      }
+   }
+
+   if (!path)
+      menu_entries_set_at_offset(list, idx, fill_buf, virt->path_playlist,
+            MENU_ENUM_LABEL_PLAYLIST_ENTRY, FILE_TYPE_PLAYLIST_ENTRY, i,
+            virt->menu_path, virt->menu_label);
+   else if (virt->is_history)
+      menu_entries_set_at_offset(list, idx, fill_buf, path,
+            MENU_ENUM_LABEL_PLAYLIST_ENTRY, FILE_TYPE_RPL_ENTRY, i,
+            virt->menu_path, virt->menu_label);
+   else
+      menu_entries_set_at_offset(list, idx, label, path,
+            MENU_ENUM_LABEL_PLAYLIST_ENTRY, FILE_TYPE_RPL_ENTRY, i,
+            virt->menu_path, virt->menu_label);
+}
+
 static int menu_displaylist_parse_playlist(menu_displaylist_info_t *info,
       playlist_t *playlist, const char *path_playlist, bool is_history)
 {
-   unsigned i;
-   size_t list_size = 0;
-   size_t selection = menu_navigation_get_selection();
+   size_t list_size                       = 0;
+   size_t selection                       = menu_navigation_get_selection();
+   const char *menu_path                  = NULL;
+   const char *menu_label                 = NULL;
+   struct menu_displaylist_playlist *virt = NULL;
 
    if (!playlist)
       return -1;
@@ -1506,89 +1596,48 @@ static int menu_displaylist_parse_playlist(menu_displaylist_info_t *info,
       free(lpl_basename);
    }
 
-   /* preallocate the file list */
-   file_list_reserve(info->list, list_size);
-
-   for (i = 0; i < list_size; i++)
+   if (!is_history && selection < list_size)
    {
-      char *path_copy                 = (char*)malloc(PATH_MAX_LENGTH * sizeof(char));
-      char *fill_buf                  = (char*)malloc(PATH_MAX_LENGTH * sizeof(char));
-      size_t path_size                = PATH_MAX_LENGTH * sizeof(char);
-      const char *core_name           = NULL;
-      const char *path                = NULL;
-      const char *label               = NULL;
-
-      fill_buf[0] = path_copy[0]      = '\0';
+      const char *label = NULL;
 
-      if (!string_is_empty(info->path))
-         strlcpy(path_copy, info->path, path_size);
+      playlist_get_index(playlist, selection,
+            NULL, &label, NULL, NULL, NULL, NULL);
 
-      path                            = path_copy;
-
-      playlist_get_index(playlist, i,
-            &path, &label, NULL, &core_name, NULL, NULL);
-
-      if (core_name)
-         strlcpy(fill_buf, core_name, path_size);
-
-      if (!is_history && i == selection && !string_is_empty(label))
+      if (!string_is_empty(label))
       {
          char *content_basename = strdup(label);
 
-         if (!string_is_empty(content_basename))
-         {
-            menu_driver_set_thumbnail_content(content_basename, strlen(content_basename) + 1);
-            menu_driver_ctl(RARCH_MENU_CTL_UPDATE_THUMBNAIL_PATH, NULL);
-            menu_driver_ctl(RARCH_MENU_CTL_UPDATE_THUMBNAIL_IMAGE, NULL);
-            free(content_basename);
-         }
-      }
-
-      if (path)
-      {
-         char *path_short = (char*)malloc(PATH_MAX_LENGTH * sizeof(char));
-
-         path_short[0] = '\0';
-
-         fill_short_pathname_representation(path_short, path,
-               path_size);
-         strlcpy(fill_buf,
-               (!string_is_empty(label)) ? label : path_short,
-               path_size);
-
-         if (!string_is_empty(core_name))
-         {
-            if (!string_is_equal(core_name,
-                     file_path_str(FILE_PATH_DETECT)))
-            {
-               char *tmp       = (char*)
-                  malloc(PATH_MAX_LENGTH * sizeof(char));
-
-               tmp[0] = '\0';
-
-               snprintf(tmp, path_size, " (%s)", core_name);
-               strlcat(fill_buf, tmp, path_size);
-
-               free(tmp);
-            }
-         }
-         
-         free(path_short);
+         menu_driver_set_thumbnail_content(content_basename, strlen(content_basename) + 1);
+         menu_driver_ctl(RARCH_MENU_CTL_UPDATE_THUMBNAIL_PATH, NULL);
+         menu_driver_ctl(RARCH_MENU_CTL_UPDATE_THUMBNAIL_IMAGE, NULL);
+         free(content_basename);
       }
+   }
 
-      if (!path)
-         menu_entries_append_enum(info->list, fill_buf, path_playlist,
-               MENU_ENUM_LABEL_PLAYLIST_ENTRY, FILE_TYPE_PLAYLIST_ENTRY, 0, i);
-      else if (is_history)
-         menu_entries_append_enum(info->list, fill_buf,
-               path, MENU_ENUM_LABEL_PLAYLIST_ENTRY, FILE_TYPE_RPL_ENTRY, 0, i);
-      else
-         menu_entries_append_enum(info->list, label,
-               path, MENU_ENUM_LABEL_PLAYLIST_ENTRY, FILE_TYPE_RPL_ENTRY, 0, i);
+   virt = (struct menu_displaylist_playlist*)calloc(1, sizeof(*virt));
+   if (!virt)
+      return -1;
 
-      free(path_copy);
-      free(fill_buf);
-   }
+   virt->size       = list_size;
+   virt->is_history = is_history;
+   if (playlist_get_conf_path(playlist))
+      strlcpy(virt->conf_path, playlist_get_conf_path(playlist),
+            sizeof(virt->conf_path));
+   strlcpy(virt->path_playlist, path_playlist, sizeof(virt->path_playlist));
+
+   /* Entries are built later on, by when another menu
+    * may be on top of the stack. */
+   menu_entries_get_last_stack(&menu_path, &menu_label, NULL, NULL, NULL);
+   if (menu_path)
+      strlcpy(virt->menu_path, menu_path, sizeof(virt->menu_path));
+   if (menu_label)
+      strlcpy(virt->menu_label, menu_label, sizeof(virt->menu_label));
+
+   /* Only the entries that are shown are built, the
+    * file list calls back for them as needed. */
+   if (!file_list_append_virtual(info->list, list_size,
+            menu_displaylist_playlist_materialize, virt))
+      return -1;
 
    return 0;
 }
@@ -3079,7 +3128,7 @@ static int menu_displaylist_parse_information_list(
           !string_is_equal(system->info.library_name,
              msg_hash_to_str(MENU_ENUM_LABEL_VALUE_NO_CORE))
          )
-         && core_info && core_info->config_data
+         && core_info && core_info->has_info
       )
       menu_entries_append_enum(info->list,
             msg_hash_to_str(MENU_ENUM_LABEL_VALUE_CORE_INFORMATION),
@@ -4605,9 +4654,10 @@ bool menu_displaylist_ctl(enum menu_displaylist_ctl_state type, void *data)
             ret = menu_displaylist_parse_playlist(info,
                   playlist, path_playlist, false);
 
+            /* Already sorted by playlist_qsort, sorting the
+             * menu list would build every entry. */
             if (ret == 0)
             {
-               info->need_sort    = true;
                info->need_refresh = true;
                info->need_push    = true;
             }
@@ -5045,6 +5095,9 @@ bool menu_displaylist_ctl(enum menu_displaylist_ctl_state type, void *data)
          ret = menu_displaylist_parse_settings_enum(menu, info,
                MENU_ENUM_LABEL_PLAYLIST_ENTRY_REMOVE,
                PARSE_ONLY_BOOL, false);
+         ret = menu_displaylist_parse_settings_enum(menu, info,
+               MENU_ENUM_LABEL_PLAYLIST_BINARY_FORMAT,
+               PARSE_ONLY_BOOL, false);
 
          menu_displaylist_parse_playlist_associations(info);
          info->need_push    = true;
@@ -5146,6 +5199,9 @@ bool menu_displaylist_ctl(enum menu_displaylist_ctl_state type, void *data)
          menu_displaylist_parse_settings_enum(menu, info,
                MENU_ENUM_LABEL_SAVESTATE_THUMBNAIL_ENABLE,
                PARSE_ONLY_BOOL, false);
+         menu_displaylist_parse_settings_enum(menu, info,
+               MENU_ENUM_LABEL_SAVESTATE_FILE_COMPRESSION,
+               PARSE_ONLY_BOOL, false);
          menu_displaylist_parse_settings_enum(menu, info,
                MENU_ENUM_LABEL_SAVEFILES_IN_CONTENT_DIR_ENABLE,
                PARSE_ONLY_BOOL, false);
@@ -5171,9 +5227,14 @@ bool menu_displaylist_ctl(enum menu_displaylist_ctl_state type, void *data)
                MENU_ENUM_LABEL_LIBRETRO_LOG_LEVEL,
                PARSE_ONLY_UINT, false);
          if (settings->bools.menu_show_advanced_settings)
+         {
             menu_displaylist_parse_settings_enum(menu, info,
                   MENU_ENUM_LABEL_PERFCNT_ENABLE,
                   PARSE_ONLY_BOOL, false);
+            menu_displaylist_parse_settings_enum(menu, info,
+                  MENU_ENUM_LABEL_FRAME_TIMELINE_ENABLE,
+                  PARSE_ONLY_BOOL, false);
+         }
 
          info->need_refresh = true;
          info->need_push    = true;
@@ -5204,6 +5265,9 @@ bool menu_displaylist_ctl(enum menu_displaylist_ctl_state type, void *data)
          menu_displaylist_parse_settings_enum(menu, info,
                MENU_ENUM_LABEL_REWIND_GRANULARITY,
                PARSE_ONLY_UINT, false);
+         menu_displaylist_parse_settings_enum(menu, info,
+               MENU_ENUM_LABEL_REWIND_THREADED,
+               PARSE_ONLY_BOOL, false);
 
          info->need_refresh = true;
          info->need_push    = true;
@@ -5953,6 +6017,9 @@ bool menu_displaylist_ctl(enum menu_displaylist_ctl_state type, void *data)
          menu_displaylist_parse_settings_enum(menu, info,
                MENU_ENUM_LABEL_FRAMECOUNT_SHOW,
                PARSE_ONLY_BOOL, false);
+         menu_displaylist_parse_settings_enum(menu, info,
+               MENU_ENUM_LABEL_FRAME_TIMELINE_SHOW,
+               PARSE_ONLY_BOOL, false);
          menu_displaylist_parse_settings_enum(menu, info,
                MENU_ENUM_LABEL_SCREEN_RESOLUTION,
                PARSE_ACTION, false);
@@ -6052,6 +6119,12 @@ bool menu_displaylist_ctl(enum menu_displaylist_ctl_state type, void *data)
          menu_displaylist_parse_settings_enum(menu, info,
                MENU_ENUM_LABEL_VIDEO_FRAME_DELAY,
                PARSE_ONLY_UINT, false);
+         menu_displaylist_parse_settings_enum(menu, info,
+               MENU_ENUM_LABEL_VIDEO_FRAME_DELAY_AUTO,
+               PARSE_ONLY_BOOL, false);
+         menu_displaylist_parse_settings_enum(menu, info,
+               MENU_ENUM_LABEL_RUN_AHEAD_FRAMES,
+               PARSE_ONLY_UINT, false);
          menu_displaylist_parse_settings_enum(menu, info,
                MENU_ENUM_LABEL_VIDEO_BLACK_FRAME_INSERTION,
                PARSE_ONLY_BOOL, false);
@@ -6112,6 +6185,9 @@ bool menu_displaylist_ctl(enum menu_displaylist_ctl_state type, void *data)
          menu_displaylist_parse_settings_enum(menu, info,
                MENU_ENUM_LABEL_AUDIO_SYNC,
                PARSE_ONLY_BOOL, false);
+         menu_displaylist_parse_settings_enum(menu, info,
+               MENU_ENUM_LABEL_AUDIO_OUTPUT_THREAD,
+               PARSE_ONLY_BOOL, false);
          menu_displaylist_parse_settings_enum(menu, info,
                MENU_ENUM_LABEL_AUDIO_LATENCY,
                PARSE_ONLY_UINT, false);
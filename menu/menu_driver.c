@@ -1595,6 +1595,8 @@ bool menu_driver_render(bool is_idle, bool rarch_is_inited,
       }
    }
 
+   menu_entries_materialize_visible();
+
    if (BIT64_GET(menu_driver_data->state, MENU_STATE_BLIT))
    {
       settings_t *settings = config_get_ptr();
@@ -123,6 +123,20 @@ static void menu_entries_build_scroll_indices(file_list_t *list)
    menu_driver_ctl(MENU_NAVIGATION_CTL_CLEAR_SCROLL_INDICES, NULL);
    menu_driver_ctl(MENU_NAVIGATION_CTL_ADD_SCROLL_INDEX, &scroll_value);
 
+   /* Going by first letters would build every entry of a
+    * virtual list, jump by an even share of it instead. */
+   if (list->pending)
+   {
+      size_t step = list->size / 26 + 1;
+
+      for (i = step; i < list->size; i += step)
+         menu_driver_ctl(MENU_NAVIGATION_CTL_ADD_SCROLL_INDEX, &i);
+
+      scroll_value = list->size - 1;
+      menu_driver_ctl(MENU_NAVIGATION_CTL_ADD_SCROLL_INDEX, &scroll_value);
+      return;
+   }
+
    current        = menu_entries_elem_get_first_char(list, 0);
    current_is_dir = menu_entries_elem_is_dir(list, 0);
 
@@ -274,6 +288,26 @@ file_list_t *menu_entries_get_selection_buf_ptr(size_t idx)
    return menu_list_get_selection(menu_list, (unsigned)idx);
 }
 
+/* Entries of a virtual list built on each side of the
+ * selection and after the first one shown. */
+#define MENU_ENTRIES_MATERIALIZE_WINDOW 64
+
+void menu_entries_materialize_visible(void)
+{
+   size_t selection  = menu_navigation_get_selection();
+   file_list_t *list = menu_entries_get_selection_buf_ptr(0);
+
+   if (!list || !list->pending)
+      return;
+
+   file_list_materialize(list,
+         selection > MENU_ENTRIES_MATERIALIZE_WINDOW
+         ? selection - MENU_ENTRIES_MATERIALIZE_WINDOW : 0,
+         selection + MENU_ENTRIES_MATERIALIZE_WINDOW + 1);
+   file_list_materialize(list, menu_entries_begin,
+         menu_entries_begin + MENU_ENTRIES_MATERIALIZE_WINDOW);
+}
+
 static bool menu_entries_init(void)
 {
    if (!menu_entries_ctl(MENU_ENTRIES_CTL_LIST_INIT, NULL))
@@ -338,23 +372,13 @@ void menu_entries_append(file_list_t *list, const char *path, const char *label,
    menu_cbs_init(list, cbs, path, label, type, idx);
 }
 
-void menu_entries_append_enum(file_list_t *list, const char *path,
-      const char *label,
-      enum msg_hash_enums enum_idx,
-      unsigned type, size_t directory_ptr, size_t entry_idx)
+static void menu_entries_init_entry(file_list_t *list, size_t idx,
+      const char *path, const char *label,
+      enum msg_hash_enums enum_idx, unsigned type,
+      const char *menu_path, const char *menu_label)
 {
    menu_ctx_list_t list_info;
-   size_t idx;
-   const char *menu_path           = NULL;
    menu_file_list_cbs_t *cbs       = NULL;
-   if (!list || !label)
-      return;
-
-   file_list_append(list, path, label, type, directory_ptr, entry_idx);
-
-   menu_entries_get_last_stack(&menu_path, NULL, NULL, NULL, NULL);
-
-   idx                   = list->size - 1;
 
    list_info.fullpath    = NULL;
 
@@ -388,7 +412,40 @@ void menu_entries_append_enum(file_list_t *list, const char *path,
       cbs->setting  = menu_setting_find_enum(enum_idx);
    }
 
-   menu_cbs_init(list, cbs, path, label, type, idx);
+   menu_cbs_init_menu_label(list, cbs, path, label, type, idx, menu_label);
+}
+
+void menu_entries_append_enum(file_list_t *list, const char *path,
+      const char *label,
+      enum msg_hash_enums enum_idx,
+      unsigned type, size_t directory_ptr, size_t entry_idx)
+{
+   const char *menu_path           = NULL;
+   const char *menu_label          = NULL;
+   if (!list || !label)
+      return;
+
+   file_list_append(list, path, label, type, directory_ptr, entry_idx);
+
+   menu_entries_get_last_stack(&menu_path, &menu_label, NULL, NULL, NULL);
+
+   menu_entries_init_entry(list, list->size - 1,
+         path, label, enum_idx, type, menu_path, menu_label);
+}
+
+void menu_entries_set_at_offset(file_list_t *list, size_t idx,
+      const char *path, const char *label,
+      enum msg_hash_enums enum_idx,
+      unsigned type, size_t entry_idx,
+      const char *menu_path, const char *menu_label)
+{
+   if (!list)
+      return;
+
+   file_list_set_at_offset(list, idx, path, label, type, entry_idx);
+
+   menu_entries_init_entry(list, idx, path, label, enum_idx, type,
+         menu_path, menu_label);
 }
 
 void menu_entries_prepend(file_list_t *list, const char *path, const char *label,
@@ -155,6 +155,21 @@ void menu_entries_append_enum(file_list_t *list, const char *path, const char *l
       enum msg_hash_enums enum_idx,
       unsigned type, size_t directory_ptr, size_t entry_idx);
 
+/* Fills in entry @idx of a virtual list, see
+ * file_list_append_virtual. The entry is built for the menu
+ * @menu_path/@menu_label the list was pushed for, which need
+ * not be the one on top of the stack by then. */
+void menu_entries_set_at_offset(file_list_t *list, size_t idx,
+      const char *path, const char *label,
+      enum msg_hash_enums enum_idx,
+      unsigned type, size_t entry_idx,
+      const char *menu_path, const char *menu_label);
+
+/* Builds the pending entries of the current list that can be
+ * shown. The getters leave pending entries empty, so this has
+ * to run on the main thread before the menu is drawn. */
+void menu_entries_materialize_visible(void);
+
 bool menu_entries_ctl(enum menu_entries_ctl_state state, void *data);
 
 RETRO_END_DECLS
@@ -79,6 +79,7 @@
 #include "../performance_counters.h"
 #include "../setting_list.h"
 #include "../lakka.h"
+#include "../managers/run_ahead.h"
 #include "../retroarch.h"
 
 #include "../tasks/tasks_internal.h"
@@ -1761,6 +1762,7 @@ void general_write_handler(void *data)
          audio_set_float(AUDIO_ACTION_MIXER_VOLUME_GAIN, *setting->value.target.fraction);
          break;
       case MENU_ENUM_LABEL_AUDIO_LATENCY:
+      case MENU_ENUM_LABEL_AUDIO_OUTPUT_THREAD:
       case MENU_ENUM_LABEL_AUDIO_OUTPUT_RATE:
       case MENU_ENUM_LABEL_AUDIO_WASAPI_EXCLUSIVE_MODE:
       case MENU_ENUM_LABEL_AUDIO_WASAPI_FLOAT_FORMAT:
@@ -3055,6 +3057,21 @@ static bool setting_append_list(
                   general_write_handler,
                   general_read_handler,
                   SD_FLAG_ADVANCED);
+
+            CONFIG_BOOL(
+                  list, list_info,
+                  &settings->bools.frame_timeline_enable,
+                  MENU_ENUM_LABEL_FRAME_TIMELINE_ENABLE,
+                  MENU_ENUM_LABEL_VALUE_FRAME_TIMELINE_ENABLE,
+                  frame_timeline_enable,
+                  MENU_ENUM_LABEL_VALUE_OFF,
+                  MENU_ENUM_LABEL_VALUE_ON,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  SD_FLAG_ADVANCED);
          }
          END_SUB_GROUP(list, list_info, parent_group);
          END_GROUP(list, list_info, parent_group);
@@ -3062,7 +3079,7 @@ static bool setting_append_list(
       case SETTINGS_LIST_SAVING:
          {
             uint8_t i;
-            struct bool_entry bool_entries[11];
+            struct bool_entry bool_entries[12];
 
             START_GROUP(list, list_info, &group_info, msg_hash_to_str(MENU_ENUM_LABEL_VALUE_SAVING_SETTINGS), parent_group);
             parent_group = msg_hash_to_str(MENU_ENUM_LABEL_SAVING_SETTINGS);
@@ -3136,6 +3153,12 @@ static bool setting_append_list(
             bool_entries[10].default_value  = default_screenshots_in_content_dir;
             bool_entries[10].flags          = SD_FLAG_ADVANCED;
 
+            bool_entries[11].target         = &settings->bools.savestate_file_compression;
+            bool_entries[11].name_enum_idx  = MENU_ENUM_LABEL_SAVESTATE_FILE_COMPRESSION;
+            bool_entries[11].SHORT_enum_idx = MENU_ENUM_LABEL_VALUE_SAVESTATE_FILE_COMPRESSION;
+            bool_entries[11].default_value  = savestate_file_compression;
+            bool_entries[11].flags          = SD_FLAG_ADVANCED;
+
             for (i = 0; i < ARRAY_SIZE(bool_entries); i++)
             {
                CONFIG_BOOL(
@@ -3227,6 +3250,25 @@ static bool setting_append_list(
                   general_read_handler);
          menu_settings_list_current_add_range(list, list_info, 1, 32768, 1, true, true);
 
+#ifdef HAVE_THREADS
+         CONFIG_BOOL(
+               list, list_info,
+               &settings->bools.rewind_threaded,
+               MENU_ENUM_LABEL_REWIND_THREADED,
+               MENU_ENUM_LABEL_VALUE_REWIND_THREADED,
+               rewind_threaded,
+               MENU_ENUM_LABEL_VALUE_OFF,
+               MENU_ENUM_LABEL_VALUE_ON,
+               &group_info,
+               &subgroup_info,
+               parent_group,
+               general_write_handler,
+               general_read_handler,
+               SD_FLAG_CMD_APPLY_AUTO);
+         menu_settings_list_current_add_cmd(list, list_info, CMD_EVENT_REWIND_TOGGLE);
+         settings_data_list_current_add_flags(list, list_info, SD_FLAG_ADVANCED);
+#endif
+
          END_SUB_GROUP(list, list_info, parent_group);
          END_GROUP(list, list_info, parent_group);
          break;
@@ -3288,6 +3330,21 @@ static bool setting_append_list(
                   general_read_handler,
                   SD_FLAG_NONE);
 
+            CONFIG_BOOL(
+                  list, list_info,
+                  &settings->bools.video_frame_timeline_show,
+                  MENU_ENUM_LABEL_FRAME_TIMELINE_SHOW,
+                  MENU_ENUM_LABEL_VALUE_FRAME_TIMELINE_SHOW,
+                  frame_timeline_show,
+                  MENU_ENUM_LABEL_VALUE_OFF,
+                  MENU_ENUM_LABEL_VALUE_ON,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  SD_FLAG_ADVANCED);
+
             END_SUB_GROUP(list, list_info, parent_group);
             START_SUB_GROUP(list, list_info, "Platform-specific", &group_info, &subgroup_info, parent_group);
 
@@ -3815,6 +3872,36 @@ static bool setting_append_list(
             menu_settings_list_current_add_range(list, list_info, 0, 15, 1, true, true);
             settings_data_list_current_add_flags(list, list_info, SD_FLAG_LAKKA_ADVANCED);
 
+            CONFIG_BOOL(
+                  list, list_info,
+                  &settings->bools.video_frame_delay_auto,
+                  MENU_ENUM_LABEL_VIDEO_FRAME_DELAY_AUTO,
+                  MENU_ENUM_LABEL_VALUE_VIDEO_FRAME_DELAY_AUTO,
+                  frame_delay_auto,
+                  MENU_ENUM_LABEL_VALUE_OFF,
+                  MENU_ENUM_LABEL_VALUE_ON,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler,
+                  SD_FLAG_NONE);
+            settings_data_list_current_add_flags(list, list_info, SD_FLAG_LAKKA_ADVANCED);
+
+            CONFIG_UINT(
+                  list, list_info,
+                  &settings->uints.run_ahead_frames,
+                  MENU_ENUM_LABEL_RUN_AHEAD_FRAMES,
+                  MENU_ENUM_LABEL_VALUE_RUN_AHEAD_FRAMES,
+                  run_ahead_frames,
+                  &group_info,
+                  &subgroup_info,
+                  parent_group,
+                  general_write_handler,
+                  general_read_handler);
+            menu_settings_list_current_add_range(list, list_info, 0, RUN_AHEAD_MAX_FRAMES, 1, true, true);
+            settings_data_list_current_add_flags(list, list_info, SD_FLAG_ADVANCED);
+
 #if !defined(RARCH_MOBILE)
             CONFIG_BOOL(
                   list, list_info,
@@ -4029,6 +4116,25 @@ static bool setting_append_list(
                );
          settings_data_list_current_add_flags(list, list_info, SD_FLAG_LAKKA_ADVANCED);
 
+#ifdef HAVE_THREADS
+         CONFIG_BOOL(
+               list, list_info,
+               &settings->bools.audio_output_thread,
+               MENU_ENUM_LABEL_AUDIO_OUTPUT_THREAD,
+               MENU_ENUM_LABEL_VALUE_AUDIO_OUTPUT_THREAD,
+               audio_output_thread,
+               MENU_ENUM_LABEL_VALUE_OFF,
+               MENU_ENUM_LABEL_VALUE_ON,
+               &group_info,
+               &subgroup_info,
+               parent_group,
+               general_write_handler,
+               general_read_handler,
+               SD_FLAG_ADVANCED
+               );
+         settings_data_list_current_add_flags(list, list_info, SD_FLAG_LAKKA_ADVANCED);
+#endif
+
          CONFIG_UINT(
                list, list_info,
                &settings->uints.audio_latency,
@@ -6401,6 +6507,21 @@ static bool setting_append_list(
                general_read_handler,
                SD_FLAG_NONE);
 
+         CONFIG_BOOL(
+               list, list_info,
+               &settings->bools.playlist_binary_format,
+               MENU_ENUM_LABEL_PLAYLIST_BINARY_FORMAT,
+               MENU_ENUM_LABEL_VALUE_PLAYLIST_BINARY_FORMAT,
+               def_playlist_binary_format,
+               MENU_ENUM_LABEL_VALUE_OFF,
+               MENU_ENUM_LABEL_VALUE_ON,
+               &group_info,
+               &subgroup_info,
+               parent_group,
+               general_write_handler,
+               general_read_handler,
+               SD_FLAG_NONE);
+
          END_SUB_GROUP(list, list_info, parent_group);
 
          END_GROUP(list, list_info, parent_group);
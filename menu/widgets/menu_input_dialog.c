@@ -36,6 +36,10 @@ static void menu_input_search_cb(void *userdata, const char *str)
    if (!selection_buf)
       return;
 
+   /* Pending entries of a virtual list have nothing to match. */
+   if (str && *str)
+      file_list_materialize(selection_buf, 0, selection_buf->size);
+
    if (str && *str && file_list_search(selection_buf, str, &idx))
    {
       menu_navigation_set_selection(idx);
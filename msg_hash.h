@@ -645,6 +645,8 @@ enum msg_hash_enums
    MENU_LABEL(VIDEO_GPU_SCREENSHOT),
    MENU_LABEL(VIDEO_BLACK_FRAME_INSERTION),
    MENU_LABEL(VIDEO_FRAME_DELAY),
+   MENU_LABEL(VIDEO_FRAME_DELAY_AUTO),
+   MENU_LABEL(RUN_AHEAD_FRAMES),
    MENU_LABEL(VIDEO_VSYNC),
    MENU_LABEL(VIDEO_HARD_SYNC),
    MENU_LABEL(VIDEO_HARD_SYNC_FRAMES),
@@ -781,6 +783,7 @@ enum msg_hash_enums
    MENU_LABEL(HISTORY_LIST_ENABLE),
    MENU_LABEL(CONTENT_HISTORY_SIZE),
    MENU_LABEL(PLAYLIST_ENTRY_REMOVE),
+   MENU_LABEL(PLAYLIST_BINARY_FORMAT),
    MENU_LABEL(PLAYLIST_ENTRY_RENAME),
    MENU_LABEL(GOTO_FAVORITES),
    MENU_LABEL(GOTO_MUSIC),
@@ -1054,6 +1057,7 @@ enum msg_hash_enums
    MENU_LABEL(AUDIO_MUTE),
    MENU_LABEL(AUDIO_MIXER_MUTE),
    MENU_LABEL(AUDIO_SYNC),
+   MENU_LABEL(AUDIO_OUTPUT_THREAD),
    MENU_LABEL(AUDIO_VOLUME),
    MENU_LABEL(AUDIO_MIXER_VOLUME),
    MENU_LABEL(AUDIO_RATE_CONTROL_DELTA),
@@ -1076,6 +1080,8 @@ enum msg_hash_enums
    MENU_LABEL(FRAME_ADVANCE),
    MENU_LABEL(FPS_SHOW),
    MENU_LABEL(FRAMECOUNT_SHOW),
+   MENU_LABEL(FRAME_TIMELINE_SHOW),
+   MENU_LABEL(FRAME_TIMELINE_ENABLE),
    MENU_LABEL(MOVIE_RECORD_TOGGLE),
    MENU_ENUM_LABEL_L_X_PLUS,
    MENU_ENUM_LABEL_L_X_MINUS,
@@ -1097,6 +1103,7 @@ enum msg_hash_enums
    MENU_LABEL(SCREENSHOT),
    MENU_LABEL(REWIND),
    MENU_LABEL(REWIND_GRANULARITY),
+   MENU_LABEL(REWIND_THREADED),
    MENU_LABEL(INPUT_META_REWIND),
 
    MENU_LABEL(SCREEN_RESOLUTION),
@@ -1105,6 +1112,7 @@ enum msg_hash_enums
    MENU_LABEL(SAVESTATE_AUTO_SAVE),
    MENU_LABEL(SAVESTATE_AUTO_LOAD),
    MENU_LABEL(SAVESTATE_THUMBNAIL_ENABLE),
+   MENU_LABEL(SAVESTATE_FILE_COMPRESSION),
 
    MENU_LABEL(SUSPEND_SCREENSAVER_ENABLE),
    MENU_LABEL(DPI_OVERRIDE_ENABLE),
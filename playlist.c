@@ -17,20 +17,53 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 #include <boolean.h>
 #include <compat/posix_string.h>
 #include <string/stdstring.h>
 #include <streams/file_stream.h>
 #include <file/file_path.h>
+#include <memmap.h>
+
+#ifdef HAVE_MMAN
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include "playlist.h"
+#include "configuration.h"
 #include "verbosity.h"
 
 #ifndef PLAYLIST_ENTRIES
 #define PLAYLIST_ENTRIES 6
 #endif
 
+/* Version of the binary playlist layout, bump on any change. */
+#define PLAYLIST_BINARY_VERSION 1
+
+/* The binary format is a header, one record per entry and a
+ * pool of NUL-terminated strings. Strings are offsets into the
+ * pool, 0 is NULL. Identical strings (core paths, database
+ * names) are stored once. All of it is in native byte order. */
+struct playlist_binary_header
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t byte_order;
+   uint32_t count;
+   uint32_t strings_size;
+};
+
+struct playlist_binary_record
+{
+   uint32_t path_hash;
+   /* path, label, core_path, core_name, crc32, db_name */
+   uint32_t strings[PLAYLIST_ENTRIES];
+};
+
 struct playlist_entry
 {
    char *path;
@@ -39,6 +72,23 @@ struct playlist_entry
    char *core_name;
    char *db_name;
    char *crc32;
+   uint32_t path_hash;
+};
+
+enum playlist_hash_state
+{
+   PLAYLIST_HASH_EMPTY = 0,
+   PLAYLIST_HASH_USED,
+   PLAYLIST_HASH_DELETED
+};
+
+/* Maps the path hash of an entry to its index. Entries
+ * with the same hash each have a slot of their own. */
+struct playlist_hash_slot
+{
+   uint32_t hash;
+   uint32_t index;
+   uint8_t state;
 };
 
 struct content_playlist
@@ -46,15 +96,250 @@ struct content_playlist
    bool modified;
    size_t size;
    size_t cap;
+   size_t allocated;
 
    char *conf_path;
    struct playlist_entry *entries;
+
+   /* Contents of a binary playlist file. Entries point into
+    * its string pool until they are changed. */
+   void *file_data;
+   size_t file_size;
+   bool file_mapped;
+   const char *pool;
+   size_t pool_size;
+
+   struct playlist_hash_slot *path_hashes;
+   size_t path_hashes_size;
+   /* Slots that are not empty, deleted ones included. */
+   size_t path_hashes_used;
 };
 
 typedef int (playlist_sort_fun_t)(
       const struct playlist_entry *a,
       const struct playlist_entry *b);
 
+static uint32_t playlist_hash_path(const char *path)
+{
+   uint32_t hash = 5381;
+
+   if (!path)
+      return 0;
+
+   while (*path)
+      hash = hash * 33 + (unsigned char)*path++;
+
+   /* Paths often differ in one character only, spread
+    * that over all bits before it is used as an index. */
+   hash ^= hash >> 16;
+   hash *= 0x85ebca6b;
+   hash ^= hash >> 13;
+   hash *= 0xc2b2ae35;
+   hash ^= hash >> 16;
+
+   return hash;
+}
+
+/**
+ * playlist_hash_rebuild:
+ * @playlist            : Playlist handle.
+ *
+ * Fills the path hash table from the entries, dropping
+ * deleted slots. It keeps its size when those made up most
+ * of it, so a playlist with a lot of churn does not grow it.
+ * On failure the table is dropped and lookups scan the
+ * entries until it is rebuilt.
+ *
+ * Returns: true if successful, otherwise false.
+ **/
+static bool playlist_hash_rebuild(playlist_t *playlist)
+{
+   size_t i;
+   size_t size                      = 64;
+   struct playlist_hash_slot *slots = NULL;
+
+   while (size < (playlist->size + 1) * 4)
+      size *= 2;
+
+   slots = (struct playlist_hash_slot*)calloc(size, sizeof(*slots));
+
+   free(playlist->path_hashes);
+   playlist->path_hashes      = slots;
+   playlist->path_hashes_size = slots ? size : 0;
+   playlist->path_hashes_used = 0;
+
+   if (!slots)
+      return false;
+
+   for (i = 0; i < playlist->size; i++)
+   {
+      uint32_t hash = playlist->entries[i].path_hash;
+      size_t j      = hash & (size - 1);
+
+      while (slots[j].state != PLAYLIST_HASH_EMPTY)
+         j = (j + 1) & (size - 1);
+
+      slots[j].hash  = hash;
+      slots[j].index = (uint32_t)i;
+      slots[j].state = PLAYLIST_HASH_USED;
+   }
+
+   playlist->path_hashes_used = playlist->size;
+   return true;
+}
+
+/* Makes room for one more slot. Must be called while the
+ * table still matches the entries. */
+static void playlist_hash_reserve(playlist_t *playlist)
+{
+   if ((playlist->path_hashes_used + 1) * 2 > playlist->path_hashes_size)
+      playlist_hash_rebuild(playlist);
+}
+
+static void playlist_hash_add(playlist_t *playlist,
+      uint32_t hash, size_t idx)
+{
+   size_t i, mask;
+
+   if (!playlist->path_hashes)
+      return;
+
+   mask = playlist->path_hashes_size - 1;
+
+   for (i = hash & mask; playlist->path_hashes[i].state
+         == PLAYLIST_HASH_USED; i = (i + 1) & mask);
+
+   if (playlist->path_hashes[i].state == PLAYLIST_HASH_EMPTY)
+      playlist->path_hashes_used++;
+
+   playlist->path_hashes[i].hash  = hash;
+   playlist->path_hashes[i].index = (uint32_t)idx;
+   playlist->path_hashes[i].state = PLAYLIST_HASH_USED;
+}
+
+static void playlist_hash_remove(playlist_t *playlist,
+      uint32_t hash, size_t idx)
+{
+   size_t i, mask;
+
+   if (!playlist->path_hashes)
+      return;
+
+   mask = playlist->path_hashes_size - 1;
+
+   for (i = hash & mask; playlist->path_hashes[i].state
+         != PLAYLIST_HASH_EMPTY; i = (i + 1) & mask)
+   {
+      struct playlist_hash_slot *slot = &playlist->path_hashes[i];
+
+      if (     slot->state == PLAYLIST_HASH_USED
+            && slot->hash  == hash
+            && slot->index == idx)
+      {
+         slot->state = PLAYLIST_HASH_DELETED;
+         return;
+      }
+   }
+}
+
+/* Adds @delta to the index of the entries from @first up
+ * to @last, after they were moved. */
+static void playlist_hash_move(playlist_t *playlist,
+      size_t first, size_t last, int delta)
+{
+   size_t i;
+
+   if (!playlist->path_hashes)
+      return;
+
+   for (i = 0; i < playlist->path_hashes_size; i++)
+   {
+      struct playlist_hash_slot *slot = &playlist->path_hashes[i];
+
+      if (     slot->state == PLAYLIST_HASH_USED
+            && slot->index >= first && slot->index < last)
+         slot->index += delta;
+   }
+}
+
+static bool playlist_entry_matches(const struct playlist_entry *entry,
+      const char *path, const char *core_path)
+{
+   if (path ? !string_is_equal(entry->path, path) : !!entry->path)
+      return false;
+   return !core_path || string_is_equal(entry->core_path, core_path);
+}
+
+/**
+ * playlist_find_entry:
+ * @playlist            : Playlist handle.
+ * @path                : Path to look for, can be NULL.
+ * @hash                : Hash of @path.
+ * @core_path           : Core path to look for, NULL for any.
+ * @idx                 : Index of the entry found.
+ *
+ * Finds the first entry with @path. Only the entries whose
+ * path hash matches are compared.
+ *
+ * Returns: true if an entry was found, otherwise false.
+ **/
+static bool playlist_find_entry(playlist_t *playlist,
+      const char *path, uint32_t hash, const char *core_path,
+      size_t *idx)
+{
+   size_t i, mask;
+   bool found = false;
+
+   if (!playlist->path_hashes)
+   {
+      for (i = 0; i < playlist->size; i++)
+      {
+         if (playlist_entry_matches(&playlist->entries[i],
+                  path, core_path))
+         {
+            *idx = i;
+            return true;
+         }
+      }
+      return false;
+   }
+
+   mask = playlist->path_hashes_size - 1;
+
+   for (i = hash & mask; playlist->path_hashes[i].state
+         != PLAYLIST_HASH_EMPTY; i = (i + 1) & mask)
+   {
+      const struct playlist_hash_slot *slot = &playlist->path_hashes[i];
+
+      if (     slot->state != PLAYLIST_HASH_USED
+            || slot->hash  != hash
+            || (found && slot->index >= *idx))
+         continue;
+
+      if (!playlist_entry_matches(&playlist->entries[slot->index],
+               path, core_path))
+         continue;
+
+      *idx  = slot->index;
+      found = true;
+   }
+
+   return found;
+}
+
+/* Strings in the pool of a binary playlist belong to the file. */
+static void playlist_free_string(playlist_t *playlist, char *str)
+{
+   if (!str)
+      return;
+
+   if (playlist->pool && str >= playlist->pool
+         && str < playlist->pool + playlist->pool_size)
+      return;
+
+   free(str);
+}
+
 uint32_t playlist_get_size(playlist_t *playlist)
 {
    if (!playlist)
@@ -103,6 +388,35 @@ void playlist_get_index(playlist_t *playlist,
       *crc32     = playlist->entries[idx].crc32;
 }
 
+/**
+ * playlist_free_entry:
+ * @playlist            : Playlist handle.
+ * @entry               : Playlist entry handle.
+ *
+ * Frees playlist entry.
+ **/
+static void playlist_free_entry(playlist_t *playlist,
+      struct playlist_entry *entry)
+{
+   if (!entry)
+      return;
+
+   playlist_free_string(playlist, entry->path);
+   playlist_free_string(playlist, entry->label);
+   playlist_free_string(playlist, entry->core_path);
+   playlist_free_string(playlist, entry->core_name);
+   playlist_free_string(playlist, entry->db_name);
+   playlist_free_string(playlist, entry->crc32);
+
+   entry->path      = NULL;
+   entry->label     = NULL;
+   entry->core_path = NULL;
+   entry->core_name = NULL;
+   entry->db_name   = NULL;
+   entry->crc32     = NULL;
+   entry->path_hash = 0;
+}
+
 /**
  * playlist_delete_index:
  * @playlist            : Playlist handle.
@@ -113,11 +427,15 @@ void playlist_get_index(playlist_t *playlist,
 void playlist_delete_index(playlist_t *playlist,
       size_t idx)
 {
-   if (!playlist)
+   if (!playlist || idx >= playlist->size)
       return;
 
+   playlist_hash_remove(playlist, playlist->entries[idx].path_hash, idx);
+   playlist_free_entry(playlist, &playlist->entries[idx]);
+
    memmove(playlist->entries + idx, playlist->entries + idx + 1,
-         (playlist->size - idx) * sizeof(struct playlist_entry));
+         (playlist->size - idx - 1) * sizeof(struct playlist_entry));
+   playlist_hash_move(playlist, idx + 1, playlist->size, -1);
 
    playlist->size     = playlist->size - 1;
    playlist->modified = true;
@@ -133,28 +451,23 @@ void playlist_get_index_by_path(playlist_t *playlist,
       char **db_name)
 {
    size_t i;
-   if (!playlist)
-      return;
 
-   for (i = 0; i < playlist->size; i++)
-   {
-      if (!string_is_equal(playlist->entries[i].path, search_path))
-         continue;
+   if (!playlist || !search_path || !playlist_find_entry(playlist,
+            search_path, playlist_hash_path(search_path), NULL, &i))
+      return;
 
-      if (path)
-         *path      = playlist->entries[i].path;
-      if (label)
-         *label     = playlist->entries[i].label;
-      if (core_path)
-         *core_path = playlist->entries[i].core_path;
-      if (core_name)
-         *core_name = playlist->entries[i].core_name;
-      if (db_name)
-         *db_name   = playlist->entries[i].db_name;
-      if (crc32)
-         *crc32     = playlist->entries[i].crc32;
-      break;
-   }
+   if (path)
+      *path      = playlist->entries[i].path;
+   if (label)
+      *label     = playlist->entries[i].label;
+   if (core_path)
+      *core_path = playlist->entries[i].core_path;
+   if (core_name)
+      *core_name = playlist->entries[i].core_name;
+   if (db_name)
+      *db_name   = playlist->entries[i].db_name;
+   if (crc32)
+      *crc32     = playlist->entries[i].crc32;
 }
 
 bool playlist_entry_exists(playlist_t *playlist,
@@ -162,46 +475,12 @@ bool playlist_entry_exists(playlist_t *playlist,
       const char *crc32)
 {
    size_t i;
-   if (!playlist)
-      return false;
-
-   for (i = 0; i < playlist->size; i++)
-      if (string_is_equal(playlist->entries[i].path, path))
-         return true;
-
-   return false;
-}
-
-/**
- * playlist_free_entry:
- * @entry               : Playlist entry handle.
- *
- * Frees playlist entry.
- **/
-static void playlist_free_entry(struct playlist_entry *entry)
-{
-   if (!entry)
-      return;
 
-   if (entry->path != NULL)
-      free(entry->path);
-   if (entry->label != NULL)
-      free(entry->label);
-   if (entry->core_path != NULL)
-      free(entry->core_path);
-   if (entry->core_name != NULL)
-      free(entry->core_name);
-   if (entry->db_name != NULL)
-      free(entry->db_name);
-   if (entry->crc32 != NULL)
-      free(entry->crc32);
+   if (!playlist || !path)
+      return false;
 
-   entry->path      = NULL;
-   entry->label     = NULL;
-   entry->core_path = NULL;
-   entry->core_name = NULL;
-   entry->db_name   = NULL;
-   entry->crc32     = NULL;
+   return playlist_find_entry(playlist, path,
+         playlist_hash_path(path), NULL, &i);
 }
 
 void playlist_update(playlist_t *playlist, size_t idx,
@@ -212,61 +491,88 @@ void playlist_update(playlist_t *playlist, size_t idx,
 {
    struct playlist_entry *entry = NULL;
 
-   if (!playlist || idx > playlist->size)
+   if (!playlist || idx >= playlist->size)
       return;
 
    entry            = &playlist->entries[idx];
 
    if (path && (path != entry->path))
    {
-      if (entry->path != NULL)
-         free(entry->path);
+      playlist_hash_reserve(playlist);
+      playlist_hash_remove(playlist, entry->path_hash, idx);
+      playlist_free_string(playlist, entry->path);
       entry->path        = strdup(path);
+      entry->path_hash   = playlist_hash_path(entry->path);
+      playlist_hash_add(playlist, entry->path_hash, idx);
       playlist->modified = true;
    }
 
    if (label && (label != entry->label))
    {
-      if (entry->label != NULL)
-         free(entry->label);
+      playlist_free_string(playlist, entry->label);
       entry->label       = strdup(label);
       playlist->modified = true;
    }
 
    if (core_path && (core_path != entry->core_path))
    {
-      if (entry->core_path != NULL)
-         free(entry->core_path);
-      entry->core_path   = NULL;
+      playlist_free_string(playlist, entry->core_path);
       entry->core_path   = strdup(core_path);
       playlist->modified = true;
    }
 
    if (core_name && (core_name != entry->core_name))
    {
-      if (entry->core_name != NULL)
-         free(entry->core_name);
+      playlist_free_string(playlist, entry->core_name);
       entry->core_name   = strdup(core_name);
       playlist->modified = true;
    }
 
    if (db_name && (db_name != entry->db_name))
    {
-      if (entry->db_name != NULL)
-         free(entry->db_name);
+      playlist_free_string(playlist, entry->db_name);
       entry->db_name     = strdup(db_name);
       playlist->modified = true;
    }
 
    if (crc32 && (crc32 != entry->crc32))
    {
-      if (entry->crc32 != NULL)
-         free(entry->crc32);
+      playlist_free_string(playlist, entry->crc32);
       entry->crc32       = strdup(crc32);
       playlist->modified = true;
    }
 }
 
+/* Grows the entry array to hold @size entries, it never
+ * grows past the capacity of the playlist. */
+static bool playlist_reserve(playlist_t *playlist, size_t size)
+{
+   size_t allocated;
+   struct playlist_entry *entries = NULL;
+
+   if (size <= playlist->allocated)
+      return true;
+
+   allocated = playlist->allocated ? playlist->allocated * 2 : 16;
+   if (allocated < size)
+      allocated = size;
+   if (allocated > playlist->cap)
+      allocated = playlist->cap;
+
+   entries   = (struct playlist_entry*)realloc(playlist->entries,
+         allocated * sizeof(*entries));
+
+   if (!entries)
+      return false;
+
+   memset(entries + playlist->allocated, 0,
+         (allocated - playlist->allocated) * sizeof(*entries));
+
+   playlist->entries   = entries;
+   playlist->allocated = allocated;
+   return true;
+}
+
 /**
  * playlist_push:
  * @playlist        	   : Playlist handle.
@@ -283,6 +589,8 @@ bool playlist_push(playlist_t *playlist,
       const char *db_name)
 {
    size_t i;
+   uint32_t hash;
+   struct playlist_entry *entry = NULL;
 
    if (string_is_empty(core_path) || string_is_empty(core_name))
    {
@@ -303,23 +611,16 @@ bool playlist_push(playlist_t *playlist,
    if (string_is_empty(path))
       path = NULL;
 
-   if (!playlist)
+   if (!playlist || !playlist->cap)
       return false;
 
-   for (i = 0; i < playlist->size; i++)
+   hash = playlist_hash_path(path);
+
+   /* Core name can have changed while still being the same core.
+    * Differentiate based on the core path only. */
+   if (playlist_find_entry(playlist, path, hash, core_path, &i))
    {
       struct playlist_entry tmp;
-      bool equal_path = (!path && !playlist->entries[i].path) ||
-         (path && playlist->entries[i].path &&
-          string_is_equal(path,playlist->entries[i].path));
-
-      /* Core name can have changed while still being the same core.
-       * Differentiate based on the core path only. */
-      if (!equal_path)
-         continue;
-
-      if (!string_is_equal(playlist->entries[i].core_path, core_path))
-         continue;
 
       /* If top entry, we don't want to push a new entry since
        * the top and the entry to be pushed are the same. */
@@ -327,47 +628,57 @@ bool playlist_push(playlist_t *playlist,
          return false;
 
       /* Seen it before, bump to top. */
+      playlist_hash_reserve(playlist);
+      playlist_hash_remove(playlist, hash, i);
+
       tmp = playlist->entries[i];
       memmove(playlist->entries + 1, playlist->entries,
             i * sizeof(struct playlist_entry));
       playlist->entries[0] = tmp;
 
+      playlist_hash_move(playlist, 0, i, 1);
+      playlist_hash_add(playlist, hash, 0);
+
       goto success;
    }
 
    if (playlist->size == playlist->cap)
    {
-      struct playlist_entry *entry = &playlist->entries[playlist->cap - 1];
+      size_t last = playlist->size - 1;
 
-      if (entry)
-         playlist_free_entry(entry);
+      playlist_hash_remove(playlist,
+            playlist->entries[last].path_hash, last);
+      playlist_free_entry(playlist, &playlist->entries[last]);
       playlist->size--;
    }
 
-   if (playlist->entries)
-   {
-      memmove(playlist->entries + 1, playlist->entries,
-            (playlist->cap - 1) * sizeof(struct playlist_entry));
-
-      playlist->entries[0].path         = NULL;
-      playlist->entries[0].label        = NULL;
-      playlist->entries[0].core_path    = NULL;
-      playlist->entries[0].core_name    = NULL;
-      playlist->entries[0].db_name      = NULL;
-      playlist->entries[0].crc32        = NULL;
-      if (!string_is_empty(path))
-         playlist->entries[0].path      = strdup(path);
-      if (!string_is_empty(label))
-         playlist->entries[0].label     = strdup(label);
-      if (!string_is_empty(core_path))
-         playlist->entries[0].core_path = strdup(core_path);
-      if (!string_is_empty(core_name))
-         playlist->entries[0].core_name = strdup(core_name);
-      if (!string_is_empty(db_name))
-         playlist->entries[0].db_name   = strdup(db_name);
-      if (!string_is_empty(crc32))
-         playlist->entries[0].crc32     = strdup(crc32);
-   }
+   if (!playlist_reserve(playlist, playlist->size + 1))
+      return false;
+
+   playlist_hash_reserve(playlist);
+
+   memmove(playlist->entries + 1, playlist->entries,
+         playlist->size * sizeof(struct playlist_entry));
+   playlist_hash_move(playlist, 0, playlist->size, 1);
+
+   entry            = &playlist->entries[0];
+   memset(entry, 0, sizeof(*entry));
+
+   if (!string_is_empty(path))
+      entry->path      = strdup(path);
+   if (!string_is_empty(label))
+      entry->label     = strdup(label);
+   if (!string_is_empty(core_path))
+      entry->core_path = strdup(core_path);
+   if (!string_is_empty(core_name))
+      entry->core_name = strdup(core_name);
+   if (!string_is_empty(db_name))
+      entry->db_name   = strdup(db_name);
+   if (!string_is_empty(crc32))
+      entry->crc32     = strdup(crc32);
+
+   entry->path_hash    = hash;
+   playlist_hash_add(playlist, hash, 0);
 
    playlist->size++;
 
@@ -377,24 +688,167 @@ success:
    return true;
 }
 
-void playlist_write_file(playlist_t *playlist)
+struct playlist_pool_slot
+{
+   uint32_t hash;
+   uint32_t offset;
+};
+
+/* Builds the string pool of a binary playlist, every
+ * distinct string is stored once. */
+struct playlist_pool_writer
+{
+   char *data;
+   size_t size;
+   size_t capacity;
+   struct playlist_pool_slot *slots;
+   size_t slots_size;
+   size_t slots_used;
+};
+
+static bool playlist_pool_grow_slots(struct playlist_pool_writer *writer)
 {
    size_t i;
-   RFILE *file = NULL;
+   size_t size                      = writer->slots_size
+      ? writer->slots_size * 2 : 1024;
+   struct playlist_pool_slot *slots = (struct playlist_pool_slot*)
+      calloc(size, sizeof(*slots));
 
-   if (!playlist || !playlist->modified)
-      return;
+   if (!slots)
+      return false;
 
-   file = filestream_open(playlist->conf_path, RFILE_MODE_WRITE, -1);
+   for (i = 0; i < writer->slots_size; i++)
+   {
+      size_t j;
 
-   RARCH_LOG("Trying to write to playlist file: %s\n", playlist->conf_path);
+      if (!writer->slots[i].offset)
+         continue;
 
-   if (!file)
+      for (j = writer->slots[i].hash & (size - 1); slots[j].offset;
+            j = (j + 1) & (size - 1));
+      slots[j] = writer->slots[i];
+   }
+
+   free(writer->slots);
+   writer->slots      = slots;
+   writer->slots_size = size;
+   return true;
+}
+
+static uint32_t playlist_pool_add(struct playlist_pool_writer *writer,
+      const char *str)
+{
+   size_t i, len;
+   uint32_t hash;
+
+   if (!str)
+      return 0;
+
+   if ((writer->slots_used + 1) * 2 > writer->slots_size
+         && !playlist_pool_grow_slots(writer))
+      return 0;
+
+   hash = playlist_hash_path(str);
+
+   for (i = hash & (writer->slots_size - 1); writer->slots[i].offset;
+         i = (i + 1) & (writer->slots_size - 1))
    {
-      RARCH_ERR("Failed to write to playlist file: %s\n", playlist->conf_path);
-      return;
+      if (writer->slots[i].hash == hash
+            && string_is_equal(writer->data + writer->slots[i].offset, str))
+         return writer->slots[i].offset;
+   }
+
+   len = strlen(str) + 1;
+
+   if (writer->size + len > writer->capacity)
+   {
+      size_t capacity = writer->capacity * 2;
+      char *data      = NULL;
+
+      while (writer->size + len > capacity)
+         capacity *= 2;
+
+      data = (char*)realloc(writer->data, capacity);
+      if (!data)
+         return 0;
+
+      writer->data     = data;
+      writer->capacity = capacity;
+   }
+
+   memcpy(writer->data + writer->size, str, len);
+
+   writer->slots[i].hash   = hash;
+   writer->slots[i].offset = (uint32_t)writer->size;
+   writer->slots_used++;
+   writer->size           += len;
+
+   return writer->slots[i].offset;
+}
+
+static bool playlist_write_binary(playlist_t *playlist, RFILE *file)
+{
+   size_t i;
+   struct playlist_binary_header header;
+   struct playlist_pool_writer writer;
+   size_t records_size                    = playlist->size
+      * sizeof(struct playlist_binary_record);
+   struct playlist_binary_record *records = (struct playlist_binary_record*)
+      calloc(playlist->size ? playlist->size : 1, sizeof(*records));
+   bool ret                               = false;
+
+   memset(&writer, 0, sizeof(writer));
+
+   if (!records || !playlist_pool_grow_slots(&writer))
+      goto end;
+
+   /* Offset 0 is NULL. */
+   writer.capacity = 65536;
+   writer.data     = (char*)calloc(1, writer.capacity);
+   writer.size     = 1;
+
+   if (!writer.data)
+      goto end;
+
+   for (i = 0; i < playlist->size; i++)
+   {
+      const struct playlist_entry *entry = &playlist->entries[i];
+      struct playlist_binary_record *rec = &records[i];
+
+      rec->path_hash  = entry->path_hash;
+      rec->strings[0] = playlist_pool_add(&writer, entry->path);
+      rec->strings[1] = playlist_pool_add(&writer, entry->label);
+      rec->strings[2] = playlist_pool_add(&writer, entry->core_path);
+      rec->strings[3] = playlist_pool_add(&writer, entry->core_name);
+      rec->strings[4] = playlist_pool_add(&writer, entry->crc32);
+      rec->strings[5] = playlist_pool_add(&writer, entry->db_name);
    }
 
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, "RAPLIST", 8);
+   header.version      = PLAYLIST_BINARY_VERSION;
+   header.byte_order   = 0x01020304;
+   header.count        = (uint32_t)playlist->size;
+   header.strings_size = (uint32_t)writer.size;
+
+   ret = filestream_write(file, &header, sizeof(header))
+         == (ssize_t)sizeof(header)
+      && filestream_write(file, records, records_size)
+         == (ssize_t)records_size
+      && filestream_write(file, writer.data, writer.size)
+         == (ssize_t)writer.size;
+
+end:
+   free(writer.data);
+   free(writer.slots);
+   free(records);
+   return ret;
+}
+
+static bool playlist_write_text(playlist_t *playlist, RFILE *file)
+{
+   size_t i;
+
    for (i = 0; i < playlist->size; i++)
       fprintf(filestream_get_fp(file), "%s\n%s\n%s\n%s\n%s\n%s\n",
             playlist->entries[i].path    ? playlist->entries[i].path    : "",
@@ -405,8 +859,81 @@ void playlist_write_file(playlist_t *playlist)
             playlist->entries[i].db_name ? playlist->entries[i].db_name : ""
             );
 
-   playlist->modified = false;
+   return true;
+}
+
+void playlist_write_file(playlist_t *playlist)
+{
+   char tmp_path[PATH_MAX_LENGTH];
+   const char *path     = NULL;
+   RFILE *file          = NULL;
+   settings_t *settings = config_get_ptr();
+   bool ret             = false;
+
+   if (!playlist || !playlist->modified)
+      return;
+
+   path = playlist->conf_path;
+
+   /* Truncating a mapped file would pull the strings out from
+    * under the entries, write a new file and replace it instead. */
+   if (playlist->file_mapped)
+   {
+      snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", playlist->conf_path);
+      path = tmp_path;
+   }
+
+   file = filestream_open(path, RFILE_MODE_WRITE, -1);
+
+   RARCH_LOG("Trying to write to playlist file: %s\n", playlist->conf_path);
+
+   if (!file)
+   {
+      RARCH_ERR("Failed to write to playlist file: %s\n", playlist->conf_path);
+      return;
+   }
+
+   if (settings && settings->bools.playlist_binary_format)
+      ret = playlist_write_binary(playlist, file);
+   else
+      ret = playlist_write_text(playlist, file);
+
    filestream_close(file);
+
+   if (playlist->file_mapped)
+   {
+      if (ret && rename(tmp_path, playlist->conf_path) != 0)
+         ret = false;
+      if (!ret)
+         remove(tmp_path);
+   }
+
+   if (!ret)
+   {
+      RARCH_ERR("Failed to write to playlist file: %s\n", playlist->conf_path);
+      return;
+   }
+
+   playlist->modified = false;
+}
+
+static void playlist_close_file(playlist_t *playlist)
+{
+   if (!playlist->file_data)
+      return;
+
+#ifdef HAVE_MMAN
+   if (playlist->file_mapped)
+      munmap(playlist->file_data, playlist->file_size);
+   else
+#endif
+      free(playlist->file_data);
+
+   playlist->file_data   = NULL;
+   playlist->file_size   = 0;
+   playlist->file_mapped = false;
+   playlist->pool        = NULL;
+   playlist->pool_size   = 0;
 }
 
 /**
@@ -428,16 +955,14 @@ void playlist_free(playlist_t *playlist)
    playlist->conf_path = NULL;
 
    for (i = 0; i < playlist->size; i++)
-   {
-      struct playlist_entry *entry = &playlist->entries[i];
+      playlist_free_entry(playlist, &playlist->entries[i]);
 
-      if (entry)
-         playlist_free_entry(entry);
-   }
+   playlist_close_file(playlist);
 
    free(playlist->entries);
    playlist->entries = NULL;
 
+   free(playlist->path_hashes);
    free(playlist);
 }
 
@@ -454,13 +979,13 @@ void playlist_clear(playlist_t *playlist)
       return;
 
    for (i = 0; i < playlist->size; i++)
-   {
-      struct playlist_entry *entry = &playlist->entries[i];
-
-      if (entry)
-         playlist_free_entry(entry);
-   }
+      playlist_free_entry(playlist, &playlist->entries[i]);
    playlist->size = 0;
+
+   free(playlist->path_hashes);
+   playlist->path_hashes      = NULL;
+   playlist->path_hashes_size = 0;
+   playlist->path_hashes_used = 0;
 }
 
 /**
@@ -477,14 +1002,146 @@ size_t playlist_size(playlist_t *playlist)
    return playlist->size;
 }
 
+static bool playlist_map_file(playlist_t *playlist, const char *path)
+{
+#ifdef HAVE_MMAN
+   struct stat st;
+   void *data = NULL;
+   int fd     = open(path, O_RDONLY);
+
+   if (fd < 0)
+      return false;
+
+   if (fstat(fd, &st) < 0
+         || (size_t)st.st_size < sizeof(struct playlist_binary_header))
+   {
+      close(fd);
+      return false;
+   }
+
+   data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+
+   if (data == MAP_FAILED)
+      return false;
+
+   playlist->file_data   = data;
+   playlist->file_size   = st.st_size;
+   playlist->file_mapped = true;
+   return true;
+#else
+   void *data  = NULL;
+   ssize_t len = 0;
+
+   if (!path_is_valid(path)
+         || !filestream_read_file(path, &data, &len)
+         || (size_t)len < sizeof(struct playlist_binary_header))
+   {
+      free(data);
+      return false;
+   }
+
+   playlist->file_data = data;
+   playlist->file_size = len;
+   return true;
+#endif
+}
+
+/**
+ * playlist_read_binary:
+ * @playlist            : Playlist handle.
+ * @path                : Path to playlist contents file.
+ *
+ * Loads a binary playlist. The file stays mapped and the
+ * entries point into it, so no string is copied until its
+ * entry is changed.
+ *
+ * Returns: true (1) if @path is a valid binary playlist,
+ * otherwise false (0).
+ **/
+static bool playlist_read_binary(playlist_t *playlist, const char *path)
+{
+   size_t i, count;
+   const struct playlist_binary_header *header  = NULL;
+   const struct playlist_binary_record *records = NULL;
+
+   if (!playlist_map_file(playlist, path))
+      return false;
+
+   header = (const struct playlist_binary_header*)playlist->file_data;
+
+   if (memcmp(header->magic, "RAPLIST", 8)
+         || header->version    != PLAYLIST_BINARY_VERSION
+         || header->byte_order != 0x01020304
+         || !header->strings_size
+         || playlist->file_size != sizeof(*header)
+            + (size_t)header->count * sizeof(*records)
+            + header->strings_size)
+      goto error;
+
+   records             = (const struct playlist_binary_record*)(header + 1);
+   playlist->pool      = (const char*)(records + header->count);
+   playlist->pool_size = header->strings_size;
+
+   if (playlist->pool[playlist->pool_size - 1] != '\0')
+      goto error;
+
+   count = header->count < playlist->cap ? header->count : playlist->cap;
+
+   if (!playlist_reserve(playlist, count))
+      goto error;
+
+   for (i = 0; i < count; i++)
+   {
+      unsigned j;
+      char *strings[PLAYLIST_ENTRIES];
+      struct playlist_entry *entry = &playlist->entries[playlist->size];
+
+      for (j = 0; j < PLAYLIST_ENTRIES; j++)
+      {
+         uint32_t offset = records[i].strings[j];
+
+         if (offset >= playlist->pool_size)
+            goto error;
+
+         strings[j] = offset ? (char*)playlist->pool + offset : NULL;
+      }
+
+      if (string_is_empty(strings[2]) || string_is_empty(strings[3]))
+         continue;
+
+      entry->path      = strings[0];
+      entry->label     = strings[1];
+      entry->core_path = strings[2];
+      entry->core_name = strings[3];
+      entry->crc32     = strings[4];
+      entry->db_name   = strings[5];
+      entry->path_hash = records[i].path_hash;
+
+      playlist_hash_reserve(playlist);
+      playlist_hash_add(playlist, entry->path_hash, playlist->size);
+      playlist->size++;
+   }
+
+   return true;
+
+error:
+   playlist_clear(playlist);
+   playlist_close_file(playlist);
+   return false;
+}
 
 static bool playlist_read_file(
       playlist_t *playlist, const char *path)
 {
    unsigned i;
    char buf[PLAYLIST_ENTRIES][1024];
-   RFILE *file                      = filestream_open(
-         path, RFILE_MODE_READ_TEXT, -1);
+   RFILE *file                      = NULL;
+
+   if (playlist_read_binary(playlist, path))
+      return true;
+
+   file = filestream_open(path, RFILE_MODE_READ_TEXT, -1);
 
    for (i = 0; i < PLAYLIST_ENTRIES; i++)
       buf[i][0] = '\0';
@@ -516,11 +1173,14 @@ static bool playlist_read_file(
              *last = '\0';	
       }
 
-      entry = &playlist->entries[playlist->size];
-
       if (!*buf[2] || !*buf[3])
          continue;
 
+      if (!playlist_reserve(playlist, playlist->size + 1))
+         goto end;
+
+      entry = &playlist->entries[playlist->size];
+
       if (*buf[0])
          entry->path      = strdup(buf[0]);
       if (*buf[1])
@@ -532,6 +1192,10 @@ static bool playlist_read_file(
          entry->crc32     = strdup(buf[4]);
       if (*buf[5])
          entry->db_name   = strdup(buf[5]);
+
+      entry->path_hash    = playlist_hash_path(entry->path);
+      playlist_hash_reserve(playlist);
+      playlist_hash_add(playlist, entry->path_hash, playlist->size);
       playlist->size++;
    }
 
@@ -545,29 +1209,25 @@ end:
  * @path            	   : Path to playlist contents file.
  * @size                : Maximum capacity of playlist size.
  *
- * Creates and initializes a playlist.
+ * Creates and initializes a playlist. Text and binary
+ * playlists are both read, which of the two is written
+ * depends on the playlist_binary_format setting.
  *
  * Returns: handle to new playlist if successful, otherwise NULL
  **/
 playlist_t *playlist_init(const char *path, size_t size)
 {
-   struct playlist_entry *entries = NULL;
-   playlist_t           *playlist = (playlist_t*)malloc(sizeof(*playlist));
+   playlist_t           *playlist = (playlist_t*)calloc(1, sizeof(*playlist));
    if (!playlist)
       return NULL;
 
-   entries = (struct playlist_entry*)calloc(size, sizeof(*entries));
-   if (!entries)
-   {
-      free(playlist);
-      return NULL;
-   }
-
+   /* Entries are allocated as the playlist grows,
+    * most never come near their capacity. */
    playlist->modified  = false;
    playlist->size      = 0;
    playlist->cap       = size;
    playlist->conf_path = strdup(path);
-   playlist->entries   = entries;
+   playlist->entries   = NULL;
 
    playlist_read_file(playlist, path);
 
@@ -591,4 +1251,5 @@ void playlist_qsort(playlist_t *playlist)
    qsort(playlist->entries, playlist->size,
          sizeof(struct playlist_entry),
          (int (*)(const void *, const void *))playlist_qsort_func);
+   playlist_hash_rebuild(playlist);
 }
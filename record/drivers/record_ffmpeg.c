@@ -24,6 +24,7 @@
 #include <boolean.h>
 #include <queues/fifo_queue.h>
 #include <rthreads/rthreads.h>
+#include <features/features_cpu.h>
 #include <gfx/scaler/scaler.h>
 #include <gfx/video_frame.h>
 #include <file/config_file.h>
@@ -445,6 +446,10 @@ static bool ffmpeg_init_video(ffmpeg_t *handle)
       video->scaler.out_fmt = SCALER_FMT_BGR24;
    }
 
+   /* Downscaling 4K output is too much for one core. The encoder
+    * has threads of its own, so only half of the cores are used. */
+   video->scaler.threads = cpu_features_get_core_amount() / 2;
+
    switch (param->pix_fmt)
    {
       case FFEMU_PIX_RGB565:
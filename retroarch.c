@@ -103,10 +103,13 @@
 #include "record/record_driver.h"
 #include "core.h"
 #include "configuration.h"
+#include "frame_timeline.h"
 #include "list_special.h"
 #include "managers/core_option_manager.h"
 #include "managers/cheat_manager.h"
 #include "managers/state_manager.h"
+#include "managers/run_ahead.h"
+#include "managers/frame_delay.h"
 #include "tasks/tasks_internal.h"
 
 #include "version.h"
@@ -1445,6 +1448,7 @@ bool rarch_ctl(enum rarch_ctl_state state, void *data)
 
          retroarch_msg_queue_deinit();
          driver_uninit(DRIVERS_CMD_ALL);
+         frame_timeline_deinit();
          command_event(CMD_EVENT_LOG_FILE_DEINIT, NULL);
 
          rarch_ctl(RARCH_CTL_STATE_FREE,  NULL);
@@ -1756,6 +1760,9 @@ bool rarch_ctl(enum rarch_ctl_state state, void *data)
 #ifdef HAVE_THREADS
             settings_t *settings = config_get_ptr();
             bool threaded_enable = settings->bools.threaded_data_runloop_enable;
+
+            task_queue_set_num_workers(
+                  settings->uints.threaded_data_runloop_workers);
 #else
             bool threaded_enable = false;
 #endif
@@ -2134,6 +2141,10 @@ int retroarch_get_capabilities(enum rarch_capabilities type,
                strlcat(s, "VMX128 ", len);
             if (cpu & RETRO_SIMD_ASIMD)
                strlcat(s, "ASIMD ", len);
+            if (cpu & CPU_FEATURE_PCLMUL)
+               strlcat(s, "PCLMUL ", len);
+            if (cpu & CPU_FEATURE_CRC32)
+               strlcat(s, "CRC32 ", len);
          }
          break;
       case RARCH_CAPABILITIES_COMPILER:
@@ -2865,7 +2876,8 @@ static enum runloop_state runloop_check_state(
       s[0] = '\0';
 
       if (state_manager_check_rewind(runloop_cmd_press(current_input, RARCH_REWIND),
-            settings->uints.rewind_granularity, runloop_paused, s, sizeof(s), &t))
+            settings->uints.rewind_granularity,
+            runloop_paused, s, sizeof(s), &t))
          runloop_msg_queue_push(s, 0, t, true);
    }
 
@@ -3019,6 +3031,7 @@ void runloop_unset(enum runloop_action action)
 int runloop_iterate(unsigned *sleep_ms)
 {
    unsigned i;
+   retro_time_t core_run_start                  = 0;
    bool input_nonblock_state                    = input_driver_is_nonblock_state();
    settings_t *settings                         = config_get_ptr();
    unsigned max_users                           = *(input_driver_get_uint(INPUT_ACTION_MAX_USERS));
@@ -3078,6 +3091,9 @@ int runloop_iterate(unsigned *sleep_ms)
          break;
    }
 
+   frame_timeline_frame_begin(settings->bools.frame_timeline_enable
+         || settings->bools.video_frame_timeline_show);
+
    if (runloop_autosave)
       autosave_lock();
 
@@ -3099,10 +3115,28 @@ int runloop_iterate(unsigned *sleep_ms)
       input_push_analog_dpad(auto_binds,    dpad_mode);
    }
 
-   if ((settings->uints.video_frame_delay > 0) && !input_nonblock_state)
-      retro_sleep(settings->uints.video_frame_delay);
+   if (!input_nonblock_state)
+   {
+      unsigned frame_delay = settings->bools.video_frame_delay_auto
+         ? frame_delay_auto_get() : settings->uints.video_frame_delay;
+
+      if (frame_delay > 0)
+         retro_sleep(frame_delay);
+   }
+
+   frame_timeline_begin(FRAME_TIMELINE_CORE_RUN);
+   frame_delay_auto_begin();
+   core_run_start = cpu_features_get_time_usec();
+
+   if (settings->uints.run_ahead_frames == 0 || input_nonblock_state
+         || !runahead_run(settings->uints.run_ahead_frames))
+      core_run();
+
+   if (settings->bools.video_frame_delay_auto && !input_nonblock_state)
+      frame_delay_auto_update(cpu_features_get_time_usec() - core_run_start,
+            settings->floats.video_refresh_rate);
 
-   core_run();
+   frame_timeline_end(FRAME_TIMELINE_CORE_RUN);
 
 #ifdef HAVE_CHEEVOS
    if (runloop_check_cheevos())
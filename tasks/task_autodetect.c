@@ -421,8 +421,9 @@ bool input_autoconfigure_disconnect(unsigned i, const char *ident)
 
    input_config_clear_device_name(state->idx);
 
-   task->state   = state;
-   task->handler = input_autoconfigure_disconnect_handler;
+   task->state     = state;
+   task->handler   = input_autoconfigure_disconnect_handler;
+   task->exclusive = TASK_EXCLUSIVE_INPUT;
 
    task_queue_push(task);
 
@@ -522,6 +523,7 @@ bool input_autoconfigure_connect(
 
    task->state                      = state;
    task->handler                    = input_autoconfigure_connect_handler;
+   task->exclusive                  = TASK_EXCLUSIVE_INPUT;
 
    task_queue_push(task);
 
@@ -53,6 +53,11 @@ typedef struct database_state_handle
    char serial[4096];
    database_info_list_t *info;
    struct string_list *list;
+   /* Lookup handles, one per database in list,
+    * opened on first use and kept for the whole scan. */
+   database_info_index_t **indexes;
+   /* Hashes plain files ahead of the scanner. */
+   database_hasher_t *hasher;
 } database_state_handle_t;
 
 typedef struct db_handle
@@ -145,13 +150,14 @@ error:
 }
 
 static intfstream_t*
-open_chd_track(const char *path, int32_t track)
+open_chd_track(const char *path, int32_t track, bool threaded)
 {
    intfstream_info_t info;
    intfstream_t *fd = NULL;
 
-   info.type        = INTFSTREAM_CHD;
-   info.chd.track   = track;
+   info.type         = INTFSTREAM_CHD;
+   info.chd.track    = track;
+   info.chd.threaded = threaded;
 
    fd               = (intfstream_t*)intfstream_init(&info);
 
@@ -400,7 +406,7 @@ static int task_database_gdi_get_serial(const char *name, char* serial)
 static int task_database_chd_get_serial(const char *name, char* serial)
 {
    int result;
-   intfstream_t *fd = open_chd_track(name, CHDSTREAM_TRACK_FIRST_DATA);
+   intfstream_t *fd = open_chd_track(name, CHDSTREAM_TRACK_FIRST_DATA, false);
    if (!fd)
       return 0;
 
@@ -427,63 +433,6 @@ static int intfstream_get_crc(intfstream_t *fd, uint32_t *crc)
    return 1;
 }
 
-static bool intfstream_file_get_crc(const char *name,
-      size_t offset, size_t size, uint32_t *crc)
-{
-   int rv;
-   intfstream_t *fd  = intfstream_open_file(name);
-   uint8_t *data     = NULL;
-   ssize_t file_size = -1;
-
-   if (!fd)
-      return 0;
-
-   if (intfstream_seek(fd, 0, SEEK_END) == -1)
-      goto error;
-
-   file_size = intfstream_tell(fd);
-
-   if (intfstream_seek(fd, 0, SEEK_SET) == -1)
-      goto error;
-
-   if (file_size < 0)
-      goto error;
-
-   if (offset != 0 || size < (size_t) file_size)
-   {
-      if (intfstream_seek(fd, offset, SEEK_SET) == -1)
-         goto error;
-
-      data = (uint8_t*)malloc(size);
-
-      if (intfstream_read(fd, data, size) != (ssize_t) size)
-         goto error;
-
-      intfstream_close(fd);
-      free(fd);
-      fd = open_memory(data, size);
-
-      if (!fd) 
-         goto error;
-   }
-
-   rv = intfstream_get_crc(fd, crc);
-   intfstream_close(fd);
-   free(fd);
-   free(data);
-   return rv;
-
-error:
-   if (fd)
-   {
-      intfstream_close(fd);
-      free(fd);
-   }
-   if (data)
-      free(data);
-   return 0;
-}
-
 static int task_database_cue_get_crc(const char *name, uint32_t *crc)
 {
    char *track_path = (char *)malloc(PATH_MAX_LENGTH);
@@ -509,7 +458,7 @@ static int task_database_cue_get_crc(const char *name, uint32_t *crc)
 
    RARCH_LOG("%s\n", msg_hash_to_str(MSG_READING_FIRST_DATA_TRACK));
 
-   rv = intfstream_file_get_crc(track_path, offset, size, crc);
+   rv = database_hash_file_crc(track_path, offset, size, crc);
    if (rv == 1)
    {
       RARCH_LOG("CUE '%s' crc: %x\n", name, *crc);
@@ -539,7 +488,7 @@ static int task_database_gdi_get_crc(const char *name, uint32_t *crc)
 
    RARCH_LOG("%s\n", msg_hash_to_str(MSG_READING_FIRST_DATA_TRACK));
 
-   rv = intfstream_file_get_crc(track_path, 0, SIZE_MAX, crc);
+   rv = database_hash_file_crc(track_path, 0, SIZE_MAX, crc);
    if (rv == 1)
    {
       RARCH_LOG("GDI '%s' crc: %x\n", name, *crc);
@@ -551,7 +500,9 @@ static int task_database_gdi_get_crc(const char *name, uint32_t *crc)
 static bool task_database_chd_get_crc(const char *name, uint32_t *crc)
 {
    int rv;
-   intfstream_t *fd = open_chd_track(name, CHDSTREAM_TRACK_PRIMARY);
+   /* The whole track is read, and scan tasks are exclusive,
+    * so only one image is read this way at a time. */
+   intfstream_t *fd = open_chd_track(name, CHDSTREAM_TRACK_PRIMARY, true);
    if (!fd)
       return 0;
 
@@ -568,8 +519,8 @@ static bool task_database_chd_get_crc(const char *name, uint32_t *crc)
    return rv;
 }
 
-static void task_database_cue_prune(database_info_handle_t *db,
-      const char *name)
+static void task_database_cue_prune(database_state_handle_t *db_state,
+      database_info_handle_t *db, const char *name)
 {
    size_t i;
    char       *path = (char *)malloc(PATH_MAX_LENGTH + 1);
@@ -588,6 +539,7 @@ static void task_database_cue_prune(database_info_handle_t *db,
             RARCH_LOG("Pruning file referenced by cue: %s\n", path);
             free(db->list->elems[i].data);
             db->list->elems[i].data = NULL;
+            database_hasher_skip(db_state->hasher, i);
          }
       }
    }
@@ -601,7 +553,8 @@ end:
    free(path);
 }
 
-static void gdi_prune(database_info_handle_t *db, const char *name)
+static void gdi_prune(database_state_handle_t *db_state,
+      database_info_handle_t *db, const char *name)
 {
    size_t i;
    char       *path = (char *)malloc(PATH_MAX_LENGTH + 1);
@@ -619,6 +572,7 @@ static void gdi_prune(database_info_handle_t *db, const char *name)
             RARCH_LOG("Pruning file referenced by gdi: %s\n", path);
             free(db->list->elems[i].data);
             db->list->elems[i].data = NULL;
+            database_hasher_skip(db_state->hasher, i);
          }
       }
    }
@@ -638,13 +592,13 @@ static int task_database_iterate_playlist(
 #ifdef HAVE_COMPRESSION
          database_info_set_type(db, DATABASE_TYPE_CRC_LOOKUP);
          /* first check crc of archive itself */
-         return intfstream_file_get_crc(name,
+         return database_hash_file_crc(name,
                0, SIZE_MAX, &db_state->archive_crc);
 #else
          break;
 #endif
       case FILE_TYPE_CUE:
-         task_database_cue_prune(db, name);
+         task_database_cue_prune(db_state, db, name);
          db_state->serial[0] = '\0';
          if (task_database_cue_get_serial(name, db_state->serial))
             database_info_set_type(db, DATABASE_TYPE_SERIAL_LOOKUP);
@@ -655,7 +609,7 @@ static int task_database_iterate_playlist(
          }
          break;
       case FILE_TYPE_GDI:
-         gdi_prune(db, name);
+         gdi_prune(db_state, db, name);
          db_state->serial[0] = '\0';
          /* There are no serial databases, so don't bother with
             serials at the moment */
@@ -687,7 +641,8 @@ static int task_database_iterate_playlist(
          break;
       default:
          database_info_set_type(db, DATABASE_TYPE_CRC_LOOKUP);
-         return intfstream_file_get_crc(name, 0, SIZE_MAX, &db_state->crc);
+         return database_hasher_get_crc(db_state->hasher,
+               db->list_ptr, name, &db_state->crc);
    }
 
    return 1;
@@ -761,24 +716,6 @@ static int task_database_iterate_next(database_info_handle_t *db)
    return -1;
 }
 
-static int database_info_list_iterate_new(database_state_handle_t *db_state,
-      const char *query)
-{
-   const char *new_database = database_info_get_current_name(db_state);
-
-#if 0
-   RARCH_LOG("Check database [%d/%d] : %s\n", (unsigned)db_state->list_index,
-         (unsigned)db_state->list->size, new_database);
-#endif
-   if (db_state->info)
-   {
-      database_info_list_free(db_state->info);
-      free(db_state->info);
-   }
-   db_state->info = database_info_list_new(new_database, query);
-   return 0;
-}
-
 static int database_info_list_iterate_found_match(
       db_handle_t *_db,
       database_state_handle_t *db_state,
@@ -881,6 +818,41 @@ static int database_info_list_iterate_next(
    return 1;
 }
 
+static database_info_index_t *task_database_get_index(
+      database_state_handle_t *db_state)
+{
+   size_t i = db_state->list_index;
+
+   if (!db_state->indexes)
+   {
+      db_state->indexes = (database_info_index_t**)
+         calloc(db_state->list->size, sizeof(*db_state->indexes));
+
+      if (!db_state->indexes)
+         return NULL;
+   }
+
+   if (!db_state->indexes[i])
+      db_state->indexes[i] = database_info_index_new(
+            db_state->list->elems[i].data);
+
+   return db_state->indexes[i];
+}
+
+static void task_database_free_indexes(database_state_handle_t *db_state)
+{
+   size_t i;
+
+   if (!db_state->indexes)
+      return;
+
+   for (i = 0; i < db_state->list->size; i++)
+      database_info_index_free(db_state->indexes[i]);
+
+   free(db_state->indexes);
+   db_state->indexes = NULL;
+}
+
 static int task_database_iterate_crc_lookup(
       db_handle_t *_db,
       database_state_handle_t *db_state,
@@ -888,70 +860,40 @@ static int task_database_iterate_crc_lookup(
       const char *name,
       const char *archive_entry)
 {
+   database_info_index_t *idx = NULL;
 
    if (!db_state->list ||
          (unsigned)db_state->list_index == (unsigned)db_state->list->size)
       return database_info_list_iterate_end_no_match(db, db_state, name);
 
-   if (db_state->entry_index == 0)
-   {
-      char query[50];
-
-      query[0] = '\0';
-
-      /* don't scan files that can't be in this database */
-      if (!core_info_database_supports_content_path(
-         db_state->list->elems[db_state->list_index].data, name))
-         return database_info_list_iterate_next(db_state);
-
-      snprintf(query, sizeof(query),
-            "{crc:or(b\"%08X\",b\"%08X\")}",
-            db_state->crc, db_state->archive_crc);
-
-      database_info_list_iterate_new(db_state, query);
-   }
-
-   if (db_state->info)
-   {
-      database_info_t *db_info_entry =
-         &db_state->info->list[db_state->entry_index];
-
-      if (db_info_entry && db_info_entry->crc32)
-      {
-#if 0
-         RARCH_LOG("CRC32: 0x%08X , entry CRC32: 0x%08X (%s).\n",
-               db_state->crc, db_info_entry->crc32, db_info_entry->name);
-#endif
-         if (db_state->archive_crc == db_info_entry->crc32)
-            return database_info_list_iterate_found_match(
-                  _db,
-                  db_state, db, NULL);
-         if (db_state->crc == db_info_entry->crc32)
-            return database_info_list_iterate_found_match(
-                  _db,
-                  db_state, db, archive_entry);
-      }
-   }
+   /* don't scan files that can't be in this database */
+   if (!core_info_database_supports_content_path(
+      db_state->list->elems[db_state->list_index].data, name))
+      return database_info_list_iterate_next(db_state);
 
-   db_state->entry_index++;
+   idx = task_database_get_index(db_state);
 
-   if (db_state->info)
+   if (idx)
    {
-      if (db_state->entry_index >= db_state->info->count)
-         return database_info_list_iterate_next(db_state);
+      db_state->entry_index = 0;
+
+      db_state->info = database_info_index_find_crc(idx,
+            db_state->archive_crc);
+      if (db_state->info)
+         return database_info_list_iterate_found_match(
+               _db,
+               db_state, db, NULL);
+
+      db_state->info = database_info_index_find_crc(idx,
+            db_state->crc);
+      if (db_state->info)
+         return database_info_list_iterate_found_match(
+               _db,
+               db_state, db, archive_entry);
    }
 
-   /* If we haven't reached the end of the database list yet,
-    * continue iterating. */
-   if (db_state->list_index < db_state->list->size)
-      return 1;
-
-   database_info_list_free(db_state->info);
-
-   if (db_state->info)
-      free(db_state->info);
-
-   return 0;
+   /* No match, continue with the next database. */
+   return database_info_list_iterate_next(db_state);
 }
 
 static int task_database_iterate_playlist_archive(
@@ -1023,61 +965,27 @@ static int task_database_iterate_serial_lookup(
       database_state_handle_t *db_state,
       database_info_handle_t *db, const char *name)
 {
+   database_info_index_t *idx = NULL;
+
    if (!db_state->list ||
          (unsigned)db_state->list_index == (unsigned)db_state->list->size)
       return database_info_list_iterate_end_no_match(db, db_state, name);
 
-   if (db_state->entry_index == 0)
-   {
-      char query[50];
-      char *serial_buf =
-         bin_to_hex_alloc((uint8_t*)db_state->serial, strlen(db_state->serial) * sizeof(uint8_t));
-
-      if (!serial_buf)
-         return 1;
-
-      query[0] = '\0';
-
-      snprintf(query, sizeof(query), "{'serial': b'%s'}", serial_buf);
-      database_info_list_iterate_new(db_state, query);
-
-      free(serial_buf);
-   }
+   idx = task_database_get_index(db_state);
 
-   if (db_state->info)
+   if (idx)
    {
-      database_info_t *db_info_entry = &db_state->info->list[
-         db_state->entry_index];
+      db_state->entry_index = 0;
+      db_state->info        = database_info_index_find_serial(idx,
+            db_state->serial);
 
-      if (db_info_entry && db_info_entry->serial)
-      {
-#if 0
-         RARCH_LOG("serial: %s , entry serial: %s (%s).\n",
-                   db_state->serial, db_info_entry->serial,
-                   db_info_entry->name);
-#endif
-         if (string_is_equal(db_state->serial, db_info_entry->serial))
-            return database_info_list_iterate_found_match(_db,
-                  db_state, db, NULL);
-      }
-   }
-
-   db_state->entry_index++;
-
-   if (db_state->info)
-   {
-      if (db_state->entry_index >= db_state->info->count)
-         return database_info_list_iterate_next(db_state);
+      if (db_state->info)
+         return database_info_list_iterate_found_match(_db,
+               db_state, db, NULL);
    }
 
-   /* If we haven't reached the end of the database list yet,
-    * continue iterating. */
-   if (db_state->list_index < db_state->list->size)
-      return 1;
-
-   database_info_list_free(db_state->info);
-   free(db_state->info);
-   return 0;
+   /* No match, continue with the next database. */
+   return database_info_list_iterate_next(db_state);
 }
 
 static int task_database_iterate(
@@ -1210,6 +1118,8 @@ static void task_database_handler(retro_task_t *task)
                }
             }
          }
+         if (dbstate && !dbstate->hasher)
+            dbstate->hasher = database_hasher_new(dbinfo->list);
          dbinfo->status = DATABASE_STATUS_ITERATE_START;
          break;
       case DATABASE_STATUS_ITERATE_START:
@@ -1253,8 +1163,14 @@ task_finished:
 
    if (dbstate)
    {
+      database_hasher_free(dbstate->hasher);
+      dbstate->hasher = NULL;
+
       if (dbstate->list)
+      {
+         task_database_free_indexes(dbstate);
          dir_list_free(dbstate->list);
+      }
    }
 
    if (db)
@@ -1293,6 +1209,8 @@ bool task_push_dbscan(
    t->state                  = db;
    t->callback               = cb;
    t->title                  = strdup(msg_hash_to_str(MSG_PREPARING_FOR_CONTENT_SCAN));
+   t->priority               = TASK_PRIORITY_BACKGROUND;
+   t->exclusive              = TASK_EXCLUSIVE_PLAYLIST;
 
    db->is_directory          = directory;
    db->playlist_directory    = NULL;
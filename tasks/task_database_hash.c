@@ -0,0 +1,437 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *  Copyright (C) 2014-2017 - Jean-André Santoni
+ *  Copyright (C) 2016-2017 - Brad Parker
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <boolean.h>
+#include <file/file_path.h>
+#include <lists/string_list.h>
+#include <encodings/crc32.h>
+#include <streams/file_stream.h>
+
+#ifdef HAVE_CONFIG_H
+#include "../config.h"
+#endif
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#include <features/features_cpu.h>
+#endif
+
+#include "tasks_internal.h"
+
+#include "../msg_hash.h"
+#include "../verbosity.h"
+
+/* Reads are issued in large chunks so the kernel can stream
+ * from disk instead of servicing thousands of 4 KiB requests. */
+#define DATABASE_HASH_BUFFER_SIZE   (1024 * 1024)
+#define DATABASE_HASH_MAX_WORKERS   8
+
+typedef bool (*database_hash_cancelled_t)(void *data);
+
+static bool database_hash_file_crc_internal(const char *path,
+      size_t offset, size_t size, uint32_t *crc,
+      database_hash_cancelled_t cancelled, void *data)
+{
+   uint32_t acc     = 0;
+   uint8_t *buffer  = NULL;
+   RFILE *fd        = filestream_open(path, RFILE_MODE_READ, -1);
+
+   if (!fd)
+      return false;
+
+   if (offset && filestream_seek(fd, offset, SEEK_SET) == -1)
+      goto error;
+
+   buffer = (uint8_t*)malloc(DATABASE_HASH_BUFFER_SIZE);
+
+   if (!buffer)
+      goto error;
+
+   while (size)
+   {
+      ssize_t read;
+      size_t  chunk = size < DATABASE_HASH_BUFFER_SIZE
+         ? size : DATABASE_HASH_BUFFER_SIZE;
+
+      if (cancelled && cancelled(data))
+         goto error;
+
+      read          = filestream_read(fd, buffer, chunk);
+
+      if (read < 0)
+         goto error;
+      if (read == 0)
+         break;
+
+      acc = encoding_crc32(acc, buffer, read);
+
+      if (size != SIZE_MAX)
+         size -= read;
+   }
+
+   *crc = acc;
+
+   free(buffer);
+   filestream_close(fd);
+   return true;
+
+error:
+   free(buffer);
+   filestream_close(fd);
+   return false;
+}
+
+/**
+ * database_hash_file_crc:
+ * @path                : Path to the file.
+ * @offset              : Offset in bytes to start hashing at.
+ * @size                : Amount of bytes to hash, SIZE_MAX hashes
+ *                        until the end of the file.
+ * @crc                 : Receives the CRC32.
+ *
+ * Streams a file region through CRC32 without keeping
+ * more than one read buffer in memory.
+ *
+ * Returns: true (1) if successful, otherwise false (0).
+ **/
+bool database_hash_file_crc(const char *path,
+      size_t offset, size_t size, uint32_t *crc)
+{
+   return database_hash_file_crc_internal(path, offset, size, crc,
+         NULL, NULL);
+}
+
+#ifdef HAVE_THREADS
+enum database_hash_status
+{
+   DATABASE_HASH_PENDING = 0,
+   DATABASE_HASH_BUSY,
+   DATABASE_HASH_DONE,
+   DATABASE_HASH_FAILED,
+   DATABASE_HASH_SKIPPED
+};
+
+typedef struct database_hash_entry
+{
+   char *path;
+   uint32_t crc;
+   enum database_hash_status status;
+} database_hash_entry_t;
+
+struct database_hasher
+{
+   slock_t *lock;
+   scond_t *cond;
+   sthread_t *workers[DATABASE_HASH_MAX_WORKERS];
+   unsigned num_workers;
+   bool quit;
+   /* Next entry a worker should look at. */
+   size_t next;
+   size_t count;
+   database_hash_entry_t *entries;
+};
+
+/* Only files the scanner would hash as a whole are hashed ahead
+ * of time. Archives, disc images and lutro files go through their
+ * own serial or CRC lookups on the scanner thread. */
+static bool database_hasher_wants(const char *path)
+{
+   if (!path || path_contains_compressed_file(path))
+      return false;
+
+   switch (msg_hash_to_file_type(
+            msg_hash_calculate(path_get_extension(path))))
+   {
+      case FILE_TYPE_COMPRESSED:
+      case FILE_TYPE_CUE:
+      case FILE_TYPE_GDI:
+      case FILE_TYPE_ISO:
+      case FILE_TYPE_CHD:
+      case FILE_TYPE_LUTRO:
+         return false;
+      default:
+         break;
+   }
+
+   return true;
+}
+
+struct database_hasher_job
+{
+   database_hasher_t *hasher;
+   database_hash_entry_t *entry;
+};
+
+/* Checked between reads, so that freeing the hasher or
+ * skipping a file does not wait for a large file to be
+ * read to the end. */
+static bool database_hasher_cancelled(void *data)
+{
+   bool cancelled;
+   struct database_hasher_job *job = (struct database_hasher_job*)data;
+
+   slock_lock(job->hasher->lock);
+   cancelled = job->hasher->quit
+      || job->entry->status == DATABASE_HASH_SKIPPED;
+   slock_unlock(job->hasher->lock);
+
+   return cancelled;
+}
+
+static void database_hasher_thread(void *data)
+{
+   database_hasher_t *hasher = (database_hasher_t*)data;
+
+   slock_lock(hasher->lock);
+
+   while (!hasher->quit && hasher->next < hasher->count)
+   {
+      struct database_hasher_job job;
+      uint32_t crc                 = 0;
+      bool ok                      = false;
+      database_hash_entry_t *entry = &hasher->entries[hasher->next++];
+
+      if (entry->status != DATABASE_HASH_PENDING)
+         continue;
+
+      entry->status = DATABASE_HASH_BUSY;
+      slock_unlock(hasher->lock);
+
+      job.hasher    = hasher;
+      job.entry     = entry;
+      ok            = database_hash_file_crc_internal(entry->path,
+            0, SIZE_MAX, &crc, database_hasher_cancelled, &job);
+
+      slock_lock(hasher->lock);
+      if (entry->status == DATABASE_HASH_BUSY)
+      {
+         entry->crc    = crc;
+         entry->status = ok ? DATABASE_HASH_DONE : DATABASE_HASH_FAILED;
+      }
+      scond_broadcast(hasher->cond);
+   }
+
+   slock_unlock(hasher->lock);
+}
+
+/**
+ * database_hasher_new:
+ * @list                : Files that are about to be scanned.
+ *
+ * Starts reader/hasher threads that CRC the files in @list
+ * in scan order, ahead of the scanner.
+ *
+ * Returns: handle, or NULL if threads could not be started.
+ **/
+database_hasher_t *database_hasher_new(const struct string_list *list)
+{
+   size_t i;
+   unsigned cores;
+   database_hasher_t *hasher = NULL;
+
+   if (!list || !list->size)
+      return NULL;
+
+   hasher = (database_hasher_t*)calloc(1, sizeof(*hasher));
+
+   if (!hasher)
+      return NULL;
+
+   hasher->count   = list->size;
+   hasher->entries = (database_hash_entry_t*)
+      calloc(list->size, sizeof(*hasher->entries));
+   hasher->lock    = slock_new();
+   hasher->cond    = scond_new();
+
+   if (!hasher->entries || !hasher->lock || !hasher->cond)
+      goto error;
+
+   /* The scanner prunes and frees list entries while
+    * the workers run, so they get their own copies. */
+   for (i = 0; i < list->size; i++)
+   {
+      database_hash_entry_t *entry = &hasher->entries[i];
+
+      if (database_hasher_wants(list->elems[i].data))
+         entry->path   = strdup(list->elems[i].data);
+
+      if (!entry->path)
+         entry->status = DATABASE_HASH_SKIPPED;
+   }
+
+   cores = cpu_features_get_core_amount();
+
+   if (cores > DATABASE_HASH_MAX_WORKERS)
+      cores = DATABASE_HASH_MAX_WORKERS;
+   if (cores < 1)
+      cores = 1;
+
+   for (i = 0; i < cores; i++)
+   {
+      hasher->workers[i] = sthread_create(database_hasher_thread, hasher);
+
+      if (!hasher->workers[i])
+         break;
+
+      hasher->num_workers++;
+   }
+
+   if (!hasher->num_workers)
+      goto error;
+
+   RARCH_LOG("[Scanner]: Hashing with %u threads.\n", hasher->num_workers);
+
+   return hasher;
+
+error:
+   database_hasher_free(hasher);
+   return NULL;
+}
+
+void database_hasher_free(database_hasher_t *hasher)
+{
+   size_t i;
+
+   if (!hasher)
+      return;
+
+   if (hasher->lock)
+   {
+      slock_lock(hasher->lock);
+      hasher->quit = true;
+      slock_unlock(hasher->lock);
+   }
+
+   for (i = 0; i < hasher->num_workers; i++)
+      sthread_join(hasher->workers[i]);
+
+   if (hasher->entries)
+   {
+      for (i = 0; i < hasher->count; i++)
+         free(hasher->entries[i].path);
+      free(hasher->entries);
+   }
+
+   if (hasher->cond)
+      scond_free(hasher->cond);
+   if (hasher->lock)
+      slock_free(hasher->lock);
+
+   free(hasher);
+}
+
+/**
+ * database_hasher_skip:
+ * @hasher              : Hasher handle, may be NULL.
+ * @index               : Index of the file in the scanned list.
+ *
+ * Drops a file the scanner will not look at, such as a track
+ * a cue or gdi sheet refers to. A worker hashing it right
+ * now stops at its next read.
+ **/
+void database_hasher_skip(database_hasher_t *hasher, size_t index)
+{
+   if (!hasher || index >= hasher->count)
+      return;
+
+   slock_lock(hasher->lock);
+   hasher->entries[index].status = DATABASE_HASH_SKIPPED;
+   slock_unlock(hasher->lock);
+}
+
+/**
+ * database_hasher_get_crc:
+ * @hasher              : Hasher handle, may be NULL.
+ * @index               : Index of @path in the scanned list.
+ * @path                : File to get the CRC of.
+ * @crc                 : Receives the CRC32.
+ *
+ * Picks up the CRC a worker computed for @path, waiting for
+ * it if it is being hashed right now. Files no worker has
+ * claimed yet are hashed on the calling thread.
+ *
+ * Returns: true (1) if successful, otherwise false (0).
+ **/
+bool database_hasher_get_crc(database_hasher_t *hasher,
+      size_t index, const char *path, uint32_t *crc)
+{
+   bool ok                      = false;
+   database_hash_entry_t *entry = NULL;
+
+   if (!hasher || index >= hasher->count)
+      return database_hash_file_crc(path, 0, SIZE_MAX, crc);
+
+   entry = &hasher->entries[index];
+
+   slock_lock(hasher->lock);
+
+   while (entry->status == DATABASE_HASH_BUSY)
+      scond_wait(hasher->cond, hasher->lock);
+
+   switch (entry->status)
+   {
+      case DATABASE_HASH_DONE:
+         *crc = entry->crc;
+         ok   = true;
+         break;
+      case DATABASE_HASH_FAILED:
+         break;
+      case DATABASE_HASH_PENDING:
+         /* Claim it so no worker duplicates the read. */
+         entry->status = DATABASE_HASH_BUSY;
+         slock_unlock(hasher->lock);
+
+         ok            = database_hash_file_crc(path, 0, SIZE_MAX, crc);
+
+         slock_lock(hasher->lock);
+         entry->crc    = *crc;
+         entry->status = ok ? DATABASE_HASH_DONE : DATABASE_HASH_FAILED;
+         scond_broadcast(hasher->cond);
+         break;
+      default:
+         slock_unlock(hasher->lock);
+         return database_hash_file_crc(path, 0, SIZE_MAX, crc);
+   }
+
+   slock_unlock(hasher->lock);
+
+   return ok;
+}
+#else
+database_hasher_t *database_hasher_new(const struct string_list *list)
+{
+   return NULL;
+}
+
+void database_hasher_free(database_hasher_t *hasher)
+{
+}
+
+void database_hasher_skip(database_hasher_t *hasher, size_t index)
+{
+}
+
+bool database_hasher_get_crc(database_hasher_t *hasher,
+      size_t index, const char *path, uint32_t *crc)
+{
+   return database_hash_file_crc(path, 0, SIZE_MAX, crc);
+}
+#endif
@@ -21,6 +21,9 @@
 
 #ifdef _WIN32
 #include <direct.h>
+#ifndef _XBOX
+#include <windows.h>
+#endif
 #else
 #include <unistd.h>
 #endif
@@ -34,6 +37,11 @@
 #include <file/file_path.h>
 #include <retro_miscellaneous.h>
 #include <string/stdstring.h>
+#include <encodings/crc32.h>
+#include <features/features_cpu.h>
+#ifdef HAVE_ZLIB
+#include <streams/trans_stream.h>
+#endif
 
 #ifdef HAVE_CONFIG_H
 #include "../core.h"
@@ -54,6 +62,31 @@
 
 #define SAVE_STATE_CHUNK 4096
 
+/* Compressed savestates start with this magic and the size of
+ * the uncompressed state as a 64-bit little-endian integer,
+ * followed by a zlib stream. Anything else is a raw state. */
+#define SAVE_STATE_ZLIB_MAGIC       "RASTZLIB"
+#define SAVE_STATE_ZLIB_MAGIC_SIZE  8
+#define SAVE_STATE_ZLIB_HEADER_SIZE 16
+/* States are mostly runs and tables, higher levels barely
+ * shrink them further but take several times longer. */
+#define SAVE_STATE_ZLIB_LEVEL       1
+
+/* Autosaves track SRAM in blocks and only rewrite the blocks
+ * that changed. The blocks are first written to a journal next
+ * to the save file, so a crash while patching the save file
+ * in place can be repaired on the next load. */
+#define SRAM_BLOCK_SIZE             4096
+#define SRAM_JOURNAL_EXT            ".journal"
+#define SRAM_TMP_EXT                ".tmp"
+/* Journal layout, all integers 32-bit little-endian:
+ * magic, block size, block count, save file size, then
+ * for each block its index and data, and a CRC32 of
+ * everything before it. */
+#define SRAM_JOURNAL_MAGIC          "RASRAMJ1"
+#define SRAM_JOURNAL_MAGIC_SIZE     8
+#define SRAM_JOURNAL_HEADER_SIZE    20
+
 static struct string_list *task_save_files = NULL;
 
 struct ram_type
@@ -82,10 +115,20 @@ typedef struct
    char path[PATH_MAX_LENGTH];
    void *data;
    void *undo_data;
+   /* zlib stream and file buffer of compressed states */
+   void *zstream;
+   uint8_t *zbuf;
    ssize_t size;
    ssize_t undo_size;
    ssize_t written;
    ssize_t bytes_read;
+   /* Bytes of the file itself, differs from the
+    * state sizes for compressed states */
+   ssize_t file_size;
+   ssize_t file_pos;
+   /* Time the task spent on the main thread */
+   retro_time_t stall_usec;
+   bool compress;
    bool load_to_backup_buffer;
    bool autoload;
    bool autosave;
@@ -106,6 +149,177 @@ static struct save_state_buf undo_save_buf;
  * Can be restored with undo_load_state(). */
 static struct save_state_buf undo_load_buf;
 
+/* Buffer of the last state written to disk, reused by the next
+ * save so large states are not allocated for every save.
+ * Only touched on the main thread. */
+static void *save_state_pool       = NULL;
+static size_t save_state_pool_size = 0;
+
+static void sram_put_le32(uint8_t *data, uint32_t val)
+{
+   data[0] = val;
+   data[1] = val >> 8;
+   data[2] = val >> 16;
+   data[3] = val >> 24;
+}
+
+static uint32_t sram_get_le32(const uint8_t *data)
+{
+   return data[0] | (data[1] << 8) | (data[2] << 16)
+      | ((uint32_t)data[3] << 24);
+}
+
+static void sram_aux_path(char *s, size_t len,
+      const char *path, const char *ext)
+{
+   strlcpy(s, path, len);
+   strlcat(s, ext, len);
+}
+
+/**
+ * sram_journal_check:
+ * @journal         : journal contents.
+ * @size            : size of @journal.
+ *
+ * Checks that a journal was written completely.
+ *
+ * Returns: true if every block in @journal can be applied.
+ **/
+static bool sram_journal_check(const uint8_t *journal, size_t size)
+{
+   uint32_t i, block_size, count, file_size;
+   size_t pos = SRAM_JOURNAL_HEADER_SIZE;
+
+   if (size < SRAM_JOURNAL_HEADER_SIZE + 4
+         || memcmp(journal, SRAM_JOURNAL_MAGIC, SRAM_JOURNAL_MAGIC_SIZE))
+      return false;
+
+   if (sram_get_le32(journal + size - 4)
+         != encoding_crc32(0, journal, size - 4))
+      return false;
+
+   block_size = sram_get_le32(journal + 8);
+   count      = sram_get_le32(journal + 12);
+   file_size  = sram_get_le32(journal + 16);
+
+   if (!block_size)
+      return false;
+
+   for (i = 0; i < count; i++)
+   {
+      uint32_t idx;
+
+      if (pos + 4 > size - 4)
+         return false;
+
+      idx = sram_get_le32(journal + pos);
+      if ((uint64_t)idx * block_size >= file_size)
+         return false;
+
+      pos += 4 + MIN(block_size, file_size - idx * block_size);
+      if (pos > size - 4)
+         return false;
+   }
+
+   return pos == size - 4;
+}
+
+/**
+ * sram_journal_apply:
+ * @path            : path of the save file.
+ * @journal         : journal contents, see sram_journal_check.
+ *
+ * Writes the blocks of @journal into the save file in place
+ * and waits until they reach the disk.
+ *
+ * Returns: true if successful, otherwise false.
+ **/
+static bool sram_journal_apply(const char *path, const uint8_t *journal)
+{
+   uint32_t i;
+   bool failed         = false;
+   size_t pos          = SRAM_JOURNAL_HEADER_SIZE;
+   uint32_t block_size = sram_get_le32(journal + 8);
+   uint32_t count      = sram_get_le32(journal + 12);
+   uint32_t file_size  = sram_get_le32(journal + 16);
+   RFILE *file         = filestream_open(path,
+         RFILE_MODE_READ_WRITE | RFILE_HINT_UNBUFFERED, -1);
+
+   if (!file)
+      return false;
+
+   for (i = 0; i < count && !failed; i++)
+   {
+      uint32_t idx = sram_get_le32(journal + pos);
+      size_t len   = MIN(block_size, file_size - idx * block_size);
+
+      failed |= (filestream_seek(file,
+               (ssize_t)idx * block_size, SEEK_SET) != 0);
+      failed |= ((size_t)filestream_write(file,
+               journal + pos + 4, len) != len);
+      pos    += 4 + len;
+   }
+
+   failed |= (filestream_sync(file) != 0);
+   failed |= (filestream_close(file) != 0);
+
+   return !failed;
+}
+
+/**
+ * sram_recover_file:
+ * @path            : path of the save file.
+ *
+ * Finishes an autosave that was interrupted by a crash, before
+ * the save file is loaded. A complete journal is written into
+ * the save file again, an incomplete one is dropped since the
+ * save file was not touched yet.
+ **/
+static void sram_recover_file(const char *path)
+{
+   char aux_path[PATH_MAX_LENGTH];
+
+   sram_aux_path(aux_path, sizeof(aux_path), path, SRAM_JOURNAL_EXT);
+
+   if (path_is_valid(aux_path))
+   {
+      void *buf   = NULL;
+      ssize_t len = 0;
+      bool keep   = false;
+
+      if (filestream_read_file(aux_path, &buf, &len)
+            && sram_journal_check((const uint8_t*)buf, len))
+      {
+         if (sram_journal_apply(path, (const uint8_t*)buf))
+            RARCH_LOG("[SRAM]: Replayed autosave journal \"%s\".\n",
+                  aux_path);
+         else
+         {
+            RARCH_WARN("[SRAM]: Could not replay autosave journal \"%s\".\n",
+                  aux_path);
+            keep = true;
+         }
+      }
+
+      if (buf)
+         free(buf);
+      if (!keep)
+         path_file_remove(aux_path);
+   }
+
+   sram_aux_path(aux_path, sizeof(aux_path), path, SRAM_TMP_EXT);
+
+   /* Only left behind when the save file is complete, unless
+    * the platform cannot replace a file by renaming over it. */
+   if (path_is_valid(aux_path))
+   {
+      if (path_is_valid(path))
+         path_file_remove(aux_path);
+      else
+         path_file_rename(aux_path, path);
+   }
+}
+
 #ifdef HAVE_THREADS
 typedef struct autosave autosave_t;
 
@@ -119,8 +333,12 @@ struct autosave_st
 struct autosave
 {
    volatile bool quit;
+   bool rewrite;
    size_t bufsize;
    unsigned interval;
+   unsigned num_blocks;
+   uint32_t *hashes;
+   unsigned *dirty;
    void *buffer;
    const void *retro_buffer;
    const char *path;
@@ -132,6 +350,126 @@ struct autosave
 
 static struct autosave_st autosave_state;
 
+/**
+ * autosave_write_file:
+ * @save            : pointer to autosave object
+ *
+ * Writes the whole SRAM copy to a temporary file and renames
+ * it over the save file.
+ *
+ * Returns: true if successful, otherwise false.
+ **/
+static bool autosave_write_file(autosave_t *save)
+{
+   char aux_path[PATH_MAX_LENGTH];
+   bool failed = false;
+   RFILE *file = NULL;
+
+   sram_aux_path(aux_path, sizeof(aux_path), save->path, SRAM_TMP_EXT);
+
+   file        = filestream_open(aux_path, RFILE_MODE_WRITE, -1);
+   if (!file)
+      return false;
+
+   failed |= ((size_t)filestream_write(file, save->buffer, save->bufsize) != save->bufsize);
+   failed |= (filestream_sync(file) != 0);
+   failed |= (filestream_close(file) != 0);
+
+#if defined(_WIN32) && !defined(_XBOX)
+   /* rename does not replace existing files here, and removing
+    * the save file first would lose it on a crash in between. */
+   if (!failed)
+      failed = !MoveFileExA(aux_path, save->path,
+            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+#ifdef _WIN32
+   if (!failed)
+      path_file_remove(save->path);
+#endif
+   if (!failed)
+      failed = !path_file_rename(aux_path, save->path);
+#endif
+
+   if (failed)
+   {
+      path_file_remove(aux_path);
+      return false;
+   }
+
+   /* A journal left by a failed block write is older than
+    * the file now. */
+   sram_aux_path(aux_path, sizeof(aux_path), save->path, SRAM_JOURNAL_EXT);
+   if (path_is_valid(aux_path))
+      path_file_remove(aux_path);
+
+   return true;
+}
+
+/**
+ * autosave_write_blocks:
+ * @save            : pointer to autosave object
+ * @count           : number of blocks in save->dirty.
+ *
+ * Writes the changed blocks to the journal, then into the
+ * save file in place.
+ *
+ * Returns: true if successful, otherwise false.
+ **/
+static bool autosave_write_blocks(autosave_t *save, unsigned count)
+{
+   unsigned i;
+   char aux_path[PATH_MAX_LENGTH];
+   bool failed      = false;
+   size_t pos       = SRAM_JOURNAL_HEADER_SIZE;
+   RFILE *file      = NULL;
+   uint8_t *journal = (uint8_t*)malloc(SRAM_JOURNAL_HEADER_SIZE
+         + count * (4 + SRAM_BLOCK_SIZE) + 4);
+
+   if (!journal)
+      return false;
+
+   memcpy(journal, SRAM_JOURNAL_MAGIC, SRAM_JOURNAL_MAGIC_SIZE);
+   sram_put_le32(journal + 8,  SRAM_BLOCK_SIZE);
+   sram_put_le32(journal + 12, count);
+   sram_put_le32(journal + 16, (uint32_t)save->bufsize);
+
+   for (i = 0; i < count; i++)
+   {
+      size_t offset = (size_t)save->dirty[i] * SRAM_BLOCK_SIZE;
+      size_t len    = MIN(SRAM_BLOCK_SIZE, save->bufsize - offset);
+
+      sram_put_le32(journal + pos, save->dirty[i]);
+      memcpy(journal + pos + 4, (const uint8_t*)save->buffer + offset, len);
+      pos          += 4 + len;
+   }
+
+   sram_put_le32(journal + pos, encoding_crc32(0, journal, pos));
+   pos += 4;
+
+   sram_aux_path(aux_path, sizeof(aux_path), save->path, SRAM_JOURNAL_EXT);
+
+   file = filestream_open(aux_path, RFILE_MODE_WRITE, -1);
+   if (!file)
+   {
+      free(journal);
+      return false;
+   }
+
+   failed |= ((size_t)filestream_write(file, journal, pos) != pos);
+   failed |= (filestream_sync(file) != 0);
+   failed |= (filestream_close(file) != 0);
+
+   /* The journal is replayed on the next load if the
+    * save file cannot be patched now. */
+   if (!failed)
+      failed = !sram_journal_apply(save->path, journal);
+   if (!failed)
+      path_file_remove(aux_path);
+
+   free(journal);
+   return !failed;
+}
+
 /**
  * autosave_thread:
  * @data            : pointer to autosave object
@@ -145,40 +483,57 @@ static void autosave_thread(void *data)
 
    while (!save->quit)
    {
-      bool differ;
+      unsigned i;
+      unsigned dirty = 0;
 
+      /* The core waits on this lock to run the next frame,
+       * so only copy under it and compare afterwards. */
       slock_lock(save->lock);
-      differ = string_is_not_equal_fast(save->buffer, save->retro_buffer,
-            save->bufsize);
-      if (differ)
-         memcpy(save->buffer, save->retro_buffer, save->bufsize);
+      memcpy(save->buffer, save->retro_buffer, save->bufsize);
       slock_unlock(save->lock);
 
-      if (differ)
+      for (i = 0; i < save->num_blocks; i++)
+      {
+         size_t offset = (size_t)i * SRAM_BLOCK_SIZE;
+         uint32_t hash = encoding_crc32(0,
+               (const uint8_t*)save->buffer + offset,
+               MIN(SRAM_BLOCK_SIZE, save->bufsize - offset));
+
+         if (hash != save->hashes[i])
+         {
+            save->hashes[i]     = hash;
+            save->dirty[dirty++] = i;
+         }
+      }
+
+      if (dirty || save->rewrite)
       {
-         /* Should probably deal with this more elegantly. */
-         RFILE *file = filestream_open(save->path, RFILE_MODE_WRITE, -1);
+         bool written = false;
 
-         if (file)
+         /* Avoid spamming down stderr ... */
+         if (first_log)
          {
-            bool failed = false;
-
-            /* Avoid spamming down stderr ... */
-            if (first_log)
-            {
-               RARCH_LOG("Autosaving SRAM to \"%s\", will continue to check every %u seconds ...\n",
-                     save->path, save->interval);
-               first_log = false;
-            }
-            else
-               RARCH_LOG("SRAM changed ... autosaving ...\n");
-
-            failed |= ((size_t)filestream_write(file, save->buffer, save->bufsize) != save->bufsize);
-            failed |= (filestream_flush(file) != 0);
-            failed |= (filestream_close(file) != 0);
-            if (failed)
-               RARCH_WARN("Failed to autosave SRAM. Disk might be full.\n");
+            RARCH_LOG("Autosaving SRAM to \"%s\", will continue to check every %u seconds ...\n",
+                  save->path, save->interval);
+            first_log = false;
          }
+         else
+            RARCH_LOG("SRAM changed ... autosaving %u of %u blocks ...\n",
+                  dirty, save->num_blocks);
+
+         /* Patching in place only pays off for a few blocks,
+          * and needs a save file of the right size. */
+         if (!save->rewrite && dirty * 2 <= save->num_blocks
+               && path_get_size(save->path) == (int32_t)save->bufsize)
+            written = autosave_write_blocks(save, dirty);
+         else
+            written = autosave_write_file(save);
+
+         /* The hashes already match the failed copy, rewrite
+          * all of it next time. */
+         save->rewrite = !written;
+         if (!written)
+            RARCH_WARN("Failed to autosave SRAM. Disk might be full.\n");
       }
 
       slock_lock(save->cond_lock);
@@ -210,22 +565,39 @@ static autosave_t *autosave_new(const char *path,
       const void *data, size_t size,
       unsigned interval)
 {
-   autosave_t *handle            = (autosave_t*)malloc(sizeof(*handle));
+   unsigned i;
+   autosave_t *handle            = (autosave_t*)calloc(1, sizeof(*handle));
    if (!handle)
       goto error;
 
    handle->quit                  = false;
+   handle->rewrite               = false;
    handle->bufsize               = size;
    handle->interval              = interval;
+   handle->num_blocks            = (unsigned)((size + SRAM_BLOCK_SIZE - 1)
+         / SRAM_BLOCK_SIZE);
+   handle->hashes                = (uint32_t*)malloc(
+         handle->num_blocks * sizeof(*handle->hashes));
+   handle->dirty                 = (unsigned*)malloc(
+         handle->num_blocks * sizeof(*handle->dirty));
    handle->buffer                = malloc(size);
    handle->retro_buffer          = data;
    handle->path                  = path;
 
-   if (!handle->buffer)
+   if (!handle->buffer || !handle->hashes || !handle->dirty)
       goto error;
 
    memcpy(handle->buffer, handle->retro_buffer, handle->bufsize);
 
+   /* SRAM was just loaded from the save file. */
+   for (i = 0; i < handle->num_blocks; i++)
+   {
+      size_t offset      = (size_t)i * SRAM_BLOCK_SIZE;
+      handle->hashes[i]  = encoding_crc32(0,
+            (const uint8_t*)handle->buffer + offset,
+            MIN(SRAM_BLOCK_SIZE, size - offset));
+   }
+
    handle->lock                  = slock_new();
    handle->cond_lock             = slock_new();
    handle->cond                  = scond_new();
@@ -235,7 +607,12 @@ static autosave_t *autosave_new(const char *path,
 
 error:
    if (handle)
+   {
+      free(handle->hashes);
+      free(handle->dirty);
+      free(handle->buffer);
       free(handle);
+   }
    return NULL;
 }
 
@@ -260,6 +637,11 @@ static void autosave_free(autosave_t *handle)
    if (handle->buffer)
       free(handle->buffer);
    handle->buffer = NULL;
+
+   free(handle->hashes);
+   free(handle->dirty);
+   handle->hashes = NULL;
+   handle->dirty  = NULL;
 }
 
 
@@ -515,6 +897,166 @@ static void undo_save_state_cb(void *task_data,
    }
 }
 
+static void *save_state_pool_get(size_t size)
+{
+   void *data = NULL;
+
+   if (save_state_pool && save_state_pool_size == size)
+   {
+      data            = save_state_pool;
+      save_state_pool = NULL;
+      return data;
+   }
+
+   return malloc(size);
+}
+
+static void save_state_pool_put(void *data, size_t size)
+{
+   if (!data)
+      return;
+
+   if (save_state_pool)
+      free(save_state_pool);
+
+   save_state_pool      = data;
+   save_state_pool_size = size;
+}
+
+#ifdef HAVE_ZLIB
+static bool task_save_compress_init(save_task_state_t *state)
+{
+   unsigned i;
+   uint8_t header[SAVE_STATE_ZLIB_HEADER_SIZE];
+   uint64_t size = (uint64_t)state->size;
+
+   memcpy(header, SAVE_STATE_ZLIB_MAGIC, SAVE_STATE_ZLIB_MAGIC_SIZE);
+   for (i = 0; i < 8; i++)
+      header[SAVE_STATE_ZLIB_MAGIC_SIZE + i] = (uint8_t)(size >> (i * 8));
+
+   if (filestream_write(state->file, header, sizeof(header))
+         != sizeof(header))
+      return false;
+
+   state->file_size = sizeof(header);
+   state->zstream   = zlib_deflate_backend.stream_new();
+   state->zbuf      = (uint8_t*)malloc(SAVE_STATE_CHUNK);
+
+   if (!state->zstream || !state->zbuf)
+      return false;
+
+   zlib_deflate_backend.define(state->zstream, "level",
+         SAVE_STATE_ZLIB_LEVEL);
+
+   return true;
+}
+
+/* Compresses @size bytes of the state and writes them out,
+ * finishing the zlib stream on the last chunk. */
+static bool task_save_write_compressed(save_task_state_t *state,
+      const uint8_t *data, uint32_t size, bool flush)
+{
+   enum trans_stream_error error = TRANS_STREAM_ERROR_NONE;
+
+   zlib_deflate_backend.set_in(state->zstream, data, size);
+
+   do
+   {
+      uint32_t rd = 0;
+      uint32_t wn = 0;
+
+      zlib_deflate_backend.set_out(state->zstream,
+            state->zbuf, SAVE_STATE_CHUNK);
+
+      if (!zlib_deflate_backend.trans(state->zstream, flush,
+               &rd, &wn, &error)
+            && error != TRANS_STREAM_ERROR_BUFFER_FULL)
+         return false;
+
+      if (wn && filestream_write(state->file, state->zbuf, wn) != wn)
+         return false;
+
+      state->file_size += wn;
+   } while (flush
+         ? error != TRANS_STREAM_ERROR_NONE
+         : error == TRANS_STREAM_ERROR_BUFFER_FULL);
+
+   return true;
+}
+
+/* Reads the header of compressed states. Raw states are
+ * left as they are, to be read in one piece. */
+static bool task_load_compressed_init(save_task_state_t *state)
+{
+   unsigned i;
+   uint8_t header[SAVE_STATE_ZLIB_HEADER_SIZE];
+   uint64_t size = 0;
+
+   if (state->file_size < SAVE_STATE_ZLIB_HEADER_SIZE)
+      return true;
+
+   if (filestream_read(state->file, header, sizeof(header))
+         != sizeof(header))
+      return false;
+
+   if (memcmp(header, SAVE_STATE_ZLIB_MAGIC, SAVE_STATE_ZLIB_MAGIC_SIZE))
+   {
+      filestream_rewind(state->file);
+      return true;
+   }
+
+   for (i = 0; i < 8; i++)
+      size |= (uint64_t)header[SAVE_STATE_ZLIB_MAGIC_SIZE + i] << (i * 8);
+
+   state->size     = (ssize_t)size;
+   state->file_pos = sizeof(header);
+   state->zstream  = zlib_inflate_backend.stream_new();
+   state->zbuf     = (uint8_t*)malloc(SAVE_STATE_CHUNK);
+
+   return state->zstream && state->zbuf && size;
+}
+
+/* Inflates the next @size bytes of the file straight into
+ * the state buffer. */
+static bool task_load_read_compressed(save_task_state_t *state,
+      uint32_t size)
+{
+   uint32_t rd                   = 0;
+   uint32_t wn                   = 0;
+   enum trans_stream_error error = TRANS_STREAM_ERROR_NONE;
+
+   zlib_inflate_backend.set_in(state->zstream, state->zbuf, size);
+   zlib_inflate_backend.set_out(state->zstream,
+         (uint8_t*)state->data + state->bytes_read,
+         (uint32_t)(state->size - state->bytes_read));
+
+   if (!zlib_inflate_backend.trans(state->zstream, false,
+            &rd, &wn, &error))
+      return false;
+
+   state->bytes_read += wn;
+
+   /* Either all input was used or the state is complete. */
+   return rd == size || error == TRANS_STREAM_ERROR_NONE;
+}
+#endif
+
+static void task_save_free_zstream(save_task_state_t *state, bool load)
+{
+#ifdef HAVE_ZLIB
+   if (state->zstream)
+   {
+      if (load)
+         zlib_inflate_backend.stream_free(state->zstream);
+      else
+         zlib_deflate_backend.stream_free(state->zstream);
+      state->zstream = NULL;
+   }
+#endif
+   free(state->zbuf);
+   state->zbuf = NULL;
+}
+
 /**
  * task_save_handler_finished:
  * @task : the task to finish
@@ -530,6 +1072,7 @@ static void task_save_handler_finished(retro_task_t *task,
    task_set_finished(task, true);
 
    filestream_close(state->file);
+   task_save_free_zstream(state, false);
 
    if (!task_get_error(task) && task_get_cancelled(task))
       task_set_error(task, strdup("Task canceled"));
@@ -539,12 +1082,14 @@ static void task_save_handler_finished(retro_task_t *task,
 
    task_set_data(task, task_data);
 
-   if (state->data)
+   /* Saved states go back to the pool in save_state_cb,
+    * on the main thread. */
+   if (state->undo_save && state->data)
    {
-      if (state->undo_save && state->data == undo_save_buf.data)
+      if (state->data == undo_save_buf.data)
          undo_save_buf.data = NULL;
       free(state->data);
-      state->data = NULL;
+      task_data->data = NULL;
    }
 
    free(state);
@@ -561,6 +1106,8 @@ static void task_save_handler(retro_task_t *task)
    int written;
    ssize_t remaining;
    save_task_state_t *state = (save_task_state_t*)task->state;
+   bool threaded            = task_queue_is_threaded();
+   retro_time_t start       = threaded ? 0 : cpu_features_get_time_usec();
 
    if (!state->file)
    {
@@ -568,14 +1115,33 @@ static void task_save_handler(retro_task_t *task)
 
       if (!state->file)
          return;
+
+#ifdef HAVE_ZLIB
+      if (state->compress && !task_save_compress_init(state))
+      {
+         /* Write the state as it is rather than not at all. */
+         task_save_free_zstream(state, false);
+         filestream_rewind(state->file);
+      }
+#endif
    }
 
    remaining       = MIN(state->size - state->written, SAVE_STATE_CHUNK);
-   written         = (int)filestream_write(state->file,
-         (uint8_t*)state->data + state->written, remaining);
+#ifdef HAVE_ZLIB
+   if (state->zstream)
+      written      = task_save_write_compressed(state,
+            (const uint8_t*)state->data + state->written, (uint32_t)remaining,
+            state->written + remaining == state->size) ? (int)remaining : -1;
+   else
+#endif
+      written      = (int)filestream_write(state->file,
+            (uint8_t*)state->data + state->written, remaining);
 
    state->written += written;
 
+   if (!threaded)
+      state->stall_usec += cpu_features_get_time_usec() - start;
+
    task_set_progress(task, (state->written / (float)state->size) * 100);
 
    if (task_get_cancelled(task) || written != remaining)
@@ -608,6 +1174,13 @@ static void task_save_handler(retro_task_t *task)
 
       task_free_title(task);
 
+      if (state->zstream)
+         RARCH_LOG("[State]: Compressed %u bytes to %u.\n",
+               (unsigned)state->size, (unsigned)state->file_size);
+      if (state->stall_usec)
+         RARCH_LOG("[State]: Writing took %u usec on the main thread.\n",
+               (unsigned)state->stall_usec);
+
       if (state->undo_save)
          msg = strdup(msg_hash_to_str(MSG_RESTORED_OLD_SAVE_STATE));
       else if (state->state_slot < 0)
@@ -658,12 +1231,14 @@ static bool task_push_undo_save_state(const char *path, void *data, size_t size)
    state->data                   = data;
    state->size                   = size;
    state->undo_save              = true;
+   state->compress               = settings->bools.savestate_file_compression;
    state->state_slot             = settings->ints.state_slot;
    state->has_valid_framebuffer  = video_driver_cached_frame_has_valid_framebuffer();
 
    task->type                    = TASK_TYPE_BLOCKING;
    task->state                   = state;
    task->handler                 = task_save_handler;
+   task->exclusive               = TASK_EXCLUSIVE_SAVE;
    task->callback                = undo_save_state_cb;
    task->title                   = strdup(msg_hash_to_str(MSG_UNDOING_SAVE_STATE));
 
@@ -711,6 +1286,7 @@ static void task_load_handler_finished(retro_task_t *task,
 
    if (state->file)
       filestream_close(state->file);
+   task_save_free_zstream(state, true);
 
    if (!task_get_error(task) && task_get_cancelled(task))
       task_set_error(task, strdup("Task canceled"));
@@ -732,6 +1308,8 @@ static void task_load_handler_finished(retro_task_t *task,
 static void task_load_handler(retro_task_t *task)
 {
    ssize_t remaining, bytes_read;
+   bool failed              = false;
+   bool done                = false;
    save_task_state_t *state = (save_task_state_t*)task->state;
 
    if (!state->file)
@@ -751,21 +1329,57 @@ static void task_load_handler(retro_task_t *task)
 
       filestream_rewind(state->file);
 
+      state->file_size = state->size;
+
+#ifdef HAVE_ZLIB
+      /* Compressed states are inflated as they are read,
+       * state->size becomes the size of the state. */
+      if (!task_load_compressed_init(state))
+         goto error;
+#endif
+
       state->data = malloc(state->size + 1);
 
       if (!state->data)
          goto error;
    }
 
-   remaining          = MIN(state->size - state->bytes_read, SAVE_STATE_CHUNK);
-   bytes_read         = filestream_read(state->file,
-         (uint8_t*)state->data + state->bytes_read, remaining);
-   state->bytes_read += bytes_read;
-
-   if (state->size > 0)
-      task_set_progress(task, (state->bytes_read / (float)state->size) * 100);
+#ifdef HAVE_ZLIB
+   if (state->zstream)
+   {
+      remaining        = MIN(state->file_size - state->file_pos,
+            SAVE_STATE_CHUNK);
+      bytes_read       = filestream_read(state->file,
+            state->zbuf, remaining);
+      failed           = bytes_read != remaining
+         || !task_load_read_compressed(state, (uint32_t)bytes_read);
+      state->file_pos += bytes_read;
+      done             = state->file_pos == state->file_size;
+
+      if (done && state->bytes_read != state->size)
+         failed        = true;
+
+      if (state->file_size > 0)
+         task_set_progress(task,
+               (state->file_pos / (float)state->file_size) * 100);
+   }
+   else
+#endif
+   {
+      remaining          = MIN(state->size - state->bytes_read,
+            SAVE_STATE_CHUNK);
+      bytes_read         = filestream_read(state->file,
+            (uint8_t*)state->data + state->bytes_read, remaining);
+      state->bytes_read += bytes_read;
+      failed             = bytes_read != remaining;
+      done               = state->bytes_read == state->size;
+
+      if (state->size > 0)
+         task_set_progress(task,
+               (state->bytes_read / (float)state->size) * 100);
+   }
 
-   if (task_get_cancelled(task) || bytes_read != remaining)
+   if (task_get_cancelled(task) || failed)
    {
       if (state->autoload)
       {
@@ -791,7 +1405,7 @@ static void task_load_handler(retro_task_t *task)
       return;
    }
 
-   if (state->bytes_read == state->size)
+   if (done)
    {
       char *msg = (char*)malloc(1024 * sizeof(char));
 
@@ -1001,7 +1615,10 @@ static void save_state_cb(void *task_data,
    if (state->thumbnail_enable)
       take_screenshot(path, true, state->has_valid_framebuffer);
 
+   save_state_pool_put(state->data, state->size);
+
    free(path);
+   free(state);
 }
 
 /**
@@ -1026,6 +1643,7 @@ static void task_push_save_state(const char *path, void *data, size_t size, bool
    state->size             = size;
    state->autosave         = autosave;
    state->mute             = autosave; /* don't show OSD messages if we are auto-saving */
+   state->compress         = settings->bools.savestate_file_compression;
    state->thumbnail_enable = settings->bools.savestate_thumbnail_enable;
    state->state_slot       = settings->ints.state_slot;
    state->has_valid_framebuffer  = video_driver_cached_frame_has_valid_framebuffer();
@@ -1033,6 +1651,7 @@ static void task_push_save_state(const char *path, void *data, size_t size, bool
    task->type              = TASK_TYPE_BLOCKING;
    task->state             = state;
    task->handler           = task_save_handler;
+   task->exclusive         = TASK_EXCLUSIVE_SAVE;
    task->callback          = save_state_cb;
    task->title             = strdup(msg_hash_to_str(MSG_SAVING_STATE));
    task->mute              = state->mute;
@@ -1106,6 +1725,7 @@ static void task_push_load_and_save_state(const char *path, void *data,
    task->state       = state;
    task->type        = TASK_TYPE_BLOCKING;
    task->handler     = task_load_handler;
+   task->exclusive   = TASK_EXCLUSIVE_SAVE;
    task->callback    = content_load_and_save_state_cb;
    task->title       = strdup(msg_hash_to_str(MSG_LOADING_STATE));
    task->mute        = state->mute;
@@ -1135,8 +1755,9 @@ bool content_save_state(const char *path, bool save_to_disk, bool autosave)
 {
    retro_ctx_serialize_info_t serial_info;
    retro_ctx_size_info_t info;
-   bool ret    = false;
-   void *data  = NULL;
+   bool ret           = false;
+   void *data         = NULL;
+   retro_time_t start = cpu_features_get_time_usec();
 
    core_serialize_size(&info);
 
@@ -1147,7 +1768,7 @@ bool content_save_state(const char *path, bool save_to_disk, bool autosave)
    if (info.size == 0)
       return false;
 
-   data = malloc(info.size);
+   data = save_state_pool_get(info.size);
 
    if (!data)
       return false;
@@ -1161,6 +1782,10 @@ bool content_save_state(const char *path, bool save_to_disk, bool autosave)
    serial_info.size = info.size;
    ret              = core_serialize(&serial_info);
 
+   /* The rest is left to the save task. */
+   RARCH_LOG("[State]: Serializing took %u usec on the main thread.\n",
+         (unsigned)(cpu_features_get_time_usec() - start));
+
    if (ret)
    {
       if (save_to_disk)
@@ -1183,29 +1808,19 @@ bool content_save_state(const char *path, bool save_to_disk, bool autosave)
          /* save_to_disk is false, which means we are saving the state
          in undo_load_buf to allow content_undo_load_state() to restore it */
 
-         /* If we were holding onto an old state already, clean it up first */
+         /* If we were holding onto an old state already, it is
+          * the right size to serialize into next time */
          if (undo_load_buf.data)
-         {
-            free(undo_load_buf.data);
-            undo_load_buf.data = NULL;
-         }
-
-         undo_load_buf.data = malloc(info.size);
-         if (!undo_load_buf.data)
-         {
-            free(data);
-            return false;
-         }
+            save_state_pool_put(undo_load_buf.data, undo_load_buf.size);
 
-         memcpy(undo_load_buf.data, data, info.size);
-         free(data);
+         undo_load_buf.data = data;
          undo_load_buf.size = info.size;
          strlcpy(undo_load_buf.path, path, sizeof(undo_load_buf.path));
       }
    }
    else
    {
-      free(data);
+      save_state_pool_put(data, info.size);
       RARCH_ERR("%s \"%s\".\n",
             msg_hash_to_str(MSG_FAILED_TO_SAVE_STATE_TO),
             path);
@@ -1243,6 +1858,7 @@ bool content_load_state(const char *path,
    task->type                   = TASK_TYPE_BLOCKING;
    task->state                  = state;
    task->handler                = task_load_handler;
+   task->exclusive              = TASK_EXCLUSIVE_SAVE;
    task->callback               = content_load_state_cb;
    task->title                  = strdup(msg_hash_to_str(MSG_LOADING_STATE));
 
@@ -1299,6 +1915,14 @@ bool content_reset_savestate_backups(void)
    undo_load_buf.path[0] = '\0';
    undo_load_buf.size    = 0;
 
+   if (save_state_pool)
+   {
+      free(save_state_pool);
+      save_state_pool = NULL;
+   }
+
+   save_state_pool_size  = 0;
+
    return true;
 }
 
@@ -1345,6 +1969,8 @@ bool content_load_ram_file(unsigned slot)
    if (!content_get_memory(&mem_info, &ram, slot))
       return false;
 
+   sram_recover_file(ram.path);
+
    if (!filestream_read_file(ram.path, &buf, &rc))
       return false;
 
@@ -1431,6 +2057,7 @@ error:
  */
 bool content_save_ram_file(unsigned slot)
 {
+   char aux_path[PATH_MAX_LENGTH];
    struct ram_type ram;
    retro_ctx_memory_info_t mem_info;
 
@@ -1461,6 +2088,13 @@ bool content_save_ram_file(unsigned slot)
       return false;
    }
 
+   /* A journal kept because it could not be replayed is
+    * older than the file now, replaying it on the next load
+    * would undo this save. */
+   sram_aux_path(aux_path, sizeof(aux_path), ram.path, SRAM_JOURNAL_EXT);
+   if (path_is_valid(aux_path))
+      path_file_remove(aux_path);
+
    RARCH_LOG("%s \"%s\".\n",
          msg_hash_to_str(MSG_SAVED_SUCCESSFULLY_TO),
          ram.path);
@@ -263,6 +263,8 @@ static bool screenshot_dump(
    task->type        = TASK_TYPE_BLOCKING;
    task->state       = state;
    task->handler     = task_screenshot_handler;
+   /* Pushes to the image history. */
+   task->exclusive   = TASK_EXCLUSIVE_PLAYLIST;
 
    if (!savestate)
       task->title    = strdup(msg_hash_to_str(MSG_TAKING_SCREENSHOT));
@@ -44,6 +44,19 @@ typedef struct nbio_buf
    unsigned bufsize;
 } nbio_buf_t;
 
+/* Exclusive classes of tasks sharing global state, see
+ * retro_task::exclusive. */
+enum task_exclusive_class
+{
+   TASK_EXCLUSIVE_NONE = 0,
+   /* Save states, SRAM and their undo buffers. */
+   TASK_EXCLUSIVE_SAVE,
+   /* Playlists written from a task handler. */
+   TASK_EXCLUSIVE_PLAYLIST,
+   /* Input autoconfiguration and its per-port state. */
+   TASK_EXCLUSIVE_INPUT
+};
+
 enum content_mode_load
 {
    CONTENT_MODE_LOAD_NONE = 0,
@@ -129,6 +142,22 @@ bool task_push_dbscan(
       const char *content_database,
       const char *fullpath,
       bool directory, retro_task_callback_t cb);
+
+struct string_list;
+
+typedef struct database_hasher database_hasher_t;
+
+bool database_hash_file_crc(const char *path,
+      size_t offset, size_t size, uint32_t *crc);
+
+database_hasher_t *database_hasher_new(const struct string_list *list);
+
+void database_hasher_free(database_hasher_t *hasher);
+
+void database_hasher_skip(database_hasher_t *hasher, size_t index);
+
+bool database_hasher_get_crc(database_hasher_t *hasher,
+      size_t index, const char *path, uint32_t *crc);
 #endif
 
 #ifdef HAVE_OVERLAY
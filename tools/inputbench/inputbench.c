@@ -0,0 +1,440 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libretro.h>
+#include <features/features_cpu.h>
+
+#include "../../input/input_defines.h"
+#include "../../input/input_snapshot.h"
+
+#define SYNTH_PORTS        4
+#define SYNTH_FRAMES       600
+#define SYNTH_LATCHES      3
+#define CALL_POLL          0xff
+#define MOCK_BINDS         (RARCH_FIRST_CUSTOM_BIND + 8)
+
+struct call
+{
+   uint8_t port;
+   uint8_t device;
+   uint8_t idx;
+   uint8_t id;
+};
+
+struct trace
+{
+   struct call *calls;
+   size_t count;
+   size_t cap;
+   unsigned frames;
+};
+
+struct mock_bind
+{
+   bool valid;
+   unsigned key;
+   unsigned joykey;
+   unsigned joyaxis;
+};
+
+struct mock_pad
+{
+   uint32_t buttons;
+   int16_t axes[4];
+};
+
+struct mock_joypad_info
+{
+   unsigned joy_idx;
+   float axis_threshold;
+   const struct mock_bind *auto_binds;
+};
+
+typedef int16_t (*mock_input_state_t)(void *data,
+      struct mock_joypad_info joypad_info,
+      const struct mock_bind **binds, unsigned port,
+      unsigned device, unsigned idx, unsigned id);
+
+static struct mock_bind mock_binds[MAX_USERS][MOCK_BINDS];
+static const struct mock_bind *mock_bind_ptrs[MAX_USERS];
+static unsigned mock_remap[MAX_USERS][MOCK_BINDS];
+static unsigned mock_joypad_map[MAX_USERS];
+static struct mock_pad *mock_frames;
+static uint8_t mock_keys[512];
+static const struct mock_pad *mock_cur;
+
+static bool mock_joypad_button(const struct mock_pad *pad, unsigned joykey)
+{
+   return (pad->buttons >> joykey) & 1;
+}
+
+static int16_t mock_joypad_axis(const struct mock_pad *pad, unsigned joyaxis)
+{
+   return joyaxis < 4 ? pad->axes[joyaxis] : 0;
+}
+
+/* The joypad driver sits behind its own function pointers. */
+static bool (*volatile mock_joypad)(const struct mock_pad*, unsigned) =
+   mock_joypad_button;
+static int16_t (*volatile mock_joypad_axis_cb)(const struct mock_pad*, unsigned) =
+   mock_joypad_axis;
+
+/* Keyboard first, then the user's bind, then the autoconf bind,
+ * the way the desktop drivers look a button up. */
+static bool mock_pressed(const struct mock_pad *pad,
+      struct mock_joypad_info joypad_info,
+      const struct mock_bind *bind, unsigned id)
+{
+   unsigned joykey;
+
+   if (bind->key && mock_keys[bind->key & 511])
+      return true;
+
+   joykey = bind->joykey != 0xffff
+      ? bind->joykey : joypad_info.auto_binds[id].joykey;
+
+   if (joykey != 0xffff && mock_joypad(pad, joykey))
+      return true;
+
+   return ((float)abs(mock_joypad_axis_cb(pad, bind->joyaxis)) / 0x8000)
+      > joypad_info.axis_threshold;
+}
+
+static int16_t mock_analog(const struct mock_pad *pad,
+      struct mock_joypad_info joypad_info,
+      const struct mock_bind *binds, unsigned idx, unsigned id)
+{
+   unsigned base = RARCH_FIRST_CUSTOM_BIND + (idx * 2 + id) * 2;
+   int16_t value = pad->axes[idx * 2 + id];
+
+   if (value)
+      return value;
+
+   /* Fall back to digital binds, like input_joypad_analog. */
+   if (binds[base].valid && mock_pressed(pad, joypad_info, &binds[base], base))
+      value += 0x7fff;
+   if (binds[base + 1].valid && mock_pressed(pad, joypad_info, &binds[base + 1], base + 1))
+      value -= 0x7fff;
+   return value;
+}
+
+static int16_t mock_input_state(void *data,
+      struct mock_joypad_info joypad_info,
+      const struct mock_bind **binds, unsigned port,
+      unsigned device, unsigned idx, unsigned id)
+{
+   const struct mock_pad *pad = &((const struct mock_pad*)data)[joypad_info.joy_idx];
+
+   switch (device)
+   {
+      case RETRO_DEVICE_JOYPAD:
+         if (id < MOCK_BINDS && binds[port][id].valid)
+            return mock_pressed(pad, joypad_info, &binds[port][id], id);
+         break;
+      case RETRO_DEVICE_ANALOG:
+         if (idx < 2 && id < 2)
+            return mock_analog(pad, joypad_info, binds[port], idx, id);
+         break;
+   }
+
+   return 0;
+}
+
+/* Keeps the driver call out of line, like the real function pointer. */
+static volatile mock_input_state_t mock_driver = mock_input_state;
+
+/* The part of input_state below remapping. */
+static int16_t mock_state_device(void *data, unsigned port,
+      unsigned device, unsigned idx, unsigned id)
+{
+   int16_t res = 0;
+
+   (void)data;
+
+   if (id < MOCK_BINDS && mock_bind_ptrs[port][id].valid)
+   {
+      struct mock_joypad_info joypad_info;
+
+      joypad_info.axis_threshold = 0.5f;
+      joypad_info.joy_idx        = mock_joypad_map[port];
+      joypad_info.auto_binds     = mock_binds[joypad_info.joy_idx];
+
+      res = mock_driver((void*)mock_cur, joypad_info,
+            mock_bind_ptrs, port, device, idx, id);
+   }
+
+   return res;
+}
+
+static void mock_remap_ids(unsigned port, unsigned device,
+      unsigned *idx, unsigned *id)
+{
+   switch (device)
+   {
+      case RETRO_DEVICE_JOYPAD:
+         if (*id < RARCH_FIRST_CUSTOM_BIND)
+            *id = mock_remap[port][*id];
+         break;
+      case RETRO_DEVICE_ANALOG:
+         if (*idx < 2 && *id < 2)
+         {
+            unsigned new_id = mock_remap[port][
+               RARCH_FIRST_CUSTOM_BIND + (*idx * 2 + *id)];
+
+            *idx = (new_id & 2) >> 1;
+            *id  = new_id & 1;
+         }
+         break;
+   }
+}
+
+static int16_t state_uncached(unsigned port, unsigned device,
+      unsigned idx, unsigned id)
+{
+   mock_remap_ids(port, device, &idx, &id);
+   return mock_state_device(NULL, port, device, idx, id);
+}
+
+static int16_t state_snapshot(unsigned port, unsigned device,
+      unsigned idx, unsigned id)
+{
+   int16_t res = 0;
+
+   mock_remap_ids(port, device, &idx, &id);
+   if (!input_snapshot_get(port, device, idx, id,
+            mock_state_device, NULL, &res))
+      res = mock_state_device(NULL, port, device, idx, id);
+   return res;
+}
+
+static void mock_init(unsigned frames)
+{
+   unsigned i, j;
+
+   for (i = 0; i < MAX_USERS; i++)
+   {
+      for (j = 0; j < MOCK_BINDS; j++)
+      {
+         mock_binds[i][j].valid  = true;
+         mock_binds[i][j].key    = i == 0 ? 32 + j : 0;
+         mock_binds[i][j].joykey = j < RARCH_FIRST_CUSTOM_BIND ? j : 16 + (j & 7);
+         mock_binds[i][j].joyaxis = 0xffffffff;
+      }
+      for (j = 0; j < RARCH_FIRST_CUSTOM_BIND; j++)
+         mock_remap[i][j] = j;
+      for (j = 0; j < 4; j++)
+         mock_remap[i][RARCH_FIRST_CUSTOM_BIND + j] = j;
+      mock_bind_ptrs[i]  = mock_binds[i];
+      mock_joypad_map[i] = i;
+   }
+
+   /* Swap B and A on the second user, as a remap would. */
+   mock_remap[1][RETRO_DEVICE_ID_JOYPAD_B] = RETRO_DEVICE_ID_JOYPAD_A;
+   mock_remap[1][RETRO_DEVICE_ID_JOYPAD_A] = RETRO_DEVICE_ID_JOYPAD_B;
+
+   srand(0x1234);
+
+   mock_frames = (struct mock_pad*)calloc(
+         (size_t)frames * MAX_USERS, sizeof(*mock_frames));
+
+   for (i = 0; i < frames * MAX_USERS; i++)
+   {
+      mock_frames[i].buttons = (uint32_t)rand() & 0xffffff;
+      for (j = 0; j < 4; j++)
+         mock_frames[i].axes[j] = (rand() & 3) ? 0 : (int16_t)(rand() - RAND_MAX / 2);
+   }
+}
+
+static void trace_push(struct trace *t, unsigned port, unsigned device,
+      unsigned idx, unsigned id)
+{
+   if (t->count == t->cap)
+   {
+      t->cap   = t->cap ? t->cap * 2 : 4096;
+      t->calls = (struct call*)realloc(t->calls, t->cap * sizeof(*t->calls));
+   }
+
+   t->calls[t->count].port   = port;
+   t->calls[t->count].device = device;
+   t->calls[t->count].idx    = idx;
+   t->calls[t->count].id     = id;
+   t->count++;
+
+   if (port == CALL_POLL)
+      t->frames++;
+}
+
+static bool load_trace(const char *path, struct trace *t)
+{
+   char line[128];
+   FILE *fp = fopen(path, "r");
+
+   if (!fp)
+      return false;
+
+   while (fgets(line, sizeof(line), fp))
+   {
+      unsigned port, device, idx, id;
+
+      if (!strncmp(line, "poll", 4))
+         trace_push(t, CALL_POLL, 0, 0, 0);
+      else if (sscanf(line, "%u %u %u %u", &port, &device, &idx, &id) == 4
+            && port < MAX_USERS && idx < 256 && id < 256)
+         trace_push(t, port, device, idx, id);
+   }
+
+   fclose(fp);
+   return t->frames > 0;
+}
+
+static void synth_trace(struct trace *t)
+{
+   unsigned frame, latch, port, i;
+
+   for (frame = 0; frame < SYNTH_FRAMES; frame++)
+   {
+      trace_push(t, CALL_POLL, 0, 0, 0);
+
+      /* Emulated controller latches read every button
+       * more than once a frame. */
+      for (latch = 0; latch < SYNTH_LATCHES; latch++)
+         for (port = 0; port < SYNTH_PORTS; port++)
+            for (i = 0; i < RARCH_FIRST_CUSTOM_BIND; i++)
+               trace_push(t, port, RETRO_DEVICE_JOYPAD, 0, i);
+
+      for (port = 0; port < SYNTH_PORTS; port++)
+         for (i = 0; i < 4; i++)
+            trace_push(t, port, RETRO_DEVICE_ANALOG, i >> 1, i & 1);
+   }
+}
+
+static retro_time_t replay(const struct trace *t,
+      int16_t (*state)(unsigned, unsigned, unsigned, unsigned),
+      int16_t *results, unsigned passes)
+{
+   unsigned pass;
+   retro_time_t start = cpu_features_get_time_usec();
+
+   for (pass = 0; pass < passes; pass++)
+   {
+      size_t i;
+      unsigned frame = 0;
+
+      mock_cur = mock_frames;
+
+      for (i = 0; i < t->count; i++)
+      {
+         const struct call *c = &t->calls[i];
+
+         if (c->port == CALL_POLL)
+         {
+            mock_cur = &mock_frames[(size_t)frame++ * MAX_USERS];
+            input_snapshot_invalidate();
+            continue;
+         }
+
+         results[i] = state(c->port, c->device, c->idx, c->id);
+      }
+   }
+
+   return cpu_features_get_time_usec() - start;
+}
+
+int main(int argc, char *argv[])
+{
+   size_t i;
+   struct trace t;
+   retro_time_t uncached_time, snapshot_time;
+   int16_t *ref      = NULL;
+   int16_t *res      = NULL;
+   size_t calls      = 0;
+   unsigned passes   = 50;
+   int first_file    = 1;
+
+   memset(&t, 0, sizeof(t));
+
+   if (argc > 2 && !strcmp(argv[1], "-p"))
+   {
+      passes     = (unsigned)strtoul(argv[2], NULL, 0);
+      first_file = 3;
+   }
+
+   if (!passes)
+   {
+      printf("Usage: %s [-p passes] [trace file]\n", argv[0]);
+      return 1;
+   }
+
+   if (first_file < argc)
+   {
+      if (!load_trace(argv[first_file], &t))
+      {
+         printf("Could not read a trace from '%s'.\n", argv[first_file]);
+         return 1;
+      }
+   }
+   else
+      synth_trace(&t);
+
+   for (i = 0; i < t.count; i++)
+      if (t.calls[i].port != CALL_POLL)
+         calls++;
+
+   if (!calls)
+   {
+      printf("Trace has no input_state calls.\n");
+      return 1;
+   }
+
+   mock_init(t.frames);
+
+   ref = (int16_t*)calloc(t.count, sizeof(*ref));
+   res = (int16_t*)calloc(t.count, sizeof(*res));
+
+   replay(&t, state_uncached, ref, 1);
+   replay(&t, state_snapshot, res, 1);
+
+   for (i = 0; i < t.count; i++)
+   {
+      if (ref[i] != res[i])
+      {
+         const struct call *c = &t.calls[i];
+         printf("MISMATCH at call %u (port %u device %u index %u id %u): %d != %d\n",
+               (unsigned)i, c->port, c->device, c->idx, c->id, ref[i], res[i]);
+         return 1;
+      }
+   }
+
+   printf("%u frames, %u calls (%.1f per frame), %u passes\n",
+         t.frames, (unsigned)calls, (double)calls / t.frames, passes);
+
+   uncached_time = replay(&t, state_uncached, res, passes);
+   snapshot_time = replay(&t, state_snapshot, res, passes);
+
+   printf("uncached  %7.2f ns/call\n",
+         uncached_time * 1000.0 / ((double)calls * passes));
+   printf("snapshot  %7.2f ns/call\n",
+         snapshot_time * 1000.0 / ((double)calls * passes));
+
+   free(ref);
+   free(res);
+   free(t.calls);
+   free(mock_frames);
+   return 0;
+}
@@ -0,0 +1,280 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* A core that loads the core named by INPUTTRACE_CORE, passes
+ * everything through to it and writes its input_poll and
+ * input_state calls to INPUTTRACE_FILE (input_state.trace by
+ * default), in the format inputbench reads. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <libretro.h>
+#include <dynamic/dylib.h>
+
+#define TRACE_FILE_DEFAULT "input_state.trace"
+
+struct trace_core
+{
+   void (*set_environment)(retro_environment_t);
+   void (*set_video_refresh)(retro_video_refresh_t);
+   void (*set_audio_sample)(retro_audio_sample_t);
+   void (*set_audio_sample_batch)(retro_audio_sample_batch_t);
+   void (*set_input_poll)(retro_input_poll_t);
+   void (*set_input_state)(retro_input_state_t);
+   void (*init)(void);
+   void (*deinit)(void);
+   unsigned (*api_version)(void);
+   void (*get_system_info)(struct retro_system_info*);
+   void (*get_system_av_info)(struct retro_system_av_info*);
+   void (*set_controller_port_device)(unsigned, unsigned);
+   void (*reset)(void);
+   void (*run)(void);
+   size_t (*serialize_size)(void);
+   bool (*serialize)(void*, size_t);
+   bool (*unserialize)(const void*, size_t);
+   void (*cheat_reset)(void);
+   void (*cheat_set)(unsigned, bool, const char*);
+   bool (*load_game)(const struct retro_game_info*);
+   bool (*load_game_special)(unsigned,
+         const struct retro_game_info*, size_t);
+   void (*unload_game)(void);
+   unsigned (*get_region)(void);
+   void *(*get_memory_data)(unsigned);
+   size_t (*get_memory_size)(unsigned);
+};
+
+static struct trace_core core;
+static dylib_t core_lib;
+static FILE *trace_file;
+static retro_input_poll_t input_poll_cb;
+static retro_input_state_t input_state_cb;
+
+#define TRACE_SYM(x) \
+   *(void**)&core.x = (void*)dylib_proc(core_lib, "retro_" #x); \
+   if (!core.x) \
+      goto error
+
+/* Loads the wrapped core on the first call into this one,
+ * the frontend may ask for its system info before retro_init. */
+static void trace_load(void)
+{
+   const char *path = getenv("INPUTTRACE_CORE");
+
+   if (core_lib)
+      return;
+
+   if (!path || !(core_lib = dylib_load(path)))
+   {
+      fprintf(stderr, "[inputtrace]: Set INPUTTRACE_CORE to the core to trace.\n");
+      exit(1);
+   }
+
+   TRACE_SYM(set_environment);
+   TRACE_SYM(set_video_refresh);
+   TRACE_SYM(set_audio_sample);
+   TRACE_SYM(set_audio_sample_batch);
+   TRACE_SYM(set_input_poll);
+   TRACE_SYM(set_input_state);
+   TRACE_SYM(init);
+   TRACE_SYM(deinit);
+   TRACE_SYM(api_version);
+   TRACE_SYM(get_system_info);
+   TRACE_SYM(get_system_av_info);
+   TRACE_SYM(set_controller_port_device);
+   TRACE_SYM(reset);
+   TRACE_SYM(run);
+   TRACE_SYM(serialize_size);
+   TRACE_SYM(serialize);
+   TRACE_SYM(unserialize);
+   TRACE_SYM(cheat_reset);
+   TRACE_SYM(cheat_set);
+   TRACE_SYM(load_game);
+   TRACE_SYM(load_game_special);
+   TRACE_SYM(unload_game);
+   TRACE_SYM(get_region);
+   TRACE_SYM(get_memory_data);
+   TRACE_SYM(get_memory_size);
+   return;
+
+error:
+   fprintf(stderr, "[inputtrace]: \"%s\" is not a libretro core.\n", path);
+   exit(1);
+}
+
+static void trace_input_poll(void)
+{
+   if (trace_file)
+      fputs("poll\n", trace_file);
+   input_poll_cb();
+}
+
+static int16_t trace_input_state(unsigned port, unsigned device,
+      unsigned idx, unsigned id)
+{
+   if (trace_file)
+      fprintf(trace_file, "%u %u %u %u\n", port, device, idx, id);
+   return input_state_cb(port, device, idx, id);
+}
+
+void retro_set_environment(retro_environment_t cb)
+{
+   trace_load();
+   core.set_environment(cb);
+}
+
+void retro_set_video_refresh(retro_video_refresh_t cb)
+{
+   trace_load();
+   core.set_video_refresh(cb);
+}
+
+void retro_set_audio_sample(retro_audio_sample_t cb)
+{
+   trace_load();
+   core.set_audio_sample(cb);
+}
+
+void retro_set_audio_sample_batch(retro_audio_sample_batch_t cb)
+{
+   trace_load();
+   core.set_audio_sample_batch(cb);
+}
+
+void retro_set_input_poll(retro_input_poll_t cb)
+{
+   trace_load();
+   input_poll_cb = cb;
+   core.set_input_poll(trace_input_poll);
+}
+
+void retro_set_input_state(retro_input_state_t cb)
+{
+   trace_load();
+   input_state_cb = cb;
+   core.set_input_state(trace_input_state);
+}
+
+void retro_init(void)
+{
+   const char *path = getenv("INPUTTRACE_FILE");
+
+   trace_load();
+
+   trace_file = fopen(path ? path : TRACE_FILE_DEFAULT, "w");
+   if (!trace_file)
+      fprintf(stderr, "[inputtrace]: Could not open the trace file.\n");
+
+   core.init();
+}
+
+void retro_deinit(void)
+{
+   core.deinit();
+
+   if (trace_file)
+      fclose(trace_file);
+   trace_file = NULL;
+
+   dylib_close(core_lib);
+   core_lib = NULL;
+}
+
+unsigned retro_api_version(void)
+{
+   return RETRO_API_VERSION;
+}
+
+void retro_get_system_info(struct retro_system_info *info)
+{
+   trace_load();
+   core.get_system_info(info);
+}
+
+void retro_get_system_av_info(struct retro_system_av_info *info)
+{
+   core.get_system_av_info(info);
+}
+
+void retro_set_controller_port_device(unsigned port, unsigned device)
+{
+   core.set_controller_port_device(port, device);
+}
+
+void retro_reset(void)
+{
+   core.reset();
+}
+
+void retro_run(void)
+{
+   core.run();
+}
+
+size_t retro_serialize_size(void)
+{
+   return core.serialize_size();
+}
+
+bool retro_serialize(void *data, size_t size)
+{
+   return core.serialize(data, size);
+}
+
+bool retro_unserialize(const void *data, size_t size)
+{
+   return core.unserialize(data, size);
+}
+
+void retro_cheat_reset(void)
+{
+   core.cheat_reset();
+}
+
+void retro_cheat_set(unsigned index, bool enabled, const char *code)
+{
+   core.cheat_set(index, enabled, code);
+}
+
+bool retro_load_game(const struct retro_game_info *game)
+{
+   return core.load_game(game);
+}
+
+bool retro_load_game_special(unsigned type,
+      const struct retro_game_info *info, size_t num)
+{
+   return core.load_game_special(type, info, num);
+}
+
+void retro_unload_game(void)
+{
+   core.unload_game();
+}
+
+unsigned retro_get_region(void)
+{
+   return core.get_region();
+}
+
+void *retro_get_memory_data(unsigned id)
+{
+   return core.get_memory_data(id);
+}
+
+size_t retro_get_memory_size(unsigned id)
+{
+   return core.get_memory_size(id);
+}
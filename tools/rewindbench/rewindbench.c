@@ -0,0 +1,314 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <features/features_cpu.h>
+
+#include "../../managers/state_delta.h"
+
+/* A 1 MiB state with a few kilobytes of change per frame,
+ * roughly what a 16-bit console core pushes. */
+#define SYNTH_STATE_SIZE   (1024 * 1024)
+#define SYNTH_FRAMES       120
+
+static const char *impl_names[STATE_DELTA_IMPL_LAST] = {
+   "auto",
+   "scalar",
+   "sse2",
+   "avx2",
+   "neon"
+};
+
+struct sequence
+{
+   uint8_t **frames;
+   unsigned count;
+   size_t size;
+   /* Reference patch from frame i back to frame i - 1. */
+   uint8_t **patches;
+   size_t *patch_sizes;
+};
+
+static bool load_file(const char *path, uint8_t **out, size_t *size)
+{
+   long len;
+   uint8_t *buf = NULL;
+   FILE *fp     = fopen(path, "rb");
+
+   if (!fp)
+      return false;
+
+   fseek(fp, 0, SEEK_END);
+   len = ftell(fp);
+   fseek(fp, 0, SEEK_SET);
+
+   if (len <= 0 || (*size && (size_t)len != *size))
+      goto error;
+
+   buf = (uint8_t*)state_delta_alloc(len, 0);
+   if (!buf || fread(buf, 1, len, fp) != (size_t)len)
+      goto error;
+
+   fclose(fp);
+   *size = len;
+   *out  = buf;
+   return true;
+
+error:
+   free(buf);
+   fclose(fp);
+   return false;
+}
+
+static void synth_sequence(struct sequence *seq)
+{
+   unsigned i, j;
+
+   seq->size   = SYNTH_STATE_SIZE;
+   seq->count  = SYNTH_FRAMES;
+   seq->frames = (uint8_t**)calloc(seq->count, sizeof(*seq->frames));
+
+   srand(0x1234);
+
+   for (i = 0; i < seq->count; i++)
+   {
+      uint8_t *frame = (uint8_t*)state_delta_alloc(seq->size, 0);
+
+      if (i == 0)
+         for (j = 0; j < seq->size; j++)
+            frame[j] = (j & 0x3ff) < 0x200 ? (uint8_t)rand() : 0;
+      else
+      {
+         memcpy(frame, seq->frames[i - 1], seq->size);
+
+         /* Frame counters and CPU registers. */
+         for (j = 0; j < 64; j++)
+            frame[j]++;
+
+         /* Scattered RAM writes. */
+         for (j = 0; j < 300; j++)
+            frame[(size_t)rand() * 7 % seq->size] = (uint8_t)rand();
+
+         /* Part of a frame buffer being redrawn. */
+         for (j = 0; j < 2048; j++)
+            frame[seq->size / 2 + ((i * 4096 + j) % (seq->size / 4))]
+               ^= (uint8_t)(i + j);
+      }
+
+      seq->frames[i] = frame;
+   }
+}
+
+static void set_uniq(struct sequence *seq)
+{
+   unsigned i;
+   size_t len16 = (seq->size + 1) & ~(size_t)1;
+
+   /* Neighbours need a different end marker, see state_delta_alloc. */
+   for (i = 0; i < seq->count; i++)
+      ((uint16_t*)seq->frames[i])[len16 / 2 + 3] = i & 1;
+}
+
+/* Builds the reference patches with the scalar code and checks
+ * that they bring every frame back. */
+static bool build_reference(struct sequence *seq)
+{
+   unsigned i;
+   size_t max      = state_delta_maxsize(seq->size);
+   uint8_t *patch  = (uint8_t*)malloc(max);
+   uint8_t *work   = (uint8_t*)malloc(seq->size + 64);
+
+   seq->patches     = (uint8_t**)calloc(seq->count, sizeof(*seq->patches));
+   seq->patch_sizes = (size_t*)calloc(seq->count, sizeof(*seq->patch_sizes));
+
+   state_delta_set_impl(STATE_DELTA_IMPL_SCALAR);
+
+   for (i = 1; i < seq->count; i++)
+   {
+      size_t len = state_delta_compress(seq->frames[i - 1],
+            seq->frames[i], seq->size, patch);
+
+      seq->patches[i]     = (uint8_t*)malloc(len);
+      seq->patch_sizes[i] = len;
+      memcpy(seq->patches[i], patch, len);
+
+      memcpy(work, seq->frames[i], seq->size);
+      state_delta_decompress(patch, len, work, seq->size);
+
+      if (memcmp(work, seq->frames[i - 1], seq->size))
+      {
+         printf("scalar patch %u does not restore the state\n", i);
+         free(patch);
+         free(work);
+         return false;
+      }
+   }
+
+   free(patch);
+   free(work);
+   return true;
+}
+
+static bool run_impl(struct sequence *seq, enum state_delta_impl impl,
+      unsigned passes, size_t total_patch)
+{
+   unsigned i, pass;
+   retro_time_t start, comp_time, decomp_time;
+   size_t max     = state_delta_maxsize(seq->size);
+   uint8_t *patch = (uint8_t*)malloc(max);
+   uint8_t *work  = (uint8_t*)malloc(seq->size + 64);
+   double bytes   = (double)seq->size * (seq->count - 1) * passes;
+
+   state_delta_set_impl(impl);
+
+   for (i = 1; i < seq->count; i++)
+   {
+      size_t len = state_delta_compress(seq->frames[i - 1],
+            seq->frames[i], seq->size, patch);
+
+      if (len != seq->patch_sizes[i] || memcmp(patch, seq->patches[i], len))
+      {
+         printf("%-8s MISMATCH at frame %u\n", impl_names[impl], i);
+         free(patch);
+         free(work);
+         return false;
+      }
+   }
+
+   start = cpu_features_get_time_usec();
+   for (pass = 0; pass < passes; pass++)
+      for (i = 1; i < seq->count; i++)
+         state_delta_compress(seq->frames[i - 1],
+               seq->frames[i], seq->size, patch);
+   comp_time = cpu_features_get_time_usec() - start;
+
+   /* Walk back from the newest frame, like rewinding does. */
+   start = cpu_features_get_time_usec();
+   for (pass = 0; pass < passes; pass++)
+   {
+      memcpy(work, seq->frames[seq->count - 1], seq->size);
+      for (i = seq->count - 1; i > 0; i--)
+         state_delta_decompress(seq->patches[i],
+               seq->patch_sizes[i], work, seq->size);
+   }
+   decomp_time = cpu_features_get_time_usec() - start;
+
+   if (memcmp(work, seq->frames[0], seq->size))
+   {
+      printf("%-8s did not rewind to the first frame\n", impl_names[impl]);
+      free(patch);
+      free(work);
+      return false;
+   }
+
+   printf("%-8s compress %9.1f MB/s  decompress %9.1f MB/s  ratio %6.2f%%\n",
+         impl_names[impl],
+         bytes / (comp_time > 0 ? comp_time : 1),
+         bytes / (decomp_time > 0 ? decomp_time : 1),
+         100.0 * total_patch / ((double)seq->size * (seq->count - 1)));
+
+   free(patch);
+   free(work);
+   return true;
+}
+
+int main(int argc, char *argv[])
+{
+   int i;
+   struct sequence seq;
+   unsigned passes    = 5;
+   size_t total_patch = 0;
+   int failures       = 0;
+   int first_file     = 1;
+
+   memset(&seq, 0, sizeof(seq));
+
+   if (argc > 2 && !strcmp(argv[1], "-p"))
+   {
+      passes     = (unsigned)strtoul(argv[2], NULL, 0);
+      first_file = 3;
+   }
+
+   if (!passes)
+   {
+      printf("Usage: %s [-p passes] [state files...]\n", argv[0]);
+      return 1;
+   }
+
+   if (first_file < argc)
+   {
+      seq.frames = (uint8_t**)calloc(argc - first_file, sizeof(*seq.frames));
+
+      for (i = first_file; i < argc; i++)
+      {
+         if (!load_file(argv[i], &seq.frames[seq.count], &seq.size))
+         {
+            printf("Skipping '%s': unreadable or not %u bytes.\n",
+                  argv[i], (unsigned)seq.size);
+            continue;
+         }
+         seq.count++;
+      }
+   }
+   else
+      synth_sequence(&seq);
+
+   if (seq.count < 2)
+   {
+      printf("Need at least two savestates.\n");
+      return 1;
+   }
+
+   set_uniq(&seq);
+
+   printf("%u states of %u bytes, %u passes\n",
+         seq.count, (unsigned)seq.size, passes);
+
+   if (!build_reference(&seq))
+      return 1;
+
+   for (i = 1; i < (int)seq.count; i++)
+      total_patch += seq.patch_sizes[i];
+
+   state_delta_set_impl(STATE_DELTA_IMPL_AUTO);
+   printf("Auto-selected: %s\n", impl_names[state_delta_get_impl()]);
+
+   for (i = STATE_DELTA_IMPL_SCALAR; i < STATE_DELTA_IMPL_LAST; i++)
+   {
+      if (!state_delta_impl_available((enum state_delta_impl)i))
+      {
+         printf("%-8s not supported\n", impl_names[i]);
+         continue;
+      }
+
+      if (!run_impl(&seq, (enum state_delta_impl)i, passes, total_patch))
+         failures++;
+   }
+
+   for (i = 0; i < (int)seq.count; i++)
+   {
+      free(seq.frames[i]);
+      if (seq.patches)
+         free(seq.patches[i]);
+   }
+   free(seq.frames);
+   free(seq.patches);
+   free(seq.patch_sizes);
+
+   return failures ? 1 : 0;
+}
@@ -0,0 +1,665 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2017 - Hans-Kristian Arntzen
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <dlfcn.h>
+
+#include <vector>
+#include <string>
+
+#include <retro_miscellaneous.h>
+#include <compat/strl.h>
+#include <file/config_file.h>
+#include <file/file_path.h>
+#include <lists/dir_list.h>
+#include <lists/string_list.h>
+#include <features/features_cpu.h>
+#include <vulkan/vulkan_symbol_wrapper.h>
+
+#include "spirv_cross.hpp"
+
+#include "../../gfx/drivers_shader/glslang_util.hpp"
+#include "../../verbosity.h"
+
+using namespace std;
+
+static bool verbose;
+
+/* glslang_util logs through these, only errors are shown by default. */
+void RARCH_LOG_V(const char *tag, const char *fmt, va_list ap)
+{
+   if (!verbose)
+      return;
+   fputs(tag, stdout);
+   vprintf(fmt, ap);
+}
+
+void RARCH_LOG(const char *fmt, ...)
+{
+   va_list ap;
+   va_start(ap, fmt);
+   RARCH_LOG_V("", fmt, ap);
+   va_end(ap);
+}
+
+void RARCH_WARN_V(const char *tag, const char *fmt, va_list ap)
+{
+   fputs(tag, stderr);
+   vfprintf(stderr, fmt, ap);
+}
+
+void RARCH_WARN(const char *fmt, ...)
+{
+   va_list ap;
+   va_start(ap, fmt);
+   RARCH_WARN_V("", fmt, ap);
+   va_end(ap);
+}
+
+void RARCH_ERR_V(const char *tag, const char *fmt, va_list ap)
+{
+   RARCH_WARN_V(tag, fmt, ap);
+}
+
+void RARCH_ERR(const char *fmt, ...)
+{
+   va_list ap;
+   va_start(ap, fmt);
+   RARCH_WARN_V("", fmt, ap);
+   va_end(ap);
+}
+
+/* Presets are read with the paths as written. */
+void fill_pathname_expand_special(char *out_path,
+      const char *in_path, size_t size)
+{
+   strlcpy(out_path, in_path, size);
+}
+
+void fill_pathname_abbreviate_special(char *out_path,
+      const char *in_path, size_t size)
+{
+   strlcpy(out_path, in_path, size);
+}
+
+static bool load_preset(const char *path, vector<string> *passes)
+{
+   unsigned i;
+   int shaders        = 0;
+   config_file_t *conf = NULL;
+
+   if (!strcmp(path_get_extension(path), "slang"))
+   {
+      passes->push_back(path);
+      return true;
+   }
+
+   if (!(conf = config_file_new(path)))
+      return false;
+
+   config_get_int(conf, "shaders", &shaders);
+
+   for (i = 0; i < (unsigned)shaders; i++)
+   {
+      char key[64];
+      char shader[PATH_MAX_LENGTH];
+      char resolved[PATH_MAX_LENGTH];
+
+      snprintf(key, sizeof(key), "shader%u", i);
+      if (!config_get_path(conf, key, shader, sizeof(shader)))
+         break;
+
+      strlcpy(resolved, shader, sizeof(resolved));
+      fill_pathname_resolve_relative(resolved, path, shader, sizeof(resolved));
+      passes->push_back(resolved);
+   }
+
+   config_file_free(conf);
+   return !passes->empty() && passes->size() == (size_t)shaders;
+}
+
+static void clear_cache(const char *dir)
+{
+   size_t i;
+   struct string_list *list = dir_list_new(dir, "spv",
+         false, false, false, false);
+
+   if (!list)
+      return;
+
+   for (i = 0; i < list->size; i++)
+      remove(list->elems[i].data);
+
+   string_list_free(list);
+}
+
+static bool compile_passes(const vector<string> &passes, const char *cache_dir,
+      vector<glslang_output> *outputs, retro_time_t *time)
+{
+   size_t i;
+   retro_time_t start = cpu_features_get_time_usec();
+
+   outputs->clear();
+   outputs->resize(passes.size());
+
+   for (i = 0; i < passes.size(); i++)
+   {
+      if (!glslang_compile_shader(passes[i].c_str(), cache_dir, &(*outputs)[i]))
+      {
+         printf("Failed to compile '%s'.\n", passes[i].c_str());
+         return false;
+      }
+   }
+
+   *time = cpu_features_get_time_usec() - start;
+   return true;
+}
+
+struct vk_context
+{
+   void *library;
+   VkInstance instance;
+   VkPhysicalDevice gpu;
+   VkDevice device;
+   VkRenderPass render_pass;
+};
+
+static bool vk_context_init(struct vk_context *vk)
+{
+   unsigned i;
+   uint32_t count                 = 1;
+   uint32_t family_count          = 0;
+   uint32_t family                = 0;
+   float priority                 = 1.0f;
+   VkApplicationInfo app          = { VK_STRUCTURE_TYPE_APPLICATION_INFO };
+   VkInstanceCreateInfo inst_info = { VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
+   VkDeviceQueueCreateInfo queue  = { VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+   VkDeviceCreateInfo dev_info    = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+   VkAttachmentDescription attachment;
+   VkAttachmentReference color_ref;
+   VkSubpassDescription subpass;
+   VkRenderPassCreateInfo rp_info = { VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
+   VkQueueFamilyProperties families[16];
+   PFN_vkGetInstanceProcAddr get_proc = NULL;
+
+   memset(vk, 0, sizeof(*vk));
+
+   if (!(vk->library = dlopen("libvulkan.so.1", RTLD_NOW))
+         && !(vk->library = dlopen("libvulkan.so", RTLD_NOW)))
+      return false;
+
+   get_proc = (PFN_vkGetInstanceProcAddr)dlsym(vk->library,
+         "vkGetInstanceProcAddr");
+   if (!get_proc)
+      return false;
+
+   vulkan_symbol_wrapper_init(get_proc);
+   if (!vulkan_symbol_wrapper_load_global_symbols())
+      return false;
+
+   app.pApplicationName        = "slangbench";
+   app.apiVersion              = VK_MAKE_VERSION(1, 0, 18);
+   inst_info.pApplicationInfo  = &app;
+
+   if (vkCreateInstance(&inst_info, NULL, &vk->instance) != VK_SUCCESS)
+      return false;
+
+   if (!vulkan_symbol_wrapper_load_core_instance_symbols(vk->instance))
+      return false;
+
+   if (vkEnumeratePhysicalDevices(vk->instance, &count, &vk->gpu) < 0
+         || !count)
+      return false;
+
+   vkGetPhysicalDeviceQueueFamilyProperties(vk->gpu, &family_count, NULL);
+   if (family_count > 16)
+      family_count = 16;
+   vkGetPhysicalDeviceQueueFamilyProperties(vk->gpu, &family_count, families);
+
+   for (i = 0; i < family_count; i++)
+   {
+      if (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
+      {
+         family = i;
+         break;
+      }
+   }
+
+   queue.queueFamilyIndex       = family;
+   queue.queueCount             = 1;
+   queue.pQueuePriorities       = &priority;
+   dev_info.queueCreateInfoCount = 1;
+   dev_info.pQueueCreateInfos    = &queue;
+
+   if (vkCreateDevice(vk->gpu, &dev_info, NULL, &vk->device) != VK_SUCCESS)
+      return false;
+
+   if (!vulkan_symbol_wrapper_load_core_device_symbols(vk->device))
+      return false;
+
+   /* Same single color attachment layout as the filter chain passes. */
+   memset(&attachment, 0, sizeof(attachment));
+   attachment.format         = VK_FORMAT_R8G8B8A8_UNORM;
+   attachment.samples        = VK_SAMPLE_COUNT_1_BIT;
+   attachment.loadOp         = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+   attachment.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
+   attachment.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+   attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+   attachment.initialLayout  = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+   attachment.finalLayout    = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+   color_ref.attachment      = 0;
+   color_ref.layout          = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+   memset(&subpass, 0, sizeof(subpass));
+   subpass.pipelineBindPoint    = VK_PIPELINE_BIND_POINT_GRAPHICS;
+   subpass.colorAttachmentCount = 1;
+   subpass.pColorAttachments    = &color_ref;
+
+   rp_info.attachmentCount = 1;
+   rp_info.pAttachments    = &attachment;
+   rp_info.subpassCount    = 1;
+   rp_info.pSubpasses      = &subpass;
+
+   return vkCreateRenderPass(vk->device, &rp_info, NULL,
+         &vk->render_pass) == VK_SUCCESS;
+}
+
+static void vk_context_free(struct vk_context *vk)
+{
+   if (vk->render_pass != VK_NULL_HANDLE)
+      vkDestroyRenderPass(vk->device, vk->render_pass, NULL);
+   if (vk->device != VK_NULL_HANDLE)
+      vkDestroyDevice(vk->device, NULL);
+   if (vk->instance != VK_NULL_HANDLE)
+      vkDestroyInstance(vk->instance, NULL);
+   if (vk->library)
+      dlclose(vk->library);
+}
+
+static void reflect_stage(const vector<uint32_t> &spirv, VkShaderStageFlags stage,
+      vector<VkDescriptorSetLayoutBinding> *bindings, VkPushConstantRange *push)
+{
+   size_t i, j;
+   spirv_cross::Compiler compiler(spirv);
+   spirv_cross::ShaderResources res = compiler.get_shader_resources();
+   const vector<spirv_cross::Resource> *lists[2] = {
+      &res.uniform_buffers, &res.sampled_images };
+   const VkDescriptorType types[2] = {
+      VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+      VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER };
+
+   for (i = 0; i < 2; i++)
+   {
+      for (j = 0; j < lists[i]->size(); j++)
+      {
+         size_t k;
+         uint32_t binding = compiler.get_decoration((*lists[i])[j].id,
+               spv::DecorationBinding);
+
+         for (k = 0; k < bindings->size(); k++)
+            if ((*bindings)[k].binding == binding)
+               break;
+
+         if (k == bindings->size())
+         {
+            VkDescriptorSetLayoutBinding b;
+            memset(&b, 0, sizeof(b));
+            b.binding         = binding;
+            b.descriptorType  = types[i];
+            b.descriptorCount = 1;
+            bindings->push_back(b);
+         }
+
+         (*bindings)[k].stageFlags |= stage;
+      }
+   }
+
+   if (!res.push_constant_buffers.empty())
+   {
+      uint32_t size = (uint32_t)compiler.get_declared_struct_size(
+            compiler.get_type(res.push_constant_buffers[0].base_type_id));
+
+      push->stageFlags |= stage;
+      if (size > push->size)
+         push->size = size;
+   }
+}
+
+/* Builds pipelines for every pass the way the filter chain does,
+ * with a layout reflected from the SPIR-V. */
+static bool create_pipelines(struct vk_context *vk,
+      const vector<glslang_output> &outputs, VkPipelineCache cache,
+      retro_time_t *time)
+{
+   size_t i;
+   bool ret                 = true;
+   retro_time_t start       = cpu_features_get_time_usec();
+
+   for (i = 0; i < outputs.size() && ret; i++)
+   {
+      VkVertexInputAttributeDescription attributes[2];
+      VkVertexInputBindingDescription binding;
+      VkPipelineShaderStageCreateInfo stages[2];
+      VkPipelineColorBlendAttachmentState blend_attachment;
+      vector<VkDescriptorSetLayoutBinding> bindings;
+      VkPushConstantRange push                           = { 0 };
+      VkDescriptorSetLayout set_layout                   = VK_NULL_HANDLE;
+      VkPipelineLayout layout                            = VK_NULL_HANDLE;
+      VkShaderModule modules[2]                          = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+      VkPipeline pipeline                                = VK_NULL_HANDLE;
+      VkDescriptorSetLayoutCreateInfo set_info           = {
+         VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+      VkPipelineLayoutCreateInfo layout_info             = {
+         VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+      VkShaderModuleCreateInfo module_info               = {
+         VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+      VkPipelineInputAssemblyStateCreateInfo input_assembly = {
+         VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+      VkPipelineVertexInputStateCreateInfo vertex_input  = {
+         VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+      VkPipelineRasterizationStateCreateInfo raster      = {
+         VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+      VkPipelineColorBlendStateCreateInfo blend          = {
+         VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+      VkPipelineViewportStateCreateInfo viewport         = {
+         VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+      VkPipelineDepthStencilStateCreateInfo depth_stencil = {
+         VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
+      VkPipelineMultisampleStateCreateInfo multisample   = {
+         VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+      VkPipelineDynamicStateCreateInfo dynamic           = {
+         VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
+      VkGraphicsPipelineCreateInfo pipe                  = {
+         VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+      static const VkDynamicState dynamics[]             = {
+         VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+      reflect_stage(outputs[i].vertex, VK_SHADER_STAGE_VERTEX_BIT,
+            &bindings, &push);
+      reflect_stage(outputs[i].fragment, VK_SHADER_STAGE_FRAGMENT_BIT,
+            &bindings, &push);
+
+      set_info.bindingCount = (uint32_t)bindings.size();
+      set_info.pBindings    = bindings.data();
+      layout_info.setLayoutCount = 1;
+      layout_info.pSetLayouts    = &set_layout;
+      if (push.stageFlags)
+      {
+         layout_info.pushConstantRangeCount = 1;
+         layout_info.pPushConstantRanges    = &push;
+      }
+
+      module_info.codeSize = outputs[i].vertex.size() * sizeof(uint32_t);
+      module_info.pCode    = outputs[i].vertex.data();
+      ret = vkCreateShaderModule(vk->device, &module_info, NULL,
+            &modules[0]) == VK_SUCCESS;
+
+      module_info.codeSize = outputs[i].fragment.size() * sizeof(uint32_t);
+      module_info.pCode    = outputs[i].fragment.data();
+      ret = ret && vkCreateShaderModule(vk->device, &module_info, NULL,
+            &modules[1]) == VK_SUCCESS;
+
+      ret = ret && vkCreateDescriptorSetLayout(vk->device, &set_info, NULL,
+            &set_layout) == VK_SUCCESS;
+      ret = ret && vkCreatePipelineLayout(vk->device, &layout_info, NULL,
+            &layout) == VK_SUCCESS;
+
+      input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+
+      attributes[0].location  = 0;
+      attributes[0].binding   = 0;
+      attributes[0].format    = VK_FORMAT_R32G32_SFLOAT;
+      attributes[0].offset    = 0;
+      attributes[1].location  = 1;
+      attributes[1].binding   = 0;
+      attributes[1].format    = VK_FORMAT_R32G32_SFLOAT;
+      attributes[1].offset    = 2 * sizeof(float);
+      binding.binding         = 0;
+      binding.stride          = 4 * sizeof(float);
+      binding.inputRate       = VK_VERTEX_INPUT_RATE_VERTEX;
+      vertex_input.vertexBindingDescriptionCount   = 1;
+      vertex_input.pVertexBindingDescriptions      = &binding;
+      vertex_input.vertexAttributeDescriptionCount = 2;
+      vertex_input.pVertexAttributeDescriptions    = attributes;
+
+      raster.polygonMode = VK_POLYGON_MODE_FILL;
+      raster.cullMode    = VK_CULL_MODE_NONE;
+      raster.frontFace   = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+      raster.lineWidth   = 1.0f;
+
+      memset(&blend_attachment, 0, sizeof(blend_attachment));
+      blend_attachment.colorWriteMask = 0xf;
+      blend.attachmentCount           = 1;
+      blend.pAttachments              = &blend_attachment;
+
+      viewport.viewportCount           = 1;
+      viewport.scissorCount            = 1;
+      depth_stencil.maxDepthBounds     = 1.0f;
+      multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+      dynamic.pDynamicStates           = dynamics;
+      dynamic.dynamicStateCount        = 2;
+
+      memset(stages, 0, sizeof(stages));
+      stages[0].sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+      stages[0].stage  = VK_SHADER_STAGE_VERTEX_BIT;
+      stages[0].module = modules[0];
+      stages[0].pName  = "main";
+      stages[1].sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+      stages[1].stage  = VK_SHADER_STAGE_FRAGMENT_BIT;
+      stages[1].module = modules[1];
+      stages[1].pName  = "main";
+
+      pipe.stageCount          = 2;
+      pipe.pStages             = stages;
+      pipe.pVertexInputState   = &vertex_input;
+      pipe.pInputAssemblyState = &input_assembly;
+      pipe.pRasterizationState = &raster;
+      pipe.pColorBlendState    = &blend;
+      pipe.pMultisampleState   = &multisample;
+      pipe.pViewportState      = &viewport;
+      pipe.pDepthStencilState  = &depth_stencil;
+      pipe.pDynamicState       = &dynamic;
+      pipe.renderPass          = vk->render_pass;
+      pipe.layout              = layout;
+
+      ret = ret && vkCreateGraphicsPipelines(vk->device, cache, 1, &pipe,
+            NULL, &pipeline) == VK_SUCCESS;
+
+      if (pipeline != VK_NULL_HANDLE)
+         vkDestroyPipeline(vk->device, pipeline, NULL);
+      if (layout != VK_NULL_HANDLE)
+         vkDestroyPipelineLayout(vk->device, layout, NULL);
+      if (set_layout != VK_NULL_HANDLE)
+         vkDestroyDescriptorSetLayout(vk->device, set_layout, NULL);
+      if (modules[0] != VK_NULL_HANDLE)
+         vkDestroyShaderModule(vk->device, modules[0], NULL);
+      if (modules[1] != VK_NULL_HANDLE)
+         vkDestroyShaderModule(vk->device, modules[1], NULL);
+
+      if (!ret)
+         printf("Failed to create pipeline for pass %u.\n", (unsigned)i);
+   }
+
+   *time = cpu_features_get_time_usec() - start;
+   return ret;
+}
+
+static bool create_cache(struct vk_context *vk, const vector<uint8_t> &data,
+      VkPipelineCache *cache)
+{
+   VkPipelineCacheCreateInfo info = {
+      VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+
+   info.initialDataSize = data.size();
+   info.pInitialData    = data.empty() ? NULL : data.data();
+
+   return vkCreatePipelineCache(vk->device, &info, NULL, cache) == VK_SUCCESS;
+}
+
+static void bench_pipelines(const vector<glslang_output> &outputs,
+      unsigned runs)
+{
+   unsigned i;
+   struct vk_context vk;
+   VkPhysicalDeviceProperties props;
+   vector<uint8_t> data;
+   size_t size                = 0;
+   retro_time_t time          = 0;
+   retro_time_t cold          = 0;
+   retro_time_t warm          = 0;
+   VkPipelineCache cache      = VK_NULL_HANDLE;
+
+   if (!vk_context_init(&vk))
+   {
+      printf("No Vulkan device, skipping pipeline creation.\n");
+      vk_context_free(&vk);
+      return;
+   }
+
+   vkGetPhysicalDeviceProperties(vk.gpu, &props);
+   printf("Vulkan device: %s\n", props.deviceName);
+
+   for (i = 0; i < runs; i++)
+   {
+      vector<uint8_t> empty;
+
+      /* Cold is what every start used to pay, an empty cache. */
+      if (!create_cache(&vk, empty, &cache))
+         goto end;
+      if (!create_pipelines(&vk, outputs, cache, &time))
+         goto end;
+      if (!cold || time < cold)
+         cold = time;
+
+      vkGetPipelineCacheData(vk.device, cache, &size, NULL);
+      data.resize(size);
+      vkGetPipelineCacheData(vk.device, cache, &size, data.data());
+      vkDestroyPipelineCache(vk.device, cache, NULL);
+      cache = VK_NULL_HANDLE;
+
+      /* Warm starts from the data vulkan_pipeline.cache would hold. */
+      if (!create_cache(&vk, data, &cache))
+         goto end;
+      if (!create_pipelines(&vk, outputs, cache, &time))
+         goto end;
+      if (!warm || time < warm)
+         warm = time;
+
+      vkDestroyPipelineCache(vk.device, cache, NULL);
+      cache = VK_NULL_HANDLE;
+   }
+
+   printf("pipelines, empty cache  %8.2f ms\n", cold / 1000.0);
+   printf("pipelines, loaded cache %8.2f ms (%u KB)\n", warm / 1000.0,
+         (unsigned)(data.size() / 1024));
+
+end:
+   if (cache != VK_NULL_HANDLE)
+      vkDestroyPipelineCache(vk.device, cache, NULL);
+   vk_context_free(&vk);
+}
+
+int main(int argc, char *argv[])
+{
+   int i;
+   unsigned run;
+   vector<string> passes;
+   vector<glslang_output> outputs;
+   vector<glslang_output> reference;
+   retro_time_t time        = 0;
+   retro_time_t uncached    = 0;
+   retro_time_t cold        = 0;
+   retro_time_t warm        = 0;
+   unsigned runs            = 3;
+   const char *cache_dir    = "slangbench_cache";
+   const char *preset       = NULL;
+
+   for (i = 1; i < argc; i++)
+   {
+      if (!strcmp(argv[i], "-n") && i + 1 < argc)
+         runs = (unsigned)strtoul(argv[++i], NULL, 0);
+      else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+         cache_dir = argv[++i];
+      else if (!strcmp(argv[i], "-v"))
+         verbose = true;
+      else if (argv[i][0] == '-')
+         break;
+      else
+         preset = argv[i];
+   }
+
+   if (!preset || i < argc)
+   {
+      printf("Usage: %s [-n runs] [-c cache dir] [-v] <preset.slangp | shader.slang>\n",
+            argv[0]);
+      return 1;
+   }
+
+   if (!runs)
+      runs = 1;
+
+   if (!load_preset(preset, &passes))
+   {
+      printf("Could not load '%s'.\n", preset);
+      return 1;
+   }
+
+   printf("%u passes, best of %u runs\n", (unsigned)passes.size(), runs);
+
+   for (run = 0; run < runs; run++)
+   {
+      if (!compile_passes(passes, NULL, &outputs, &time))
+         return 1;
+      if (!uncached || time < uncached)
+         uncached = time;
+      reference = outputs;
+
+      clear_cache(cache_dir);
+      if (!compile_passes(passes, cache_dir, &outputs, &time))
+         return 1;
+      if (!cold || time < cold)
+         cold = time;
+
+      if (!compile_passes(passes, cache_dir, &outputs, &time))
+         return 1;
+      if (!warm || time < warm)
+         warm = time;
+
+      for (i = 0; i < (int)passes.size(); i++)
+      {
+         if (     outputs[i].vertex   != reference[i].vertex
+               || outputs[i].fragment != reference[i].fragment)
+         {
+            printf("Cached SPIR-V of pass %d differs.\n", i);
+            return 1;
+         }
+      }
+   }
+
+   clear_cache(cache_dir);
+   remove(cache_dir);
+
+   printf("compile, no cache       %8.2f ms\n", uncached / 1000.0);
+   printf("compile, cold cache     %8.2f ms\n", cold / 1000.0);
+   printf("compile, warm cache     %8.2f ms\n", warm / 1000.0);
+
+   bench_pipelines(outputs, runs);
+
+   return 0;
+}
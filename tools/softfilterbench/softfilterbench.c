@@ -0,0 +1,325 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2010-2014 - Hans-Kristian Arntzen
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+#include <boolean.h>
+
+#include <features/features_cpu.h>
+#include <compat/strl.h>
+
+#include "../../gfx/video_filter.h"
+
+#define CANARY       0xa5
+/* Lines and pixels of border around the input frame, since
+ * some filters read a little past the edges. */
+#define INPUT_BORDER 4
+#define CONFIG_PATH  "softfilterbench.filt"
+
+struct filter
+{
+   const char *name;
+   enum retro_pixel_format format;
+};
+
+struct size
+{
+   unsigned width;
+   unsigned height;
+};
+
+static const struct filter filters[] = {
+   { "2xbr",             RETRO_PIXEL_FORMAT_XRGB8888 },
+   { "2xbr",             RETRO_PIXEL_FORMAT_RGB565 },
+   { "blargg_ntsc_snes", RETRO_PIXEL_FORMAT_RGB565 },
+   { "scale2x",          RETRO_PIXEL_FORMAT_XRGB8888 },
+   { "scale2x",          RETRO_PIXEL_FORMAT_RGB565 },
+};
+
+/* Low and high resolution SNES frames. */
+static const struct size sizes[] = {
+   { 256, 224 },
+   { 512, 448 },
+};
+
+static bool verbose = false;
+
+/* video_filter.c logs through these. */
+void RARCH_LOG(const char *fmt, ...)
+{
+   va_list ap;
+
+   if (!verbose)
+      return;
+
+   va_start(ap, fmt);
+   vfprintf(stderr, fmt, ap);
+   va_end(ap);
+}
+
+void RARCH_ERR(const char *fmt, ...)
+{
+   va_list ap;
+
+   va_start(ap, fmt);
+   vfprintf(stderr, fmt, ap);
+   va_end(ap);
+}
+
+/* Provided by RetroArch's file_path_special.c. */
+void fill_pathname_expand_special(char *out_path,
+      const char *in_path, size_t size)
+{
+   strlcpy(out_path, in_path, size);
+}
+
+void fill_pathname_abbreviate_special(char *out_path,
+      const char *in_path, size_t size)
+{
+   strlcpy(out_path, in_path, size);
+}
+
+static bool write_config(const char *name)
+{
+   FILE *file = fopen(CONFIG_PATH, "w");
+
+   if (!file)
+      return false;
+
+   fprintf(file, "filter = %s\n", name);
+   fclose(file);
+
+   return true;
+}
+
+/* Blocks of flat colour broken up by noise, so that the edge
+ * detecting filters take every path. */
+static void fill_frame(uint8_t *frame, size_t stride,
+      unsigned width, unsigned height, unsigned bpp)
+{
+   unsigned x, y;
+   uint32_t seed = 0x12345678;
+
+   for (y = 0; y < height; y++)
+   {
+      for (x = 0; x < width; x++)
+      {
+         uint32_t pixel = ((x / 5) * 0x9e3779b1u) ^ ((y / 3) * 0x85ebca6bu);
+
+         seed ^= seed << 13;
+         seed ^= seed >> 17;
+         seed ^= seed << 5;
+
+         if ((seed & 7) == 0)
+            pixel = seed;
+
+         if (bpp == 2)
+            ((uint16_t*)(frame + y * stride))[x] = (uint16_t)(pixel >> 8);
+         else
+            ((uint32_t*)(frame + y * stride))[x] = pixel & 0xffffff;
+      }
+   }
+}
+
+static rarch_softfilter_t *open_filter(const struct filter *filter,
+      unsigned threads, const struct size *size)
+{
+   return rarch_softfilter_new(CONFIG_PATH, threads, filter->format,
+         size->width, size->height);
+}
+
+/* Filters a frame with @threads threads and checks it against
+ * the single threaded output, canaries past each row included.
+ * Each run gets a new filter, since some filters alternate
+ * between fields from one frame to the next. */
+static bool verify(const struct filter *filter, const struct size *size,
+      unsigned threads, const uint8_t *input, size_t input_stride,
+      uint8_t *output, uint8_t *reference, size_t output_size,
+      size_t output_stride)
+{
+   rarch_softfilter_t *filt = open_filter(filter, threads, size);
+   bool ret                 = false;
+
+   if (!filt)
+      return false;
+
+   memset(output, CANARY, output_size);
+   rarch_softfilter_process(filt, output, output_stride,
+         input, size->width, size->height, input_stride);
+
+   if (threads == 1)
+      memcpy(reference, output, output_size);
+   else
+      ret = !memcmp(reference, output, output_size);
+
+   rarch_softfilter_free(filt);
+   return threads == 1 || ret;
+}
+
+static double bench(const struct filter *filter, const struct size *size,
+      unsigned threads, unsigned frames,
+      const uint8_t *input, size_t input_stride,
+      uint8_t *output, size_t output_stride)
+{
+   unsigned i;
+   retro_time_t start;
+   rarch_softfilter_t *filt = open_filter(filter, threads, size);
+
+   if (!filt)
+      return 0.0;
+
+   /* Warm up, and let the workers start. */
+   rarch_softfilter_process(filt, output, output_stride,
+         input, size->width, size->height, input_stride);
+
+   start = cpu_features_get_time_usec();
+   for (i = 0; i < frames; i++)
+      rarch_softfilter_process(filt, output, output_stride,
+            input, size->width, size->height, input_stride);
+   start = cpu_features_get_time_usec() - start;
+
+   rarch_softfilter_free(filt);
+   return start / (double)frames;
+}
+
+int main(int argc, char *argv[])
+{
+   int i;
+   unsigned f, s, threads;
+   unsigned frames      = 200;
+   unsigned max_threads = cpu_features_get_core_amount();
+   int ret              = 1;
+
+   for (i = 1; i < argc; i++)
+   {
+      if (!strcmp(argv[i], "-f") && i + 1 < argc)
+         frames = (unsigned)strtoul(argv[++i], NULL, 0);
+      else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+         max_threads = (unsigned)strtoul(argv[++i], NULL, 0);
+      else if (!strcmp(argv[i], "-v"))
+         verbose = true;
+      else
+      {
+         printf("Usage: %s [-f frames] [-t max threads] [-v]\n", argv[0]);
+         return 1;
+      }
+   }
+
+   if (max_threads < 4)
+      max_threads = 4;
+   if (!frames)
+      frames = 1;
+
+   printf("%-18s %-8s %-9s", "filter", "format", "size");
+   for (threads = 1; threads <= max_threads; threads *= 2)
+      printf(" %6u thr", threads);
+   printf("   (usec/frame)\n");
+
+   for (f = 0; f < sizeof(filters) / sizeof(filters[0]); f++)
+   {
+      const struct filter *filter = &filters[f];
+      unsigned bpp                = filter->format
+         == RETRO_PIXEL_FORMAT_RGB565 ? 2 : 4;
+
+      if (!write_config(filter->name))
+      {
+         printf("Could not write '%s'.\n", CONFIG_PATH);
+         return 1;
+      }
+
+      for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+      {
+         unsigned out_width, out_height, out_bpp;
+         size_t input_stride, output_stride, output_size;
+         const struct size *size  = &sizes[s];
+         uint8_t *input_buf       = NULL;
+         uint8_t *output          = NULL;
+         uint8_t *reference       = NULL;
+         const uint8_t *input     = NULL;
+         rarch_softfilter_t *filt = open_filter(filter, 1, size);
+
+         if (!filt)
+         {
+            printf("Could not load %s.\n", filter->name);
+            goto end;
+         }
+
+         rarch_softfilter_get_output_size(filt, &out_width, &out_height,
+               size->width, size->height);
+         out_bpp = rarch_softfilter_get_output_format(filt)
+            == RETRO_PIXEL_FORMAT_RGB565 ? 2 : 4;
+         rarch_softfilter_free(filt);
+
+         input_stride  = (size->width + 2 * INPUT_BORDER) * bpp;
+         output_stride = (out_width + 3) * out_bpp;
+         output_size   = output_stride * out_height;
+
+         input_buf = (uint8_t*)calloc(size->height + 2 * INPUT_BORDER,
+               input_stride);
+         output    = (uint8_t*)malloc(output_size);
+         reference = (uint8_t*)malloc(output_size);
+         if (!input_buf || !output || !reference)
+            goto end_size;
+
+         input = input_buf + INPUT_BORDER * input_stride + INPUT_BORDER * bpp;
+         fill_frame((uint8_t*)input, input_stride,
+               size->width, size->height, bpp);
+
+         for (threads = 1; threads <= max_threads; threads++)
+         {
+            if (!verify(filter, size, threads, input, input_stride,
+                     output, reference, output_size, output_stride))
+            {
+               printf("%s %ux%u: wrong output with %u threads.\n",
+                     filter->name, size->width, size->height, threads);
+               goto end_size;
+            }
+         }
+
+         printf("%-18s %-8s %4ux%-4u", filter->name,
+               bpp == 2 ? "RGB565" : "XRGB8888",
+               size->width, size->height);
+         for (threads = 1; threads <= max_threads; threads *= 2)
+         {
+            printf(" %10.1f", bench(filter, size, threads, frames,
+                     input, input_stride, output, output_stride));
+            fflush(stdout);
+         }
+         printf("\n");
+
+         free(reference);
+         free(output);
+         free(input_buf);
+         continue;
+
+end_size:
+         free(reference);
+         free(output);
+         free(input_buf);
+         goto end;
+      }
+   }
+
+   ret = 0;
+
+end:
+   remove(CONFIG_PATH);
+   return ret;
+}